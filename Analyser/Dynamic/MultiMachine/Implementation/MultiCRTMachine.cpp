@@ -83,6 +83,12 @@ void MultiCRTMachine::run_for(Time::Seconds duration) {
 	if(delegate_) delegate_->multi_crt_did_run_machines();
 }
 
+void MultiCRTMachine::set_turbo_mode(bool enabled, unsigned int field_decimation, float audio_rate_multiplier) {
+	perform_serial([=](::CRTMachine::Machine *machine) {
+		machine->set_turbo_mode(enabled, field_decimation, audio_rate_multiplier);
+	});
+}
+
 void MultiCRTMachine::did_change_machine_order() {
 	if(speaker_) {
 		speaker_->set_new_front_machine(machines_.front().get());
@@ -58,6 +58,7 @@ class MultiCRTMachine: public CRTMachine::Machine {
 		Outputs::CRT::CRT *get_crt() override;
 		Outputs::Speaker::Speaker *get_speaker() override;
 		void run_for(Time::Seconds duration) override;
+		void set_turbo_mode(bool enabled, unsigned int field_decimation, float audio_rate_multiplier) override;
 
 	private:
 		void run_for(const Cycles cycles) override {}
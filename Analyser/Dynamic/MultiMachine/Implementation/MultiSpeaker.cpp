@@ -43,17 +43,34 @@ void MultiSpeaker::set_output_rate(float cycles_per_second, int buffer_size) {
 	}
 }
 
+void MultiSpeaker::set_input_rate_multiplier(float multiplier) {
+	for(const auto &speaker: speakers_) {
+		speaker->set_input_rate_multiplier(multiplier);
+	}
+}
+
+void MultiSpeaker::set_output_channels(Outputs::Speaker::Channels channels) {
+	for(const auto &speaker: speakers_) {
+		speaker->set_output_channels(channels);
+	}
+
+	std::lock_guard<std::mutex> lock_guard(front_speaker_mutex_);
+	output_channel_count_ = front_speaker_->get_output_channel_count();
+}
+
 void MultiSpeaker::set_delegate(Outputs::Speaker::Speaker::Delegate *delegate) {
 	delegate_ = delegate;
 }
 
 void MultiSpeaker::speaker_did_complete_samples(Speaker *speaker, const std::vector<int16_t> &buffer) {
-	if(!delegate_) return;
+	if(!delegate_ && !ring_) return;
 	{
 		std::lock_guard<std::mutex> lock_guard(front_speaker_mutex_);
 		if(speaker != front_speaker_) return;
 	}
-	delegate_->speaker_did_complete_samples(this, buffer);
+	output_channel_count_ = speaker->get_output_channel_count();
+	if(ring_) ring_->write(buffer.data(), buffer.size());
+	if(delegate_) delegate_->speaker_did_complete_samples(this, buffer);
 }
 
 void MultiSpeaker::speaker_did_change_input_clock(Speaker *speaker) {
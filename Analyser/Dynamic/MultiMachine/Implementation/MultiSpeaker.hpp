@@ -40,6 +40,8 @@ class MultiSpeaker: public Outputs::Speaker::Speaker, Outputs::Speaker::Speaker:
 		// Below is the standard Outputs::Speaker::Speaker interface; see there for documentation.
 		float get_ideal_clock_rate_in_range(float minimum, float maximum) override;
 		void set_output_rate(float cycles_per_second, int buffer_size) override;
+		void set_input_rate_multiplier(float multiplier) override;
+		void set_output_channels(Outputs::Speaker::Channels channels) override;
 		void set_delegate(Outputs::Speaker::Speaker::Delegate *delegate) override;
 
 	private:
@@ -34,6 +34,15 @@ MediaTarget::Machine *MultiMachine::media_target() {
 	}
 }
 
+SnapshotMachine::Machine *MultiMachine::snapshot_machine() {
+	// State can be captured only once a single machine has been picked.
+	if(has_picked_) {
+		return machines_.front()->snapshot_machine();
+	} else {
+		return nullptr;
+	}
+}
+
 CRTMachine::Machine *MultiMachine::crt_machine() {
 	if(has_picked_) {
 		return machines_.front()->crt_machine();
@@ -56,6 +56,7 @@ class MultiMachine: public ::Machine::DynamicMachine, public MultiCRTMachine::De
 		JoystickMachine::Machine *joystick_machine() override;
 		KeyboardMachine::Machine *keyboard_machine() override;
 		MediaTarget::Machine *media_target() override;
+		SnapshotMachine::Machine *snapshot_machine() override;
 		void *raw_pointer() override;
 
 	private:
@@ -15,6 +15,7 @@
 
 #include "../../../Storage/Disk/Parsers/CPM.hpp"
 #include "../../../Storage/Disk/Encodings/MFM/Parser.hpp"
+#include "../../../Storage/State/Formats/SNA.hpp"
 
 static bool strcmp_insensitive(const char *a, const char *b) {
 	if(std::strlen(a) != std::strlen(b)) return false;
@@ -239,6 +240,22 @@ Analyser::Static::TargetList Analyser::Static::AmstradCPC::GetTargets(const Medi
 		}
 	}
 
+	// A snapshot dictates the model; it's loaded in preference to booting, so nothing need be typed.
+	// Only the first is used.
+	for(auto &snapshot: media.snapshots) {
+		Storage::State::SNA *const sna = dynamic_cast<Storage::State::SNA *>(snapshot.get());
+		if(!sna) continue;
+
+		switch(sna->model) {
+			case Storage::State::SNA::Model::CPC464:	target->model = Target::Model::CPC464;	break;
+			case Storage::State::SNA::Model::CPC664:	target->model = Target::Model::CPC664;	break;
+			default:									target->model = Target::Model::CPC6128;	break;
+		}
+		target->media.snapshots.push_back(snapshot);
+		target->loading_command.clear();
+		break;
+	}
+
 	// If any media survived, add the target.
 	if(!target->media.empty())
 		destination.push_back(std::move(target));
@@ -14,6 +14,7 @@
 #include "../../Storage/Tape/Tape.hpp"
 #include "../../Storage/Disk/Disk.hpp"
 #include "../../Storage/Cartridge/Cartridge.hpp"
+#include "../../Storage/State/Snapshot.hpp"
 
 #include <memory>
 #include <string>
@@ -23,20 +24,21 @@ namespace Analyser {
 namespace Static {
 
 /*!
-	A list of disks, tapes and cartridges.
+	A list of disks, tapes, cartridges and snapshots.
 */
 struct Media {
 	std::vector<std::shared_ptr<Storage::Disk::Disk>> disks;
 	std::vector<std::shared_ptr<Storage::Tape::Tape>> tapes;
 	std::vector<std::shared_ptr<Storage::Cartridge::Cartridge>> cartridges;
+	std::vector<std::shared_ptr<Storage::State::Snapshot>> snapshots;
 
 	bool empty() const {
-		return disks.empty() && tapes.empty() && cartridges.empty();
+		return disks.empty() && tapes.empty() && cartridges.empty() && snapshots.empty();
 	}
 };
 
 /*!
-	A list of disks, tapes and cartridges plus information about the machine to which to attach them and its configuration,
+	A list of disks, tapes, cartridges and snapshots plus information about the machine to which to attach them and its configuration,
 	and instructions on how to launch the software attached, plus a measure of confidence in this target's correctness.
 */
 struct Target {
@@ -9,6 +9,10 @@
 #ifndef ClockDeferrer_h
 #define ClockDeferrer_h
 
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <functional>
 #include <vector>
 
 /*!
@@ -78,4 +82,79 @@ template <typename TimeUnit> class ClockDeferrer {
 		std::vector<DeferredAction> pending_actions_;
 };
 
+/*!
+	A FixedClockDeferrer provides the same service as a ClockDeferrer but without allocation or
+	type erasure: up to @c capacity actions, each of type @c Action, are held in place in a ring
+	buffer alongside the absolute time at which each should occur. The target is supplied to each
+	call to run_for, and may therefore be any callable type.
+
+	So deferring an action costs a copy into the buffer, and running costs nothing further than a
+	single test if no actions are pending.
+
+	@c Action can be any default-constructible, copyable callable type that takes no arguments.
+
+	@c capacity must be at least the greatest number of actions that can ever be pending. If the owner
+	defers at most one action per unit of time, and runs the deferrer up to date before each deferral,
+	that is the longest delay in use.
+*/
+template <typename TimeUnit, typename Action, std::size_t capacity> class FixedClockDeferrer {
+	public:
+		/*!
+			Schedules @c action to occur in @c delay units of time.
+
+			Actions must be scheduled in the order they will occur, and no more than @c capacity may be
+			pending at once. It is undefined behaviour to break either rule.
+		*/
+		void defer(TimeUnit delay, const Action &action) {
+			assert(pending_ < capacity);
+			auto &entry = actions_[(next_ + pending_) % capacity];
+			entry.time = now_ + delay;
+			entry.action = action;
+			++pending_;
+		}
+
+		/*!
+			Runs for @c length units of time.
+
+			@c target will be called with one or more periods that add up to @c length;
+			any scheduled actions will be called between periods.
+		*/
+		template <typename Target> void run_for(TimeUnit length, const Target &target) {
+			// If there are no pending actions, just run for the entire length.
+			// This should be the normal branch.
+			if(!pending_) {
+				target(length);
+				return;
+			}
+
+			// Otherwise run up to and perform each action that falls within this period.
+			const TimeUnit end = now_ + length;
+			while(pending_ && actions_[next_].time <= end) {
+				// Copy the action out before performing it, as it may defer another into the same slot.
+				const auto entry = actions_[next_];
+				next_ = (next_ + 1) % capacity;
+				--pending_;
+
+				if(entry.time > now_) {
+					target(entry.time - now_);
+					now_ = entry.time;
+				}
+				entry.action();
+			}
+			if(end > now_) target(end - now_);
+
+			// Times are measured from whenever the buffer was last empty, so they can't grow without bound.
+			now_ = pending_ ? end : TimeUnit(0);
+		}
+
+	private:
+		struct DeferredAction {
+			TimeUnit time;
+			Action action;
+		};
+		std::array<DeferredAction, capacity> actions_;
+		std::size_t next_ = 0, pending_ = 0;
+		TimeUnit now_;
+};
+
 #endif /* ClockDeferrer_h */
@@ -0,0 +1,90 @@
+//
+//  JustInTime.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#ifndef JustInTime_h
+#define JustInTime_h
+
+#include "ClockReceiver.hpp"
+#include "ForceInline.hpp"
+
+#include <utility>
+
+/*!
+	A JustInTimeActor holds (i) an embedded object with a run_for method; and (ii) an amount
+	of time since run_for was last called.
+
+	Time can be added using the += operator. The -> operator can be used to access the
+	embedded object. All time accumulated will be pushed to object before the pointer is returned.
+
+	The embedded object must also implement get_next_sequence_point(), returning the amount of
+	time from now until the next moment at which it might do something other than in response to
+	an access, e.g. change an interrupt output or call a delegate. Time is accumulated without calling
+	run_for until that moment is reached, whereupon the object is brought up to date and asked again.
+	So a component that would otherwise need real-time clocking, in the ClockingHint sense, can be
+	clocked just-in-time, with no more than an add and a compare per owner cycle.
+
+	It is always safe for get_next_sequence_point() to return a shorter period than the true one,
+	at the cost of some unnecessary calls to run_for; it must never return a longer one. It should
+	also be bounded, so that time cannot accumulate indefinitely.
+*/
+template <class T, class LocalTimeScale = HalfCycles> class JustInTimeActor {
+	public:
+		/// Constructs a new JustInTimeActor using the same construction arguments as the included object.
+		template<typename... Args> JustInTimeActor(Args&&... args) : object_(std::forward<Args>(args)...) {}
+
+		/// Adds time to this actor, running the included object if that reaches its next sequence point.
+		forceinline void operator += (const LocalTimeScale &rhs) {
+			if(is_flushed_) {
+				is_flushed_ = false;
+				time_until_event_ = object_.get_next_sequence_point();
+			}
+
+			time_since_update_ += rhs;
+			if(time_since_update_ >= time_until_event_) flush();
+		}
+
+		/*!
+			@returns The amount of time that can be added before the included object reaches its next sequence point,
+			and is therefore run; until then it won't act other than in response to an access.
+		*/
+		forceinline LocalTimeScale get_time_until_sequence_point() {
+			if(is_flushed_) {
+				is_flushed_ = false;
+				time_until_event_ = object_.get_next_sequence_point();
+			}
+			return time_until_event_ - time_since_update_;
+		}
+
+		/// Flushes all accumulated time and returns a pointer to the included object.
+		forceinline T *operator->() {
+			flush();
+			return &object_;
+		}
+
+		/*!
+			Returns a pointer to the included object without flushing time. This is appropriate only for
+			inspecting state that cannot change before the next sequence point, e.g. from a delegate
+			callback made while the object is being run.
+		*/
+		forceinline T *last_valid() {
+			return &object_;
+		}
+
+		/// Flushes all accumulated time; the next sequence point will be obtained afresh when time is next added.
+		forceinline void flush() {
+			is_flushed_ = true;
+			if(time_since_update_ > LocalTimeScale(0)) object_.run_for(time_since_update_.flush());
+		}
+
+	private:
+		T object_;
+		LocalTimeScale time_since_update_, time_until_event_;
+		bool is_flushed_ = true;
+};
+
+#endif /* JustInTime_h */
@@ -16,6 +16,7 @@
 #include "Implementation/6522Storage.hpp"
 
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Storage/State/Serialiser.hpp"
 
 namespace MOS {
 namespace MOS6522 {
@@ -82,9 +83,19 @@ class MOS6522Base: public MOS6522Storage {
 		/// Runs for a specified number of cycles.
 		void run_for(const Cycles cycles);
 
+		/*!
+			@returns The number of half cycles from now after which the IRQ line might next change
+			other than as a result of a register access or control line input, i.e. the time until
+			one of the timers might next fire. This may be shorter than the true time, but never longer.
+		*/
+		HalfCycles get_next_sequence_point() const;
+
 		/// @returns @c true if the IRQ line is currently active; @c false otherwise.
 		bool get_interrupt_line();
 
+		/// Captures or restores the state of this 6522.
+		void serialise(Storage::State::Serialiser &serialiser);
+
 	private:
 		inline void do_phase1();
 		inline void do_phase2();
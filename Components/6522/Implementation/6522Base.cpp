@@ -8,6 +8,8 @@
 
 #include "../6522.hpp"
 
+#include <algorithm>
+
 using namespace MOS::MOS6522;
 
 void MOS6522Base::set_control_line_input(Port port, Line line, bool value) {
@@ -109,8 +111,68 @@ void MOS6522Base::run_for(const Cycles cycles) {
 	}
 }
 
+HalfCycles MOS6522Base::get_next_sequence_point() const {
+	// A timer fires in the phase 1 that follows the phase 2 in which it rolls over from 0 to 0xffff.
+	// If the next half cycle is a phase 1 then it'll inspect the current state.
+	if(!is_phase2_) {
+		for(int c = 0; c < 2; ++c) {
+			if(registers_.timer[c] == 0xffff && !registers_.last_timer[c]) return HalfCycles(1);
+		}
+	}
+
+	// Otherwise: find the value each timer will have after the next phase 2, then the number of
+	// further phase 2s until it next rolls over. Whether each timer is running is deliberately
+	// ignored, which can only make the result shorter and ensures that it's bounded.
+	const int half_cycles_to_phase2 = is_phase2_ ? 0 : 1;
+	int phase2s = 65536;
+	for(int c = 0; c < 2; ++c) {
+		uint16_t next_value;
+		if(registers_.next_timer[c] >= 0) {
+			next_value = static_cast<uint16_t>(registers_.next_timer[c]);
+		} else if(!c && registers_.timer_needs_reload) {
+			next_value = registers_.timer_latch[0];
+		} else {
+			next_value = static_cast<uint16_t>(registers_.timer[c] - 1);
+		}
+
+		if(next_value == 0xffff && !registers_.timer[c]) return HalfCycles(half_cycles_to_phase2 + 2);
+		phase2s = std::min(phase2s, static_cast<int>(next_value) + 1);
+	}
+
+	return HalfCycles(half_cycles_to_phase2 + 2 + phase2s * 2);
+}
+
 /*! @returns @c true if the IRQ line is currently active; @c false otherwise. */
 bool MOS6522Base::get_interrupt_line() {
 	uint8_t interrupt_status = registers_.interrupt_flags & registers_.interrupt_enable & 0x7f;
 	return !!interrupt_status;
 }
+
+void MOS6522Base::serialise(Storage::State::Serialiser &serialiser) {
+	serialiser.begin_section("6522", 1);
+
+	serialiser.field(is_phase2_);
+
+	serialiser.field(registers_.output);
+	serialiser.field(registers_.input);
+	serialiser.field(registers_.data_direction);
+	serialiser.field(registers_.timer);
+	serialiser.field(registers_.timer_latch);
+	serialiser.field(registers_.last_timer);
+	serialiser.field(registers_.next_timer);
+	serialiser.field(registers_.shift);
+	serialiser.field(registers_.auxiliary_control);
+	serialiser.field(registers_.peripheral_control);
+	serialiser.field(registers_.interrupt_flags);
+	serialiser.field(registers_.interrupt_enable);
+	serialiser.field(registers_.timer_needs_reload);
+
+	for(auto &inputs: control_inputs_) {
+		serialiser.field(inputs.line_one);
+		serialiser.field(inputs.line_two);
+	}
+	serialiser.field(timer_is_running_);
+	serialiser.field(last_posted_interrupt_status_);
+
+	serialiser.end_section();
+}
@@ -13,6 +13,7 @@
 #include <cstdio>
 
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Storage/State/Serialiser.hpp"
 
 namespace MOS {
 
@@ -146,6 +147,28 @@ template <class T> class MOS6532 {
 			return interrupt_line_;
 		}
 
+		/// Captures or restores the state of this 6532, including its RAM.
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialiser.begin_section("6532", 1);
+
+			serialiser.field(ram_);
+			serialiser.field(timer_.value);
+			serialiser.field(timer_.activeShift);
+			serialiser.field(timer_.writtenShift);
+			serialiser.field(timer_.interrupt_enabled);
+			serialiser.field(a7_interrupt_.enabled);
+			serialiser.field(a7_interrupt_.active_on_positive);
+			serialiser.field(a7_interrupt_.last_port_value);
+			for(auto &port: port_) {
+				serialiser.field(port.output_mask);
+				serialiser.field(port.output);
+			}
+			serialiser.field(interrupt_status_);
+			serialiser.field(interrupt_line_);
+
+			serialiser.end_section();
+		}
+
 	private:
 		uint8_t ram_[128];
 
@@ -15,6 +15,8 @@
 #include "../../Outputs/Speaker/Implementation/LowpassSpeaker.hpp"
 #include "../../Outputs/Speaker/Implementation/SampleSource.hpp"
 
+#include <cmath>
+
 namespace MOS {
 namespace MOS6560 {
 
@@ -78,6 +80,11 @@ template <class BusHandler> class MOS6560 {
 
 					"return vec2(yc.x, chroma);"
 				"}");
+			crt_->set_software_svideo_sampling_function([] (const uint8_t *sample, float phase, float amplitude, float *luminance_chrominance) {
+				const float chroma_phase = static_cast<float>(sample[1]) / 255.0f;
+				luminance_chrominance[0] = static_cast<float>(sample[0]) / 255.0f;
+				luminance_chrominance[1] = (chroma_phase <= 0.75f) ? cosf(phase + 6.283185308f * 2.0f * chroma_phase) : 0.0f;
+			});
 
 			// default to s-video output
 			crt_->set_video_signal(Outputs::CRT::VideoSignal::SVideo);
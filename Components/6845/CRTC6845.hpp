@@ -10,6 +10,7 @@
 #define CRTC6845_hpp
 
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Storage/State/Serialiser.hpp"
 
 #include <cstdint>
 #include <cstdio>
@@ -164,6 +165,41 @@ template <class T> class CRTC6845 {
 			return bus_state_;
 		}
 
+		/// Captures or restores the complete state of this CRTC.
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialiser.begin_section("6845", 1);
+
+			serialiser.field(bus_state_.display_enable);
+			serialiser.field(bus_state_.hsync);
+			serialiser.field(bus_state_.vsync);
+			serialiser.field(bus_state_.cursor);
+			serialiser.field(bus_state_.refresh_address);
+			serialiser.field(bus_state_.row_address);
+
+			serialiser.field(registers_);
+			serialiser.field(dummy_register_);
+			serialiser.field(selected_register_);
+
+			serialiser.field(character_counter_);
+			serialiser.field(line_counter_);
+			serialiser.field(character_is_visible_);
+			serialiser.field(line_is_visible_);
+			serialiser.field(hsync_counter_);
+			serialiser.field(vsync_counter_);
+			serialiser.field(is_in_adjustment_period_);
+			serialiser.field(line_address_);
+			serialiser.field(end_of_line_address_);
+			serialiser.field(status_);
+			serialiser.field(display_skew_mask_);
+			serialiser.field(character_is_visible_shifter_);
+
+			serialiser.end_section();
+
+			if(display_skew_mask_ != 1 && display_skew_mask_ != 2 && display_skew_mask_ != 4) {
+				serialiser.set_invalid();
+			}
+		}
+
 	private:
 		inline void perform_bus_cycle_phase1() {
 			// Skew theory of operation: keep a history of the last three states, and apply whichever is selected.
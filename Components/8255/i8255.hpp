@@ -9,6 +9,8 @@
 #ifndef i8255_hpp
 #define i8255_hpp
 
+#include "../../Storage/State/Serialiser.hpp"
+
 namespace Intel {
 namespace i8255 {
 
@@ -74,6 +76,17 @@ template <class T> class i8255 {
 			return 0xff;
 		}
 
+		/*!
+			Captures or restores the state of this 8255. The port handler is not informed of
+			restored output values; its owner is responsible for any state it holds.
+		*/
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialiser.begin_section("8255", 1);
+			serialiser.field(control_);
+			serialiser.field(outputs_);
+			serialiser.end_section();
+		}
+
 	private:
 		void update_outputs() {
 			if(!(control_ & 0x10)) port_handler_.set_value(0, outputs_[0]);
@@ -12,14 +12,22 @@
 #include <cstring>
 #include <cstdlib>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TMS_X86
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define TMS_NEON
+#endif
+
 using namespace TI::TMS;
 
 namespace {
 
 const uint8_t StatusInterrupt = 0x80;
 const uint8_t StatusSpriteOverflow = 0x40;
-
-const int StatusSpriteCollisionShift = 5;
 const uint8_t StatusSpriteCollision = 0x20;
 
 // 342 internal cycles are 228/227.5ths of a line, so 341.25 cycles should be a whole
@@ -46,6 +54,78 @@ struct ReverseTable {
 	}
 } reverse_table;
 
+/*!
+	Maps from a byte of a bitplane to eight bytes, one per pixel in display order, each of which
+	is either 0 or 1. So the four planes of a Master System tile row can be combined into colour
+	indices for all eight pixels at once via shifts and ORs.
+*/
+struct PlanarTable {
+	std::uint64_t map[256];
+
+	PlanarTable() {
+		for(int c = 0; c < 256; ++c) {
+			std::uint8_t *const pixels = reinterpret_cast<std::uint8_t *>(&map[c]);
+			for(int pixel = 0; pixel < 8; ++pixel) {
+				pixels[pixel] = static_cast<uint8_t>((c >> (7 - pixel)) & 1);
+			}
+		}
+	}
+} planar_table;
+
+/*!
+	Maps from a byte of a TMS sprite pattern to the sixteen bits it occupies when magnified,
+	i.e. with each bit doubled.
+*/
+struct MagnificationTable {
+	std::uint16_t map[256];
+
+	MagnificationTable() {
+		for(int c = 0; c < 256; ++c) {
+			map[c] = 0;
+			for(int bit = 0; bit < 8; ++bit) {
+				if(c & (1 << bit)) map[c] |= 3 << (bit * 2);
+			}
+		}
+	}
+} magnification_table;
+
+/*!
+	Writes eight pixels to @c target, one for each bit of @c pattern starting from the most significant,
+	being @c colours[1] if that bit is set and @c colours[0] otherwise.
+*/
+inline void draw_pattern_byte(uint32_t *target, uint8_t pattern, const uint32_t colours[2]) {
+	alignas(16) static const uint32_t bits[8] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
+#if defined(TMS_X86)
+	const __m128i source = _mm_set1_epi32(pattern);
+	const __m128i background = _mm_set1_epi32(static_cast<int>(colours[0]));
+	const __m128i foreground = _mm_set1_epi32(static_cast<int>(colours[1]));
+	for(int half = 0; half < 2; ++half) {
+		const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i *>(&bits[half * 4]));
+		const __m128i selection = _mm_cmpeq_epi32(_mm_and_si128(source, mask), mask);
+		_mm_storeu_si128(
+			reinterpret_cast<__m128i *>(&target[half * 4]),
+			_mm_or_si128(_mm_and_si128(selection, foreground), _mm_andnot_si128(selection, background)));
+	}
+#elif defined(TMS_NEON)
+	const uint32x4_t source = vdupq_n_u32(pattern);
+	const uint32x4_t background = vdupq_n_u32(colours[0]);
+	const uint32x4_t foreground = vdupq_n_u32(colours[1]);
+	vst1q_u32(&target[0], vbslq_u32(vtstq_u32(source, vld1q_u32(&bits[0])), foreground, background));
+	vst1q_u32(&target[4], vbslq_u32(vtstq_u32(source, vld1q_u32(&bits[4])), foreground, background));
+#else
+	for(int c = 0; c < 8; ++c) {
+		target[c] = colours[(pattern & bits[c]) ? 1 : 0];
+	}
+#endif
+}
+
+/// Serialises a table address as 32 bits, so that state is independent of the size of size_t.
+void serialise_address(Storage::State::Serialiser &serialiser, size_t &address) {
+	uint32_t value = static_cast<uint32_t>(address);
+	serialiser.field(value);
+	address = value;
+}
+
 }
 
 Base::Base(Personality p) :
@@ -91,6 +171,11 @@ TMS9918::TMS9918(Personality p):
 		"{"
 			"return texture(sampler, coordinate).rgb / vec3(255.0);"
 		"}");
+	crt_->set_software_rgb_sampling_function([] (const uint8_t *sample, float *rgb) {
+		rgb[0] = static_cast<float>(sample[0]) / 255.0f;
+		rgb[1] = static_cast<float>(sample[1]) / 255.0f;
+		rgb[2] = static_cast<float>(sample[2]) / 255.0f;
+	});
 	crt_->set_video_signal(Outputs::CRT::VideoSignal::RGB);
 	crt_->set_visible_area(Outputs::CRT::Rect(0.055f, 0.025f, 0.9f, 0.9f));
 
@@ -220,10 +305,18 @@ void TMS9918::run_for(const HalfCycles cycles) {
 			// Perform memory accesses.
 			// ------------------------
 #define fetch(function)	\
-	if(final_window != 171) {	\
-		function<true>(first_window, final_window);\
+	if(queued_access_ == MemoryAccess::None) {\
+		if(final_window != 171) {	\
+			function<true, false>(first_window, final_window);\
+		} else {\
+			function<false, false>(first_window, final_window);\
+		}\
 	} else {\
-		function<false>(first_window, final_window);\
+		if(final_window != 171) {	\
+			function<true, true>(first_window, final_window);\
+		} else {\
+			function<false, true>(first_window, final_window);\
+		}\
 	}
 
 			// column_ and end_column are in 342-per-line cycles;
@@ -233,7 +326,8 @@ void TMS9918::run_for(const HalfCycles cycles) {
 			if(first_window != final_window) {
 				switch(line_buffer.line_mode) {
 					case LineMode::Text:		fetch(fetch_tms_text);		break;
-					case LineMode::Character:	fetch(fetch_tms_character);	break;
+					case LineMode::Character:
+					case LineMode::MultiColour:	fetch(fetch_tms_character);	break;
 					case LineMode::SMS:			fetch(fetch_sms);			break;
 					case LineMode::Refresh:		fetch(fetch_tms_refresh);	break;
 				}
@@ -304,6 +398,9 @@ void TMS9918::run_for(const HalfCycles cycles) {
 						next_line_buffer.line_mode = LineMode::SMS;
 						mode_timing_.maximum_visible_sprites = 8;
 					break;
+					case ScreenMode::MultiColour:
+						next_line_buffer.line_mode = LineMode::MultiColour;
+					break;
 					default:
 						next_line_buffer.line_mode = LineMode::Character;
 					break;
@@ -419,7 +516,8 @@ void TMS9918::run_for(const HalfCycles cycles) {
 							const int relative_end = end - line_buffer.first_pixel_output_column;
 							switch(line_buffer.line_mode) {
 								case LineMode::SMS:			draw_sms(relative_start, relative_end, cram_value);		break;
-								case LineMode::Character:	draw_tms_character(relative_start, relative_end);		break;
+								case LineMode::Character:
+								case LineMode::MultiColour:	draw_tms_character(relative_start, relative_end);		break;
 								case LineMode::Text:		draw_tms_text(relative_start, relative_end);			break;
 
 								case LineMode::Refresh:		break;	/* Dealt with elsewhere. */
@@ -766,12 +864,13 @@ void Base::draw_tms_character(int start, int end) {
 
 	// Paint the background tiles.
 	const int pixels_left = end - start;
-	if(screen_mode_ == ScreenMode::MultiColour) {
+	if(line_buffer.line_mode == LineMode::MultiColour) {
 		for(int c = start; c < end; ++c) {
-			pixel_target_[c] = palette[
+			pixel_target_[c - start] = palette[
 				(line_buffer.patterns[c >> 3][0] >> (((c & 4)^4))) & 15
 			];
 		}
+		pixel_target_ += pixels_left;
 	} else {
 		const int shift = start & 7;
 		int byte_column = start >> 3;
@@ -785,12 +884,18 @@ void Base::draw_tms_character(int start, int end) {
 			palette[(colour >> 4) ? (colour >> 4) : background_colour_]
 		};
 
+		// Whole tiles are drawn eight pixels at a time; only a partial tile at either end
+		// of the span needs to be drawn pixel by pixel.
 		int background_pixels_left = pixels_left;
 		while(true) {
 			background_pixels_left -= length;
-			for(int c = 0; c < length; ++c) {
-				pixel_target_[c] = colours[pattern&0x01];
-				pattern >>= 1;
+			if(length == 8) {
+				draw_pattern_byte(pixel_target_, line_buffer.patterns[byte_column][0], colours);
+			} else {
+				for(int c = 0; c < length; ++c) {
+					pixel_target_[c] = colours[pattern&0x01];
+					pattern >>= 1;
+				}
 			}
 			pixel_target_ += length;
 
@@ -798,7 +903,7 @@ void Base::draw_tms_character(int start, int end) {
 			length = std::min(8, background_pixels_left);
 			byte_column++;
 
-			pattern = reverse_table.map[line_buffer.patterns[byte_column][0]];
+			if(length != 8) pattern = reverse_table.map[line_buffer.patterns[byte_column][0]];
 			colour = line_buffer.patterns[byte_column][1];
 			colours[0] = palette[(colour & 15) ? (colour & 15) : background_colour_];
 			colours[1] = palette[(colour >> 4) ? (colour >> 4) : background_colour_];
@@ -817,39 +922,59 @@ void Base::draw_tms_character(int start, int end) {
 			}
 		}
 
-		int sprite_buffer[256];
-		int sprite_collision = 0;
-		memset(&sprite_buffer[start], 0, size_t(end - start)*sizeof(sprite_buffer[0]));
-
-		static const uint32_t sprite_colour_selection_masks[2] = {0x00000000, 0xffffffff};
-		static const int colour_masks[16] = {0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		// Sprite pixels are accumulated into a bitmap of the line, most significant bit first,
+		// with which to detect collisions. A spare word at the end allows any sprite's pixels
+		// to be applied as a pair of 32-bit words.
+		uint32_t sprite_bitmap[9] = {};
+		uint32_t sprite_collision = 0;
 
-		// Draw all sprites into the sprite buffer.
+		// Draw all sprites.
 		const int shifter_target = sprites_16x16_ ? 32 : 16;
 		for(int index = line_buffer.active_sprite_slot - 1; index >= 0; --index) {
 			LineBuffer::ActiveSprite &sprite = line_buffer.active_sprites[index];
-			if(sprite.shift_position < shifter_target) {
-				const int pixel_start = std::max(start, sprite.x);
-				for(int c = pixel_start; c < end && sprite.shift_position < shifter_target; ++c) {
-					const int shift = (sprite.shift_position >> 1) ^ 7;
-					int sprite_colour = (sprite.image[shift >> 3] >> (shift & 7)) & 1;
-
-					// A colision is detected regardless of sprite colour ...
-					sprite_collision |= sprite_buffer[c] & sprite_colour;
-					sprite_buffer[c] |= sprite_colour;
-
-					// ... but a sprite with the transparent colour won't actually be visible.
-					sprite_colour &= colour_masks[sprite.image[2]&15];
-					pixel_origin_[c] =
-						(pixel_origin_[c] & sprite_colour_selection_masks[sprite_colour^1]) |
-						(palette[sprite.image[2]&15] & sprite_colour_selection_masks[sprite_colour]);
+			if(sprite.shift_position >= shifter_target) continue;
+
+			const int pixel_start = std::max(start, sprite.x);
+			if(pixel_start >= end) continue;
+
+			// Form the sprite's pixels as a bit string, most significant bit first, and
+			// discard those already output or beyond the end of this span.
+			uint32_t pixels;
+			int pixels_output;
+			if(sprites_magnified_) {
+				pixels = uint32_t((magnification_table.map[sprite.image[0]] << 16) | magnification_table.map[sprite.image[1]]);
+				pixels_output = sprite.shift_position;
+			} else {
+				pixels = uint32_t((sprite.image[0] << 24) | (sprite.image[1] << 16));
+				pixels_output = sprite.shift_position >> 1;
+			}
 
-					sprite.shift_position += shift_advance;
+			const int length = std::min(end - pixel_start, (shifter_target - sprite.shift_position + shift_advance - 1) / shift_advance);
+			pixels = (pixels << pixels_output) & (0xffffffff << (32 - length));
+			sprite.shift_position += length * shift_advance;
+
+			// A colision is detected regardless of sprite colour ...
+			const uint64_t line_pixels = (uint64_t(pixels) << 32) >> (pixel_start & 31);
+			uint32_t *const bitmap = &sprite_bitmap[pixel_start >> 5];
+			sprite_collision |=
+				(bitmap[0] & uint32_t(line_pixels >> 32)) |
+				(bitmap[1] & uint32_t(line_pixels));
+			bitmap[0] |= uint32_t(line_pixels >> 32);
+			bitmap[1] |= uint32_t(line_pixels);
+
+			// ... but a sprite with the transparent colour won't actually be visible.
+			if(sprite.image[2]&15) {
+				const uint32_t colour = palette[sprite.image[2]&15];
+				uint32_t *target = &pixel_origin_[pixel_start];
+				while(pixels) {
+					if(pixels & 0x80000000) *target = colour;
+					pixels <<= 1;
+					++target;
 				}
 			}
 		}
 
-		status_ |= sprite_collision << StatusSpriteCollisionShift;
+		if(sprite_collision) status_ |= StatusSpriteCollision;
 	}
 }
 
@@ -879,7 +1004,7 @@ void Base::draw_tms_text(int start, int end) {
 
 void Base::draw_sms(int start, int end, uint32_t cram_dot) {
 	LineBuffer &line_buffer = line_buffers_[read_pointer_.row];
-	int colour_buffer[256];
+	uint8_t colour_buffer[256];
 
 	/*
 		Add extra border for any pixels that fall before the fine scroll.
@@ -888,7 +1013,7 @@ void Base::draw_sms(int start, int end, uint32_t cram_dot) {
 	int tile_offset = start;
 	if(read_pointer_.row >= 16 || !master_system_.horizontal_scroll_lock) {
 		for(int c = start; c < (line_buffer.latched_horizontal_scroll & 7); ++c) {
-			colour_buffer[c] = 16 + background_colour_;
+			colour_buffer[c] = static_cast<uint8_t>(16 + background_colour_);
 			++tile_offset;
 		}
 
@@ -898,58 +1023,46 @@ void Base::draw_sms(int start, int end, uint32_t cram_dot) {
 	}
 
 
-	uint32_t pattern;
-	uint8_t *const pattern_index = reinterpret_cast<uint8_t *>(&pattern);
-
 	/*
 		Add background tiles; these will fill the colour_buffer with values in which
 		the low five bits are a palette index, and bit six is set if this tile has
 		priority over sprites.
+
+		All eight pixels of a tile are decoded at once, each as one byte of a 64-bit word,
+		then whichever of them are within the span are copied.
 	*/
 	if(tile_start < end) {
-		const int shift = tile_start & 7;
+		int shift = tile_start & 7;
 		int byte_column = tile_start >> 3;
 		int pixels_left = tile_end - tile_start;
-		int length = std::min(pixels_left, 8 - shift);
 
-		pattern = *reinterpret_cast<const uint32_t *>(line_buffer.patterns[byte_column]);
-		if(line_buffer.names[byte_column].flags&2)
-			pattern >>= shift;
-		else
-			pattern <<= shift;
-
-		while(true) {
-			const int palette_offset = (line_buffer.names[byte_column].flags&0x18) << 1;
-			if(line_buffer.names[byte_column].flags&2) {
-				for(int c = 0; c < length; ++c) {
-					colour_buffer[tile_offset] =
-						((pattern_index[3] & 0x01) << 3) |
-						((pattern_index[2] & 0x01) << 2) |
-						((pattern_index[1] & 0x01) << 1) |
-						((pattern_index[0] & 0x01) << 0) |
-						palette_offset;
-					++tile_offset;
-					pattern >>= 1;
-				}
+		while(pixels_left) {
+			const int length = std::min(pixels_left, 8 - shift);
+			const uint8_t flags = line_buffer.names[byte_column].flags;
+			const uint8_t *const planes = line_buffer.patterns[byte_column];
+
+			// Horizontally-flipped tiles have their planes bit-reversed, to be displayed least significant bit first.
+			uint64_t pixels;
+			if(flags&2) {
+				pixels =
+					(planar_table.map[reverse_table.map[planes[0]]] << 0) |
+					(planar_table.map[reverse_table.map[planes[1]]] << 1) |
+					(planar_table.map[reverse_table.map[planes[2]]] << 2) |
+					(planar_table.map[reverse_table.map[planes[3]]] << 3);
 			} else {
-				for(int c = 0; c < length; ++c) {
-					colour_buffer[tile_offset] =
-						((pattern_index[3] & 0x80) >> 4) |
-						((pattern_index[2] & 0x80) >> 5) |
-						((pattern_index[1] & 0x80) >> 6) |
-						((pattern_index[0] & 0x80) >> 7) |
-						palette_offset;
-					++tile_offset;
-					pattern <<= 1;
-				}
+				pixels =
+					(planar_table.map[planes[0]] << 0) |
+					(planar_table.map[planes[1]] << 1) |
+					(planar_table.map[planes[2]] << 2) |
+					(planar_table.map[planes[3]] << 3);
 			}
+			pixels |= uint64_t((flags&0x18) << 1) * 0x0101010101010101;
 
+			memcpy(&colour_buffer[tile_offset], reinterpret_cast<const uint8_t *>(&pixels) + shift, size_t(length));
+			tile_offset += length;
 			pixels_left -= length;
-			if(!pixels_left) break;
-
-			length = std::min(8, pixels_left);
-			byte_column++;
-			pattern = *reinterpret_cast<const uint32_t *>(line_buffer.patterns[byte_column]);
+			shift = 0;
+			++byte_column;
 		}
 	}
 
@@ -977,15 +1090,16 @@ void Base::draw_sms(int start, int end, uint32_t cram_dot) {
 			if(sprite.shift_position < 16) {
 				const int pixel_start = std::max(start, sprite.x);
 
-				// TODO: it feels like the work below should be simplifiable;
-				// the double shift in particular, and hopefully the variable shift.
+				// Decode all eight pixels of the sprite up front, as for background tiles.
+				const uint64_t pixels =
+					(planar_table.map[sprite.image[0]] << 0) |
+					(planar_table.map[sprite.image[1]] << 1) |
+					(planar_table.map[sprite.image[2]] << 2) |
+					(planar_table.map[sprite.image[3]] << 3);
+				const uint8_t *const colours = reinterpret_cast<const uint8_t *>(&pixels);
+
 				for(int c = pixel_start; c < end && sprite.shift_position < 16; ++c) {
-					const int shift = (sprite.shift_position >> 1);
-					const int sprite_colour =
-						(((sprite.image[3] << shift) & 0x80) >> 4) |
-						(((sprite.image[2] << shift) & 0x80) >> 5) |
-						(((sprite.image[1] << shift) & 0x80) >> 6) |
-						(((sprite.image[0] << shift) & 0x80) >> 7);
+					const int sprite_colour = colours[sprite.shift_position >> 1];
 
 					if(sprite_colour) {
 						sprite_collision |= sprite_buffer[c];
@@ -1003,7 +1117,7 @@ void Base::draw_sms(int start, int end, uint32_t cram_dot) {
 			if(
 				sprite_buffer[c] &&
 				(!(colour_buffer[c]&0x20) || !(colour_buffer[c]&0xf))
-			) colour_buffer[c] = sprite_buffer[c];
+			) colour_buffer[c] = static_cast<uint8_t>(sprite_buffer[c]);
 		}
 
 		if(sprite_collision)
@@ -1026,3 +1140,122 @@ void Base::draw_sms(int start, int end, uint32_t cram_dot) {
 		}
 	}
 }
+
+// MARK: - State
+
+void TMS9918::serialise(Storage::State::Serialiser &serialiser) {
+	serialiser.begin_section("9918", 1);
+
+	// Memory and the memory access mechanism.
+	serialiser.field(ram_);
+	serialiser.field(ram_pointer_);
+	serialiser.field(read_ahead_buffer_);
+	serialiser.field(queued_access_);
+	serialiser.field(cycles_until_access_);
+	serialiser.field(minimum_access_column_);
+
+	// Programmer-visible state.
+	serialiser.field(status_);
+	serialiser.field(write_phase_);
+	serialiser.field(low_write_);
+	serialiser.field(mode1_enable_);
+	serialiser.field(mode2_enable_);
+	serialiser.field(mode3_enable_);
+	serialiser.field(blank_display_);
+	serialiser.field(sprites_16x16_);
+	serialiser.field(sprites_magnified_);
+	serialiser.field(generate_interrupts_);
+	serialiser.field(sprite_height_);
+	serialise_address(serialiser, pattern_name_address_);
+	serialise_address(serialiser, colour_table_address_);
+	serialise_address(serialiser, pattern_generator_table_address_);
+	serialise_address(serialiser, sprite_attribute_table_address_);
+	serialise_address(serialiser, sprite_generator_table_address_);
+	serialiser.field(text_colour_);
+	serialiser.field(background_colour_);
+	serialiser.field(screen_mode_);
+
+	// Timing.
+	serialiser.field(cycles_error_);
+	serialiser.field(latched_column_);
+	serialiser.field(mode_timing_.total_lines);
+	serialiser.field(mode_timing_.pixel_lines);
+	serialiser.field(mode_timing_.first_vsync_line);
+	serialiser.field(mode_timing_.maximum_visible_sprites);
+	serialiser.field(mode_timing_.end_of_frame_interrupt_position.column);
+	serialiser.field(mode_timing_.end_of_frame_interrupt_position.row);
+	serialiser.field(mode_timing_.line_interrupt_position);
+	serialiser.field(mode_timing_.allow_sprite_terminator);
+	serialiser.field(mode_timing_.sprite_terminator);
+	serialiser.field(line_interrupt_target);
+	serialiser.field(line_interrupt_counter);
+	serialiser.field(enable_line_interrupts_);
+	serialiser.field(line_interrupt_pending_);
+	serialiser.field(read_pointer_.row);
+	serialiser.field(read_pointer_.column);
+	serialiser.field(write_pointer_.row);
+	serialiser.field(write_pointer_.column);
+
+	if(!serialiser.is_capturing()) {
+		if(
+			mode_timing_.total_lines < 1 || mode_timing_.total_lines > 313 ||
+			read_pointer_.row < 0 || read_pointer_.row >= mode_timing_.total_lines ||
+			write_pointer_.row < 0 || write_pointer_.row >= mode_timing_.total_lines
+		) {
+			serialiser.set_invalid();
+		}
+	}
+
+	// Line buffers: only those currently being output and those being fetched or
+	// selected for are in flight; all others will be refilled before next use.
+	for(int offset = 0; offset < 3 && serialiser.is_valid(); ++offset) {
+		LineBuffer &buffer = line_buffers_[(write_pointer_.row + offset) % mode_timing_.total_lines];
+		serialiser.field(buffer.line_mode);
+		serialiser.field(buffer.latched_horizontal_scroll);
+		for(auto &name: buffer.names) {
+			serialise_address(serialiser, name.offset);
+			serialiser.field(name.flags);
+		}
+		serialiser.bytes(&buffer.patterns[0][0], sizeof(buffer.patterns));
+		serialiser.field(buffer.first_pixel_output_column);
+		serialiser.field(buffer.next_border_column);
+		for(auto &sprite: buffer.active_sprites) {
+			serialiser.field(sprite.index);
+			serialiser.field(sprite.row);
+			serialiser.field(sprite.x);
+			serialiser.field(sprite.image);
+			serialiser.field(sprite.shift_position);
+		}
+		serialiser.field(buffer.active_sprite_slot);
+		serialiser.field(buffer.sprites_stopped);
+	}
+
+	// Master System extensions.
+	serialiser.field(master_system_.vertical_scroll_lock);
+	serialiser.field(master_system_.horizontal_scroll_lock);
+	serialiser.field(master_system_.hide_left_column);
+	serialiser.field(master_system_.shift_sprites_8px_left);
+	serialiser.field(master_system_.mode4_enable);
+	serialiser.field(master_system_.horizontal_scroll);
+	serialiser.field(master_system_.vertical_scroll);
+	serialiser.field(master_system_.colour_ram);
+	serialiser.field(master_system_.cram_is_selected);
+	serialiser.field(master_system_.latched_vertical_scroll);
+	serialise_address(serialiser, master_system_.pattern_name_address);
+	serialise_address(serialiser, master_system_.sprite_attribute_table_address);
+	serialise_address(serialiser, master_system_.sprite_generator_table_address);
+
+	uint32_t cram_dot_count = static_cast<uint32_t>(upcoming_cram_dots_.size());
+	serialiser.field(cram_dot_count);
+	if(!serialiser.is_capturing() && serialiser.is_valid()) {
+		if(cram_dot_count > 1024) serialiser.set_invalid();
+		else upcoming_cram_dots_.resize(cram_dot_count);
+	}
+	for(auto &dot: upcoming_cram_dots_) {
+		serialiser.field(dot.location.row);
+		serialiser.field(dot.location.column);
+		serialiser.field(dot.value);
+	}
+
+	serialiser.end_section();
+}
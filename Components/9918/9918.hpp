@@ -88,6 +88,12 @@ class TMS9918: public Base {
 			@returns @c true if the interrupt line is currently active; @c false otherwise.
 		*/
 		bool get_interrupt_line();
+
+		/*!
+			Captures or restores the state of this VDP, including its video RAM. Output already
+			passed to the CRT is not included; the CRT will resynchronise after a restoration.
+		*/
+		void serialise(Storage::State::Serialiser &serialiser);
 };
 
 }
@@ -11,6 +11,7 @@
 
 #include "../../../Outputs/CRT/CRT.hpp"
 #include "../../../ClockReceiver/ClockReceiver.hpp"
+#include "../../../Storage/State/Serialiser.hpp"
 
 #include <cassert>
 #include <cstdint>
@@ -196,7 +197,8 @@ class Base {
 			Text,
 			Character,
 			Refresh,
-			SMS
+			SMS,
+			MultiColour		// Has the same timing as Character, but distinct pixel output.
 		};
 
 		// Temporary buffers collect a representation of this line prior to pixel serialisation.
@@ -409,6 +411,12 @@ class Base {
 			end is < 172, false otherwise. So functions can use it to eliminate should-exit-not checks,
 			for the more usual path of execution.
 
+		5)	they are also templated with a `use_external_slots` parameter. That will be false if no VRAM
+			access is pending at the start of the period. Accesses are queued only by the CPU, which can't
+			act while a fetch is ongoing, so in that case no external slot will have any effect and
+			functions can eliminate them entirely. Whole lines without CPU access are therefore just
+			a straight run of data fetches.
+
 	Provided for the benefit of the methods below:
 
 		* 	the function external_slot(), which will perform any pending VRAM read/write.
@@ -425,7 +433,7 @@ class Base {
 		case n
 
 #define external_slot(n)	\
-	slot(n): do_external_slot((n)*2);
+	slot(n): if(use_external_slots) do_external_slot((n)*2);
 
 #define external_slots_2(n)	\
 	external_slot(n);		\
@@ -452,7 +460,7 @@ class Base {
              TMS9918 Fetching Code
 ************************************************/
 
-		template<bool use_end> void fetch_tms_refresh(int start, int end) {
+		template<bool use_end, bool use_external_slots> void fetch_tms_refresh(int start, int end) {
 #define refresh(location)		\
 	slot(location):				\
 	external_slot(location+1);
@@ -496,7 +504,7 @@ class Base {
 #undef refresh
 		}
 
-		template<bool use_end> void fetch_tms_text(int start, int end) {
+		template<bool use_end, bool use_external_slots> void fetch_tms_text(int start, int end) {
 #define fetch_tile_name(location, column)		slot(location): line_buffer.names[column].offset = ram_[row_base + column];
 #define fetch_tile_pattern(location, column)	slot(location): line_buffer.patterns[column][0] = ram_[row_offset + size_t(line_buffer.names[column].offset << 3)];
 
@@ -553,7 +561,7 @@ class Base {
 #undef fetch_tile_name
 		}
 
-		template<bool use_end> void fetch_tms_character(int start, int end) {
+		template<bool use_end, bool use_external_slots> void fetch_tms_character(int start, int end) {
 #define sprite_fetch_coordinates(location, sprite)	\
 	slot(location):		\
 	slot(location+1):	\
@@ -657,7 +665,7 @@ class Base {
 
 				slot(31):
 					sprite_selection_buffer.reset_sprite_collection();
-					do_external_slot(31*2);
+					if(use_external_slots) do_external_slot(31*2);
 				external_slots_2(32);
 				external_slot(34);
 
@@ -696,7 +704,7 @@ class Base {
           Master System Fetching Code
 ************************************************/
 
-		template<bool use_end> void fetch_sms(int start, int end) {
+		template<bool use_end, bool use_external_slots> void fetch_sms(int start, int end) {
 #define sprite_fetch(sprite)	{\
 		line_buffer.active_sprites[sprite].x = \
 			ram_[\
@@ -809,7 +817,7 @@ class Base {
 
 				slot(29):
 					sprite_selection_buffer.reset_sprite_collection();
-					do_external_slot(29*2);
+					if(use_external_slots) do_external_slot(29*2);
 				external_slot(30);
 
 				sprite_y_read(31, 0);
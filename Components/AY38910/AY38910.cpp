@@ -8,7 +8,9 @@
 
 #include "AY38910.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 using namespace GI::AY38910;
 
@@ -70,15 +72,73 @@ void AY38910::set_sample_volume_range(std::int16_t range) {
 	evaluate_output_volume();
 }
 
+void AY38910::set_output_channels(::Outputs::Speaker::Channels channels) {
+	switch(channels) {
+		case ::Outputs::Speaker::Channels::Mono:		channel_count_ = 1;	break;
+		case ::Outputs::Speaker::Channels::Stereo:		channel_count_ = 2;	break;
+		case ::Outputs::Speaker::Channels::Separate:	channel_count_ = 3;	break;
+	}
+	evaluate_output_volume();
+}
+
+std::size_t AY38910::get_channel_count() {
+	return channel_count_;
+}
+
+void AY38910::set_output_mixing(float a_left, float b_left, float c_left, float a_right, float b_right, float c_right) {
+	task_queue_.defer([=] {
+		mixing_levels_[0][0] = static_cast<int>(a_left * 256.0f);
+		mixing_levels_[0][1] = static_cast<int>(b_left * 256.0f);
+		mixing_levels_[0][2] = static_cast<int>(c_left * 256.0f);
+		mixing_levels_[1][0] = static_cast<int>(a_right * 256.0f);
+		mixing_levels_[1][1] = static_cast<int>(b_right * 256.0f);
+		mixing_levels_[1][2] = static_cast<int>(c_right * 256.0f);
+		evaluate_output_volume();
+	});
+}
+
 void AY38910::get_samples(std::size_t number_of_samples, int16_t *target) {
+	advance<true>(number_of_samples, target);
+}
+
+void AY38910::skip_samples(std::size_t number_of_samples) {
+	advance<false>(number_of_samples, nullptr);
+}
+
+std::size_t AY38910::get_constant_samples(int16_t *level) {
+	// Output will be constant for the remainder of the current tick, if one is underway, and for as many
+	// further ticks as are quiet.
+	const std::size_t quiet_ticks = static_cast<std::size_t>(get_quiet_ticks());
+	const std::size_t remainder = (master_divider_&7) ? static_cast<std::size_t>(8 - (master_divider_&7)) : 0;
+	std::copy(output_volume_, output_volume_ + channel_count_, level);
+	return (quiet_ticks << 3) + remainder;
+}
+
+template <bool produce_output> void AY38910::advance(std::size_t number_of_samples, int16_t *target) {
+	// Complete the current tick, if one is underway.
 	std::size_t c = 0;
-	while((master_divider_&7) && c < number_of_samples) {
-		target[c] = output_volume_;
-		master_divider_++;
-		c++;
+	if(master_divider_&7) {
+		c = std::min(number_of_samples, static_cast<std::size_t>(8 - (master_divider_&7)));
+		if(produce_output) write_samples(target, c);
+		master_divider_ += static_cast<int>(c);
 	}
 
 	while(c < number_of_samples) {
+		// If the output can't change for a while, skip straight to the next tick at which it might,
+		// filling in the interim with the current output.
+		const std::size_t quiet_ticks = std::min(
+			static_cast<std::size_t>(get_quiet_ticks()),
+			(number_of_samples - c + 7) >> 3);
+		if(quiet_ticks) {
+			skip_ticks(static_cast<int>(quiet_ticks));
+
+			const std::size_t samples = std::min(quiet_ticks << 3, number_of_samples - c);
+			if(produce_output) write_samples(&target[c * channel_count_], samples);
+			c += samples;
+			master_divider_ += static_cast<int>(samples);
+			continue;
+		}
+
 #define step_channel(c) \
 	if(tone_counters_[c]) tone_counters_[c]--;\
 	else {\
@@ -93,37 +153,122 @@ void AY38910::get_samples(std::size_t number_of_samples, int16_t *target) {
 
 #undef step_channel
 
-		// ... the noise generator. This recomputes the new bit repeatedly but harmlessly, only shifting
-		// it into the official 17 upon divider underflow.
+		// ... the noise generator ...
 		if(noise_counter_) noise_counter_--;
 		else {
 			noise_counter_ = noise_period_;
-			noise_output_ ^= noise_shift_register_&1;
-			noise_shift_register_ |= ((noise_shift_register_ ^ (noise_shift_register_ >> 3))&1) << 17;
-			noise_shift_register_ >>= 1;
+			step_noise();
 		}
 
-		// ... and the envelope generator. Table based for pattern lookup, with a 'refill' step: a way of
-		// implementing non-repeating patterns by locking them to table position 0x1f.
+		// ... and the envelope generator.
 		if(envelope_divider_) envelope_divider_--;
 		else {
 			envelope_divider_ = envelope_period_;
-			envelope_position_ ++;
-			if(envelope_position_ == 32) envelope_position_ = envelope_overflow_masks_[output_registers_[13]];
+			step_envelope();
 		}
 
 		evaluate_output_volume();
 
-		for(int ic = 0; ic < 8 && c < number_of_samples; ic++) {
-			target[c] = output_volume_;
-			c++;
-			master_divider_++;
-		}
+		const std::size_t samples = std::min(static_cast<std::size_t>(8), number_of_samples - c);
+		if(produce_output) write_samples(&target[c * channel_count_], samples);
+		c += samples;
+		master_divider_ += static_cast<int>(samples);
 	}
 
 	master_divider_ &= 7;
 }
 
+void AY38910::write_samples(int16_t *target, std::size_t number_of_samples) {
+	switch(channel_count_) {
+		default:
+			std::fill_n(target, number_of_samples, output_volume_[0]);
+		break;
+		case 2:
+			while(number_of_samples--) {
+				target[0] = output_volume_[0];
+				target[1] = output_volume_[1];
+				target += 2;
+			}
+		break;
+		case 3:
+			while(number_of_samples--) {
+				target[0] = output_volume_[0];
+				target[1] = output_volume_[1];
+				target[2] = output_volume_[2];
+				target += 3;
+			}
+		break;
+	}
+}
+
+void AY38910::step_noise() {
+	// This recomputes the new bit repeatedly but harmlessly, only shifting it into the official 17 upon divider underflow.
+	noise_output_ ^= noise_shift_register_&1;
+	noise_shift_register_ |= ((noise_shift_register_ ^ (noise_shift_register_ >> 3))&1) << 17;
+	noise_shift_register_ >>= 1;
+}
+
+void AY38910::step_envelope() {
+	// Table based for pattern lookup, with a 'refill' step: a way of implementing non-repeating patterns
+	// by locking them to table position 0x1f.
+	envelope_position_ ++;
+	if(envelope_position_ == 32) envelope_position_ = envelope_overflow_masks_[output_registers_[13]];
+}
+
+int AY38910::get_quiet_ticks() {
+	if(!skips_quiet_ticks_) return 0;
+
+	// A divider that currently holds n will underflow, and possibly change the output, on the (n+1)th tick from now.
+	// So the output is certain to stay the same for the minimum n of all dividers that currently affect it: those
+	// belonging to channels that are enabled and not at a fixed volume of zero, and the envelope if any channel is using it.
+	int quiet_ticks = std::numeric_limits<int>::max();
+	for(int channel = 0; channel < 3; ++channel) {
+		const int volume = output_registers_[8 + channel];
+		if(!(volume & 0x10)) {
+			if(!volumes_[volume & 0xf]) continue;
+		} else {
+			quiet_ticks = std::min(quiet_ticks, envelope_divider_);
+		}
+
+		if(!(output_registers_[7] & (1 << channel))) quiet_ticks = std::min(quiet_ticks, tone_counters_[channel]);
+		if(!(output_registers_[7] & (8 << channel))) quiet_ticks = std::min(quiet_ticks, noise_counter_);
+	}
+	return quiet_ticks;
+}
+
+void AY38910::skip_ticks(int ticks) {
+	// Tone channels just toggle, so can be advanced directly: the first toggle is (counter+1) ticks away,
+	// with another every (period+1) ticks thereafter.
+	for(int channel = 0; channel < 3; ++channel) {
+		if(ticks <= tone_counters_[channel]) {
+			tone_counters_[channel] -= ticks;
+		} else {
+			const int elapsed = ticks - tone_counters_[channel] - 1;
+			const int period = tone_periods_[channel] + 1;
+			tone_outputs_[channel] ^= (1 + elapsed / period) & 1;
+			tone_counters_[channel] = tone_periods_[channel] - elapsed % period;
+		}
+	}
+
+	// The noise and envelope generators are stepped once per underflow, which happens only when
+	// they are not currently affecting the output.
+	int noise_ticks = ticks;
+	while(noise_ticks > noise_counter_) {
+		noise_ticks -= noise_counter_ + 1;
+		noise_counter_ = noise_period_;
+		step_noise();
+	}
+	noise_counter_ -= noise_ticks;
+
+	int envelope_ticks = ticks;
+	while(envelope_ticks > envelope_divider_) {
+		envelope_ticks -= envelope_divider_ + 1;
+		envelope_divider_ = envelope_period_;
+		step_envelope();
+	}
+	envelope_divider_ -= envelope_ticks;
+}
+
 void AY38910::evaluate_output_volume() {
 	int envelope_volume = envelope_shapes_[output_registers_[13]][envelope_position_];
 
@@ -153,12 +298,35 @@ void AY38910::evaluate_output_volume() {
 	};
 #undef channel_volume
 
-	// Mix additively.
-	output_volume_ = static_cast<int16_t>(
-		volumes_[volumes[0]] * channel_levels[0] +
-		volumes_[volumes[1]] * channel_levels[1] +
+	const int channel_volumes[3] = {
+		volumes_[volumes[0]] * channel_levels[0],
+		volumes_[volumes[1]] * channel_levels[1],
 		volumes_[volumes[2]] * channel_levels[2]
-	);
+	};
+
+	switch(channel_count_) {
+		default:
+			// Mix additively.
+			output_volume_[0] = static_cast<int16_t>(channel_volumes[0] + channel_volumes[1] + channel_volumes[2]);
+		break;
+
+		case 2:
+			// Mix additively, according to the stereo mixing levels.
+			for(int side = 0; side < 2; ++side) {
+				output_volume_[side] = static_cast<int16_t>((
+					channel_volumes[0] * mixing_levels_[side][0] +
+					channel_volumes[1] * mixing_levels_[side][1] +
+					channel_volumes[2] * mixing_levels_[side][2]
+				) >> 8);
+			}
+		break;
+
+		case 3:
+			output_volume_[0] = static_cast<int16_t>(channel_volumes[0]);
+			output_volume_[1] = static_cast<int16_t>(channel_volumes[1]);
+			output_volume_[2] = static_cast<int16_t>(channel_volumes[2]);
+		break;
+	}
 }
 
 bool AY38910::is_zero_level() {
@@ -286,3 +454,37 @@ void AY38910::update_bus() {
 		case Read:			data_output_ = get_register_value();	break;
 	}
 }
+
+// MARK: - State
+
+void AY38910::serialise(Storage::State::Serialiser &serialiser) {
+	serialiser.begin_section("AY  ", 1);
+
+	serialiser.field(selected_register_);
+	serialiser.field(registers_);
+	serialiser.field(output_registers_);
+	serialiser.field(control_state_);
+	serialiser.field(data_input_);
+	serialiser.field(data_output_);
+
+	serialiser.field(master_divider_);
+	serialiser.field(tone_periods_);
+	serialiser.field(tone_counters_);
+	serialiser.field(tone_outputs_);
+	serialiser.field(noise_period_);
+	serialiser.field(noise_counter_);
+	serialiser.field(noise_shift_register_);
+	serialiser.field(noise_output_);
+	serialiser.field(envelope_period_);
+	serialiser.field(envelope_divider_);
+	serialiser.field(envelope_position_);
+
+	serialiser.end_section();
+
+	if(!serialiser.is_capturing()) {
+		// Ensure table lookups remain in bounds, whatever was stored.
+		output_registers_[13] &= 0xf;
+		envelope_position_ &= 0x1f;
+		evaluate_output_volume();
+	}
+}
@@ -11,6 +11,7 @@
 
 #include "../../Outputs/Speaker/Implementation/SampleSource.hpp"
 #include "../../Concurrency/AsyncTaskQueue.hpp"
+#include "../../Storage/State/Serialiser.hpp"
 
 namespace GI {
 namespace AY38910 {
@@ -83,11 +84,38 @@ class AY38910: public ::Outputs::Speaker::SampleSource {
 		*/
 		void set_port_handler(PortHandler *);
 
+		/*!
+			Sets the stereo placement of each channel, as the proportion of its volume that is output on the
+			left and on the right; this has an effect only if stereo output is requested. By default each
+			channel is output at full volume on both sides, so that stereo output duplicates mono.
+		*/
+		void set_output_mixing(float a_left, float b_left, float c_left, float a_right, float b_right, float c_right);
+
+		/*!
+			Captures or restores the state of this AY. The owner should ensure that the task queue
+			supplied at construction has been flushed, and has no work deferred, before calling.
+		*/
+		void serialise(Storage::State::Serialiser &serialiser);
+
+		/*!
+			Sets whether spans of ticks in which the output can't change are skipped, as they are by default, or
+			every tick is stepped individually. Output is identical either way; this allows the two to be compared.
+		*/
+		void set_skips_quiet_ticks(bool skips_quiet_ticks) {
+			skips_quiet_ticks_ = skips_quiet_ticks;
+		}
+
 		// to satisfy ::Outputs::Speaker (included via ::Outputs::Filter; not for public consumption
 		void get_samples(std::size_t number_of_samples, int16_t *target);
+		void skip_samples(std::size_t number_of_samples);
 		bool is_zero_level();
+		std::size_t get_constant_samples(int16_t *level);
 		void set_sample_volume_range(std::int16_t range);
 
+		// If separate channels are requested, the three tone channels are output in order A, B, C.
+		void set_output_channels(::Outputs::Speaker::Channels channels);
+		std::size_t get_channel_count();
+
 	private:
 		Concurrency::DeferringAsyncTaskQueue &task_queue_;
 
@@ -127,8 +155,24 @@ class AY38910: public ::Outputs::Speaker::SampleSource {
 
 		uint8_t data_input_, data_output_;
 
-		int16_t output_volume_;
+		// Output is one, two or three values per sample, depending on the channels requested.
+		std::size_t channel_count_ = 1;
+		int16_t output_volume_[3] = {0, 0, 0};
 		inline void evaluate_output_volume();
+		inline void write_samples(int16_t *target, std::size_t number_of_samples);
+
+		// Stereo mixing levels, out of 256, for each channel on each side.
+		int mixing_levels_[2][3] = {{256, 256, 256}, {256, 256, 256}};
+
+		/// Advances by @c number_of_samples, writing them to @c target if @c produce_output is @c true.
+		template <bool produce_output> void advance(std::size_t number_of_samples, int16_t *target);
+
+		inline void step_noise();
+		inline void step_envelope();
+
+		bool skips_quiet_ticks_ = true;
+		inline int get_quiet_ticks();
+		void skip_ticks(int ticks);
 
 		inline void update_bus();
 		PortHandler *port_handler_ = nullptr;
@@ -8,15 +8,16 @@
 
 #include "AudioToggle.hpp"
 
+#include <algorithm>
+#include <limits>
+
 using namespace Audio;
 
 Audio::Toggle::Toggle(Concurrency::DeferringAsyncTaskQueue &audio_queue) :
 	audio_queue_(audio_queue) {}
 
 void Toggle::get_samples(std::size_t number_of_samples, std::int16_t *target) {
-	for(std::size_t sample = 0; sample < number_of_samples; ++sample) {
-		target[sample] = level_;
-	}
+	std::fill_n(target, number_of_samples, level_);
 }
 
 void Toggle::set_sample_volume_range(std::int16_t range) {
@@ -25,6 +26,12 @@ void Toggle::set_sample_volume_range(std::int16_t range) {
 
 void Toggle::skip_samples(const std::size_t number_of_samples) {}
 
+std::size_t Toggle::get_constant_samples(std::int16_t *level) {
+	// The level changes only upon a call to set_output.
+	*level = level_;
+	return std::numeric_limits<std::size_t>::max();
+}
+
 void Toggle::set_output(bool enabled) {
 	if(is_enabled_ == enabled) return;
 	is_enabled_ = enabled;
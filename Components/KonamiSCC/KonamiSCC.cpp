@@ -8,7 +8,9 @@
 
 #include "KonamiSCC.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
 
 using namespace Konami;
 
@@ -25,14 +27,52 @@ void SCC::get_samples(std::size_t number_of_samples, std::int16_t *target) {
 		return;
 	}
 
+	advance<true>(number_of_samples, target);
+}
+
+void SCC::skip_samples(std::size_t number_of_samples) {
+	// As per get_samples, time doesn't advance while all channels are disabled.
+	if(is_zero_level()) return;
+	advance<false>(number_of_samples, nullptr);
+}
+
+std::size_t SCC::get_constant_samples(std::int16_t *level) {
+	if(is_zero_level()) {
+		*level = 0;
+		return std::numeric_limits<std::size_t>::max();
+	}
+
+	// Otherwise output will be constant for the remainder of the current tick, if one is underway,
+	// and for as many further ticks as are quiet.
+	*level = transient_output_level_;
+	const std::size_t remainder = (master_divider_&7) ? static_cast<std::size_t>(8 - (master_divider_&7)) : 0;
+	return (static_cast<std::size_t>(get_quiet_ticks()) << 3) + remainder;
+}
+
+template <bool produce_output> void SCC::advance(std::size_t number_of_samples, std::int16_t *target) {
 	std::size_t c = 0;
-	while((master_divider_&7) && c < number_of_samples) {
-		target[c] = transient_output_level_;
-		master_divider_++;
-		c++;
+	if(master_divider_&7) {
+		c = std::min(number_of_samples, static_cast<std::size_t>(8 - (master_divider_&7)));
+		if(produce_output) std::fill_n(target, c, transient_output_level_);
+		master_divider_ += static_cast<int>(c);
 	}
 
 	while(c < number_of_samples) {
+		// If the output can't change for a while, skip straight to the next tick at which it might,
+		// filling in the interim with the current output.
+		const std::size_t quiet_ticks = std::min(
+			static_cast<std::size_t>(get_quiet_ticks()),
+			(number_of_samples - c + 7) >> 3);
+		if(quiet_ticks) {
+			skip_ticks(static_cast<int>(quiet_ticks));
+
+			const std::size_t samples = std::min(quiet_ticks << 3, number_of_samples - c);
+			if(produce_output) std::fill_n(&target[c], samples, transient_output_level_);
+			c += samples;
+			master_divider_ += static_cast<int>(samples);
+			continue;
+		}
+
 		for(int channel = 0; channel < 5; ++channel) {
 			if(channels_[channel].tone_counter) channels_[channel].tone_counter--;
 			else {
@@ -43,10 +83,40 @@ void SCC::get_samples(std::size_t number_of_samples, std::int16_t *target) {
 
 		evaluate_output_volume();
 
-		for(int ic = 0; ic < 8 && c < number_of_samples; ++ic) {
-			target[c] = transient_output_level_;
-			c++;
-			master_divider_++;
+		const std::size_t samples = std::min(static_cast<std::size_t>(8), number_of_samples - c);
+		if(produce_output) std::fill_n(&target[c], samples, transient_output_level_);
+		c += samples;
+		master_divider_ += static_cast<int>(samples);
+	}
+
+	master_divider_ &= 7;
+}
+
+int SCC::get_quiet_ticks() {
+	if(!skips_quiet_ticks_) return 0;
+
+	// A counter that currently holds n will underflow, and change the output, on the (n+1)th tick
+	// from now; only enabled channels with a non-zero amplitude need be considered.
+	int quiet_ticks = std::numeric_limits<int>::max();
+	for(int channel = 0; channel < 5; ++channel) {
+		if((channel_enable_ & (1 << channel)) && channels_[channel].amplitude) {
+			quiet_ticks = std::min(quiet_ticks, channels_[channel].tone_counter);
+		}
+	}
+	return quiet_ticks;
+}
+
+void SCC::skip_ticks(int ticks) {
+	// Each channel advances its offset once per underflow, the first being (counter+1) ticks away,
+	// with another every (period+1) ticks thereafter.
+	for(int channel = 0; channel < 5; ++channel) {
+		if(ticks <= channels_[channel].tone_counter) {
+			channels_[channel].tone_counter -= ticks;
+		} else {
+			const int elapsed = ticks - channels_[channel].tone_counter - 1;
+			const int period = channels_[channel].period + 1;
+			channels_[channel].offset = (channels_[channel].offset + 1 + elapsed / period) & 0x1f;
+			channels_[channel].tone_counter = channels_[channel].period - elapsed % period;
 		}
 	}
 }
@@ -29,8 +29,12 @@ class SCC: public ::Outputs::Speaker::SampleSource {
 		/// As per ::SampleSource; provides a broadphase test for silence.
 		bool is_zero_level();
 
+		/// As per ::SampleSource; provides a broadphase test for constant output.
+		std::size_t get_constant_samples(std::int16_t *level);
+
 		/// As per ::SampleSource; provides audio output.
 		void get_samples(std::size_t number_of_samples, std::int16_t *target);
+		void skip_samples(std::size_t number_of_samples);
 		void set_sample_volume_range(std::int16_t range);
 
 		/// Writes to the SCC.
@@ -39,6 +43,14 @@ class SCC: public ::Outputs::Speaker::SampleSource {
 		/// Reads from the SCC.
 		uint8_t read(uint16_t address);
 
+		/*!
+			Sets whether spans of ticks in which the output can't change are skipped, as they are by default, or
+			every tick is stepped individually. Output is identical either way; this allows the two to be compared.
+		*/
+		void set_skips_quiet_ticks(bool skips_quiet_ticks) {
+			skips_quiet_ticks_ = skips_quiet_ticks;
+		}
+
 	private:
 		Concurrency::DeferringAsyncTaskQueue &task_queue_;
 
@@ -56,7 +68,7 @@ class SCC: public ::Outputs::Speaker::SampleSource {
 		} channels_[5];
 
 		struct Wavetable {
-			std::uint8_t samples[32];
+			std::uint8_t samples[32] = {};
 		} waves_[4];
 
 		std::uint8_t channel_enable_ = 0;
@@ -64,9 +76,16 @@ class SCC: public ::Outputs::Speaker::SampleSource {
 
 		void evaluate_output_volume();
 
+		/// Advances by @c number_of_samples, writing them to @c target if @c produce_output is @c true.
+		template <bool produce_output> void advance(std::size_t number_of_samples, std::int16_t *target);
+
+		bool skips_quiet_ticks_ = true;
+		inline int get_quiet_ticks();
+		void skip_ticks(int ticks);
+
 		// This keeps a copy of wave memory that is accessed from the
 		// main emulation thread.
-		std::uint8_t ram_[128];
+		std::uint8_t ram_[128] = {};
 };
 
 }
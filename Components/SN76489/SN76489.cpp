@@ -8,8 +8,10 @@
 
 #include "SN76489.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <limits>
 
 using namespace TI;
 
@@ -90,24 +92,86 @@ bool SN76489::is_zero_level() {
 	return channels_[0].volume == 0xf && channels_[1].volume == 0xf && channels_[2].volume == 0xf && channels_[3].volume == 0xf;
 }
 
+void SN76489::set_output_channels(Outputs::Speaker::Channels channels) {
+	channel_count_ = (channels == Outputs::Speaker::Channels::Separate) ? 4 : 1;
+	evaluate_output_volume();
+}
+
+std::size_t SN76489::get_channel_count() {
+	return channel_count_;
+}
+
 void SN76489::evaluate_output_volume() {
-	output_volume_ = static_cast<int16_t>(
-		channels_[0].level * volumes_[channels_[0].volume] +
-		channels_[1].level * volumes_[channels_[1].volume] +
-		channels_[2].level * volumes_[channels_[2].volume] +
-		channels_[3].level * volumes_[channels_[3].volume]
-	);
+	if(channel_count_ == 1) {
+		output_volume_[0] = static_cast<int16_t>(
+			channels_[0].level * volumes_[channels_[0].volume] +
+			channels_[1].level * volumes_[channels_[1].volume] +
+			channels_[2].level * volumes_[channels_[2].volume] +
+			channels_[3].level * volumes_[channels_[3].volume]
+		);
+	} else {
+		for(int c = 0; c < 4; ++c) {
+			output_volume_[c] = static_cast<int16_t>(channels_[c].level * volumes_[channels_[c].volume]);
+		}
+	}
+}
+
+void SN76489::write_samples(std::int16_t *target, std::size_t number_of_samples) {
+	if(channel_count_ == 1) {
+		std::fill_n(target, number_of_samples, output_volume_[0]);
+	} else {
+		while(number_of_samples--) {
+			std::copy(output_volume_, output_volume_ + 4, target);
+			target += 4;
+		}
+	}
 }
 
 void SN76489::get_samples(std::size_t number_of_samples, std::int16_t *target) {
+	advance<true>(number_of_samples, target);
+}
+
+void SN76489::skip_samples(std::size_t number_of_samples) {
+	advance<false>(number_of_samples, nullptr);
+}
+
+std::size_t SN76489::get_constant_samples(std::int16_t *level) {
+	// Output will be constant for the remainder of the current tick, if one is underway, and for as many
+	// further ticks as are quiet.
+	const std::size_t period = static_cast<std::size_t>(master_divider_period_);
+	const int phase = master_divider_ & (master_divider_period_ - 1);
+	const std::size_t remainder = phase ? static_cast<std::size_t>(master_divider_period_ - phase) : 0;
+	std::copy(output_volume_, output_volume_ + channel_count_, level);
+	return static_cast<std::size_t>(get_quiet_ticks()) * period + remainder;
+}
+
+template <bool produce_output> void SN76489::advance(std::size_t number_of_samples, std::int16_t *target) {
+	// Complete the current tick, if one is underway.
 	std::size_t c = 0;
-	while((master_divider_& (master_divider_period_ - 1)) && c < number_of_samples) {
-		target[c] = output_volume_;
-		master_divider_++;
-		c++;
+	const int phase = master_divider_ & (master_divider_period_ - 1);
+	if(phase) {
+		c = std::min(number_of_samples, static_cast<std::size_t>(master_divider_period_ - phase));
+		if(produce_output) write_samples(target, c);
+		master_divider_ += static_cast<int>(c);
 	}
 
 	while(c < number_of_samples) {
+		// If the output can't change for a while, skip straight to the next tick at which it might,
+		// filling in the interim with the current output.
+		const std::size_t period = static_cast<std::size_t>(master_divider_period_);
+		const std::size_t quiet_ticks = std::min(
+			static_cast<std::size_t>(get_quiet_ticks()),
+			(number_of_samples - c + period - 1) / period);
+		if(quiet_ticks) {
+			skip_ticks(static_cast<int>(quiet_ticks));
+
+			const std::size_t samples = std::min(quiet_ticks * period, number_of_samples - c);
+			if(produce_output) write_samples(&target[c * channel_count_], samples);
+			c += samples;
+			master_divider_ += static_cast<int>(samples);
+			continue;
+		}
+
 		bool did_flip = false;
 
 #define step_channel(x, s) \
@@ -132,30 +196,118 @@ void SN76489::get_samples(std::size_t number_of_samples, std::int16_t *target) {
 			}
 		}
 
-		if(did_flip) {
-			channels_[3].level = noise_shifter_ & 1;
-			int new_bit = channels_[3].level;
-			switch(noise_mode_) {
-				default: break;
-				case Noise15:
-					new_bit ^= (noise_shifter_ >> 1);
-				break;
-				case Noise16:
-					new_bit ^= (noise_shifter_ >> 3);
-				break;
-			}
-			noise_shifter_ >>= 1;
-			noise_shifter_ |= (new_bit & 1) << (shifter_is_16bit_ ? 15 : 14);
-		}
+		if(did_flip) step_noise();
 
 		evaluate_output_volume();
 
-		for(int ic = 0; ic < master_divider_period_ && c < number_of_samples; ++ic) {
-			target[c] = output_volume_;
-			c++;
-			master_divider_++;
-		}
+		const std::size_t samples = std::min(period, number_of_samples - c);
+		if(produce_output) write_samples(&target[c * channel_count_], samples);
+		c += samples;
+		master_divider_ += static_cast<int>(samples);
 	}
 
 	master_divider_ &= (master_divider_period_ - 1);
 }
+
+void SN76489::step_noise() {
+	channels_[3].level = noise_shifter_ & 1;
+	int new_bit = channels_[3].level;
+	switch(noise_mode_) {
+		default: break;
+		case Noise15:
+			new_bit ^= (noise_shifter_ >> 1);
+		break;
+		case Noise16:
+			new_bit ^= (noise_shifter_ >> 3);
+		break;
+	}
+	noise_shifter_ >>= 1;
+	noise_shifter_ |= (new_bit & 1) << (shifter_is_16bit_ ? 15 : 14);
+}
+
+int SN76489::get_quiet_ticks() {
+	if(!skips_quiet_ticks_) return 0;
+
+	// A counter that currently holds n will underflow, and possibly change the output, on the (n+1)th tick from now.
+	// So the output is certain to stay the same for the minimum n of all counters belonging to audible channels;
+	// the noise channel is shifted by both its own counter, if in use, and by channel 2.
+	int quiet_ticks = std::numeric_limits<int>::max();
+	for(int channel = 0; channel < 3; ++channel) {
+		if(volumes_[channels_[channel].volume]) quiet_ticks = std::min(quiet_ticks, int(channels_[channel].counter));
+	}
+	if(volumes_[channels_[3].volume]) {
+		quiet_ticks = std::min(quiet_ticks, int(channels_[2].counter));
+		if(channels_[3].divider != 0xffff) quiet_ticks = std::min(quiet_ticks, int(channels_[3].counter));
+	}
+	return quiet_ticks;
+}
+
+void SN76489::skip_ticks(int ticks) {
+	// Channels 0 and 1 just toggle, so can be advanced directly: the first toggle is (counter+1) ticks away,
+	// with another every (divider+1) ticks thereafter.
+	for(int channel = 0; channel < 2; ++channel) {
+		if(ticks <= channels_[channel].counter) {
+			channels_[channel].counter -= ticks;
+		} else {
+			const int elapsed = ticks - channels_[channel].counter - 1;
+			const int period = channels_[channel].divider + 1;
+			channels_[channel].level ^= (1 + elapsed / period) & 1;
+			channels_[channel].counter = static_cast<uint16_t>(channels_[channel].divider - elapsed % period);
+		}
+	}
+
+	// Channel 2 also shifts the noise generator whenever it flips, so it and the noise channel are advanced
+	// from one underflow of either to the next; the noise channel will be inaudible if there are any.
+	const bool noise_has_counter = channels_[3].divider != 0xffff;
+	while(true) {
+		int next_flip = channels_[2].counter;
+		if(noise_has_counter) next_flip = std::min(next_flip, int(channels_[3].counter));
+
+		if(ticks <= next_flip) {
+			channels_[2].counter -= ticks;
+			if(noise_has_counter) channels_[3].counter -= ticks;
+			break;
+		}
+
+		channels_[2].counter -= next_flip;
+		if(noise_has_counter) channels_[3].counter -= next_flip;
+		ticks -= next_flip + 1;
+
+		if(!channels_[2].counter) {
+			channels_[2].level ^= 1;
+			channels_[2].counter = channels_[2].divider;
+		} else {
+			channels_[2].counter--;
+		}
+		if(noise_has_counter) {
+			if(!channels_[3].counter) {
+				channels_[3].counter = channels_[3].divider;
+			} else {
+				channels_[3].counter--;
+			}
+		}
+		step_noise();
+	}
+}
+
+void SN76489::serialise(Storage::State::Serialiser &serialiser) {
+	serialiser.begin_section("SN76", 1);
+
+	serialiser.field(master_divider_);
+	for(auto &channel: channels_) {
+		serialiser.field(channel.divider);
+		serialiser.field(channel.volume);
+		serialiser.field(channel.counter);
+		serialiser.field(channel.level);
+	}
+	serialiser.field(noise_mode_);
+	serialiser.field(noise_shifter_);
+	serialiser.field(active_register_);
+
+	serialiser.end_section();
+
+	if(!serialiser.is_capturing()) {
+		for(auto &channel: channels_) channel.volume &= 0xf;
+		evaluate_output_volume();
+	}
+}
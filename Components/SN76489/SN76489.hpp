@@ -11,6 +11,7 @@
 
 #include "../../Outputs/Speaker/Implementation/SampleSource.hpp"
 #include "../../Concurrency/AsyncTaskQueue.hpp"
+#include "../../Storage/State/Serialiser.hpp"
 
 namespace TI {
 
@@ -28,16 +29,37 @@ class SN76489: public Outputs::Speaker::SampleSource {
 		/// Writes a new value to the SN76489.
 		void set_register(uint8_t value);
 
-		// As per SampleSource.
+		/*!
+			Captures or restores the state of this SN76489. The owner should ensure that the task queue
+			supplied at construction has been flushed, and has no work deferred, before calling.
+		*/
+		void serialise(Storage::State::Serialiser &serialiser);
+
+		/*!
+			Sets whether spans of ticks in which the output can't change are skipped, as they are by default, or
+			every tick is stepped individually. Output is identical either way; this allows the two to be compared.
+		*/
+		void set_skips_quiet_ticks(bool skips_quiet_ticks) {
+			skips_quiet_ticks_ = skips_quiet_ticks;
+		}
+
+		// As per SampleSource. If separate channels are requested, the three tone channels are output in order, followed by noise.
 		void get_samples(std::size_t number_of_samples, std::int16_t *target);
+		void skip_samples(std::size_t number_of_samples);
 		bool is_zero_level();
+		std::size_t get_constant_samples(std::int16_t *level);
 		void set_sample_volume_range(std::int16_t range);
+		void set_output_channels(Outputs::Speaker::Channels channels);
+		std::size_t get_channel_count();
 
 	private:
 		int master_divider_ = 0;
 		int master_divider_period_ = 16;
-		int16_t output_volume_ = 0;
+		// Output is either one value per sample, or one per channel if separate channels have been requested.
+		std::size_t channel_count_ = 1;
+		int16_t output_volume_[4] = {0, 0, 0, 0};
 		void evaluate_output_volume();
+		inline void write_samples(std::int16_t *target, std::size_t number_of_samples);
 		int volumes_[16];
 
 		Concurrency::DeferringAsyncTaskQueue &task_queue_;
@@ -61,6 +83,15 @@ class SN76489: public Outputs::Speaker::SampleSource {
 		int active_register_ = 0;
 
 		bool shifter_is_16bit_ = false;
+
+		/// Advances by @c number_of_samples, writing them to @c target if @c produce_output is @c true.
+		template <bool produce_output> void advance(std::size_t number_of_samples, std::int16_t *target);
+
+		inline void step_noise();
+
+		bool skips_quiet_ticks_ = true;
+		inline int get_quiet_ticks();
+		void skip_ticks(int ticks);
 };
 
 }
@@ -41,6 +41,7 @@ std::vector<std::unique_ptr<Configurable::Option>> Configurable::standard_option
 		options.emplace_back(new Configurable::ListOption("Display", "display", display_options));
 	}
 	if(mask & AutomaticTapeMotorControl)	options.emplace_back(new Configurable::BooleanOption("Automatic Tape Motor Control", "autotapemotor"));
+	if(mask & Stereo)						options.emplace_back(new Configurable::ListOption("Stereo Layout", "stereo", {"mono", "abc", "acb"}));
 	return options;
 }
 
@@ -64,6 +65,17 @@ void Configurable::append_display_selection(Configurable::SelectionSet &selectio
 	selection_set["display"] = std::unique_ptr<Configurable::Selection>(new Configurable::ListSelection(string_selection));
 }
 
+void Configurable::append_stereo_layout_selection(SelectionSet &selection_set, StereoLayout selection) {
+	std::string string_selection;
+	switch(selection) {
+		default:
+		case StereoLayout::Mono:	string_selection = "mono";	break;
+		case StereoLayout::ABC:		string_selection = "abc";	break;
+		case StereoLayout::ACB:		string_selection = "acb";	break;
+	}
+	selection_set["stereo"] = std::unique_ptr<Configurable::Selection>(new Configurable::ListSelection(string_selection));
+}
+
 // MARK: - Selection parsers
 bool Configurable::get_quick_load_tape(const Configurable::SelectionSet &selections_by_option, bool &result) {
 	return get_bool(selections_by_option, "quickload", result);
@@ -91,3 +103,22 @@ bool Configurable::get_display(const Configurable::SelectionSet &selections_by_o
 	}
 	return false;
 }
+
+bool Configurable::get_stereo_layout(const SelectionSet &selections_by_option, StereoLayout &result) {
+	auto layout = Configurable::selection<Configurable::ListSelection>(selections_by_option, "stereo");
+	if(layout) {
+		if(layout->value == "mono") {
+			result = Configurable::StereoLayout::Mono;
+			return true;
+		}
+		if(layout->value == "abc") {
+			result = Configurable::StereoLayout::ABC;
+			return true;
+		}
+		if(layout->value == "acb") {
+			result = Configurable::StereoLayout::ACB;
+			return true;
+		}
+	}
+	return false;
+}
@@ -18,7 +18,8 @@ enum StandardOptions {
 	DisplaySVideo				= (1 << 1),
 	DisplayComposite			= (1 << 2),
 	QuickLoadTape				= (1 << 3),
-	AutomaticTapeMotorControl	= (1 << 4)
+	AutomaticTapeMotorControl	= (1 << 4),
+	Stereo						= (1 << 5)
 };
 
 enum class Display {
@@ -27,6 +28,16 @@ enum class Display {
 	Composite
 };
 
+/*!
+	Describes where the three channels of a stereo-capable tone generator, such as the AY-3-8910,
+	are placed: all centred, or A left, B centre and C right, or A left, C centre and B right.
+*/
+enum class StereoLayout {
+	Mono,
+	ABC,
+	ACB
+};
+
 /*!
 	@returns An option list comprised of the standard names for all the options indicated by @c mask.
 */
@@ -47,6 +58,11 @@ void append_automatic_tape_motor_control_selection(SelectionSet &selection_set,
 */
 void append_display_selection(SelectionSet &selection_set, Display selection);
 
+/*!
+	Appends to @c selection_set a selection of @c selection for StereoLayout.
+*/
+void append_stereo_layout_selection(SelectionSet &selection_set, StereoLayout selection);
+
 /*!
 	Attempts to discern a QuickLoadTape selection from @c selections_by_option.
  
@@ -74,6 +90,15 @@ bool get_automatic_tape_motor_control_selection(const SelectionSet &selections_b
 */
 bool get_display(const SelectionSet &selections_by_option, Display &result);
 
+/*!
+	Attempts to discern a stereo layout selection from @c selections_by_option.
+ 
+	@param selections_by_option The user selections.
+	@param result The location to which the selection will be stored if found.
+	@returns @c true if a selection is found; @c false otherwise.
+*/
+bool get_stereo_layout(const SelectionSet &selections_by_option, StereoLayout &result);
+
 }
 
 #endif /* StandardOptions_hpp */
@@ -25,14 +25,17 @@
 #include "../CRTMachine.hpp"
 #include "../JoystickMachine.hpp"
 #include "../KeyboardMachine.hpp"
+#include "../SnapshotMachine.hpp"
 
 #include "../../Storage/Tape/Tape.hpp"
+#include "../../Storage/State/Formats/SNA.hpp"
 
 #include "../../ClockReceiver/ForceInline.hpp"
 #include "../../Outputs/Speaker/Implementation/LowpassSpeaker.hpp"
 
 #include "../../Analyser/Static/AmstradCPC/Target.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 
@@ -40,7 +43,7 @@ namespace AmstradCPC {
 
 std::vector<std::unique_ptr<Configurable::Option>> get_options() {
 	return Configurable::standard_options(
-		static_cast<Configurable::StandardOptions>(Configurable::DisplayRGB | Configurable::DisplayComposite)
+		static_cast<Configurable::StandardOptions>(Configurable::DisplayRGB | Configurable::DisplayComposite | Configurable::Stereo)
 	);
 }
 
@@ -108,6 +111,14 @@ class InterruptTimer {
 			interrupt_request_ = false;
 		}
 
+		/// Captures or restores the state of this timer.
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialiser.field(reset_counter_);
+			serialiser.field(interrupt_request_);
+			serialiser.field(last_interrupt_request_);
+			serialiser.field(timer_);
+		}
+
 	private:
 		int reset_counter_ = 0;
 		bool interrupt_request_ = false;
@@ -156,6 +167,16 @@ class AYDeferrer {
 			return ay_;
 		}
 
+		/// Completes all pending audio work, then captures or restores the AY's state.
+		void serialise(Storage::State::Serialiser &serialiser) {
+			update();
+			flush();
+			audio_queue_.flush();
+
+			ay_.serialise(serialiser);
+			serialiser.field(cycles_since_update_);
+		}
+
 	private:
 		Concurrency::DeferringAsyncTaskQueue audio_queue_;
 		GI::AY38910::AY38910 ay_;
@@ -214,21 +235,7 @@ class CRTCBusHandler {
 			// If a transition between sync/border/pixels just occurred, flush whatever was
 			// in progress to the CRT and reset counting.
 			if(output_mode != previous_output_mode_) {
-				if(cycles_) {
-					switch(previous_output_mode_) {
-						default:
-						case OutputMode::Blank:			crt_->output_blank(cycles_ * 16);					break;
-						case OutputMode::Sync:			crt_->output_sync(cycles_ * 16);					break;
-						case OutputMode::Border:		output_border(cycles_);								break;
-						case OutputMode::ColourBurst:	crt_->output_default_colour_burst(cycles_ * 16);	break;
-						case OutputMode::Pixels:
-							crt_->output_data(cycles_ * 16, cycles_ * 16 / pixel_divider_);
-							pixel_pointer_ = pixel_data_ = nullptr;
-						break;
-					}
-				}
-
-				cycles_ = 0;
+				flush_output();
 				previous_output_mode_ = output_mode;
 			}
 
@@ -301,12 +308,7 @@ class CRTCBusHandler {
 			if(was_hsync_ && !state.hsync) {
 				if(mode_ != next_mode_) {
 					mode_ = next_mode_;
-					switch(mode_) {
-						default:
-						case 0:		pixel_divider_ = 4;	break;
-						case 1:		pixel_divider_ = 2;	break;
-						case 2:		pixel_divider_ = 1;	break;
-					}
+					update_pixel_divider();
 					build_mode_table();
 				}
 
@@ -332,6 +334,11 @@ class CRTCBusHandler {
 					"uint sample = texture(texID, coordinate).r;"
 					"return vec3(float((sample >> 4) & 3u), float((sample >> 2) & 3u), float(sample & 3u)) / 2.0;"
 				"}");
+			crt_->set_software_rgb_sampling_function([] (const uint8_t *sample, float *rgb) {
+				rgb[0] = static_cast<float>((*sample >> 4) & 3) / 2.0f;
+				rgb[1] = static_cast<float>((*sample >> 2) & 3) / 2.0f;
+				rgb[2] = static_cast<float>(*sample & 3) / 2.0f;
+			});
 			crt_->set_visible_area(Outputs::CRT::Rect(0.1072f, 0.1f, 0.842105263157895f, 0.842105263157895f));
 			crt_->set_video_signal(Outputs::CRT::VideoSignal::RGB);
 		}
@@ -375,7 +382,62 @@ class CRTCBusHandler {
 			}
 		}
 
+		/*!
+			Captures or restores the gate array's state. Upon restoration, whatever output was
+			in progress is first posted to the CRT.
+		*/
+		void serialise(Storage::State::Serialiser &serialiser) {
+			if(!serialiser.is_capturing()) {
+				flush_output();
+			}
+
+			serialiser.field(previous_output_mode_);
+			if(previous_output_mode_ > OutputMode::Pixels) serialiser.set_invalid();
+			serialiser.field(was_hsync_);
+			serialiser.field(was_vsync_);
+			serialiser.field(cycles_into_hsync_);
+			serialiser.field(next_mode_);
+			serialiser.field(mode_);
+			serialiser.field(pen_);
+			serialiser.field(palette_);
+			serialiser.field(border_);
+
+			if(!serialiser.is_capturing()) {
+				next_mode_ &= 3;
+				mode_ &= 3;
+				pen_ &= 0x1f;
+				update_pixel_divider();
+				build_mode_table();
+			}
+		}
+
 	private:
+		void update_pixel_divider() {
+			switch(mode_) {
+				default:
+				case 0:		pixel_divider_ = 4;	break;
+				case 1:		pixel_divider_ = 2;	break;
+				case 2:		pixel_divider_ = 1;	break;
+			}
+		}
+
+		void flush_output() {
+			if(crt_ && cycles_) {
+				switch(previous_output_mode_) {
+					default:
+					case OutputMode::Blank:			crt_->output_blank(cycles_ * 16);					break;
+					case OutputMode::Sync:			crt_->output_sync(cycles_ * 16);					break;
+					case OutputMode::Border:		output_border(cycles_);								break;
+					case OutputMode::ColourBurst:	crt_->output_default_colour_burst(cycles_ * 16);	break;
+					case OutputMode::Pixels:
+						crt_->output_data(cycles_ * 16, cycles_ * 16 / pixel_divider_);
+					break;
+				}
+			}
+			pixel_pointer_ = pixel_data_ = nullptr;
+			cycles_ = 0;
+		}
+
 		void output_border(unsigned int length) {
 			uint8_t *colour_pointer = static_cast<uint8_t *>(crt_->allocate_write_area(1));
 			if(colour_pointer) *colour_pointer = border_;
@@ -606,6 +668,13 @@ class KeyboardState: public GI::AY38910::PortHandler {
 			return joysticks_;
 		}
 
+		/// Captures or restores the selected row; key states are user input and are not included.
+		void serialise(Storage::State::Serialiser &serialiser) {
+			uint8_t row = static_cast<uint8_t>(row_);
+			serialiser.field(row);
+			row_ = row;
+		}
+
 	private:
 		uint8_t joy2_state_ = 0xff;
 		uint8_t rows_[10] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
@@ -764,7 +833,8 @@ template <bool has_fdc> class ConcreteMachine:
 	public Configurable::Device,
 	public JoystickMachine::Machine,
 	public Machine,
-	public Activity::Source {
+	public Activity::Source,
+	public SnapshotMachine::Machine {
 	public:
 		ConcreteMachine(const Analyser::Static::AmstradCPC::Target &target, const ROMMachine::ROMFetcher &rom_fetcher) :
 			z80_(*this),
@@ -893,8 +963,7 @@ template <bool has_fdc> class ConcreteMachine:
 
 					// Check for an upper ROM selection
 					if(has_fdc && !(address&0x2000)) {
-						upper_rom_ = (*cycle.value == 7) ? ROMType::AMSDOS : ROMType::BASIC;
-						if(upper_rom_is_paged_) read_pointers_[3] = roms_[upper_rom_].data();
+						select_upper_rom(*cycle.value);
 					}
 
 					// Check for a CRTC access
@@ -1020,7 +1089,18 @@ template <bool has_fdc> class ConcreteMachine:
 				if(c == 4) break;
 			}
 
-			return !media.tapes.empty() || (!media.disks.empty() && has_fdc);
+			// Install the first snapshot supplied, if any.
+			bool did_install_snapshot = false;
+			for(const auto &snapshot: media.snapshots) {
+				const Storage::State::SNA *const sna = dynamic_cast<Storage::State::SNA *>(snapshot.get());
+				if(sna) {
+					install_snapshot(*sna);
+					did_install_snapshot = true;
+					break;
+				}
+			}
+
+			return !media.tapes.empty() || (!media.disks.empty() && has_fdc) || did_install_snapshot;
 		}
 
 		void set_component_prefers_clocking(ClockingHint::Source *component, ClockingHint::Preference clocking) override final {
@@ -1071,26 +1151,166 @@ template <bool has_fdc> class ConcreteMachine:
 			if(Configurable::get_display(selections_by_option, display)) {
 				set_video_signal_configurable(display);
 			}
+
+			Configurable::StereoLayout layout;
+			if(Configurable::get_stereo_layout(selections_by_option, layout)) {
+				set_stereo_layout(layout);
+			}
 		}
 
 		Configurable::SelectionSet get_accurate_selections() override {
 			Configurable::SelectionSet selection_set;
 			Configurable::append_display_selection(selection_set, Configurable::Display::RGB);
+			Configurable::append_stereo_layout_selection(selection_set, Configurable::StereoLayout::ABC);
 			return selection_set;
 		}
 
 		Configurable::SelectionSet get_user_friendly_selections() override {
 			Configurable::SelectionSet selection_set;
 			Configurable::append_display_selection(selection_set, Configurable::Display::RGB);
+			Configurable::append_stereo_layout_selection(selection_set, Configurable::StereoLayout::ABC);
 			return selection_set;
 		}
 
+		/// Places the AY's channels as per @c layout; the CPC's own stereo output is ABC.
+		void set_stereo_layout(Configurable::StereoLayout layout) {
+			switch(layout) {
+				case Configurable::StereoLayout::Mono:	ay_.ay().set_output_mixing(1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f);	break;
+				case Configurable::StereoLayout::ABC:	ay_.ay().set_output_mixing(1.0f, 0.5f, 0.0f, 0.0f, 0.5f, 1.0f);	break;
+				case Configurable::StereoLayout::ACB:	ay_.ay().set_output_mixing(1.0f, 0.0f, 0.5f, 0.0f, 1.0f, 0.5f);	break;
+			}
+		}
+
 		// MARK: - Joysticks
 		std::vector<std::unique_ptr<Inputs::Joystick>> &get_joysticks() override {
 			return key_state_.get_joysticks();
 		}
 
+		// MARK: - Snapshots
+		void serialise(Storage::State::Serialiser &serialiser) override final {
+			flush_fdc();
+
+			serialiser.begin_section("CPC ", 1);
+
+			z80_.serialise(serialiser);
+			crtc_.serialise(serialiser);
+			crtc_bus_handler_.serialise(serialiser);
+			interrupt_timer_.serialise(serialiser);
+			ay_.serialise(serialiser);
+			i8255_.serialise(serialiser);
+			key_state_.serialise(serialiser);
+
+			serialiser.field(clock_offset_);
+			serialiser.field(crtc_counter_);
+			serialiser.field(ram_);
+
+			// Memory paging is recorded in terms of RAM banks and ROMs, rather than as pointers.
+			serialiser.field(upper_rom_is_paged_);
+			serialiser.field(upper_rom_);
+			for(int c = 0; c < 4; ++c) {
+				uint8_t read_source = pointer_source(read_pointers_[c]);
+				uint8_t write_source = pointer_source(write_pointers_[c]);
+				serialiser.field(read_source);
+				serialiser.field(write_source);
+				if(!serialiser.is_capturing()) {
+					if(read_source >= 11 || write_source >= 8 || upper_rom_ < ROMType::AMSDOS || upper_rom_ > ROMType::BASIC) {
+						serialiser.set_invalid();
+					} else {
+						read_pointers_[c] = pointer_for_source(read_source);
+						write_pointers_[c] = pointer_for_source(write_source);
+					}
+				}
+			}
+
+			serialiser.end_section();
+		}
+
 	private:
+		/// @returns An index that describes @c pointer: 0–7 for each of the RAM banks, 8–10 for each of the ROMs.
+		uint8_t pointer_source(const uint8_t *pointer) {
+			for(int c = 0; c < 3; ++c) {
+				if(pointer == roms_[c].data()) return static_cast<uint8_t>(8 + c);
+			}
+			return static_cast<uint8_t>((pointer - ram_) / 16384);
+		}
+
+		/// @returns The pointer described by @c source, per @c pointer_source.
+		uint8_t *pointer_for_source(uint8_t source) {
+			if(source >= 8) return roms_[source - 8].data();
+			return &ram_[source * 16384];
+		}
+
+		/// Pages in the upper ROM selected by @c value, as written to the ROM selection port, if the upper ROM is paged.
+		inline void select_upper_rom(uint8_t value) {
+			upper_rom_ = (value == 7) ? ROMType::AMSDOS : ROMType::BASIC;
+			if(upper_rom_is_paged_) read_pointers_[3] = roms_[upper_rom_].data();
+		}
+
+		/*!
+			Installs the processor, gate array, CRTC, 8255, AY and memory state captured by @c snapshot. Other than
+			memory, state is established by the same register writes that software would use.
+		*/
+		void install_snapshot(const Storage::State::SNA &snapshot) {
+			// Z80.
+			z80_.set_value_of_register(CPU::Z80::Register::AF, snapshot.z80.af);
+			z80_.set_value_of_register(CPU::Z80::Register::BC, snapshot.z80.bc);
+			z80_.set_value_of_register(CPU::Z80::Register::DE, snapshot.z80.de);
+			z80_.set_value_of_register(CPU::Z80::Register::HL, snapshot.z80.hl);
+			z80_.set_value_of_register(CPU::Z80::Register::AFDash, snapshot.z80.af_dash);
+			z80_.set_value_of_register(CPU::Z80::Register::BCDash, snapshot.z80.bc_dash);
+			z80_.set_value_of_register(CPU::Z80::Register::DEDash, snapshot.z80.de_dash);
+			z80_.set_value_of_register(CPU::Z80::Register::HLDash, snapshot.z80.hl_dash);
+			z80_.set_value_of_register(CPU::Z80::Register::IX, snapshot.z80.ix);
+			z80_.set_value_of_register(CPU::Z80::Register::IY, snapshot.z80.iy);
+			z80_.set_value_of_register(CPU::Z80::Register::StackPointer, snapshot.z80.sp);
+			z80_.set_value_of_register(CPU::Z80::Register::ProgramCounter, snapshot.z80.pc);
+			z80_.set_value_of_register(CPU::Z80::Register::I, snapshot.z80.i);
+			z80_.set_value_of_register(CPU::Z80::Register::R, snapshot.z80.r);
+			z80_.set_value_of_register(CPU::Z80::Register::IFF1, snapshot.z80.iff1);
+			z80_.set_value_of_register(CPU::Z80::Register::IFF2, snapshot.z80.iff2);
+			z80_.set_value_of_register(CPU::Z80::Register::IM, snapshot.z80.interrupt_mode);
+			z80_.abandon_instruction();
+
+			// Memory. A 128kb snapshot loaded into a 64kb machine keeps only its first 64kb.
+			const std::size_t ram_size = std::min(snapshot.ram.size(), static_cast<std::size_t>(has_128k_ ? 128*1024 : 64*1024));
+			std::copy(snapshot.ram.begin(), snapshot.ram.begin() + static_cast<std::ptrdiff_t>(ram_size), ram_);
+
+			// Gate array: palette, then RAM and ROM paging, in that order as the latter depends on the former.
+			for(uint8_t pen = 0; pen < 17; ++pen) {
+				write_to_gate_array(pen);
+				write_to_gate_array(0x40 | snapshot.gate_array.palette[pen]);
+			}
+			write_to_gate_array(snapshot.gate_array.selected_pen);
+			if(has_fdc) select_upper_rom(snapshot.upper_rom_selection);
+			write_to_gate_array(0xc0 | (snapshot.gate_array.ram_configuration & 0x3f));
+			write_to_gate_array(0x80 | (snapshot.gate_array.rom_and_mode_configuration & 0x0f));
+
+			// CRTC.
+			for(uint8_t c = 0; c < 18; ++c) {
+				crtc_.select_register(c);
+				crtc_.set_register(snapshot.crtc.registers[c]);
+			}
+			crtc_.select_register(snapshot.crtc.selected_register);
+
+			// AY: latch each register address and then write its value, leaving the selected register latched.
+			ay_.update();
+			const auto latch = [this] (uint8_t value, GI::AY38910::ControlLines lines) {
+				ay_.ay().set_data_input(value);
+				ay_.ay().set_control_lines(lines);
+				ay_.ay().set_control_lines(GI::AY38910::BC2);
+			};
+			for(uint8_t c = 0; c < 16; ++c) {
+				latch(c, GI::AY38910::ControlLines(GI::AY38910::BDIR | GI::AY38910::BC2 | GI::AY38910::BC1));
+				latch(snapshot.psg.registers[c], GI::AY38910::ControlLines(GI::AY38910::BDIR | GI::AY38910::BC2));
+			}
+			latch(snapshot.psg.selected_register, GI::AY38910::ControlLines(GI::AY38910::BDIR | GI::AY38910::BC2 | GI::AY38910::BC1));
+
+			// 8255: a mode-setting control word, if one was captured, and then outputs.
+			if(snapshot.ppi.control & 0x80) i8255_.set_register(3, snapshot.ppi.control);
+			i8255_.set_register(0, snapshot.ppi.port_a);
+			i8255_.set_register(2, snapshot.ppi.port_c);
+		}
+
 		inline void write_to_gate_array(uint8_t value) {
 			switch(value >> 6) {
 				case 0: crtc_bus_handler_.select_pen(value & 0x1f);		break;
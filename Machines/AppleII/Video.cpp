@@ -10,10 +10,9 @@
 
 using namespace AppleII::Video;
 
-VideoBase::VideoBase(bool is_iie, std::function<void(Cycles)> &&target) :
+VideoBase::VideoBase(bool is_iie) :
 	crt_(new Outputs::CRT::CRT(910, 1, Outputs::CRT::DisplayType::NTSC60, 1)),
-	is_iie_(is_iie),
-	deferrer_(std::move(target)) {
+	is_iie_(is_iie) {
 
 	// Set a composite sampling function that assumes one byte per pixel input, and
 	// accepts any non-zero value as being fully on, zero being fully off.
@@ -22,6 +21,9 @@ VideoBase::VideoBase(bool is_iie, std::function<void(Cycles)> &&target) :
 		"{"
 			"return clamp(texture(sampler, coordinate).r, 0.0, 0.66);"
 		"}");
+	crt_->set_software_composite_sampling_function([] (const uint8_t *sample, float phase, float amplitude) {
+		return *sample ? 0.66f : 0.0f;
+	});
 
 	// Show only the centre 75% of the TV frame.
 	crt_->set_video_signal(Outputs::CRT::VideoSignal::Composite);
@@ -55,16 +57,7 @@ Outputs::CRT::CRT *VideoBase::get_crt() {
 */
 void VideoBase::set_alternative_character_set(bool alternative_character_set) {
 	set_alternative_character_set_ = alternative_character_set;
-	deferrer_.defer(Cycles(2), [=] {
-		alternative_character_set_ = alternative_character_set;
-		if(alternative_character_set) {
-			character_zones[1].address_mask = 0xff;
-			character_zones[1].xor_mask = 0;
-		} else {
-			character_zones[1].address_mask = 0x3f;
-			character_zones[1].xor_mask = flash_mask();
-		}
-	});
+	deferrer_.defer(Cycles(2), DeferredSwitch{this, Switch::AlternativeCharacterSet, alternative_character_set});
 }
 
 bool VideoBase::get_alternative_character_set() {
@@ -73,9 +66,7 @@ bool VideoBase::get_alternative_character_set() {
 
 void VideoBase::set_80_columns(bool columns_80) {
 	set_columns_80_ = columns_80;
-	deferrer_.defer(Cycles(2), [=] {
-		columns_80_ = columns_80;
-	});
+	deferrer_.defer(Cycles(2), DeferredSwitch{this, Switch::Columns80, columns_80});
 }
 
 bool VideoBase::get_80_columns() {
@@ -100,9 +91,7 @@ bool VideoBase::get_page2() {
 
 void VideoBase::set_text(bool text) {
 	set_text_ = text;
-	deferrer_.defer(Cycles(2), [=] {
-		text_ = text;
-	});
+	deferrer_.defer(Cycles(2), DeferredSwitch{this, Switch::Text, text});
 }
 
 bool VideoBase::get_text() {
@@ -111,9 +100,7 @@ bool VideoBase::get_text() {
 
 void VideoBase::set_mixed(bool mixed) {
 	set_mixed_ = mixed;
-	deferrer_.defer(Cycles(2), [=] {
-		mixed_ = mixed;
-	});
+	deferrer_.defer(Cycles(2), DeferredSwitch{this, Switch::Mixed, mixed});
 }
 
 bool VideoBase::get_mixed() {
@@ -122,9 +109,7 @@ bool VideoBase::get_mixed() {
 
 void VideoBase::set_high_resolution(bool high_resolution) {
 	set_high_resolution_ = high_resolution;
-	deferrer_.defer(Cycles(2), [=] {
-		high_resolution_ = high_resolution;
-	});
+	deferrer_.defer(Cycles(2), DeferredSwitch{this, Switch::HighResolution, high_resolution});
 }
 
 bool VideoBase::get_high_resolution() {
@@ -133,16 +118,36 @@ bool VideoBase::get_high_resolution() {
 
 void VideoBase::set_annunciator_3(bool annunciator_3) {
 	set_annunciator_3_ = annunciator_3;
-	deferrer_.defer(Cycles(2), [=] {
-		annunciator_3_ = annunciator_3;
-		high_resolution_mask_ = annunciator_3_ ? 0x7f : 0xff;
-	});
+	deferrer_.defer(Cycles(2), DeferredSwitch{this, Switch::Annunciator3, annunciator_3});
 }
 
 bool VideoBase::get_annunciator_3() {
 	return set_annunciator_3_;
 }
 
+void VideoBase::apply(Switch target, bool value) {
+	switch(target) {
+		case Switch::AlternativeCharacterSet:
+			alternative_character_set_ = value;
+			if(value) {
+				character_zones[1].address_mask = 0xff;
+				character_zones[1].xor_mask = 0;
+			} else {
+				character_zones[1].address_mask = 0x3f;
+				character_zones[1].xor_mask = flash_mask();
+			}
+		break;
+		case Switch::Columns80:			columns_80_ = value;		break;
+		case Switch::Text:				text_ = value;				break;
+		case Switch::Mixed:				mixed_ = value;				break;
+		case Switch::HighResolution:	high_resolution_ = value;	break;
+		case Switch::Annunciator3:
+			annunciator_3_ = value;
+			high_resolution_mask_ = annunciator_3_ ? 0x7f : 0xff;
+		break;
+	}
+}
+
 void VideoBase::set_character_rom(const std::vector<uint8_t> &character_rom) {
 	character_rom_ = character_rom;
 
@@ -34,7 +34,7 @@ class BusHandler {
 
 class VideoBase {
 	public:
-		VideoBase(bool is_iie, std::function<void(Cycles)> &&target);
+		VideoBase(bool is_iie);
 
 		/// @returns The CRT this video feed is feeding.
 		Outputs::CRT::CRT *get_crt();
@@ -247,22 +247,42 @@ class VideoBase {
 		*/
 		void output_fat_low_resolution(uint8_t *target, const uint8_t *source, size_t length, int column, int row) const;
 
-		// Maintain a ClockDeferrer for delayed mode switches.
-		ClockDeferrer<Cycles> deferrer_;
+		// Mode switches take effect after a short delay; each pending one is
+		// recorded as the switch affected and its new state.
+		enum class Switch {
+			AlternativeCharacterSet,
+			Columns80,
+			Text,
+			Mixed,
+			HighResolution,
+			Annunciator3
+		};
+		void apply(Switch target, bool value);
+		struct DeferredSwitch {
+			VideoBase *video;
+			Switch target;
+			bool value;
+			void operator()() const	{	video->apply(target, value);	}
+		};
+
+		// Maintain a FixedClockDeferrer for delayed mode switches. Each switch is deferred by two cycles, the
+		// machine brings video up to date before each and makes at most one per cycle, so no more than two
+		// can be pending at once; sixteen leaves ample room.
+		FixedClockDeferrer<Cycles, DeferredSwitch, 16> deferrer_;
 };
 
 template <class BusHandler, bool is_iie> class Video: public VideoBase {
 	public:
 		/// Constructs an instance of the video feed; a CRT is also created.
 		Video(BusHandler &bus_handler) :
-			VideoBase(is_iie, [=] (Cycles cycles) { advance(cycles); }),
+			VideoBase(is_iie),
 			bus_handler_(bus_handler) {}
 
 		/*!
 			Runs video for @c cycles.
 		*/
 		void run_for(Cycles cycles) {
-			deferrer_.run_for(cycles);
+			deferrer_.run_for(cycles, [this] (Cycles cycles) { advance(cycles); });
 		}
 
 		/*!
@@ -13,6 +13,7 @@
 
 #include "../CRTMachine.hpp"
 #include "../JoystickMachine.hpp"
+#include "../SnapshotMachine.hpp"
 
 #include "../../Analyser/Static/Atari/Target.hpp"
 
@@ -76,7 +77,8 @@ class ConcreteMachine:
 	public Machine,
 	public CRTMachine::Machine,
 	public JoystickMachine::Machine,
-	public Outputs::CRT::Delegate {
+	public Outputs::CRT::Delegate,
+	public SnapshotMachine::Machine {
 	public:
 		ConcreteMachine(const Analyser::Static::Atari::Target &target) {
 			set_clock_rate(NTSC_clock_rate);
@@ -222,6 +224,15 @@ class ConcreteMachine:
 			return confidence_counter_.get_confidence();
 		}
 
+		// to satisfy SnapshotMachine::Machine
+		void serialise(Storage::State::Serialiser &serialiser) override {
+			if(!bus_) {
+				serialiser.set_invalid();
+				return;
+			}
+			bus_->serialise(serialiser);
+		}
+
 	private:
 		// the bus
 		std::unique_ptr<Bus> bus_;
@@ -16,6 +16,7 @@
 
 #include "../../Analyser/Dynamic/ConfidenceCounter.hpp"
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Storage/State/Serialiser.hpp"
 #include "../../Outputs/Speaker/Implementation/LowpassSpeaker.hpp"
 
 namespace Atari2600 {
@@ -34,6 +35,9 @@ class Bus {
 		virtual void apply_confidence(Analyser::Dynamic::ConfidenceCounter &confidence_counter) = 0;
 		virtual void set_reset_line(bool state) = 0;
 
+		/// Captures or restores the state of the processor, cartridge and all chips on this bus.
+		virtual void serialise(Storage::State::Serialiser &serialiser) = 0;
+
 		// the RIOT, TIA and speaker
 		PIA mos6532_;
 		std::shared_ptr<TIA> tia_;
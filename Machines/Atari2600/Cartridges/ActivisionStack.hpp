@@ -40,6 +40,11 @@ class ActivisionStack: public BusExtender {
 			if(operation == CPU::MOS6502::BusOperation::ReadOpcode) last_opcode_ = *value;
 		}
 
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialise_rom_pointer(serialiser, rom_ptr_);
+			serialiser.field(last_opcode_);
+		}
+
 	private:
 		uint8_t *rom_ptr_;
 		uint8_t last_opcode_;
@@ -31,6 +31,10 @@ class Atari16k: public BusExtender {
 			}
 		}
 
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialise_rom_pointer(serialiser, rom_ptr_);
+		}
+
 	private:
 		uint8_t *rom_ptr_;
 };
@@ -55,6 +59,11 @@ class Atari16kSuperChip: public BusExtender {
 			else if(address < 0x1100 && isReadOperation(operation)) *value = ram_[address & 0x7f];
 		}
 
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialise_rom_pointer(serialiser, rom_ptr_);
+			serialiser.field(ram_);
+		}
+
 	private:
 		uint8_t *rom_ptr_;
 		uint8_t ram_[128];
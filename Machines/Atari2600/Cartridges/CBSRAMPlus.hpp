@@ -32,6 +32,11 @@ class CBSRAMPlus: public BusExtender {
 			else if(address < 0x1200 && isReadOperation(operation)) *value = ram_[address & 0xff];
 		}
 
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialise_rom_pointer(serialiser, rom_ptr_);
+			serialiser.field(ram_);
+		}
+
 	private:
 		uint8_t *rom_ptr_;
 		uint8_t ram_[256];
@@ -21,9 +21,31 @@ class BusExtender: public CPU::MOS6502::BusHandler {
 
 		void advance_cycles(int cycles) {}
 
+		/// Captures or restores any paging or other state held by the cartridge; by default there is none.
+		void serialise(Storage::State::Serialiser &serialiser) {}
+
 	protected:
 		uint8_t *rom_base_;
 		std::size_t rom_size_;
+
+		/*!
+			Captures or restores @c pointer as an offset into the ROM. If @c may_be_null is @c true then
+			@c nullptr is also acceptable.
+		*/
+		void serialise_rom_pointer(Storage::State::Serialiser &serialiser, uint8_t *&pointer, bool may_be_null = false) {
+			const uint32_t null_offset = 0xffffffff;
+			uint32_t offset = pointer ? static_cast<uint32_t>(pointer - rom_base_) : null_offset;
+			serialiser.field(offset);
+			if(serialiser.is_capturing() || !serialiser.is_valid()) return;
+
+			if(offset == null_offset && may_be_null) {
+				pointer = nullptr;
+			} else if(offset < rom_size_) {
+				pointer = rom_base_ + offset;
+			} else {
+				serialiser.set_invalid();
+			}
+		}
 };
 
 template<class T> class Cartridge:
@@ -203,6 +225,30 @@ template<class T> class Cartridge:
 			audio_queue_.perform();
 		}
 
+		void serialise(Storage::State::Serialiser &serialiser) {
+			// The TIA exists only once output has been set up.
+			if(!tia_) {
+				serialiser.set_invalid();
+				return;
+			}
+
+			// Bring all chips up to date, and complete all pending audio work.
+			flush();
+			update_6532();
+			audio_queue_.flush();
+
+			serialiser.begin_section("2600", 1);
+
+			m6502_.serialise(serialiser);
+			bus_extender_.serialise(serialiser);
+			mos6532_.serialise(serialiser);
+			tia_->serialise(serialiser);
+			tia_sound_.serialise(serialiser);
+			serialiser.field(cycles_since_speaker_update_);
+
+			serialiser.end_section();
+		}
+
 	protected:
 		CPU::MOS6502::Processor<CPU::MOS6502::Personality::P6502, Cartridge<T>, true> m6502_;
 		std::vector<uint8_t> rom_;
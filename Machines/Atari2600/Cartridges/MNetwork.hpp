@@ -57,6 +57,17 @@ class MNetwork: public BusExtender {
 			}
 		}
 
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialise_rom_pointer(serialiser, rom_ptr_[0], true);
+			serialise_rom_pointer(serialiser, rom_ptr_[1]);
+			serialiser.field(low_ram_);
+			serialiser.field(high_ram_);
+
+			uint8_t high_ram_page = static_cast<uint8_t>((high_ram_ptr_ - high_ram_) >> 8);
+			serialiser.field(high_ram_page);
+			high_ram_ptr_ = &high_ram_[(high_ram_page & 3) << 8];
+		}
+
 	private:
 		uint8_t *rom_ptr_[2];
 		uint8_t *high_ram_ptr_;
@@ -36,6 +36,11 @@ class MegaBoy: public BusExtender {
 			}
 		}
 
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialise_rom_pointer(serialiser, rom_ptr_);
+			serialiser.field(current_page_);
+		}
+
 	private:
 		uint8_t *rom_ptr_;
 		uint8_t current_page_;
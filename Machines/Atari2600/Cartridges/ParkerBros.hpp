@@ -38,6 +38,10 @@ class ParkerBros: public BusExtender {
 			}
 		}
 
+		void serialise(Storage::State::Serialiser &serialiser) {
+			for(auto &pointer: rom_ptr_) serialise_rom_pointer(serialiser, pointer);
+		}
+
 	private:
 		uint8_t *rom_ptr_[4];
 };
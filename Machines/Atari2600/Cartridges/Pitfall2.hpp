@@ -90,6 +90,17 @@ class Pitfall2: public BusExtender {
 			}
 		}
 
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialiser.field(featcher_address_);
+			serialiser.field(top_);
+			serialiser.field(bottom_);
+			serialiser.field(mask_);
+			serialiser.field(random_number_generator_);
+			serialise_rom_pointer(serialiser, rom_ptr_);
+			serialiser.field(audio_channel_);
+			serialiser.field(cycles_since_audio_update_);
+		}
+
 	private:
 		inline uint16_t address_for_counter(int counter) {
 			uint16_t fetch_address = (featcher_address_[counter] & 2047) ^ 2047;
@@ -32,6 +32,11 @@ class Tigervision: public BusExtender {
 			}
 		}
 
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialise_rom_pointer(serialiser, rom_ptr_[0]);
+			serialise_rom_pointer(serialiser, rom_ptr_[1]);
+		}
+
 	private:
 		uint8_t *rom_ptr_[2];
 };
@@ -9,6 +9,7 @@
 #include "TIA.hpp"
 
 #include <cassert>
+#include <cmath>
 #include <cstring>
 
 using namespace Atari2600;
@@ -133,6 +134,12 @@ void TIA::set_output_mode(Atari2600::TIA::OutputMode output_mode) {
 				"float phaseOffset = 6.283185308 * float(iPhase) / 13.0 + 5.074880441076923;"
 				"return vec2(float(y) / 14.0, step(1, iPhase) * cos(phase - phaseOffset));"
 			"}");
+		crt_->set_software_svideo_sampling_function([] (const uint8_t *sample, float phase, float amplitude, float *luminance_chrominance) {
+			const int phase_index = *sample >> 4;
+			const float phase_offset = 6.283185308f * static_cast<float>(phase_index) / 13.0f + 5.074880441076923f;
+			luminance_chrominance[0] = static_cast<float>(*sample & 14) / 14.0f;
+			luminance_chrominance[1] = phase_index ? cosf(phase - phase_offset) : 0.0f;
+		});
 		display_type = Outputs::CRT::DisplayType::NTSC60;
 	} else {
 		crt_->set_svideo_sampling_function(
@@ -147,6 +154,15 @@ void TIA::set_output_mode(Atari2600::TIA::OutputMode output_mode) {
 				"phaseOffset *= 6.283185308 / 12.0;"
 				"return vec2(float(y) / 14.0, step(4, (iPhase + 2u) & 15u) * cos(phase + phaseOffset));"
 			"}");
+		crt_->set_software_svideo_sampling_function([] (const uint8_t *sample, float phase, float amplitude, float *luminance_chrominance) {
+			const int phase_index = *sample >> 4;
+			const int direction = phase_index & 1;
+			const float phase_offset =
+				(static_cast<float>(7 - direction) + (static_cast<float>(direction) - 0.5f) * 2.0f * static_cast<float>(phase_index >> 1)) *
+				6.283185308f / 12.0f;
+			luminance_chrominance[0] = static_cast<float>(*sample & 14) / 14.0f;
+			luminance_chrominance[1] = (((phase_index + 2) & 15) >= 4) ? cosf(phase + phase_offset) : 0.0f;
+		});
 		display_type = Outputs::CRT::DisplayType::PAL50;
 	}
 	crt_->set_video_signal(Outputs::CRT::VideoSignal::Composite);
@@ -677,3 +693,49 @@ void TIA::draw_missile(Missile &missile, Player &player, const uint8_t collision
 		player.latched_pixel4_time = -1;
 	}
 }
+
+// MARK: - State
+
+void TIA::serialise(Storage::State::Serialiser &serialiser) {
+	if(!serialiser.is_capturing()) {
+		// Post whatever pixels have been collected so far on the current line; output will
+		// resume with a fresh write area.
+		if(pixel_target_ && crt_) {
+			const unsigned int data_length = static_cast<unsigned int>(horizontal_counter_ - pixels_start_location_);
+			crt_->output_data(data_length * 2, data_length);
+		}
+		pixel_target_ = nullptr;
+		pixels_start_location_ = 0;
+	}
+
+	serialiser.begin_section("TIA ", 1);
+
+	serialiser.field(horizontal_counter_);
+	serialiser.field(output_mode_);
+	serialiser.field(collision_buffer_);
+	serialiser.field(collision_flags_);
+	serialiser.field(colour_palette_);
+	serialiser.field(background_half_mask_);
+	serialiser.field(playfield_priority_);
+	serialiser.field(background_);
+	serialiser.field(horizontal_blank_extend_);
+
+	player_[0].serialise(serialiser);
+	player_[1].serialise(serialiser);
+	missile_[0].serialise(serialiser);
+	missile_[1].serialise(serialiser);
+	ball_.serialise(serialiser);
+
+	serialiser.end_section();
+
+	if(!serialiser.is_capturing()) {
+		output_mode_ &= sync_flag | blank_flag;
+		background_half_mask_ &= 1;
+		if(
+			horizontal_counter_ < 0 || horizontal_counter_ >= cycles_per_line ||
+			playfield_priority_ > PlayfieldPriority::OnTop
+		) {
+			serialiser.set_invalid();
+		}
+	}
+}
@@ -12,6 +12,7 @@
 #include <cstdint>
 
 #include "../CRTMachine.hpp"
+#include "../../Storage/State/Serialiser.hpp"
 
 namespace Atari2600 {
 
@@ -75,6 +76,12 @@ class TIA {
 
 		Outputs::CRT::CRT *get_crt() { return crt_.get(); }
 
+		/*!
+			Captures or restores the TIA's state. Upon restoration any partially-output
+			line of pixels is first posted to the CRT.
+		*/
+		void serialise(Storage::State::Serialiser &serialiser);
+
 	private:
 		TIA(bool create_crt);
 		std::unique_ptr<Outputs::CRT::CRT> crt_;
@@ -123,7 +130,7 @@ class TIA {
 			Standard,
 			Score,
 			OnTop
-		} playfield_priority_;
+		} playfield_priority_ = PlayfieldPriority::Standard;
 		uint32_t background_[2] = {0, 0};
 				// contains two 20-bit bitfields representing the background state;
 				// at index 0 is the left-hand side of the playfield with bit 0 being
@@ -145,6 +152,14 @@ class TIA {
 
 			// indicates whether this object is currently undergoing motion
 			bool is_moving = false;
+
+			void serialise_object(Storage::State::Serialiser &serialiser) {
+				serialiser.field(position);
+				serialiser.field(motion);
+				serialiser.field(motion_step);
+				serialiser.field(motion_time);
+				serialiser.field(is_moving);
+			}
 		};
 
 		// player state
@@ -194,6 +209,32 @@ class TIA {
 				}
 			}
 
+			void serialise(Storage::State::Serialiser &serialiser) {
+				serialise_object(serialiser);
+				serialiser.field(adder);
+				serialiser.field(copy_flags);
+				serialiser.field(graphic);
+				serialiser.field(reverse_mask);
+				serialiser.field(graphic_index);
+				serialiser.field(pixel_position);
+				serialiser.field(pixel_counter);
+				serialiser.field(latched_pixel4_time);
+				serialiser.field(copy_index_);
+				for(auto &queued: queue_) {
+					serialiser.field(queued.start);
+					serialiser.field(queued.end);
+					serialiser.field(queued.pixel_position);
+					serialiser.field(queued.adder);
+					serialiser.field(queued.reverse_mask);
+				}
+				serialiser.field(queue_read_pointer_);
+				serialiser.field(queue_write_pointer_);
+
+				graphic_index &= 1;
+				queue_read_pointer_ &= 3;
+				queue_write_pointer_ &= 3;
+			}
+
 			void enqueue_pixels(const int start, const int end, int from_horizontal_counter) {
 				queue_[queue_write_pointer_].start = start;
 				queue_[queue_write_pointer_].end = end;
@@ -253,6 +294,12 @@ class TIA {
 
 			void dequeue_pixels(uint8_t *const target, const uint8_t collision_identity, const int time_now) {}
 			void enqueue_pixels(const int start, const int end, int from_horizontal_counter) {}
+
+			void serialise_run(Storage::State::Serialiser &serialiser) {
+				serialise_object(serialiser);
+				serialiser.field(pixel_position);
+				serialiser.field(size);
+			}
 		};
 
 		// missile state
@@ -261,6 +308,13 @@ class TIA {
 			bool locked_to_player = false;
 			int copy_flags = 0;
 
+			void serialise(Storage::State::Serialiser &serialiser) {
+				serialise_run(serialiser);
+				serialiser.field(enabled);
+				serialiser.field(locked_to_player);
+				serialiser.field(copy_flags);
+			}
+
 			inline void output_pixels(uint8_t *const target, const int count, const uint8_t collision_identity, int from_horizontal_counter) {
 				if(!pixel_position) return;
 				if(enabled && !locked_to_player) {
@@ -277,6 +331,13 @@ class TIA {
 			int enabled_index = 0;
 			const int copy_flags = 0;
 
+			void serialise(Storage::State::Serialiser &serialiser) {
+				serialise_run(serialiser);
+				serialiser.field(enabled);
+				serialiser.field(enabled_index);
+				enabled_index &= 1;
+			}
+
 			inline void output_pixels(uint8_t *const target, const int count, const uint8_t collision_identity, int from_horizontal_counter) {
 				if(!pixel_position) return;
 				if(enabled[enabled_index]) {
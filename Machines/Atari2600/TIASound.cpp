@@ -8,6 +8,8 @@
 
 #include "TIASound.hpp"
 
+#include <algorithm>
+
 using namespace Atari2600;
 
 Atari2600::TIASound::TIASound(Concurrency::DeferringAsyncTaskQueue &audio_queue) :
@@ -36,94 +38,210 @@ void Atari2600::TIASound::set_control(int channel, uint8_t control) {
 	});
 }
 
-#define advance_poly4(c) poly4_counter_[channel] = (poly4_counter_[channel] >> 1) | (((poly4_counter_[channel] << 3) ^ (poly4_counter_[channel] << 2))&0x008)
-#define advance_poly5(c) poly5_counter_[channel] = (poly5_counter_[channel] >> 1) | (((poly5_counter_[channel] << 4) ^ (poly5_counter_[channel] << 2))&0x010)
-#define advance_poly9(c) poly9_counter_[channel] = (poly9_counter_[channel] >> 1) | (((poly9_counter_[channel] << 4) ^ (poly9_counter_[channel] << 8))&0x100)
-
-void Atari2600::TIASound::get_samples(std::size_t number_of_samples, int16_t *target) {
-	for(unsigned int c = 0; c < number_of_samples; c++) {
-		target[c] = 0;
-		for(int channel = 0; channel < 2; channel++) {
-			divider_counter_[channel] ++;
-			int divider_value = divider_counter_[channel] / (38 / CPUTicksPerAudioTick);
-			int level = 0;
-			switch(control_[channel]) {
-				case 0x0: case 0xb:	// constant 1
-					level = 1;
-				break;
-
-				case 0x4: case 0x5:	// div2 tone
-					level = (divider_value / (divider_[channel]+1))&1;
-				break;
-
-				case 0xc: case 0xd:	// div6 tone
-					level = (divider_value / ((divider_[channel]+1)*3))&1;
-				break;
-
-				case 0x6: case 0xa:	// div31 tone
-					level = (divider_value / (divider_[channel]+1))%30 <= 18;
-				break;
+namespace {
+
+/*!
+	Successor tables for the three polynomial counters: each maps a counter's current value to the
+	value it will have once advanced.
+*/
+struct PolynomialTables {
+	uint16_t poly4[16];
+	uint16_t poly5[32];
+	uint16_t poly9[512];
+
+	PolynomialTables() {
+		for(int c = 0; c < 16; ++c)		poly4[c] = static_cast<uint16_t>((c >> 1) | (((c << 3) ^ (c << 2))&0x008));
+		for(int c = 0; c < 32; ++c)		poly5[c] = static_cast<uint16_t>((c >> 1) | (((c << 4) ^ (c << 2))&0x010));
+		for(int c = 0; c < 512; ++c)	poly9[c] = static_cast<uint16_t>((c >> 1) | (((c << 4) ^ (c << 8))&0x100));
+	}
+} const polynomials;
 
-				case 0xe:			// div93 tone
-					level = (divider_value / ((divider_[channel]+1)*3))%30 <= 18;
-				break;
+/// The output of the div31 tones for each position within their period of 30.
+const bool div31_levels[30] = {
+	true, true, true, true, true, true, true, true, true, true,
+	true, true, true, true, true, true, true, true, true, false,
+	false, false, false, false, false, false, false, false, false, false
+};
 
-				case 0x1:			// 4-bit poly
-					level = poly4_counter_[channel]&1;
-					if(divider_value == divider_[channel]+1) {
-						divider_counter_[channel] = 0;
-						advance_poly4(channel);
-					}
-				break;
+/// The number of samples each channel is generated for at a time, ahead of mixing.
+const std::size_t ChunkLength = 512;
 
-				case 0x2:			// 4-bit poly div31
-					level = poly4_counter_[channel]&1;
-					if(divider_value%(30*(divider_[channel]+1)) == 18) {
-						advance_poly4(channel);
-					}
-				break;
+}
 
-				case 0x3:			// 5/4-bit poly
-					level = output_state_[channel];
-					if(divider_value == divider_[channel]+1) {
-						if(poly5_counter_[channel]&1) {
-							output_state_[channel] = poly4_counter_[channel]&1;
-							advance_poly4(channel);
-						}
-						advance_poly5(channel);
-					}
-				break;
+void Atari2600::TIASound::get_samples(std::size_t number_of_samples, int16_t *target) {
+	// Generate each channel in turn, in runs of constant output, then mix.
+	int16_t channel_samples[ChunkLength];
+	while(number_of_samples) {
+		const std::size_t length = std::min(number_of_samples, ChunkLength);
+
+		generate_channel(0, length, target);
+		generate_channel(1, length, channel_samples);
+		for(std::size_t c = 0; c < length; ++c) {
+			target[c] += channel_samples[c];
+		}
 
-				case 0x7: case 0x9:	// 5-bit poly
-					level = poly5_counter_[channel]&1;
-					if(divider_value == divider_[channel]+1) {
-						divider_counter_[channel] = 0;
-						advance_poly5(channel);
-					}
-				break;
+		target += length;
+		number_of_samples -= length;
+	}
+}
 
-				case 0xf:			// 5-bit poly div6
-					level = poly5_counter_[channel]&1;
-					if(divider_value == (divider_[channel]+1)*3) {
-						divider_counter_[channel] = 0;
-						advance_poly5(channel);
-					}
+void Atari2600::TIASound::generate_channel(int channel, std::size_t number_of_samples, int16_t *target) {
+	// Each output sample is (volume * per_channel_volume_ * level) >> 4, with a level of either 0 or 1.
+	const int16_t amplitude = static_cast<int16_t>((volume_[channel] * per_channel_volume_) >> 4);
+
+	// The divider counter is incremented once per sample, and compared with its thresholds in units of
+	// AudioTicksPerDivision; the levels below are those that apply after each increment.
+	const int AudioTicksPerDivision = 38 / CPUTicksPerAudioTick;
+	const int divider = divider_[channel] + 1;
+	int counter = divider_counter_[channel];
+	std::size_t c = 0;
+
+	const auto output = [&](std::size_t length, int level) {
+		std::fill_n(&target[c], length, level ? amplitude : int16_t(0));
+		c += length;
+		counter += static_cast<int>(length);
+	};
+
+	// Emits runs of a tone, the level of which depends only upon which period of length @c period the counter is in.
+	const auto tone = [&](int period, bool is_div31) {
+		while(c < number_of_samples) {
+			const int next = counter + 1;
+			const int position = next / period;
+			output(
+				std::min(number_of_samples - c, static_cast<std::size_t>((position + 1) * period - next)),
+				is_div31 ? div31_levels[position % 30] : (position & 1)
+			);
+		}
+	};
+
+	// Emits the current level of a polynomial counter until the divider counter reaches @c period,
+	// whereupon the polynomial is advanced and the counter reset. Once past that point without having been
+	// reset, e.g. having been in a tone mode, the counter won't match again and the level is fixed.
+	const auto polynomial = [&](int period, int &poly, const uint16_t *successors) {
+		const int last = period + AudioTicksPerDivision - 1;
+		while(c < number_of_samples) {
+			const int next = counter + 1;
+			if(next > last) {
+				output(number_of_samples - c, poly & 1);
 				break;
+			}
 
-				case 0x8:			// 9-bit poly
-					level = poly9_counter_[channel]&1;
-					if(divider_value == divider_[channel]+1) {
-						divider_counter_[channel] = 0;
-						advance_poly9(channel);
-					}
+			const std::size_t samples_to_advance = (next >= period) ? 1 : static_cast<std::size_t>(period - next + 1);
+			if(samples_to_advance > number_of_samples - c) {
+				output(number_of_samples - c, poly & 1);
 				break;
 			}
 
-			target[c] += (volume_[channel] * per_channel_volume_ * level) >> 4;
+			output(samples_to_advance, poly & 1);
+			counter = 0;
+			poly = successors[poly];
 		}
+	};
+
+	switch(control_[channel]) {
+		case 0x0: case 0xb:	// constant 1
+			output(number_of_samples, 1);
+		break;
+
+		case 0x4: case 0x5:	// div2 tone
+			tone(AudioTicksPerDivision * divider, false);
+		break;
+
+		case 0xc: case 0xd:	// div6 tone
+			tone(AudioTicksPerDivision * divider * 3, false);
+		break;
+
+		case 0x6: case 0xa:	// div31 tone
+			tone(AudioTicksPerDivision * divider, true);
+		break;
+
+		case 0xe:			// div93 tone
+			tone(AudioTicksPerDivision * divider * 3, true);
+		break;
+
+		case 0x1:			// 4-bit poly
+			polynomial(AudioTicksPerDivision * divider, poly4_counter_[channel], polynomials.poly4);
+		break;
+
+		case 0x7: case 0x9:	// 5-bit poly
+			polynomial(AudioTicksPerDivision * divider, poly5_counter_[channel], polynomials.poly5);
+		break;
+
+		case 0xf:			// 5-bit poly div6
+			polynomial(AudioTicksPerDivision * divider * 3, poly5_counter_[channel], polynomials.poly5);
+		break;
+
+		case 0x8:			// 9-bit poly
+			polynomial(AudioTicksPerDivision * divider, poly9_counter_[channel], polynomials.poly9);
+		break;
+
+		case 0x2: {			// 4-bit poly div31
+			// The counter isn't reset; the polynomial advances upon every sample for which the divided
+			// counter is 18 modulo 30 * divider.
+			const int period = AudioTicksPerDivision * 30 * divider;
+			const int window_start = AudioTicksPerDivision * 18;
+			const int window_end = window_start + AudioTicksPerDivision;
+			while(c < number_of_samples) {
+				const int phase = (counter + 1) % period;
+				if(phase >= window_start && phase < window_end) {
+					output(1, poly4_counter_[channel] & 1);
+					poly4_counter_[channel] = polynomials.poly4[poly4_counter_[channel]];
+				} else {
+					const int run = (phase < window_start) ? window_start - phase : period - phase + window_start;
+					output(std::min(number_of_samples - c, static_cast<std::size_t>(run)), poly4_counter_[channel] & 1);
+				}
+			}
+		} break;
+
+		case 0x3: {			// 5/4-bit poly
+			// The counter isn't reset; the polynomials advance upon every sample for which the divided
+			// counter equals the divider, and not thereafter.
+			const int first = AudioTicksPerDivision * divider;
+			const int last = first + AudioTicksPerDivision - 1;
+			while(c < number_of_samples) {
+				const int next = counter + 1;
+				if(next >= first && next <= last) {
+					output(1, output_state_[channel]);
+					if(poly5_counter_[channel]&1) {
+						output_state_[channel] = poly4_counter_[channel]&1;
+						poly4_counter_[channel] = polynomials.poly4[poly4_counter_[channel]];
+					}
+					poly5_counter_[channel] = polynomials.poly5[poly5_counter_[channel]];
+				} else {
+					const std::size_t run = (next < first) ? static_cast<std::size_t>(first - next) : number_of_samples - c;
+					output(std::min(number_of_samples - c, run), output_state_[channel]);
+				}
+			}
+		} break;
 	}
+
+	divider_counter_[channel] = counter;
 }
 
 void Atari2600::TIASound::set_sample_volume_range(std::int16_t range) {
 	per_channel_volume_ = range / 2;
 }
+
+void Atari2600::TIASound::serialise(Storage::State::Serialiser &serialiser) {
+	serialiser.begin_section("TIAS", 1);
+
+	serialiser.field(volume_);
+	serialiser.field(divider_);
+	serialiser.field(control_);
+	serialiser.field(poly4_counter_);
+	serialiser.field(poly5_counter_);
+	serialiser.field(poly9_counter_);
+	serialiser.field(output_state_);
+	serialiser.field(divider_counter_);
+
+	serialiser.end_section();
+
+	for(int channel = 0; channel < 2; ++channel) {
+		volume_[channel] &= 0xf;
+		divider_[channel] &= 0x1f;
+		control_[channel] &= 0xf;
+		poly4_counter_[channel] &= 0x00f;
+		poly5_counter_[channel] &= 0x01f;
+		poly9_counter_[channel] &= 0x1ff;
+	}
+}
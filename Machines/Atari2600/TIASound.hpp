@@ -11,6 +11,7 @@
 
 #include "../../Outputs/Speaker/Implementation/SampleSource.hpp"
 #include "../../Concurrency/AsyncTaskQueue.hpp"
+#include "../../Storage/State/Serialiser.hpp"
 
 namespace Atari2600 {
 
@@ -30,20 +31,26 @@ class TIASound: public Outputs::Speaker::SampleSource {
 		void get_samples(std::size_t number_of_samples, int16_t *target);
 		void set_sample_volume_range(std::int16_t range);
 
+		/// Captures or restores the TIA's audio state; the owner should ensure that the audio queue has been flushed.
+		void serialise(Storage::State::Serialiser &serialiser);
+
 	private:
 		Concurrency::DeferringAsyncTaskQueue &audio_queue_;
 
-		uint8_t volume_[2];
-		uint8_t divider_[2];
-		uint8_t control_[2];
+		uint8_t volume_[2] = {0, 0};
+		uint8_t divider_[2] = {0, 0};
+		uint8_t control_[2] = {0, 0};
 
 		int poly4_counter_[2];
 		int poly5_counter_[2];
 		int poly9_counter_[2];
-		int output_state_[2];
+		int output_state_[2] = {0, 0};
 
-		int divider_counter_[2];
+		int divider_counter_[2] = {0, 0};
 		int16_t per_channel_volume_ = 0;
+
+		/// Writes the next @c number_of_samples of @c channel alone to @c target.
+		void generate_channel(int channel, std::size_t number_of_samples, int16_t *target);
 };
 
 }
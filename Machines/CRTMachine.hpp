@@ -29,14 +29,14 @@ namespace CRTMachine {
 class Machine {
 	public:
 		/*!
-			Causes the machine to set up its CRT and, if it has one, speaker. The caller guarantees
-			that an OpenGL context is bound.
+			Causes the machine to set up its CRT and, if it has one, speaker. No OpenGL context is
+			required; the CRT makes no OpenGL calls until it is first drawn via OpenGL.
 		*/
 		virtual void setup_output(float aspect_ratio) = 0;
 
 		/*!
-			Gives the machine a chance to release all owned resources. The caller guarantees that the
-			OpenGL context is bound.
+			Gives the machine a chance to release all owned resources. If the CRT has been drawn via
+			OpenGL then the caller guarantees that the OpenGL context is bound.
 		*/
 		virtual void close_output() = 0;
 
@@ -57,15 +57,33 @@ class Machine {
 			run_for(Cycles(static_cast<int>(cycles)));
 		}
 
+		/// @returns The number of cycles per second of the clock that drives this machine.
+		double get_clock_rate() {
+			return clock_rate_;
+		}
+
+		/*!
+			Enables or disables turbo mode, for machines that are to be run as quickly as the host
+			permits rather than in real time, e.g. to load from tape. The caller remains responsible
+			for pacing; turbo mode just reduces the cost of output.
+
+			While turbo mode is enabled, the CRT composes only one in every @c field_decimation fields,
+			and the speaker consumes input @c audio_rate_multiplier times as quickly as its nominal rate;
+			supply 0 to discard audio. All output returns to normal when turbo mode is disabled.
+		*/
+		virtual void set_turbo_mode(bool enabled, unsigned int field_decimation, float audio_rate_multiplier) {
+			get_crt()->set_field_decimation(enabled ? field_decimation : 1);
+
+			Outputs::Speaker::Speaker *const speaker = get_speaker();
+			if(speaker) speaker->set_input_rate_multiplier(enabled ? audio_rate_multiplier : 1.0f);
+		}
+
 	protected:
 		/// Runs the machine for @c cycles.
 		virtual void run_for(const Cycles cycles) = 0;
 		void set_clock_rate(double clock_rate) {
 			clock_rate_ = clock_rate;
 		}
-		double get_clock_rate() {
-			return clock_rate_;
-		}
 
 		/*!
 			Maps from Configurable::Display to Outputs::CRT::VideoSignal and calls
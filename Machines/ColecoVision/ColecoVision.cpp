@@ -16,6 +16,7 @@
 
 #include "../CRTMachine.hpp"
 #include "../JoystickMachine.hpp"
+#include "../SnapshotMachine.hpp"
 
 #include "../../ClockReceiver/ForceInline.hpp"
 
@@ -24,6 +25,8 @@
 
 #include "../../Analyser/Dynamic/ConfidenceCounter.hpp"
 
+#include <limits>
+
 namespace {
 const int sn76489_divider = 2;
 }
@@ -107,7 +110,8 @@ class ConcreteMachine:
 	public Machine,
 	public CPU::Z80::BusHandler,
 	public CRTMachine::Machine,
-	public JoystickMachine::Machine {
+	public JoystickMachine::Machine,
+	public SnapshotMachine::Machine {
 
 	public:
 		ConcreteMachine(const Analyser::Static::Target &target, const ROMMachine::ROMFetcher &rom_fetcher) :
@@ -159,6 +163,8 @@ class ConcreteMachine:
 					is_megacart_ = false;
 				}
 			}
+
+			update_direct_memory();
 		}
 
 		~ConcreteMachine() {
@@ -206,6 +212,15 @@ class ConcreteMachine:
 			time_since_vdp_update_ += length;
 			time_since_sn76489_update_ += length;
 
+			// Count down to the next interrupt before acting, as any VDP access below will reset the countdown
+			// relative to the end of this cycle.
+			if(time_until_interrupt_ > 0) {
+				time_until_interrupt_ -= length;
+				if(time_until_interrupt_ <= HalfCycles(0)) {
+					z80_.set_non_maskable_interrupt_line(true, time_until_interrupt_);
+				}
+			}
+
 			// Act only if necessary.
 			if(cycle.is_terminal()) {
 				uint16_t address = cycle.address ? *cycle.address : 0x0000;
@@ -309,6 +324,7 @@ class ConcreteMachine:
 									default: break;
 									case 0x7f:
 										super_game_module_.replace_bios = !((*cycle.value)&0x2);
+										update_direct_memory();
 									break;
 									case 0x50:
 										// Set AY address.
@@ -326,6 +342,7 @@ class ConcreteMachine:
 									break;
 									case 0x53:
 										super_game_module_.replace_ram = !!((*cycle.value)&0x1);
+										update_direct_memory();
 									break;
 								}
 							break;
@@ -336,16 +353,15 @@ class ConcreteMachine:
 				}
 			}
 
-			if(time_until_interrupt_ > 0) {
-				time_until_interrupt_ -= length;
-				if(time_until_interrupt_ <= HalfCycles(0)) {
-					z80_.set_non_maskable_interrupt_line(true, time_until_interrupt_);
-				}
-			}
-
 			return penalty;
 		}
 
+		HalfCycles get_idle_limit() {
+			// The VDP provides the only interrupt input.
+			if(time_until_interrupt_ > 0) return time_until_interrupt_;
+			return HalfCycles(std::numeric_limits<int>::max());
+		}
+
 		void flush() {
 			update_video();
 			update_audio();
@@ -357,10 +373,86 @@ class ConcreteMachine:
 			return confidence_counter_.get_confidence();
 		}
 
+		// MARK: - Snapshots.
+		void serialise(Storage::State::Serialiser &serialiser) override {
+			// The VDP exists only once output has been set up.
+			if(!vdp_) {
+				serialiser.set_invalid();
+				return;
+			}
+
+			// Bring the VDP and audio chips up to date, and complete all pending audio work.
+			flush();
+			audio_queue_.flush();
+
+			serialiser.begin_section("COLV", 1);
+
+			z80_.serialise(serialiser);
+			vdp_->serialise(serialiser);
+			sn76489_.serialise(serialiser);
+			ay_.serialise(serialiser);
+
+			serialiser.field(ram_);
+			serialiser.field(super_game_module_.replace_bios);
+			serialiser.field(super_game_module_.replace_ram);
+			serialiser.field(super_game_module_.ram);
+			serialiser.field(joysticks_in_keypad_mode_);
+
+			// Megacarts page in 16kb at a time; record the current selection as an offset.
+			uint32_t megacart_offset = is_megacart_ ? static_cast<uint32_t>(cartridge_pages_[1] - cartridge_.data()) : 0;
+			serialiser.field(megacart_offset);
+			if(!serialiser.is_capturing() && serialiser.is_valid() && is_megacart_) {
+				if(megacart_offset & 0x3fff || megacart_offset >= cartridge_.size()) {
+					serialiser.set_invalid();
+				} else {
+					cartridge_pages_[1] = &cartridge_[megacart_offset];
+				}
+			}
+
+			serialiser.field(time_since_sn76489_update_);
+			serialiser.field(time_until_interrupt_);
+
+			serialiser.end_section();
+
+			if(!serialiser.is_capturing()) update_direct_memory();
+		}
+
 	private:
 		inline void page_megacart(uint16_t address) {
 			const std::size_t selected_start = (static_cast<std::size_t>(address&63) << 14) % cartridge_.size();
 			cartridge_pages_[1] = &cartridge_[selected_start];
+			update_direct_memory();
+		}
+
+		/*!
+			Offers the Z80 direct access to all memory that can be accessed without side effects. Reads from the
+			first 1kb are excluded because opcode fetches from address 0 feed the confidence counter, as are all
+			accesses to the final 1kb of a megacart because they trigger paging.
+		*/
+		void update_direct_memory() {
+			for(int page = 0; page < 64; ++page) {
+				const uint16_t address = static_cast<uint16_t>(page << 10);
+				const uint8_t *read = nullptr;
+				uint8_t *write = nullptr;
+
+				if(address < 0x2000) {
+					if(super_game_module_.replace_bios) {
+						read = write = &super_game_module_.ram[address];
+					} else {
+						read = &bios_[address];
+					}
+				} else if(super_game_module_.replace_ram && address < 0x8000) {
+					read = write = &super_game_module_.ram[address];
+				} else if(address >= 0x6000 && address < 0x8000) {
+					read = write = ram_;
+				} else if(address >= 0x8000 && address + 1023 <= cartridge_address_limit_) {
+					read = &cartridge_pages_[(address >> 14)&1][address&0x3fff];
+				}
+
+				if(!page) read = nullptr;
+				if(is_megacart_ && page == 63) read = write = nullptr;
+				z80_.set_direct_memory(address, read, write);
+			}
 		}
 		inline void update_audio() {
 			speaker_.run_for(audio_queue_, time_since_sn76489_update_.divide_cycles(Cycles(sn76489_divider)));
@@ -369,7 +461,7 @@ class ConcreteMachine:
 			vdp_->run_for(time_since_vdp_update_.flush());
 		}
 
-		CPU::Z80::Processor<ConcreteMachine, false, false> z80_;
+		CPU::Z80::Processor<ConcreteMachine, false, false, true> z80_;
 		std::unique_ptr<TI::TMS::TMS9918> vdp_;
 
 		Concurrency::DeferringAsyncTaskQueue audio_queue_;
@@ -21,6 +21,7 @@
 #include "../../../Components/6522/6522.hpp"
 
 #include "../../../ClockReceiver/ForceInline.hpp"
+#include "../../../ClockReceiver/JustInTime.hpp"
 
 #include "../../../Storage/Tape/Parsers/Commodore.hpp"
 
@@ -77,7 +78,7 @@ class UserPortVIA: public MOS::MOS6522::IRQDelegatePortHandler {
 			// the joystick and serial port state, both of which have been statefully collected
 			// into port_a_.
 			if(!port) {
-				return port_a_ | (tape_->has_tape() ? 0x00 : 0x40);
+				return port_a_ | ((*tape_)->has_tape() ? 0x00 : 0x40);
 			}
 			return 0xff;
 		}
@@ -86,7 +87,7 @@ class UserPortVIA: public MOS::MOS6522::IRQDelegatePortHandler {
 		void set_control_line_output(MOS::MOS6522::Port port, MOS::MOS6522::Line line, bool value) {
 			// The CA2 output is used to control the tape motor.
 			if(port == MOS::MOS6522::Port::A && line == MOS::MOS6522::Line::Two) {
-				tape_->set_motor_control(!value);
+				(*tape_)->set_motor_control(!value);
 			}
 		}
 
@@ -121,14 +122,14 @@ class UserPortVIA: public MOS::MOS6522::IRQDelegatePortHandler {
 		}
 
 		/// Sets @tape as the tape player connected to this VIA.
-		void set_tape(std::shared_ptr<Storage::Tape::BinaryTapePlayer> tape) {
+		void set_tape(JustInTimeActor<Storage::Tape::BinaryTapePlayer, Cycles> *tape) {
 			tape_ = tape;
 		}
 
 	private:
 		uint8_t port_a_;
 		std::weak_ptr<::Commodore::Serial::Port> serial_port_;
-		std::shared_ptr<Storage::Tape::BinaryTapePlayer> tape_;
+		JustInTimeActor<Storage::Tape::BinaryTapePlayer, Cycles> *tape_ = nullptr;
 };
 
 /*!
@@ -300,9 +301,9 @@ class ConcreteMachine:
 				serial_bus_(new ::Commodore::Serial::Bus),
 				user_port_via_(*user_port_via_port_handler_),
 				keyboard_via_(*keyboard_via_port_handler_),
-				tape_(new Storage::Tape::BinaryTapePlayer(1022727)) {
+				tape_(1022727) {
 			// communicate the tape to the user-port VIA
-			user_port_via_port_handler_->set_tape(tape_);
+			user_port_via_port_handler_->set_tape(&tape_);
 
 			// wire up the serial bus and serial port
 			Commodore::Serial::AttachPortAndBus(serial_port_, serial_bus_);
@@ -479,7 +480,7 @@ class ConcreteMachine:
 			if(key != KeyRestore)
 				keyboard_via_port_handler_->set_key_state(key, is_pressed);
 			else
-				user_port_via_.set_control_line_input(MOS::MOS6522::Port::A, MOS::MOS6522::Line::One, !is_pressed);
+				user_port_via_->set_control_line_input(MOS::MOS6522::Port::A, MOS::MOS6522::Line::One, !is_pressed);
 		}
 
 		void clear_all_keys() override final {
@@ -503,8 +504,8 @@ class ConcreteMachine:
 						update_video();
 						result &= mos6560_->get_register(address);
 					}
-					if(address & 0x10) result &= user_port_via_.get_register(address);
-					if(address & 0x20) result &= keyboard_via_.get_register(address);
+					if(address & 0x10) result &= user_port_via_->get_register(address);
+					if(address & 0x20) result &= keyboard_via_->get_register(address);
 				}
 				*value = result;
 
@@ -591,26 +592,52 @@ class ConcreteMachine:
 						mos6560_->set_register(address, *value);
 					}
 					// The first VIA is selected by bit 4 = 1.
-					if(address & 0x10) user_port_via_.set_register(address, *value);
+					if(address & 0x10) user_port_via_->set_register(address, *value);
 					// The second VIA is selected by bit 5 = 1.
-					if(address & 0x20) keyboard_via_.set_register(address, *value);
+					if(address & 0x20) keyboard_via_->set_register(address, *value);
 				}
 			}
 
-			user_port_via_.run_for(Cycles(1));
-			keyboard_via_.run_for(Cycles(1));
+			user_port_via_ += Cycles(1);
+			keyboard_via_ += Cycles(1);
 			if(typer_ && address == 0xeb1e && operation == CPU::MOS6502::BusOperation::ReadOpcode) {
 				if(!typer_->type_next_character()) {
 					clear_all_keys();
 					typer_.reset();
 				}
 			}
-			if(!tape_is_sleeping_ && !hold_tape_) tape_->run_for(Cycles(1));
+			if(!tape_is_sleeping_ && !hold_tape_) tape_ += Cycles(1);
 			if(c1540_) c1540_->run_for(Cycles(1));
 
 			return Cycles(1);
 		}
 
+		Cycles get_idle_limit() {
+			// The C1540 and the typer need to see every cycle; otherwise interrupts can change only when
+			// one of the VIAs, or the tape, which is wired to the keyboard VIA, next acts.
+			if(c1540_ || typer_ || use_fast_tape_hack_) return Cycles(0);
+
+			const int via_limit = std::min(
+				user_port_via_.get_time_until_sequence_point(),
+				keyboard_via_.get_time_until_sequence_point()).as_int();
+			Cycles limit((via_limit + 1) >> 1);
+			if(!tape_is_sleeping_ && !hold_tape_) limit = std::min(limit, tape_.get_time_until_sequence_point());
+			return limit;
+		}
+
+		bool is_static_address(uint16_t address) {
+			// Everything outside of the IO area is either memory or unmapped.
+			return (address&0xfc00) != 0x9000;
+		}
+
+		Cycles perform_idle_cycles(Cycles cycles) {
+			cycles_since_mos6560_update_ += cycles;
+			user_port_via_ += cycles;
+			keyboard_via_ += cycles;
+			if(!tape_is_sleeping_ && !hold_tape_) tape_ += cycles;
+			return cycles;
+		}
+
 		void flush() {
 			update_video();
 			mos6560_->flush();
@@ -640,8 +667,8 @@ class ConcreteMachine:
 		}
 
 		void mos6522_did_change_interrupt_status(void *mos6522) override final {
-			m6502_.set_nmi_line(user_port_via_.get_interrupt_line());
-			m6502_.set_irq_line(keyboard_via_.get_interrupt_line());
+			m6502_.set_nmi_line(user_port_via_.last_valid()->get_interrupt_line());
+			m6502_.set_irq_line(keyboard_via_.last_valid()->get_interrupt_line());
 		}
 
 		void type_string(const std::string &string) override final {
@@ -650,7 +677,7 @@ class ConcreteMachine:
 		}
 
 		void tape_did_change_input(Storage::Tape::BinaryTapePlayer *tape) override final {
-			keyboard_via_.set_control_line_input(MOS::MOS6522::Port::A, MOS::MOS6522::Line::One, !tape->get_input());
+			keyboard_via_->set_control_line_input(MOS::MOS6522::Port::A, MOS::MOS6522::Line::One, !tape->get_input());
 		}
 
 		KeyboardMapper *get_keyboard_mapper() override {
@@ -738,11 +765,12 @@ class ConcreteMachine:
 		std::shared_ptr<SerialPort> serial_port_;
 		std::shared_ptr<::Commodore::Serial::Bus> serial_bus_;
 
-		MOS::MOS6522::MOS6522<UserPortVIA> user_port_via_;
-		MOS::MOS6522::MOS6522<KeyboardVIA> keyboard_via_;
+		// The VIAs and tape are clocked only upon access and when they next might act.
+		JustInTimeActor<MOS::MOS6522::MOS6522<UserPortVIA>> user_port_via_;
+		JustInTimeActor<MOS::MOS6522::MOS6522<KeyboardVIA>> keyboard_via_;
 
 		// Tape
-		std::shared_ptr<Storage::Tape::BinaryTapePlayer> tape_;
+		JustInTimeActor<Storage::Tape::BinaryTapePlayer, Cycles> tape_;
 		bool use_fast_tape_hack_ = false;
 		bool hold_tape_ = false;
 		bool allow_fast_tape_hack_ = false;
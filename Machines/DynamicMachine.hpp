@@ -15,6 +15,7 @@
 #include "CRTMachine.hpp"
 #include "JoystickMachine.hpp"
 #include "KeyboardMachine.hpp"
+#include "SnapshotMachine.hpp"
 #include "Utility/Typer.hpp"
 
 namespace Machine {
@@ -32,6 +33,7 @@ struct DynamicMachine {
 	virtual JoystickMachine::Machine *joystick_machine() = 0;
 	virtual KeyboardMachine::Machine *keyboard_machine() = 0;
 	virtual MediaTarget::Machine *media_target() = 0;
+	virtual SnapshotMachine::Machine *snapshot_machine() = 0;
 
 	/*!
 		Provides a raw pointer to the underlying machine if and only if this dynamic machine really is
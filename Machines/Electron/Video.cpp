@@ -50,6 +50,11 @@ VideoOutput::VideoOutput(uint8_t *memory) : ram_(memory) {
 			"uint texValue = texture(sampler, coordinate).r;"
 			"return vec3( uvec3(texValue) & uvec3(4u, 2u, 1u));"
 		"}");
+	crt_->set_software_rgb_sampling_function([] (const uint8_t *sample, float *rgb) {
+		rgb[0] = (*sample & 4) ? 1.0f : 0.0f;
+		rgb[1] = (*sample & 2) ? 1.0f : 0.0f;
+		rgb[2] = (*sample & 1) ? 1.0f : 0.0f;
+	});
 	// TODO: as implied below, I've introduced a clock's latency into the graphics pipeline somehow. Investigate.
 	crt_->set_visible_area(crt_->get_rect_for_area(first_graphics_line - 1, 256, (first_graphics_cycle+1) * crt_cycles_multiplier, 80 * crt_cycles_multiplier, 4.0f / 3.0f));
 }
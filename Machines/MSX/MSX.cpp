@@ -9,6 +9,7 @@
 #include "MSX.hpp"
 
 #include <algorithm>
+#include <limits>
 
 #include "DiskROM.hpp"
 #include "Keyboard.hpp"
@@ -51,7 +52,7 @@ namespace MSX {
 
 std::vector<std::unique_ptr<Configurable::Option>> get_options() {
 	return Configurable::standard_options(
-		static_cast<Configurable::StandardOptions>(Configurable::DisplayRGB | Configurable::DisplaySVideo | Configurable::DisplayComposite | Configurable::QuickLoadTape)
+		static_cast<Configurable::StandardOptions>(Configurable::DisplayRGB | Configurable::DisplaySVideo | Configurable::DisplayComposite | Configurable::QuickLoadTape | Configurable::Stereo)
 	);
 }
 
@@ -554,6 +555,20 @@ class ConcreteMachine:
 			return addition;
 		}
 
+		HalfCycles get_idle_limit() {
+			// Halted fetches can be skipped only if they would be plain memory reads, with nothing to observe them
+			// in perform_machine_cycle; if so then the VDP provides the only interrupt input.
+			const uint16_t pc = z80_.get_value_of_register(CPU::Z80::Register::ProgramCounter);
+			if(use_fast_tape_ || !pc || !read_pointers_[pc >> 13] || read_pointers_[pc >> 13] == unpopulated_) return HalfCycles(0);
+
+			if(time_until_interrupt_ > 0) return time_until_interrupt_;
+			return HalfCycles(std::numeric_limits<int>::max());
+		}
+
+		HalfCycles get_opcode_fetch_penalty() {
+			return HalfCycles(2);
+		}
+
 		void flush() {
 			vdp_->run_for(time_since_vdp_update_.flush());
 			update_audio();
@@ -598,12 +613,18 @@ class ConcreteMachine:
 			if(Configurable::get_display(selections_by_option, display)) {
 				set_video_signal_configurable(display);
 			}
+
+			Configurable::StereoLayout layout;
+			if(Configurable::get_stereo_layout(selections_by_option, layout)) {
+				set_stereo_layout(layout);
+			}
 		}
 
 		Configurable::SelectionSet get_accurate_selections() override {
 			Configurable::SelectionSet selection_set;
 			Configurable::append_quick_load_tape_selection(selection_set, false);
 			Configurable::append_display_selection(selection_set, Configurable::Display::Composite);
+			Configurable::append_stereo_layout_selection(selection_set, Configurable::StereoLayout::Mono);
 			return selection_set;
 		}
 
@@ -611,9 +632,19 @@ class ConcreteMachine:
 			Configurable::SelectionSet selection_set;
 			Configurable::append_quick_load_tape_selection(selection_set, true);
 			Configurable::append_display_selection(selection_set, Configurable::Display::RGB);
+			Configurable::append_stereo_layout_selection(selection_set, Configurable::StereoLayout::Mono);
 			return selection_set;
 		}
 
+		/// Places the AY's channels as per @c layout; a standard MSX is mono, so the SCC and key click are always centred.
+		void set_stereo_layout(Configurable::StereoLayout layout) {
+			switch(layout) {
+				case Configurable::StereoLayout::Mono:	ay_.set_output_mixing(1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f);	break;
+				case Configurable::StereoLayout::ABC:	ay_.set_output_mixing(1.0f, 0.5f, 0.0f, 0.0f, 0.5f, 1.0f);	break;
+				case Configurable::StereoLayout::ACB:	ay_.set_output_mixing(1.0f, 0.0f, 0.5f, 0.0f, 1.0f, 0.5f);	break;
+			}
+		}
+
 		// MARK: - Sleeper
 		void set_component_prefers_clocking(ClockingHint::Source *component, ClockingHint::Preference clocking) override {
 			tape_player_is_sleeping_ = tape_player_.preferred_clocking() == ClockingHint::Preference::None;
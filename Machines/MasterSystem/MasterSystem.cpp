@@ -16,6 +16,7 @@
 #include "../CRTMachine.hpp"
 #include "../JoystickMachine.hpp"
 #include "../KeyboardMachine.hpp"
+#include "../SnapshotMachine.hpp"
 
 #include "../../ClockReceiver/ForceInline.hpp"
 
@@ -86,7 +87,8 @@ class ConcreteMachine:
 	public KeyboardMachine::Machine,
 	public Inputs::Keyboard::Delegate,
 	public Configurable::Device,
-	public JoystickMachine::Machine {
+	public JoystickMachine::Machine,
+	public SnapshotMachine::Machine {
 
 	public:
 		ConcreteMachine(const Analyser::Static::Sega::Target &target, const ROMMachine::ROMFetcher &rom_fetcher) :
@@ -150,6 +152,7 @@ class ConcreteMachine:
 				map(read_pointers_, ram_, 1024, 0xc000, 0x10000);
 				map(write_pointers_, ram_, 1024, 0xc000, 0x10000);
 			}
+			update_direct_memory();
 
 			// Apple a relatively low low-pass filter. More guidance needed here.
 			speaker_.set_high_frequency_cutoff(8000);
@@ -197,6 +200,15 @@ class ConcreteMachine:
 			time_since_vdp_update_ += cycle.length;
 			time_since_sn76489_update_ += cycle.length;
 
+			// Count down to the next interrupt before acting, as any VDP access below will reset the countdown
+			// relative to the end of this cycle.
+			if(time_until_interrupt_ > 0) {
+				time_until_interrupt_ -= cycle.length;
+				if(time_until_interrupt_ <= HalfCycles(0)) {
+					z80_.set_interrupt_line(true, time_until_interrupt_);
+				}
+			}
+
 			if(cycle.is_terminal()) {
 				uint16_t address = cycle.address ? *cycle.address : 0x0000;
 				switch(cycle.operation) {
@@ -324,13 +336,6 @@ class ConcreteMachine:
 				}
 			}
 
-			if(time_until_interrupt_ > 0) {
-				time_until_interrupt_ -= cycle.length;
-				if(time_until_interrupt_ <= HalfCycles(0)) {
-					z80_.set_interrupt_line(true, time_until_interrupt_);
-				}
-			}
-
 			// The pause button is debounced and takes effect only one line before pixels
 			// begin; time_until_debounce_ keeps track of the time until then.
 			time_until_debounce_ -= cycle.length;
@@ -343,6 +348,12 @@ class ConcreteMachine:
 			return HalfCycles(0);
 		}
 
+		HalfCycles get_idle_limit() {
+			// Nothing can change the Z80's interrupt inputs before the next VDP interrupt or pause debounce.
+			if(time_until_interrupt_ > 0) return std::min(time_until_interrupt_, time_until_debounce_);
+			return time_until_debounce_;
+		}
+
 		void flush() {
 			update_video();
 			update_audio();
@@ -394,6 +405,38 @@ class ConcreteMachine:
 			return selection_set;
 		}
 
+		// MARK: - Snapshots.
+		void serialise(Storage::State::Serialiser &serialiser) override {
+			// The VDP exists only once output has been set up.
+			if(!vdp_) {
+				serialiser.set_invalid();
+				return;
+			}
+
+			// Bring the VDP and SN76489 up to date, and complete all pending audio work.
+			flush();
+			audio_queue_.flush();
+
+			serialiser.begin_section("SMS ", 1);
+
+			z80_.serialise(serialiser);
+			vdp_->serialise(serialiser);
+			sn76489_.serialise(serialiser);
+
+			serialiser.field(ram_);
+			serialiser.field(paging_registers_);
+			serialiser.field(memory_control_);
+			serialiser.field(io_port_control_);
+
+			serialiser.field(time_since_sn76489_update_);
+			serialiser.field(time_until_interrupt_);
+			serialiser.field(time_until_debounce_);
+
+			serialiser.end_section();
+
+			if(!serialiser.is_capturing()) page_cartridge();
+		}
+
 	private:
 		inline uint8_t get_th_values() {
 			// Quick not on TH inputs here: if either is setup as an output, then the
@@ -417,7 +460,7 @@ class ConcreteMachine:
 		Target::Model model_;
 		Target::Region region_;
 		Target::PagingScheme paging_scheme_;
-		CPU::Z80::Processor<ConcreteMachine, false, false> z80_;
+		CPU::Z80::Processor<ConcreteMachine, false, false, true> z80_;
 		std::unique_ptr<TI::TMS::TMS9918> vdp_;
 
 		Concurrency::DeferringAsyncTaskQueue audio_queue_;
@@ -476,6 +519,19 @@ class ConcreteMachine:
 			if(has_bios() && !(memory_control_ & 0x08)) {
 				map(read_pointers_, bios_, 8*1024, 0);
 			}
+
+			update_direct_memory();
+		}
+
+		/*!
+			Offers all mapped memory to the Z80 for direct access, other than writes to the final 1kb if
+			it contains Sega paging registers. Codemasters paging registers are in ROM, which is never writeable.
+		*/
+		void update_direct_memory() {
+			for(int c = 0; c < 64; ++c) {
+				const bool is_paging_page = paging_scheme_ == Target::PagingScheme::Sega && c == 63;
+				z80_.set_direct_memory(static_cast<uint16_t>(c << 10), read_pointers_[c], is_paging_page ? nullptr : write_pointers_[c]);
+			}
 		}
 		bool has_bios() {
 			return is_master_system(model_) && region_ != Target::Region::Japan;
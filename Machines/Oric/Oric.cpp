@@ -16,6 +16,7 @@
 #include "../MediaTarget.hpp"
 #include "../CRTMachine.hpp"
 #include "../KeyboardMachine.hpp"
+#include "../SnapshotMachine.hpp"
 
 #include "../Utility/MemoryFuzzer.hpp"
 #include "../Utility/StringSerialiser.hpp"
@@ -29,11 +30,13 @@
 #include "../../Storage/Tape/Parsers/Oric.hpp"
 
 #include "../../ClockReceiver/ForceInline.hpp"
+#include "../../ClockReceiver/JustInTime.hpp"
 #include "../../Configurable/StandardOptions.hpp"
 #include "../../Outputs/Speaker/Implementation/LowpassSpeaker.hpp"
 
 #include "../../Analyser/Static/Oric/Target.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -87,6 +90,12 @@ class Keyboard {
 			return !!(rows_[row_] & column_mask);
 		}
 
+		/// Captures or restores the active row; key states are user input and are not included.
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialiser.field(row_);
+			row_ &= 7;
+		}
+
 	private:
 		uint8_t row_ = 0;
 		uint8_t rows_[8];
@@ -122,7 +131,7 @@ class TapePlayer: public Storage::Tape::BinaryTapePlayer {
 */
 class VIAPortHandler: public MOS::MOS6522::IRQDelegatePortHandler {
 	public:
-		VIAPortHandler(Concurrency::DeferringAsyncTaskQueue &audio_queue, GI::AY38910::AY38910 &ay8910, Outputs::Speaker::LowpassSpeaker<GI::AY38910::AY38910> &speaker, TapePlayer &tape_player, Keyboard &keyboard) :
+		VIAPortHandler(Concurrency::DeferringAsyncTaskQueue &audio_queue, GI::AY38910::AY38910 &ay8910, Outputs::Speaker::LowpassSpeaker<GI::AY38910::AY38910> &speaker, JustInTimeActor<TapePlayer, Cycles> &tape_player, Keyboard &keyboard) :
 			audio_queue_(audio_queue), ay8910_(ay8910), speaker_(speaker), tape_player_(tape_player), keyboard_(keyboard) {}
 
 		/*!
@@ -144,7 +153,7 @@ class VIAPortHandler: public MOS::MOS6522::IRQDelegatePortHandler {
 		void set_port_output(MOS::MOS6522::Port port, uint8_t value, uint8_t direction_mask)  {
 			if(port) {
 				keyboard_.set_active_row(value);
-				tape_player_.set_motor_control(value & 0x40);
+				tape_player_->set_motor_control(value & 0x40);
 			} else {
 				update_ay();
 				ay8910_.set_data_input(value);
@@ -176,6 +185,13 @@ class VIAPortHandler: public MOS::MOS6522::IRQDelegatePortHandler {
 			audio_queue_.perform();
 		}
 
+		/// Captures or restores the AY control lines and pending AY time.
+		void serialise(Storage::State::Serialiser &serialiser) {
+			serialiser.field(ay_bdir_);
+			serialiser.field(ay_bc1_);
+			serialiser.field(cycles_since_ay_update_);
+		}
+
 	private:
 		void update_ay() {
 			speaker_.run_for(audio_queue_, cycles_since_ay_update_.flush());
@@ -187,7 +203,7 @@ class VIAPortHandler: public MOS::MOS6522::IRQDelegatePortHandler {
 		Concurrency::DeferringAsyncTaskQueue &audio_queue_;
 		GI::AY38910::AY38910 &ay8910_;
 		Outputs::Speaker::LowpassSpeaker<GI::AY38910::AY38910> &speaker_;
-		TapePlayer &tape_player_;
+		JustInTimeActor<TapePlayer, Cycles> &tape_player_;
 		Keyboard &keyboard_;
 };
 
@@ -203,6 +219,7 @@ template <Analyser::Static::Oric::Target::DiskInterface disk_interface> class Co
 	public Microdisc::Delegate,
 	public ClockingHint::Observer,
 	public Activity::Source,
+	public SnapshotMachine::Machine,
 	public Machine {
 
 	public:
@@ -215,7 +232,7 @@ template <Analyser::Static::Oric::Target::DiskInterface disk_interface> class Co
 				diskii_(2000000) {
 			set_clock_rate(1000000);
 			via_port_handler_.set_interrupt_delegate(this);
-			tape_player_.set_delegate(this);
+			tape_player_->set_delegate(this);
 			Memory::Fuzz(ram_, sizeof(ram_));
 
 			if(disk_interface == Analyser::Static::Oric::Target::DiskInterface::Pravetz) {
@@ -318,7 +335,7 @@ template <Analyser::Static::Oric::Target::DiskInterface disk_interface> class Co
 			bool inserted = false;
 
 			if(!media.tapes.empty()) {
-				tape_player_.set_tape(media.tapes.front());
+				tape_player_->set_tape(media.tapes.front());
 				inserted = true;
 			}
 
@@ -359,10 +376,10 @@ template <Analyser::Static::Oric::Target::DiskInterface disk_interface> class Co
 					paged_rom_ == rom_.data() &&
 					use_fast_tape_hack_ &&
 					operation == CPU::MOS6502::BusOperation::ReadOpcode &&
-					tape_player_.has_tape() &&
-					!tape_player_.get_tape()->is_at_end()) {
+					tape_player_->has_tape() &&
+					!tape_player_->get_tape()->is_at_end()) {
 
-					uint8_t next_byte = tape_player_.get_next_byte(!ram_[tape_speed_address_]);
+					uint8_t next_byte = tape_player_->get_next_byte(!ram_[tape_speed_address_]);
 					m6502_.set_value_of_register(CPU::MOS6502::A, next_byte);
 					m6502_.set_value_of_register(CPU::MOS6502::Flags, next_byte ? 0 : CPU::MOS6502::Flag::Zero);
 					*value = 0x60; // i.e. RTS
@@ -370,8 +387,8 @@ template <Analyser::Static::Oric::Target::DiskInterface disk_interface> class Co
 			} else {
 				if((address & 0xff00) == 0x0300) {
 					if(address < 0x0310 || (disk_interface == Analyser::Static::Oric::Target::DiskInterface::None)) {
-						if(isReadOperation(operation)) *value = via_.get_register(address);
-						else via_.set_register(address, *value);
+						if(isReadOperation(operation)) *value = via_->get_register(address);
+						else via_->set_register(address, *value);
 					} else {
 						switch(disk_interface) {
 							default: break;
@@ -428,9 +445,9 @@ template <Analyser::Static::Oric::Target::DiskInterface disk_interface> class Co
 				if(!string_serialiser_->advance()) string_serialiser_.reset();
 			}
 
-			via_.run_for(Cycles(1));
+			via_ += Cycles(1);
 			via_port_handler_.run_for(Cycles(1));
-			tape_player_.run_for(Cycles(1));
+			tape_player_ += Cycles(1);
 			switch(disk_interface) {
 				default: break;
 				case Analyser::Static::Oric::Target::DiskInterface::Microdisc:
@@ -449,6 +466,33 @@ template <Analyser::Static::Oric::Target::DiskInterface disk_interface> class Co
 			return Cycles(1);
 		}
 
+		Cycles get_idle_limit() {
+			// Disk interfaces and the string serialiser need to see every cycle, as does the fast tape hack;
+			// otherwise interrupts can change only when the VIA, or the tape, which is wired to it, next acts.
+			if(
+				disk_interface != Analyser::Static::Oric::Target::DiskInterface::None ||
+				string_serialiser_ ||
+				use_fast_tape_hack_
+			) return Cycles(0);
+
+			return std::min(
+				Cycles((via_.get_time_until_sequence_point().as_int() + 1) >> 1),
+				tape_player_.get_time_until_sequence_point());
+		}
+
+		bool is_static_address(uint16_t address) {
+			// Everything outside of page 3 is either RAM or ROM.
+			return (address & 0xff00) != 0x0300;
+		}
+
+		Cycles perform_idle_cycles(Cycles cycles) {
+			via_ += cycles;
+			via_port_handler_.run_for(cycles);
+			tape_player_ += cycles;
+			cycles_since_video_update_ += cycles;
+			return cycles;
+		}
+
 		forceinline void flush() {
 			update_video();
 			via_port_handler_.flush();
@@ -488,7 +532,7 @@ template <Analyser::Static::Oric::Target::DiskInterface disk_interface> class Co
 		// to satisfy Storage::Tape::BinaryTapePlayer::Delegate
 		void tape_did_change_input(Storage::Tape::BinaryTapePlayer *tape_player) override final {
 			// set CB1
-			via_.set_control_line_input(MOS::MOS6522::Port::B, MOS::MOS6522::Line::One, !tape_player->get_input());
+			via_->set_control_line_input(MOS::MOS6522::Port::B, MOS::MOS6522::Line::One, !tape_player->get_input());
 		}
 
 		// for Utility::TypeRecipient::Delegate
@@ -571,6 +615,54 @@ template <Analyser::Static::Oric::Target::DiskInterface disk_interface> class Co
 			diskii_clocking_preference_ = diskii_.preferred_clocking();
 		}
 
+		// MARK: - Snapshots.
+		void serialise(Storage::State::Serialiser &serialiser) override final {
+			// Video output exists only once output has been set up.
+			if(!video_output_) {
+				serialiser.set_invalid();
+				return;
+			}
+
+			// Bring video and audio up to date, and complete all pending audio work.
+			flush();
+			audio_queue_.flush();
+
+			serialiser.begin_section("ORIC", 1);
+
+			m6502_.serialise(serialiser);
+			via_->serialise(serialiser);
+			via_port_handler_.serialise(serialiser);
+			ay8910_.serialise(serialiser);
+			keyboard_.serialise(serialiser);
+			video_output_->serialise(serialiser);
+
+			serialiser.field(ram_);
+
+			// Paging is recorded as the top of RAM plus which ROM is visible above it.
+			serialiser.field(ram_top_);
+			bool microdisc_rom_is_paged = paged_rom_ == microdisc_rom_.data();
+			serialiser.field(microdisc_rom_is_paged);
+			uint16_t pravetz_rom_base = static_cast<uint16_t>(pravetz_rom_base_pointer_);
+			serialiser.field(pravetz_rom_base);
+
+			serialiser.end_section();
+
+			if(!serialiser.is_capturing()) {
+				if(microdisc_rom_is_paged && microdisc_rom_.empty()) {
+					serialiser.set_invalid();
+					return;
+				}
+				paged_rom_ = microdisc_rom_is_paged ? microdisc_rom_.data() : rom_.data();
+				pravetz_rom_base_pointer_ = pravetz_rom_base & 0x100;
+
+				// ROM is visible from ram_top_ + 1 upwards, and is sized to reach the top of the address space.
+				const std::size_t rom_size = microdisc_rom_is_paged ? microdisc_rom_.size() : rom_.size();
+				if(static_cast<std::size_t>(0xffff - ram_top_) > rom_size) {
+					serialiser.set_invalid();
+				}
+			}
+		}
+
 	private:
 		const uint16_t basic_invisible_ram_top_ = 0xffff;
 		const uint16_t basic_visible_ram_top_ = 0xbfff;
@@ -599,12 +691,12 @@ template <Analyser::Static::Oric::Target::DiskInterface disk_interface> class Co
 		// Inputs
 		Oric::KeyboardMapper keyboard_mapper_;
 
-		// The tape
-		TapePlayer tape_player_;
+		// The tape; like the VIA, it is clocked only upon access and when it next might act.
+		JustInTimeActor<TapePlayer, Cycles> tape_player_;
 		bool use_fast_tape_hack_ = false;
 
 		VIAPortHandler via_port_handler_;
-		MOS::MOS6522::MOS6522<VIAPortHandler> via_;
+		JustInTimeActor<MOS::MOS6522::MOS6522<VIAPortHandler>> via_;
 		Keyboard keyboard_;
 
 		// the Microdisc, if in use
@@ -626,7 +718,7 @@ template <Analyser::Static::Oric::Target::DiskInterface disk_interface> class Co
 
 		// Helper to discern current IRQ state
 		inline void set_interrupt_line() {
-			bool irq_line = via_.get_interrupt_line();
+			bool irq_line = via_.last_valid()->get_interrupt_line();
 			if(disk_interface == Analyser::Static::Oric::Target::DiskInterface::Microdisc)
 				irq_line |= microdisc_.get_interrupt_request_line();
 			m6502_.set_irq_line(irq_line);
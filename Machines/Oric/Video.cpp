@@ -39,6 +39,16 @@ VideoOutput::VideoOutput(uint8_t *memory) :
 			"return (float(texValue) - 4.0) / 20.0;"
 		"}"
 	);
+	crt_->set_software_rgb_sampling_function([] (const uint8_t *sample, float *rgb) {
+		rgb[0] = (*sample & 4) ? 1.0f : 0.0f;
+		rgb[1] = (*sample & 2) ? 1.0f : 0.0f;
+		rgb[2] = (*sample & 1) ? 1.0f : 0.0f;
+	});
+	crt_->set_software_composite_sampling_function([] (const uint8_t *sample, float phase, float amplitude) {
+		const int value = sample[0] | (sample[1] << 8);
+		const int phase_index = static_cast<int>((phase + 3.141592654f + 0.39269908175f) * 2.0f / 3.141592654f) & 3;
+		return static_cast<float>(((value >> (4*(3 - phase_index))) & 15) - 4) / 20.0f;
+	});
 	crt_->set_composite_function_type(Outputs::CRT::CRT::CompositeSourceType::DiscreteFourSamplesPerCycle, 0.0f);
 
 	set_video_signal(Outputs::CRT::VideoSignal::Composite);
@@ -218,6 +228,53 @@ void VideoOutput::run_for(const Cycles cycles) {
 	}
 }
 
+int VideoOutput::pixel_line_position() {
+	const int h_counter = counter_ & 63;
+	return (counter_ < 224*64 && h_counter < 40) ? h_counter : 0;
+}
+
+void VideoOutput::serialise(Storage::State::Serialiser &serialiser) {
+	if(!serialiser.is_capturing()) {
+		const int position = pixel_line_position();
+		if(position) crt_->output_data(static_cast<unsigned int>(position * 6));
+	}
+
+	serialiser.begin_section("ORCV", 1);
+
+	serialiser.field(counter_);
+	serialiser.field(frame_counter_);
+	serialiser.field(v_sync_start_position_);
+	serialiser.field(v_sync_end_position_);
+	serialiser.field(counter_period_);
+	serialiser.field(ink_);
+	serialiser.field(paper_);
+	serialiser.field(is_graphics_mode_);
+	serialiser.field(next_frame_is_sixty_hertz_);
+	serialiser.field(use_alternative_character_set_);
+	serialiser.field(use_double_height_characters_);
+	serialiser.field(blink_text_);
+
+	serialiser.end_section();
+
+	if(!serialiser.is_capturing()) {
+		if(counter_period_ <= 0 || counter_ < 0 || counter_ >= counter_period_) {
+			serialiser.set_invalid();
+			return;
+		}
+
+		ink_ &= 7;
+		paper_ &= 7;
+		set_character_set_base_address();
+
+		// If restoration lands partway through a line of pixels, resume output into a new write area.
+		const int position = pixel_line_position();
+		if(position) {
+			pixel_target_ = reinterpret_cast<uint16_t *>(crt_->allocate_write_area(240));
+			if(pixel_target_) pixel_target_ += position * 6;
+		}
+	}
+}
+
 void VideoOutput::set_character_set_base_address() {
 	if(is_graphics_mode_) character_set_base_address_ = use_alternative_character_set_ ? 0x9c00 : 0x9800;
 	else character_set_base_address_ = use_alternative_character_set_ ? 0xb800 : 0xb400;
@@ -11,6 +11,7 @@
 
 #include "../../Outputs/CRT/CRT.hpp"
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Storage/State/Serialiser.hpp"
 
 namespace Oric {
 
@@ -22,6 +23,12 @@ class VideoOutput {
 		void set_colour_rom(const std::vector<uint8_t> &rom);
 		void set_video_signal(Outputs::CRT::VideoSignal output_device);
 
+		/*!
+			Captures or restores the video state. Upon restoration any partially-output line
+			of pixels is first posted to the CRT.
+		*/
+		void serialise(Storage::State::Serialiser &serialiser);
+
 	private:
 		uint8_t *ram_;
 		std::unique_ptr<Outputs::CRT::CRT> crt_;
@@ -40,6 +47,7 @@ class VideoOutput {
 
 		int character_set_base_address_ = 0xb400;
 		inline void set_character_set_base_address();
+		inline int pixel_line_position();
 
 		bool is_graphics_mode_ = false;
 		bool next_frame_is_sixty_hertz_ = false;
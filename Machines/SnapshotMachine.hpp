@@ -0,0 +1,77 @@
+//
+//  SnapshotMachine.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 28/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#ifndef SnapshotMachine_hpp
+#define SnapshotMachine_hpp
+
+#include "../Storage/State/Serialiser.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace SnapshotMachine {
+
+/*!
+	A snapshot machine is one that can capture its complete state into an in-memory
+	buffer, and subsequently restore it.
+
+	State is specific to the machine and configuration that produced it; it can be
+	restored only to a machine created from an equivalent target. Inserted media are
+	not part of the state.
+*/
+class Machine {
+	public:
+		/// @returns A capture of this machine's current state, or an empty vector if state can't presently be captured.
+		std::vector<uint8_t> get_state() {
+			std::vector<uint8_t> state;
+			Storage::State::Serialiser serialiser(state);
+			serialiser.begin_section("CLKS", FormatVersion);
+			serialise(serialiser);
+			serialiser.end_section();
+			if(!serialiser.is_valid()) state.clear();
+			return state;
+		}
+
+		/*!
+			Restores state previously obtained via @c get_state.
+
+			@returns @c true if the state was restored; @c false if it could not be, in which
+				case the machine's state is left as it was.
+		*/
+		bool set_state(const std::vector<uint8_t> &state) {
+			// Keep the current state, to reinstate should restoration fail part way through.
+			std::vector<uint8_t> prior_state = get_state();
+			if(prior_state.empty()) return false;
+			if(apply_state(state)) return true;
+			apply_state(prior_state);
+			return false;
+		}
+
+	protected:
+		/*!
+			Captures or restores the machine's state, depending on the serialiser's mode.
+			Implementations should begin a section of their own, bring all components up
+			to date, including any pending audio work, and then nominate every field.
+		*/
+		virtual void serialise(Storage::State::Serialiser &serialiser) = 0;
+
+	private:
+		static const int FormatVersion = 1;
+
+		bool apply_state(const std::vector<uint8_t> &state) {
+			Storage::State::Serialiser serialiser(state);
+			serialiser.begin_section("CLKS", FormatVersion);
+			serialise(serialiser);
+			serialiser.end_section();
+			return serialiser.is_valid();
+		}
+};
+
+}
+
+#endif /* SnapshotMachine_hpp */
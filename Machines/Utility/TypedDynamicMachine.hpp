@@ -49,6 +49,10 @@ template<typename T> class TypedDynamicMachine: public ::Machine::DynamicMachine
 			return get<Configurable::Device>();
 		}
 
+		SnapshotMachine::Machine *snapshot_machine() override {
+			return get<SnapshotMachine::Machine>();
+		}
+
 		void *raw_pointer() override {
 			return get();
 		}
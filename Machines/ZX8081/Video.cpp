@@ -30,6 +30,9 @@ Video::Video() :
 		"{"
 			"return texture(sampler, coordinate).r;"
 		"}");
+	crt_->set_software_composite_sampling_function([] (const uint8_t *sample, float phase, float amplitude) {
+		return *sample ? 1.0f : 0.0f;
+	});
 
 	// Show only the centre 80% of the TV frame.
 	crt_->set_video_signal(Outputs::CRT::VideoSignal::Composite);
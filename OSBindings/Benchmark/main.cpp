@@ -0,0 +1,693 @@
+//
+//  main.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 27/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../Analyser/Static/StaticAnalyser.hpp"
+#include "../../Analyser/Static/Acorn/Target.hpp"
+#include "../../Analyser/Static/AmstradCPC/Target.hpp"
+#include "../../Analyser/Static/AppleII/Target.hpp"
+#include "../../Analyser/Static/Atari/Target.hpp"
+#include "../../Analyser/Static/Commodore/Target.hpp"
+#include "../../Analyser/Static/MSX/Target.hpp"
+#include "../../Analyser/Static/Oric/Target.hpp"
+#include "../../Analyser/Static/Sega/Target.hpp"
+#include "../../Analyser/Static/ZX8081/Target.hpp"
+
+#include "../../Machines/Utility/MachineForTarget.hpp"
+#include "../../Machines/CRTMachine.hpp"
+#include "../../Machines/SnapshotMachine.hpp"
+
+#include "../../Components/9918/9918.hpp"
+#include "../../Components/AY38910/AY38910.hpp"
+#include "../../Machines/Atari2600/TIA.hpp"
+#include "../../Machines/Atari2600/TIASound.hpp"
+#include "../../Outputs/CRT/CRT.hpp"
+#include "../../Processors/6502/AllRAM/6502AllRAM.hpp"
+#include "../../Processors/Z80/AllRAM/Z80AllRAM.hpp"
+#include "../../Storage/Disk/Track/PCMSegment.hpp"
+
+/*
+	Measures emulation throughput: of each machine as a whole, in emulated cycles per wall-clock second,
+	and of the hottest individual components, in whatever unit is natural to each.
+
+	Results are written to standard output as CSV, one benchmark per line, with the columns:
+
+		name, unit, count, seconds, per_second, realtime_multiple
+
+	realtime_multiple is empty if the benchmark has no natural real-time rate.
+*/
+
+namespace {
+
+struct Result {
+	std::string name;
+	std::string unit;
+	double count = 0.0;
+	double seconds = 0.0;
+	double realtime_rate = 0.0;		// In units per second; zero if not applicable.
+};
+
+struct Options {
+	double seconds_per_benchmark = 1.0;
+	std::string filter;
+	std::string rom_path;
+	std::string functional_test;
+	std::vector<std::string> file_names;
+};
+
+void print_header() {
+	std::cout << "name,unit,count,seconds,per_second,realtime_multiple" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+}
+
+void print_result(const Result &result) {
+	const double per_second = result.seconds > 0.0 ? result.count / result.seconds : 0.0;
+	std::cout << result.name << ',' << result.unit << ',' << static_cast<long long>(result.count) << ',' << result.seconds << ',' << per_second << ',';
+	if(result.realtime_rate > 0.0) std::cout << (per_second / result.realtime_rate);
+	std::cout << std::endl;
+}
+
+/*!
+	Calls @c batch repeatedly until at least @c seconds of wall-clock time have elapsed, summing
+	the number of units of work that each call reports having done. One initial call is made
+	outside of the timed period, to allow for any one-time costs.
+*/
+void measure(Result &result, double seconds, const std::function<double(void)> &batch) {
+	batch();
+
+	const auto start_time = std::chrono::high_resolution_clock::now();
+	double elapsed = 0.0;
+	do {
+		result.count += batch();
+		elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+	} while(elapsed < seconds);
+	result.seconds = elapsed;
+}
+
+// MARK: - Whole machines.
+
+/// Receives and discards all audio, so that speakers do their usual work.
+struct SpeakerDelegate: public Outputs::Speaker::Speaker::Delegate {
+	void speaker_did_complete_samples(Outputs::Speaker::Speaker *speaker, const std::vector<int16_t> &buffer) override {}
+};
+
+ROMMachine::ROMFetcher rom_fetcher(const Options &options) {
+	// As per the SDL binding, look for ROMs in /usr/local/share/CLK/, /usr/share/CLK/ and then any user-supplied path.
+	std::vector<std::string> paths = {
+		"/usr/local/share/CLK/",
+		"/usr/share/CLK/"
+	};
+	if(!options.rom_path.empty()) {
+		paths.push_back(options.rom_path.back() == '/' ? options.rom_path : options.rom_path + "/");
+	}
+
+	return [paths] (const std::string &machine, const std::vector<std::string> &names) -> std::vector<std::unique_ptr<std::vector<uint8_t>>> {
+		std::vector<std::unique_ptr<std::vector<uint8_t>>> results;
+		for(const auto &name: names) {
+			FILE *file = nullptr;
+			for(const auto &path: paths) {
+				std::string local_path = path + machine + "/" + name;
+				file = std::fopen(local_path.c_str(), "rb");
+				if(file) break;
+			}
+
+			if(!file) {
+				results.emplace_back(nullptr);
+				continue;
+			}
+
+			std::unique_ptr<std::vector<uint8_t>> data(new std::vector<uint8_t>);
+
+			std::fseek(file, 0, SEEK_END);
+			data->resize(std::ftell(file));
+			std::fseek(file, 0, SEEK_SET);
+			std::size_t read = fread(data->data(), 1, data->size(), file);
+			std::fclose(file);
+
+			if(read == data->size())
+				results.emplace_back(std::move(data));
+			else
+				results.emplace_back(nullptr);
+		}
+		return results;
+	};
+}
+
+/*!
+	Runs the machine described by @c targets for the benchmark period, in slices of a hundredth of an emulated second,
+	with its audio and video output being generated as usual, and reports the result as @c name. The machine is then
+	run again in turbo mode, with only one field in ten composed and audio discarded.
+
+	If the machine supports snapshots then the costs of capturing and of restoring its state are also reported.
+*/
+void benchmark_machine(const std::string &name, const Analyser::Static::TargetList &targets, const Options &options) {
+	::Machine::Error error;
+	std::unique_ptr<::Machine::DynamicMachine> machine(::Machine::MachineForTargets(targets, rom_fetcher(options), error));
+	if(!machine) {
+		std::cerr << name << ": skipped; " << ((error == ::Machine::Error::MissingROM) ? "ROMs not found" : "machine could not be created") << std::endl;
+		return;
+	}
+
+	CRTMachine::Machine *const crt_machine = machine->crt_machine();
+	crt_machine->setup_output(4.0 / 3.0);
+
+	SpeakerDelegate speaker_delegate;
+	Outputs::Speaker::Speaker *const speaker = crt_machine->get_speaker();
+	if(speaker) {
+		speaker->set_output_rate(44100, 1024);
+		speaker->set_delegate(&speaker_delegate);
+	}
+
+	Result result;
+	result.name = "machine/" + name;
+	result.unit = "cycles";
+	result.realtime_rate = crt_machine->get_clock_rate();
+
+	const Time::Seconds slice = 0.01;
+	const auto run_slice = [crt_machine, slice] {
+		crt_machine->run_for(slice);
+		crt_machine->get_crt()->discard_frame();
+		return slice * crt_machine->get_clock_rate();
+	};
+	measure(result, options.seconds_per_benchmark, run_slice);
+
+	Result turbo;
+	turbo.name = "machine/" + name + "/turbo";
+	turbo.unit = result.unit;
+	turbo.realtime_rate = result.realtime_rate;
+	crt_machine->set_turbo_mode(true, 10, 0.0f);
+	measure(turbo, options.seconds_per_benchmark, run_slice);
+	crt_machine->set_turbo_mode(false, 1, 1.0f);
+
+	std::vector<Result> snapshot_results;
+	SnapshotMachine::Machine *const snapshot_machine = machine->snapshot_machine();
+	if(snapshot_machine) {
+		const std::vector<uint8_t> state = snapshot_machine->get_state();
+
+		Result capture;
+		capture.name = "snapshot/" + name + "/capture";
+		capture.unit = "snapshots";
+		measure(capture, options.seconds_per_benchmark, [snapshot_machine] {
+			snapshot_machine->get_state();
+			return 1.0;
+		});
+		snapshot_results.push_back(capture);
+
+		Result restore;
+		restore.name = "snapshot/" + name + "/restore";
+		restore.unit = "snapshots";
+		bool did_restore = true;
+		measure(restore, options.seconds_per_benchmark, [snapshot_machine, &state, &did_restore] {
+			did_restore &= snapshot_machine->set_state(state);
+			return 1.0;
+		});
+		if(did_restore) {
+			snapshot_results.push_back(restore);
+		} else {
+			std::cerr << name << ": snapshot could not be restored" << std::endl;
+		}
+	}
+
+	// Destroy the machine, and thereby wait for any outstanding audio work, before reporting.
+	machine.reset();
+	print_result(result);
+	print_result(turbo);
+	for(const auto &snapshot_result: snapshot_results) print_result(snapshot_result);
+}
+
+template <typename TargetType> std::unique_ptr<Analyser::Static::Target> target(Analyser::Machine machine) {
+	std::unique_ptr<Analyser::Static::Target> target(new TargetType);
+	target->machine = machine;
+	return target;
+}
+
+/*!
+	@returns A cartridge containing @c program, padded with @c nop to @c size bytes and appearing at @c origin.
+		If @c reset_vector is set, the 6502 reset vector in the final bytes of the cartridge is pointed at @c origin.
+*/
+std::shared_ptr<Storage::Cartridge::Cartridge> cartridge(const std::vector<uint8_t> &program, std::size_t size, uint16_t origin, uint8_t nop, bool reset_vector) {
+	std::vector<uint8_t> data(size, nop);
+	std::copy(program.begin(), program.end(), data.begin());
+	if(reset_vector) {
+		data[size - 4] = static_cast<uint8_t>(origin);
+		data[size - 3] = static_cast<uint8_t>(origin >> 8);
+	}
+
+	std::vector<Storage::Cartridge::Cartridge::Segment> segments;
+	segments.emplace_back(origin, data);
+	return std::shared_ptr<Storage::Cartridge::Cartridge>(new Storage::Cartridge::Cartridge(segments));
+}
+
+void benchmark_machines(const Options &options, const std::function<bool(const std::string &)> &is_selected) {
+	// Machines that can start without media are run as they boot and idle; cartridge-only machines
+	// are supplied with a minimal cartridge that produces a stable display.
+	struct MachineBenchmark {
+		std::string name;
+		std::function<std::unique_ptr<Analyser::Static::Target>(void)> target;
+	};
+	std::vector<MachineBenchmark> benchmarks = {
+		{"AmstradCPC", [] { return target<Analyser::Static::AmstradCPC::Target>(Analyser::Machine::AmstradCPC); }},
+		{"AppleII", [] { return target<Analyser::Static::AppleII::Target>(Analyser::Machine::AppleII); }},
+		{"Atari2600", [] {
+			auto result = target<Analyser::Static::Atari::Target>(Analyser::Machine::Atari2600);
+
+			// Three lines of vertical sync, then 256 lines each of a different background colour, repeated forever.
+			result->media.cartridges.push_back(cartridge({
+				0x78, 0xd8, 0xa2, 0xff, 0x9a,				// SEI; CLD; LDX #$ff; TXS
+				0xa9, 0x02, 0x85, 0x00,						// frame: LDA #2; STA VSYNC
+				0x85, 0x02, 0x85, 0x02, 0x85, 0x02,			// STA WSYNC; STA WSYNC; STA WSYNC
+				0xa9, 0x00, 0x85, 0x00, 0xa0, 0x00,			// LDA #0; STA VSYNC; LDY #0
+				0x84, 0x09, 0x85, 0x02, 0x88, 0xd0, 0xf9,	// line: STY COLUBK; STA WSYNC; DEY; BNE line
+				0x4c, 0x05, 0xf0							// JMP frame
+			}, 4096, 0xf000, 0xea, true));
+			return result;
+		}},
+		{"ColecoVision", [] { return target<Analyser::Static::Target>(Analyser::Machine::ColecoVision); }},
+		{"Electron", [] { return target<Analyser::Static::Acorn::Target>(Analyser::Machine::Electron); }},
+		{"MasterSystem", [] {
+			auto result = target<Analyser::Static::Sega::Target>(Analyser::Machine::MasterSystem);
+
+			// Enable the display, then spin.
+			result->media.cartridges.push_back(cartridge({
+				0xf3,							// DI
+				0x3e, 0x40, 0xd3, 0xbf,			// LD A, $40; OUT ($bf), A
+				0x3e, 0x81, 0xd3, 0xbf,			// LD A, $81; OUT ($bf), A
+				0x18, 0xfe						// JR $
+			}, 32768, 0x0000, 0x00, false));
+			return result;
+		}},
+		{"MSX", [] { return target<Analyser::Static::MSX::Target>(Analyser::Machine::MSX); }},
+		{"Oric", [] { return target<Analyser::Static::Oric::Target>(Analyser::Machine::Oric); }},
+		{"Vic20", [] { return target<Analyser::Static::Commodore::Target>(Analyser::Machine::Vic20); }},
+		{"ZX80", [] { return target<Analyser::Static::ZX8081::Target>(Analyser::Machine::ZX8081); }},
+		{"ZX81", [] {
+			auto result = target<Analyser::Static::ZX8081::Target>(Analyser::Machine::ZX8081);
+			static_cast<Analyser::Static::ZX8081::Target *>(result.get())->is_ZX81 = true;
+			return result;
+		}},
+	};
+
+	for(const auto &benchmark: benchmarks) {
+		if(!is_selected("machine/" + benchmark.name)) continue;
+
+		Analyser::Static::TargetList targets;
+		targets.push_back(benchmark.target());
+		benchmark_machine(benchmark.name, targets, options);
+	}
+
+	// Also run anything supplied on the command line.
+	for(const auto &file_name: options.file_names) {
+		const std::string name = file_name.substr(file_name.find_last_of("/\\") + 1);
+		if(!is_selected("machine/" + name)) continue;
+
+		Analyser::Static::TargetList targets = Analyser::Static::GetTargets(file_name);
+		if(targets.empty()) {
+			std::cerr << name << ": skipped; no target machine found" << std::endl;
+			continue;
+		}
+		benchmark_machine(name, targets, options);
+	}
+}
+
+// MARK: - Components.
+
+void benchmark_z80(const Options &options, bool coalesces_bus_cycles) {
+	std::unique_ptr<CPU::Z80::AllRAMProcessor> z80(CPU::Z80::AllRAMProcessor::Processor(coalesces_bus_cycles));
+
+	// Sum a page of memory into itself, forever.
+	const uint8_t program[] = {
+		0x21, 0x00, 0x80,	// start: LD HL, $8000
+		0x06, 0x00,			// LD B, 0
+		0x7e,				// loop: LD A, (HL)
+		0x80,				// ADD A, B
+		0x77,				// LD (HL), A
+		0x23,				// INC HL
+		0x10, 0xfa,			// DJNZ loop
+		0xc3, 0x00, 0x00	// JP start
+	};
+	z80->set_data_at_address(0x0000, sizeof(program), program);
+	z80->set_value_of_register(CPU::Z80::Register::ProgramCounter, 0x0000);
+
+	Result result;
+	result.name = coalesces_bus_cycles ? "component/Z80/coalesced" : "component/Z80";
+	result.unit = "cycles";
+	result.realtime_rate = 3500000.0;
+	measure(result, options.seconds_per_benchmark, [&z80] {
+		z80->run_for(Cycles(100000));
+		return 100000.0;
+	});
+	print_result(result);
+}
+
+void benchmark_6502(const Options &options) {
+	std::unique_ptr<CPU::MOS6502::AllRAMProcessor> m6502(CPU::MOS6502::AllRAMProcessor::Processor(CPU::MOS6502::Personality::P6502));
+
+	// Increment each byte of a page of memory, forever.
+	const uint8_t program[] = {
+		0xa2, 0x00,			// start: LDX #0
+		0xbd, 0x00, 0x02,	// loop: LDA $0200, X
+		0x69, 0x01,			// ADC #1
+		0x9d, 0x00, 0x02,	// STA $0200, X
+		0xe8,				// INX
+		0xd0, 0xf5,			// BNE loop
+		0x4c, 0x00, 0x04	// JMP start
+	};
+	const uint8_t reset_vector[] = {0x00, 0x04};
+	m6502->set_data_at_address(0x0400, sizeof(program), program);
+	m6502->set_data_at_address(0xfffc, sizeof(reset_vector), reset_vector);
+	m6502->set_value_of_register(CPU::MOS6502::Register::ProgramCounter, 0x0400);
+
+	Result result;
+	result.name = "component/6502";
+	result.unit = "cycles";
+	result.realtime_rate = 1000000.0;
+	measure(result, options.seconds_per_benchmark, [&m6502] {
+		m6502->run_for(Cycles(100000));
+		return 100000.0;
+	});
+	print_result(result);
+}
+
+void benchmark_6502_functional_test(const Options &options) {
+	if(options.functional_test.empty()) {
+		std::cerr << "component/6502/functional: skipped; supply --functional-test" << std::endl;
+		return;
+	}
+
+	std::vector<uint8_t> test(65536);
+	FILE *const file = std::fopen(options.functional_test.c_str(), "rb");
+	if(!file) {
+		std::cerr << "component/6502/functional: skipped; couldn't open " << options.functional_test << std::endl;
+		return;
+	}
+	const std::size_t test_size = std::fread(test.data(), 1, test.size(), file);
+	std::fclose(file);
+
+	// Run Klaus Dormann's functional test from start to finish on a fresh processor, finishing being
+	// indicated by the processor getting stuck at a single address; on success that's 0x3399.
+	bool did_fail = false;
+	const auto run_test = [&] {
+		std::unique_ptr<CPU::MOS6502::AllRAMProcessor> m6502(CPU::MOS6502::AllRAMProcessor::Processor(CPU::MOS6502::Personality::P6502));
+		m6502->set_data_at_address(0x0000, test_size, test.data());
+		m6502->set_value_of_register(CPU::MOS6502::Register::ProgramCounter, 0x0400);
+
+		double cycles = 0.0;
+		while(true) {
+			const uint16_t old_address = m6502->get_value_of_register(CPU::MOS6502::Register::LastOperationAddress);
+			m6502->run_for(Cycles(1000));
+			cycles += 1000.0;
+			if(m6502->get_value_of_register(CPU::MOS6502::Register::LastOperationAddress) == old_address) break;
+		}
+		did_fail |= m6502->get_value_of_register(CPU::MOS6502::Register::LastOperationAddress) != 0x3399;
+		return cycles;
+	};
+
+	Result result;
+	result.name = "component/6502/functional";
+	result.unit = "cycles";
+	result.realtime_rate = 1000000.0;
+	measure(result, options.seconds_per_benchmark, run_test);
+	if(did_fail) {
+		std::cerr << "component/6502/functional: test failed" << std::endl;
+		return;
+	}
+	print_result(result);
+}
+
+void benchmark_tms9918(const Options &options) {
+	TI::TMS::TMS9918 vdp(TI::TMS::Personality::TMS9918A);
+
+	// Enable the display in Graphics I mode, with whatever happens to be in VRAM.
+	vdp.set_register(1, 0x40);
+	vdp.set_register(1, 0x81);
+
+	// Input is at twice the NTSC colour clock.
+	Result result;
+	result.name = "component/TMS9918";
+	result.unit = "half_cycles";
+	result.realtime_rate = 3579545.0 * 2.0;
+	measure(result, options.seconds_per_benchmark, [&vdp] {
+		vdp.run_for(HalfCycles(71590));
+		vdp.get_crt()->discard_frame();
+		return 71590.0;
+	});
+	print_result(result);
+}
+
+void benchmark_ay38910(const Options &options) {
+	Concurrency::DeferringAsyncTaskQueue queue;
+	GI::AY38910::AY38910 ay(queue);
+	ay.set_sample_volume_range(32767);
+
+	// Enable all three tone channels at differing pitches, with the envelope generator on channel C.
+	const uint8_t registers[][2] = {
+		{0, 0x40},	{1, 0x00},	{2, 0x53},	{3, 0x00},	{4, 0x6f},	{5, 0x00},
+		{6, 0x10},	{7, 0x38},	{8, 0x0f},	{9, 0x0c},	{10, 0x10},
+		{11, 0x00},	{12, 0x04},	{13, 0x0e},
+	};
+	for(const auto &reg: registers) {
+		ay.set_data_input(reg[0]);
+		ay.set_control_lines(GI::AY38910::ControlLines(GI::AY38910::BDIR | GI::AY38910::BC2 | GI::AY38910::BC1));
+		ay.set_control_lines(GI::AY38910::ControlLines(0));
+		ay.set_data_input(reg[1]);
+		ay.set_control_lines(GI::AY38910::ControlLines(GI::AY38910::BDIR | GI::AY38910::BC2));
+		ay.set_control_lines(GI::AY38910::ControlLines(0));
+	}
+	queue.perform();
+	queue.flush();
+
+	// Samples are generated at the AY's input clock rate; a typical one is 1MHz.
+	std::vector<int16_t> samples(65536);
+	Result result;
+	result.name = "component/AY38910";
+	result.unit = "samples";
+	result.realtime_rate = 1000000.0;
+	measure(result, options.seconds_per_benchmark, [&ay, &samples] {
+		ay.get_samples(samples.size(), samples.data());
+		return static_cast<double>(samples.size());
+	});
+	print_result(result);
+}
+
+void benchmark_tia(const Options &options) {
+	Atari2600::TIA tia;
+
+	// Set up a playfield and both players, then run whole frames of 262 lines.
+	tia.set_background_colour(0x1e);
+	tia.set_playfield_ball_colour(0x44);
+	tia.set_playfield(0, 0xa0);
+	tia.set_playfield(1, 0x55);
+	tia.set_playfield(2, 0xaa);
+	tia.set_player_graphic(0, 0x3c);
+	tia.set_player_graphic(1, 0x7e);
+	tia.set_player_missile_colour(0, 0x86);
+	tia.set_player_missile_colour(1, 0xc8);
+
+	// The TIA is clocked at three times the rate of the 2600's CPU.
+	Result result;
+	result.name = "component/TIA";
+	result.unit = "cycles";
+	result.realtime_rate = 3579545.0;
+	measure(result, options.seconds_per_benchmark, [&tia] {
+		tia.set_sync(true);
+		tia.run_for(Cycles(228 * 3));
+		tia.set_sync(false);
+		tia.set_blank(true);
+		tia.run_for(Cycles(228 * 37));
+		tia.set_blank(false);
+		tia.run_for(Cycles(228 * 222));
+		tia.get_crt()->discard_frame();
+		return 228.0 * 262.0;
+	});
+	print_result(result);
+}
+
+void benchmark_tia_sound(const Options &options) {
+	Concurrency::DeferringAsyncTaskQueue queue;
+	Atari2600::TIASound tia_sound(queue);
+	tia_sound.set_sample_volume_range(32767);
+
+	// Play a div2 tone on one channel and 5-bit noise on the other.
+	tia_sound.set_control(0, 0x4);
+	tia_sound.set_divider(0, 0x0c);
+	tia_sound.set_volume(0, 0xf);
+	tia_sound.set_control(1, 0x7);
+	tia_sound.set_divider(1, 0x03);
+	tia_sound.set_volume(1, 0x8);
+	queue.perform();
+	queue.flush();
+
+	// Samples are generated at the 2600's CPU clock rate divided by CPUTicksPerAudioTick.
+	std::vector<int16_t> samples(65536);
+	Result result;
+	result.name = "component/TIASound";
+	result.unit = "samples";
+	result.realtime_rate = 1193182.0 / Atari2600::CPUTicksPerAudioTick;
+	measure(result, options.seconds_per_benchmark, [&tia_sound, &samples] {
+		tia_sound.get_samples(samples.size(), samples.data());
+		return static_cast<double>(samples.size());
+	});
+	print_result(result);
+}
+
+void benchmark_pcm_segment_event_source(const Options &options) {
+	// Use a pseudo-random bit pattern, roughly the length of a double-density track.
+	std::vector<uint8_t> data(12500);
+	uint32_t seed = 0x12345678;
+	for(auto &byte: data) {
+		seed = seed * 1103515245 + 12345;
+		byte = static_cast<uint8_t>(seed >> 16);
+	}
+	Storage::Disk::PCMSegmentEventSource source{Storage::Disk::PCMSegment(data)};
+
+	Result result;
+	result.name = "component/PCMSegmentEventSource";
+	result.unit = "events";
+	measure(result, options.seconds_per_benchmark, [&source] {
+		double events = 0.0;
+		while(true) {
+			++events;
+			if(source.get_next_event().type == Storage::Disk::Track::Event::IndexHole) break;
+		}
+		source.reset();
+		return events;
+	});
+	print_result(result);
+}
+
+void benchmark_crt_software(const Options &options) {
+	// Use a PAL composite display with the timing of an Atari 2600's: lines of 455 cycles, each with
+	// 160 samples of data. As on the Oric, each sample is a 16-bit word holding the composite level for
+	// each of the four phases of the colour subcarrier, which is sampled as per the Oric's sampling function.
+	Outputs::CRT::CRT crt(455, 1, Outputs::CRT::DisplayType::PAL50, 2);
+	crt.set_video_signal(Outputs::CRT::VideoSignal::Composite);
+	crt.set_software_composite_sampling_function([] (const uint8_t *sample, float phase, float amplitude) {
+		const int value = sample[0] | (sample[1] << 8);
+		const int phase_index = static_cast<int>((phase + 3.141592654f + 0.39269908175f) * 2.0f / 3.141592654f) & 3;
+		return static_cast<float>(((value >> (4*(3 - phase_index))) & 15) - 4) / 20.0f;
+	});
+	crt.set_composite_function_type(Outputs::CRT::CRT::CompositeSourceType::DiscreteFourSamplesPerCycle, 0.0f);
+
+	// Generate a pseudo-random picture in which most samples repeat their predecessors, as is typical.
+	const unsigned int visible_lines = 272;
+	std::vector<uint16_t> picture(visible_lines * 160);
+	uint32_t seed = 0x12345678;
+	uint16_t value = 0;
+	for(auto &sample: picture) {
+		seed = seed * 1103515245 + 12345;
+		if(!((seed >> 16) & 3)) value = static_cast<uint16_t>(seed >> 8);
+		sample = value;
+	}
+
+	Outputs::CRT::SoftwareFrame frame;
+	frame.width = 640;
+	frame.height = 480;
+
+	// Each batch supplies and draws a complete field of 312 lines: three of sync, 37 blank and the rest of picture.
+	Result result;
+	result.name = "component/CRTSoftware";
+	result.unit = "fields";
+	result.realtime_rate = 50.0;
+	measure(result, options.seconds_per_benchmark, [&crt, &picture, &frame] {
+		for(int line = 0; line < 312; ++line) {
+			crt.output_blank(32);
+			if(line < 3) {
+				crt.output_sync(424);
+				continue;
+			}
+
+			crt.output_sync(32);
+			crt.output_default_colour_burst(32);
+			if(line < 40) {
+				crt.output_blank(360);
+				continue;
+			}
+
+			crt.output_blank(40);
+			uint16_t *const target = reinterpret_cast<uint16_t *>(crt.allocate_write_area(160));
+			if(target) std::copy(&picture[static_cast<std::size_t>(line - 40) * 160], &picture[static_cast<std::size_t>(line - 39) * 160], target);
+			crt.output_data(320, 160);
+		}
+		crt.draw_frame(frame);
+		return 1.0;
+	});
+	print_result(result);
+}
+
+void benchmark_components(const Options &options, const std::function<bool(const std::string &)> &is_selected) {
+	if(is_selected("component/Z80"))						benchmark_z80(options, false);
+	if(is_selected("component/Z80/coalesced"))				benchmark_z80(options, true);
+	if(is_selected("component/6502"))						benchmark_6502(options);
+	if(is_selected("component/6502/functional"))			benchmark_6502_functional_test(options);
+	if(is_selected("component/TMS9918"))					benchmark_tms9918(options);
+	if(is_selected("component/AY38910"))					benchmark_ay38910(options);
+	if(is_selected("component/TIA"))						benchmark_tia(options);
+	if(is_selected("component/TIASound"))					benchmark_tia_sound(options);
+	if(is_selected("component/PCMSegmentEventSource"))	benchmark_pcm_segment_event_source(options);
+	if(is_selected("component/CRTSoftware"))				benchmark_crt_software(options);
+}
+
+}
+
+int main(int argc, char *argv[]) {
+	Options options;
+
+	// Accepted arguments are --seconds={time per benchmark}, --filter={substring of benchmark names to run},
+	// --rompath={path to ROMs}, --functional-test={path to Klaus Dormann's 6502_functional_test.bin} and any
+	// number of files, each of which is benchmarked as a machine.
+	for(int index = 1; index < argc; ++index) {
+		const std::string argument = argv[index];
+		const std::size_t split_index = argument.find("=");
+		const std::string name = argument.substr(0, split_index);
+		const std::string value = (split_index == std::string::npos) ? "" : argument.substr(split_index + 1);
+
+		if(name == "--seconds") {
+			options.seconds_per_benchmark = std::atof(value.c_str());
+		} else if(name == "--filter") {
+			options.filter = value;
+		} else if(name == "--rompath") {
+			options.rom_path = value;
+		} else if(name == "--functional-test") {
+			options.functional_test = value;
+		} else if(name == "--help" || name == "-h") {
+			std::cout << "Usage: " << argv[0] << " [--seconds={time per benchmark}] [--filter={name substring}] [--rompath={path to ROMs}] [--functional-test={path to 6502 functional test}] [file ...]" << std::endl;
+			std::cout << "Results are printed as CSV; benchmarks that can't be run are reported to stderr." << std::endl;
+			return 0;
+		} else if(argument[0] != '-') {
+			options.file_names.push_back(argument);
+		} else {
+			std::cerr << "Unrecognised option " << argument << std::endl;
+			return -1;
+		}
+	}
+
+	if(options.seconds_per_benchmark <= 0.0) {
+		std::cerr << "Benchmark period must be positive" << std::endl;
+		return -1;
+	}
+
+	const auto is_selected = [&options] (const std::string &name) {
+		return options.filter.empty() || name.find(options.filter) != std::string::npos;
+	};
+
+	print_header();
+	benchmark_components(options, is_selected);
+	benchmark_machines(options, is_selected);
+
+	return 0;
+}
@@ -0,0 +1,467 @@
+//
+//  main.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 26/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../../Analyser/Static/StaticAnalyser.hpp"
+#include "../../Machines/Utility/MachineForTarget.hpp"
+
+#include "../../Machines/CRTMachine.hpp"
+#include "../../Processors/Profile.hpp"
+
+/*
+	A windowless, silent counterpart to the SDL binding: it loads a file, runs the resulting machine
+	for a nominated period of emulated time as quickly as the host allows, and then optionally writes
+	out the final frame as a PPM and everything the speaker produced as a WAV.
+
+	No OpenGL context or audio device is created; the frame is painted by the CRT's software path.
+*/
+
+namespace {
+
+/// The audio rate requested of the speaker, if audio is to be captured.
+const int AudioOutputRate = 44100;
+
+/// The emulated length of each call to run_for.
+const Time::Seconds TimeSlice = 0.01;
+
+/// The emulated period, ending at the end of execution, during which the CRT is drawn if the frame is to be captured.
+const Time::Seconds FramePeriod = 0.1;
+
+/// The number of fields received per field composed prior to the frame period.
+const unsigned int FieldDecimation = 50;
+
+struct SpeakerDelegate: public Outputs::Speaker::Speaker::Delegate {
+	void speaker_did_complete_samples(Outputs::Speaker::Speaker *speaker, const std::vector<int16_t> &buffer) override {
+		// Speakers may call from the machine's audio thread.
+		std::lock_guard<std::mutex> lock_guard(audio_buffer_mutex);
+		audio_buffer.insert(audio_buffer.end(), buffer.begin(), buffer.end());
+		channels = speaker->get_output_channel_count();
+	}
+
+	std::mutex audio_buffer_mutex;
+	std::vector<int16_t> audio_buffer;
+	std::size_t channels = 1;
+};
+
+struct ParsedArguments {
+	std::string file_name;
+	Configurable::SelectionSet selections;
+};
+
+/*! Parses an argc/argv pair to discern program arguments. */
+ParsedArguments parse_arguments(int argc, char *argv[]) {
+	ParsedArguments arguments;
+
+	for(int index = 1; index < argc; ++index) {
+		char *arg = argv[index];
+
+		// Accepted format is:
+		//
+		//	--flag			sets a Boolean option to true.
+		//	--flag=value	sets the value for a list option.
+		//	name			sets the file name to load.
+
+		// Anything starting with a dash always makes a selection; otherwise it's a file name.
+		if(arg[0] == '-') {
+			while(*arg == '-') arg++;
+
+			// Check for an equals sign, to discern a Boolean selection from a list selection.
+			std::string argument = arg;
+			std::size_t split_index = argument.find("=");
+
+			if(split_index == std::string::npos) {
+				arguments.selections[argument].reset(new Configurable::BooleanSelection(true));
+			} else {
+				std::string name = argument.substr(0, split_index);
+				std::string value = argument.substr(split_index+1, std::string::npos);
+				arguments.selections[name].reset(new Configurable::ListSelection(value));
+			}
+		} else {
+			arguments.file_name = arg;
+		}
+	}
+
+	return arguments;
+}
+
+/*! @returns The value of the list selection @c name within @c arguments, or the empty string if there is none. */
+std::string list_argument(ParsedArguments &arguments, const std::string &name) {
+	const auto selection = arguments.selections.find(name);
+	if(selection == arguments.selections.end()) return "";
+
+	std::unique_ptr<Configurable::ListSelection> list_selection(selection->second->list_selection());
+	return list_selection ? list_selection->value : "";
+}
+
+std::string final_path_component(const std::string &path) {
+	// An empty path has no final component.
+	if(path.empty()) {
+		return "";
+	}
+
+	// Find the last slash...
+	auto final_slash = path.find_last_of("/\\");
+
+	// If no slash was found at all, return the whole path.
+	if(final_slash == std::string::npos) {
+		return path;
+	}
+
+	// If a slash was found in the final position, remove it and recurse.
+	if(final_slash == path.size() - 1) {
+		return final_path_component(path.substr(0, path.size() - 1));
+	}
+
+	// Otherwise return everything from just after the slash to the end of the path.
+	return path.substr(final_slash+1, path.size() - final_slash - 1);
+}
+
+/*!
+	Writes @c frame to @c path as a binary PPM.
+
+	@returns @c true on success; @c false otherwise.
+*/
+bool write_ppm(const std::string &path, const Outputs::CRT::SoftwareFrame &frame) {
+	FILE *const file = std::fopen(path.c_str(), "wb");
+	if(!file) return false;
+
+	std::fprintf(file, "P6\n%u %u\n255\n", frame.width, frame.height);
+
+	// Strip alpha.
+	std::vector<uint8_t> row(frame.width * 3);
+	bool did_write = true;
+	for(unsigned int y = 0; y < frame.height; ++y) {
+		const uint8_t *const source = &frame.pixels[y * frame.width * 4];
+		for(unsigned int x = 0; x < frame.width; ++x) {
+			row[x*3 + 0] = source[x*4 + 0];
+			row[x*3 + 1] = source[x*4 + 1];
+			row[x*3 + 2] = source[x*4 + 2];
+		}
+		did_write &= std::fwrite(row.data(), 1, row.size(), file) == row.size();
+	}
+
+	return !std::fclose(file) && did_write;
+}
+
+/*!
+	Writes @c samples, which are interleaved frames of @c channels samples at @c rate frames per second,
+	to @c path as a 16-bit PCM WAV.
+
+	@returns @c true on success; @c false otherwise.
+*/
+bool write_wav(const std::string &path, const std::vector<int16_t> &samples, std::size_t channels, int rate) {
+	FILE *const file = std::fopen(path.c_str(), "wb");
+	if(!file) return false;
+
+	// WAV files are little endian throughout, so compose the header byte by byte.
+	std::vector<uint8_t> header;
+	const auto append = [&header](uint32_t value, int length) {
+		for(int c = 0; c < length; ++c) {
+			header.push_back(static_cast<uint8_t>(value >> (c * 8)));
+		}
+	};
+	const auto append_tag = [&header](const char *tag) {
+		header.insert(header.end(), tag, tag + 4);
+	};
+
+	const uint32_t data_size = static_cast<uint32_t>(samples.size() * 2);
+	append_tag("RIFF");	append(36 + data_size, 4);	append_tag("WAVE");
+
+	append_tag("fmt ");	append(16, 4);
+	append(1, 2);					// PCM.
+	append(static_cast<uint32_t>(channels), 2);
+	append(static_cast<uint32_t>(rate), 4);
+	append(static_cast<uint32_t>(static_cast<std::size_t>(rate) * channels * 2), 4);	// Bytes per second.
+	append(static_cast<uint32_t>(channels * 2), 2);		// Bytes per sample frame.
+	append(16, 2);					// Bits per sample.
+
+	append_tag("data");	append(data_size, 4);
+
+	std::vector<uint8_t> data(data_size);
+	for(std::size_t c = 0; c < samples.size(); ++c) {
+		data[c*2 + 0] = static_cast<uint8_t>(samples[c]);
+		data[c*2 + 1] = static_cast<uint8_t>(static_cast<uint16_t>(samples[c]) >> 8);
+	}
+
+	const bool did_write =
+		std::fwrite(header.data(), 1, header.size(), file) == header.size() &&
+		std::fwrite(data.data(), 1, data.size(), file) == data.size();
+	return !std::fclose(file) && did_write;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+	// Attempt to parse arguments.
+	ParsedArguments arguments = parse_arguments(argc, argv);
+	const std::string usage_suffix = " [file] [--seconds={emulated time}] [--frame={PPM path}] [--audio={WAV path}] [--channels={mono|stereo|separate}] [--profile={path prefix}] [OPTIONS] [--rompath={path to ROMs}]";
+
+	// Print a help message if requested.
+	if(arguments.selections.find("help") != arguments.selections.end() || arguments.selections.find("h") != arguments.selections.end()) {
+		std::cout << "Usage: " << final_path_component(argv[0]) << usage_suffix << std::endl;
+		std::cout << "Runs the machine appropriate to the file for the requested period of emulated time, ten seconds by default, as quickly as possible." << std::endl;
+		std::cout << "The final frame and all audio output can optionally be saved, as can a profile of each processor if built with PROFILE_PROCESSORS defined." << std::endl;
+		std::cout << "Audio is mono by default; it can instead be stereo, where the machine supports it, or have a separate channel for each audio source that offers them." << std::endl;
+		std::cout << "Machines with further options:" << std::endl << std::endl;
+
+		auto all_options = Machine::AllOptionsByMachineName();
+		for(const auto &machine_options: all_options) {
+			std::cout << machine_options.first << ":" << std::endl;
+			for(const auto &option: machine_options.second) {
+				std::cout << '\t' << "--" << option->short_name;
+
+				Configurable::ListOption *list_option = dynamic_cast<Configurable::ListOption *>(option.get());
+				if(list_option) {
+					std::cout << "={";
+					bool is_first = true;
+					for(const auto &option: list_option->options) {
+						if(!is_first) std::cout << '|';
+						is_first = false;
+						std::cout << option;
+					}
+					std::cout << "}";
+				}
+				std::cout << std::endl;
+			}
+			std::cout << std::endl;
+		}
+		return 0;
+	}
+
+	// Perform a sanity check on arguments.
+	if(arguments.file_name.empty()) {
+		std::cerr << "Usage: " << final_path_component(argv[0]) << usage_suffix << std::endl;
+		std::cerr << "Use --help to learn more about available options." << std::endl;
+		return -1;
+	}
+
+	Time::Seconds seconds_to_run = 10.0;
+	const std::string seconds_argument = list_argument(arguments, "seconds");
+	if(!seconds_argument.empty()) {
+		seconds_to_run = std::atof(seconds_argument.c_str());
+		if(seconds_to_run <= 0.0) {
+			std::cerr << "Cannot run for " << seconds_argument << " seconds" << std::endl;
+			return -1;
+		}
+	}
+	const std::string frame_path = list_argument(arguments, "frame");
+	const std::string audio_path = list_argument(arguments, "audio");
+	const std::string channels_argument = list_argument(arguments, "channels");
+	Outputs::Speaker::Channels channels = Outputs::Speaker::Channels::Mono;
+	if(channels_argument == "stereo") {
+		channels = Outputs::Speaker::Channels::Stereo;
+	} else if(channels_argument == "separate") {
+		channels = Outputs::Speaker::Channels::Separate;
+	} else if(!channels_argument.empty() && channels_argument != "mono") {
+		std::cerr << "Unrecognised channel layout " << channels_argument << std::endl;
+		return -1;
+	}
+	const std::string profile_prefix = list_argument(arguments, "profile");
+#ifndef PROFILE_PROCESSORS
+	if(!profile_prefix.empty()) {
+		std::cerr << "Processor profiles are available only if built with PROFILE_PROCESSORS defined" << std::endl;
+		return -1;
+	}
+#endif
+
+	// Determine the machine for the supplied file.
+	Analyser::Static::TargetList targets = Analyser::Static::GetTargets(arguments.file_name);
+	if(targets.empty()) {
+		std::cerr << "Cannot open " << arguments.file_name << "; no target machine found" << std::endl;
+		return -1;
+	}
+
+	// As per the SDL binding, assume system ROMs can be found in one of:
+	//
+	//	/usr/local/share/CLK/[system];
+	//	/usr/share/CLK/[system]; or
+	//	[user-supplied path]/[system]
+	std::vector<std::string> rom_names;
+	std::string machine_name;
+	ROMMachine::ROMFetcher rom_fetcher = [&rom_names, &machine_name, &arguments]
+		(const std::string &machine, const std::vector<std::string> &names) -> std::vector<std::unique_ptr<std::vector<uint8_t>>> {
+			rom_names.insert(rom_names.end(), names.begin(), names.end());
+			machine_name = machine;
+
+			std::vector<std::string> paths = {
+				"/usr/local/share/CLK/",
+				"/usr/share/CLK/"
+			};
+			const std::string user_path = list_argument(arguments, "rompath");
+			if(!user_path.empty()) {
+				if(user_path.back() != '/') {
+					paths.push_back(user_path + "/");
+				} else {
+					paths.push_back(user_path);
+				}
+			}
+
+			std::vector<std::unique_ptr<std::vector<uint8_t>>> results;
+			for(const auto &name: names) {
+				FILE *file = nullptr;
+				for(const auto &path: paths) {
+					std::string local_path = path + machine + "/" + name;
+					file = std::fopen(local_path.c_str(), "rb");
+					if(file) break;
+				}
+
+				if(!file) {
+					results.emplace_back(nullptr);
+					continue;
+				}
+
+				std::unique_ptr<std::vector<uint8_t>> data(new std::vector<uint8_t>);
+
+				std::fseek(file, 0, SEEK_END);
+				data->resize(std::ftell(file));
+				std::fseek(file, 0, SEEK_SET);
+				std::size_t read = fread(data->data(), 1, data->size(), file);
+				std::fclose(file);
+
+				if(read == data->size())
+					results.emplace_back(std::move(data));
+				else
+					results.emplace_back(nullptr);
+			}
+
+			return results;
+		};
+
+	// Create and configure a machine.
+	::Machine::Error error;
+	std::unique_ptr<::Machine::DynamicMachine> machine(::Machine::MachineForTargets(targets, rom_fetcher, error));
+	if(!machine) {
+		switch(error) {
+			default: break;
+			case ::Machine::Error::MissingROM:
+				std::cerr << "Could not find system ROMs; please install to /usr/local/share/CLK/ or /usr/share/CLK/, or provide a --rompath." << std::endl;
+				std::cerr << "One or more of the following were needed but not found:" << std::endl;
+				for(const auto &name: rom_names) {
+					std::cerr << machine_name << '/' << name << std::endl;
+				}
+			break;
+		}
+
+		return -1;
+	}
+
+	// Set up output. The speaker is connected only if audio is to be captured; without a
+	// delegate it declines to do any work.
+	CRTMachine::Machine *const crt_machine = machine->crt_machine();
+	crt_machine->setup_output(4.0 / 3.0);
+	crt_machine->get_crt()->set_output_gamma(2.2f);
+
+	SpeakerDelegate speaker_delegate;
+	auto speaker = crt_machine->get_speaker();
+	const bool capture_audio = speaker && !audio_path.empty();
+	if(capture_audio) {
+		speaker->set_output_rate(AudioOutputRate, 1024);
+		speaker->set_output_channels(channels);
+		speaker->set_delegate(&speaker_delegate);
+	} else if(!audio_path.empty()) {
+		std::cerr << "The machine has no audio output; " << audio_path << " will not be written" << std::endl;
+	}
+
+	Configurable::Device *const configurable_device = machine->configurable_device();
+	if(configurable_device) {
+		// Establish user-friendly options by default.
+		configurable_device->set_selections(configurable_device->get_user_friendly_selections());
+
+		// Consider transcoding any list selections that map to Boolean options.
+		for(const auto &option: configurable_device->get_options()) {
+			// Check for a corresponding selection.
+			auto selection = arguments.selections.find(option->short_name);
+			if(selection != arguments.selections.end()) {
+				// Transcode selection if necessary.
+				if(dynamic_cast<Configurable::BooleanOption *>(option.get())) {
+					arguments.selections[selection->first] =  std::unique_ptr<Configurable::Selection>(selection->second->boolean_selection());
+				}
+
+				if(dynamic_cast<Configurable::ListOption *>(option.get())) {
+					arguments.selections[selection->first] =  std::unique_ptr<Configurable::Selection>(selection->second->list_selection());
+				}
+			}
+		}
+
+		// Apply the user's actual selections to override the defaults.
+		configurable_device->set_selections(arguments.selections);
+	}
+
+	// Run for the requested period. The CRT isn't drawn other than towards the end, and then only if
+	// the frame has been requested; otherwise its output is discarded and so most fields needn't be
+	// composed. Audio is unaffected by turbo mode, in order that it can be captured in full.
+	Outputs::CRT::SoftwareFrame frame;
+	frame.width = 640;
+	frame.height = 480;
+
+	const auto start_time = std::chrono::high_resolution_clock::now();
+	Time::Seconds seconds_run = 0.0;
+	bool is_turbo = true;
+	crt_machine->set_turbo_mode(true, FieldDecimation, 1.0f);
+	while(seconds_run < seconds_to_run) {
+		const Time::Seconds slice = std::min(TimeSlice, seconds_to_run - seconds_run);
+		crt_machine->run_for(slice);
+		seconds_run += slice;
+
+		if(!frame_path.empty() && seconds_to_run - seconds_run < FramePeriod) {
+			if(is_turbo) {
+				crt_machine->set_turbo_mode(false, 1, 1.0f);
+				is_turbo = false;
+			}
+			crt_machine->get_crt()->draw_frame(frame);
+		} else {
+			crt_machine->get_crt()->discard_frame();
+		}
+	}
+	const auto end_time = std::chrono::high_resolution_clock::now();
+
+	// Save the profiles of all processors while the machine that owns them still exists, if requested.
+	if(!profile_prefix.empty()) {
+#ifdef PROFILE_PROCESSORS
+		int index = 0;
+		for(const auto profile: CPU::ProcessorProfile::all()) {
+			const std::string profile_path = profile_prefix + "-" + std::to_string(index) + "-" + profile->get_name() + ".clkprof";
+			if(!profile->save(profile_path)) {
+				std::cerr << "Could not write profile to " << profile_path << std::endl;
+				return -1;
+			}
+			++index;
+		}
+#endif
+	}
+
+	// Destroy the machine before inspecting the audio buffer, to ensure that all queued audio work is complete.
+	machine.reset();
+
+	const double wall_seconds = std::chrono::duration<double>(end_time - start_time).count();
+	std::cout << final_path_component(arguments.file_name) << ": " << seconds_run << " emulated seconds in " << wall_seconds << " seconds";
+	if(wall_seconds > 0.0) std::cout << " (" << (seconds_run / wall_seconds) << "x)";
+	std::cout << std::endl;
+
+	// Write out the frame and audio, if requested.
+	if(!frame_path.empty() && !write_ppm(frame_path, frame)) {
+		std::cerr << "Could not write frame to " << frame_path << std::endl;
+		return -1;
+	}
+
+	if(capture_audio && !write_wav(audio_path, speaker_delegate.audio_buffer, speaker_delegate.channels, AudioOutputRate)) {
+		std::cerr << "Could not write audio to " << audio_path << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
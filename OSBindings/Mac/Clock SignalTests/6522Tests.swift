@@ -105,6 +105,48 @@ class MOS6522Tests: XCTestCase {
 		}
 	}
 
+	// MARK: Sequence point tests
+
+	func testNextSequencePoint() {
+		with6522 {
+			// enable all interrupts, so that any timer firing is visible in the flag register
+			$0.setValue(0xff, forRegister: 14)
+
+			// use a fixed seed, so that any failure is reproducible
+			srand48(1)
+			func random(_ range: UInt32) -> UInt32 {
+				return UInt32(lrand48()) % range
+			}
+
+			for trial in 0 ..< 2000 {
+				// make a few random timer writes, keeping initial values short, separated by random short periods
+				for _ in 0 ..< random(3) {
+					let registers: [UInt32] = [4, 5, 6, 7, 8, 9, 11]
+					let register = registers[Int(random(UInt32(registers.count)))]
+					var value = UInt8(random(256))
+					switch register {
+						case 5, 7, 9:	value &= 0x01
+						case 11:		value &= 0xe0
+						default:		break
+					}
+					$0.setValue(value, forRegister: UInt(register))
+					$0.run(forHalfCycles: UInt(random(4)))
+				}
+				$0.setValue(0x7f, forRegister: 13)
+
+				// step a half cycle at a time; no timer should fire before the predicted sequence point
+				let prediction = $0.nextSequencePoint
+				let flags = $0.value(forRegister: 13)
+				for halfCycle in 1 ... min(prediction, 2048) {
+					$0.run(forHalfCycles: 1)
+					if $0.value(forRegister: 13) != flags {
+						XCTAssert(halfCycle == prediction, "Trial \(trial): flags changed after \(halfCycle) half cycles; predicted \(prediction)")
+						break
+					}
+				}
+			}
+		}
+	}
 
 	// MARK: Data direction tests
 	func testDataDirection() {
@@ -13,6 +13,7 @@
 @property (nonatomic, readonly) BOOL irqLine;
 @property (nonatomic) uint8_t portBInput;
 @property (nonatomic) uint8_t portAInput;
+@property (nonatomic, readonly) NSUInteger nextSequencePoint;
 
 - (void)setValue:(uint8_t)value forRegister:(NSUInteger)registerNumber;
 - (uint8_t)valueForRegister:(NSUInteger)registerNumber;
@@ -55,6 +55,10 @@ class VanillaVIAPortHandler: public MOS::MOS6522::PortHandler {
 	_via->run_for(HalfCycles((int)numberOfHalfCycles));
 }
 
+- (NSUInteger)nextSequencePoint {
+	return (NSUInteger)_via->get_next_sequence_point().as_int();
+}
+
 - (BOOL)irqLine {
 	return _viaPortHandler.irq_line;
 }
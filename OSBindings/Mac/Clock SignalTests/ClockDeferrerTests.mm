@@ -0,0 +1,94 @@
+//
+//  ClockDeferrerTests.mm
+//  Clock SignalTests
+//
+//  Created by Thomas Harte on 17/10/2018.
+//  Copyright © 2018 Thomas Harte. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "ClockDeferrer.hpp"
+#include "ClockReceiver.hpp"
+
+namespace {
+
+/// Records the total time run and the time at which each action was performed.
+struct DeferrerLog {
+	int time = 0;
+	std::vector<int> actions;		// Pairs of action identifier and time performed.
+};
+
+struct LoggingAction {
+	DeferrerLog *log;
+	int identifier;
+	void operator()() const {
+		log->actions.push_back(identifier);
+		log->actions.push_back(log->time);
+	}
+};
+
+}
+
+@interface ClockDeferrerTests : XCTestCase
+@end
+
+@implementation ClockDeferrerTests
+
+/*!
+	Feeds the same pseudo-random sequence of deferrals and periods to a ClockDeferrer and to a
+	FixedClockDeferrer, asserting that each performs the same actions at the same times.
+*/
+- (void)testFixedMatchesDynamic
+{
+	const std::size_t capacity = 8;
+	DeferrerLog dynamic_log, fixed_log;
+	ClockDeferrer<Cycles> dynamic_deferrer([&dynamic_log] (Cycles cycles) {
+		dynamic_log.time += cycles.as_int();
+	});
+	FixedClockDeferrer<Cycles, LoggingAction, capacity> fixed_deferrer;
+	const auto fixed_target = [&fixed_log] (Cycles cycles) {
+		fixed_log.time += cycles.as_int();
+	};
+
+	// Actions must be deferred in the order they will occur, so track the time of the latest.
+	srand(54321);
+	int last_action_time = 0, next_identifier = 0;
+	for(int step = 0; step < 200000; ++step) {
+		// Count the actions still pending; fired actions have been logged as two entries each.
+		const std::size_t pending = std::size_t(next_identifier) - dynamic_log.actions.size() / 2;
+
+		if(pending < capacity && !(rand() & 3)) {
+			const int earliest_delay = std::max(last_action_time - dynamic_log.time, 1);
+			const int delay = earliest_delay + (rand() % 5);
+			last_action_time = dynamic_log.time + delay;
+
+			const int identifier = next_identifier++;
+			dynamic_deferrer.defer(Cycles(delay), [&dynamic_log, identifier] {
+				dynamic_log.actions.push_back(identifier);
+				dynamic_log.actions.push_back(dynamic_log.time);
+			});
+			fixed_deferrer.defer(Cycles(delay), LoggingAction{&fixed_log, identifier});
+			continue;
+		}
+
+		const int length = rand() % 7;
+		dynamic_deferrer.run_for(Cycles(length));
+		fixed_deferrer.run_for(Cycles(length), fixed_target);
+
+		XCTAssertEqual(dynamic_log.time, fixed_log.time, @"Total time run should match after step %d", step);
+		XCTAssertEqual(dynamic_log.actions.size(), fixed_log.actions.size(), @"Number of actions performed should match after step %d", step);
+		if(dynamic_log.actions != fixed_log.actions) {
+			XCTAssert(false, @"Actions should have been performed in the same order and at the same times by step %d", step);
+			break;
+		}
+	}
+
+	XCTAssert(dynamic_log.actions.size() > 20000, @"A substantial number of actions should have been performed");
+}
+
+@end
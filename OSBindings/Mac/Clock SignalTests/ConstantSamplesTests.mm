@@ -0,0 +1,303 @@
+//
+//  ConstantSamplesTests.mm
+//  Clock SignalTests
+//
+//  Created by Thomas Harte on 17/10/2018.
+//  Copyright © 2018 Thomas Harte. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "CompoundSource.hpp"
+#include "LowpassSpeaker.hpp"
+
+namespace {
+
+/*!
+	Provides a fixed, pseudo-random signal of alternating constant runs and noise, in up to two channels,
+	optionally reporting the constant runs via get_constant_samples. In mono the two channels are averaged.
+*/
+class ScriptedSource: public Outputs::Speaker::SampleSource {
+	public:
+		ScriptedSource(std::size_t length, std::size_t maximum_channels, bool reports_constant_samples) :
+			maximum_channels_(maximum_channels), reports_constant_samples_(reports_constant_samples) {
+			std::minstd_rand random;
+			frames_.reserve(length * 2);
+			run_ends_.reserve(length);
+			while(run_ends_.size() < length) {
+				const std::size_t run_end = std::min(length, run_ends_.size() + 1 + random() % ((random() & 3) ? 64 : 4096));
+				const bool is_constant = random() % 3;
+				const int16_t left = (random() & 3) ? int16_t(int(random() % 32768) - 16384) : 0;
+				const int16_t right = (random() & 1) ? left : int16_t(int(random() % 32768) - 16384);
+				while(run_ends_.size() < run_end) {
+					if(is_constant) {
+						frames_.push_back(left);
+						frames_.push_back(right);
+						run_ends_.push_back(run_end);
+					} else {
+						frames_.push_back(int16_t(int(random() % 32768) - 16384));
+						frames_.push_back(int16_t(int(random() % 32768) - 16384));
+						run_ends_.push_back(run_ends_.size());
+					}
+				}
+			}
+		}
+
+		void get_samples(std::size_t number_of_samples, std::int16_t *target) {
+			while(number_of_samples--) {
+				if(channels_ == 1) {
+					*target++ = int16_t((frames_[position_ * 2] + frames_[position_ * 2 + 1]) / 2);
+				} else {
+					*target++ = frames_[position_ * 2];
+					*target++ = frames_[position_ * 2 + 1];
+				}
+				++position_;
+			}
+		}
+
+		void skip_samples(const std::size_t number_of_samples) {
+			position_ += number_of_samples;
+		}
+
+		std::size_t get_constant_samples(std::int16_t *level) {
+			if(!reports_constant_samples_) return 0;
+			const std::size_t constant_samples = run_ends_[position_] - position_;
+			if(constant_samples) {
+				get_samples(1, level);
+				--position_;
+			}
+			return constant_samples;
+		}
+
+		void set_output_channels(Outputs::Speaker::Channels channels) {
+			channels_ = (channels == Outputs::Speaker::Channels::Mono) ? 1 : maximum_channels_;
+		}
+
+		std::size_t get_channel_count() {
+			return channels_;
+		}
+
+	private:
+		std::vector<int16_t> frames_;
+		std::vector<std::size_t> run_ends_;
+		std::size_t position_ = 0;
+		std::size_t channels_ = 1;
+		const std::size_t maximum_channels_;
+		const bool reports_constant_samples_;
+};
+
+struct CollectingDelegate: public Outputs::Speaker::Speaker::Delegate {
+	std::vector<int16_t> samples;
+
+	void speaker_did_complete_samples(Outputs::Speaker::Speaker *speaker, const std::vector<int16_t> &buffer) {
+		samples.insert(samples.end(), buffer.begin(), buffer.end());
+	}
+};
+
+/*!
+	Runs @c source through a LowpassSpeaker, with the supplied layout and rates, in spans of pseudo-random
+	length totalling @c length input samples. @returns All complete buffers of output.
+*/
+std::vector<int16_t> speaker_output(ScriptedSource &source, Outputs::Speaker::Channels channels, float input_rate, float output_rate, std::size_t length) {
+	Concurrency::DeferringAsyncTaskQueue queue;
+	Outputs::Speaker::LowpassSpeaker<ScriptedSource> speaker(source);
+	CollectingDelegate delegate;
+	speaker.set_delegate(&delegate);
+	speaker.set_input_rate(input_rate);
+	speaker.set_output_channels(channels);
+	speaker.set_output_rate(output_rate, 256);
+
+	std::minstd_rand random;
+	while(length) {
+		const std::size_t span = std::min(length, std::size_t(1 + random() % 2000));
+		speaker.run_for(queue, Cycles(int(span)));
+		length -= span;
+	}
+	queue.perform();
+	queue.flush();
+	return delegate.samples;
+}
+
+// FIRFilter::apply_to_constant may differ from apply in the least significant bit where Accelerate is used.
+#ifdef __APPLE__
+const int ConstantTolerance = 1;
+#else
+const int ConstantTolerance = 0;
+#endif
+
+/*!
+	A source that always produces a single level, and may report itself as being zero level, reporting
+	a constant span as specified.
+*/
+class FixedSource: public Outputs::Speaker::SampleSource {
+	public:
+		FixedSource(std::size_t channels, int16_t left, int16_t right, std::size_t constant_samples, bool is_zero_level) :
+			maximum_channels_(channels), constant_samples_(constant_samples), is_zero_level_(is_zero_level) {
+			level_[0] = left;
+			level_[1] = right;
+		}
+
+		void get_samples(std::size_t number_of_samples, std::int16_t *target) {
+			while(number_of_samples--) {
+				for(std::size_t channel = 0; channel < channels_; ++channel) *target++ = level_[channel];
+			}
+		}
+
+		void skip_samples(const std::size_t number_of_samples) {}
+
+		bool is_zero_level() {
+			return is_zero_level_;
+		}
+
+		std::size_t get_constant_samples(std::int16_t *level) {
+			if(constant_samples_) get_samples(1, level);
+			return constant_samples_;
+		}
+
+		void set_output_channels(Outputs::Speaker::Channels channels) {
+			channels_ = (channels == Outputs::Speaker::Channels::Mono) ? 1 : maximum_channels_;
+		}
+
+		std::size_t get_channel_count() {
+			return channels_;
+		}
+
+	private:
+		int16_t level_[2];
+		std::size_t channels_ = 1;
+		const std::size_t maximum_channels_;
+		const std::size_t constant_samples_;
+		const bool is_zero_level_;
+};
+
+}
+
+@interface ConstantSamplesTests : XCTestCase
+@end
+
+@implementation ConstantSamplesTests
+
+#pragma mark - LowpassSpeaker
+
+- (void)testSpeakerOutputIsUnaffectedByConstantReporting
+{
+	const Outputs::Speaker::Channels channel_options[] = {
+		Outputs::Speaker::Channels::Mono,
+		Outputs::Speaker::Channels::Stereo,
+		Outputs::Speaker::Channels::Separate,
+	};
+
+	// Test downsampling, upsampling and the exact-rate path.
+	const float rates[][2] = {
+		{250000.0f, 44100.0f},
+		{22050.0f, 44100.0f},
+		{44100.0f, 44100.0f},
+	};
+
+	const std::size_t length = 1000000;
+	for(std::size_t maximum_channels = 1; maximum_channels <= 2; ++maximum_channels) {
+		for(const auto channels: channel_options) {
+			for(const auto &rate: rates) {
+				ScriptedSource reporting_source(length, maximum_channels, true), plain_source(length, maximum_channels, false);
+				const auto reporting = speaker_output(reporting_source, channels, rate[0], rate[1], length);
+				const auto plain = speaker_output(plain_source, channels, rate[0], rate[1], length);
+
+				const std::size_t expected_frames = std::size_t(double(length) * rate[1] / rate[0]) / 256 * 256;
+				std::size_t expected_channels = 2;
+				switch(channels) {
+					case Outputs::Speaker::Channels::Mono:		expected_channels = 1;					break;
+					case Outputs::Speaker::Channels::Stereo:	expected_channels = 2;					break;
+					case Outputs::Speaker::Channels::Separate:	expected_channels = maximum_channels;	break;
+				}
+				XCTAssertEqual(plain.size(), expected_frames * expected_channels, @"All output should have been produced, from %zu channels at %0.0f Hz", maximum_channels, rate[0]);
+				XCTAssert(std::any_of(plain.begin(), plain.end(), [](int16_t sample) { return sample != 0; }), @"Output should not be silent");
+
+				XCTAssertEqual(reporting.size(), plain.size(), @"Output lengths should match, from %zu channels at %0.0f Hz", maximum_channels, rate[0]);
+				if(reporting.size() != plain.size()) continue;
+				for(std::size_t index = 0; index < plain.size(); ++index) {
+					if(std::abs(reporting[index] - plain[index]) > ConstantTolerance) {
+						XCTAssert(false, @"Output from %zu channels at %0.0f Hz should match without constant reporting; first differed at value %zu: %d versus %d", maximum_channels, rate[0], index, reporting[index], plain[index]);
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
+#pragma mark - CompoundSource
+
+- (void)testCompoundConstantLevel
+{
+	FixedSource mono(1, 100, 100, 50, false), stereo(2, 200, -300, 20, false);
+	FixedSource silent_mono(1, 0, 0, 0, true), silent_stereo(2, 0, 0, 0, true);
+	Outputs::Speaker::CompoundSource<FixedSource, FixedSource, FixedSource, FixedSource> compound(silent_mono, mono, silent_stereo, stereo);
+
+	// Zero-level sources should neither limit the span nor contribute to the level.
+	int16_t level[6];
+	compound.set_output_channels(Outputs::Speaker::Channels::Mono);
+	XCTAssertEqual(compound.get_constant_samples(level), 20);
+	XCTAssertEqual(level[0], 300);
+
+	// In stereo, the mono source should be added to both channels.
+	compound.set_output_channels(Outputs::Speaker::Channels::Stereo);
+	XCTAssertEqual(compound.get_channel_count(), 2);
+	XCTAssertEqual(compound.get_constant_samples(level), 20);
+	XCTAssertEqual(level[0], 300);
+	XCTAssertEqual(level[1], -200);
+
+	// Separately, each source should have its own columns, with zeroes for those at zero level.
+	compound.set_output_channels(Outputs::Speaker::Channels::Separate);
+	XCTAssertEqual(compound.get_channel_count(), 6);
+	std::fill_n(level, 6, 1);
+	XCTAssertEqual(compound.get_constant_samples(level), 20);
+	const int16_t expected[] = {0, 100, 0, 0, 200, -300};
+	for(std::size_t channel = 0; channel < 6; ++channel) {
+		XCTAssertEqual(level[channel], expected[channel], @"Channel %zu should be at the proper level", channel);
+	}
+
+	// The constant level should be what get_samples produces.
+	const Outputs::Speaker::Channels channel_options[] = {
+		Outputs::Speaker::Channels::Mono,
+		Outputs::Speaker::Channels::Stereo,
+		Outputs::Speaker::Channels::Separate,
+	};
+	for(const auto channels: channel_options) {
+		compound.set_output_channels(channels);
+		const std::size_t channel_count = compound.get_channel_count();
+		std::vector<int16_t> samples(4 * channel_count);
+		compound.get_constant_samples(level);
+		compound.get_samples(4, samples.data());
+		for(std::size_t index = 0; index < samples.size(); ++index) {
+			XCTAssertEqual(samples[index], level[index % channel_count], @"Sample %zu should match the constant level", index);
+		}
+	}
+}
+
+- (void)testCompoundConstantSpan
+{
+	// Any audible source that can't promise constant output should prevent the compound from doing so.
+	FixedSource constant(1, 100, 100, 50, false), unpredictable(1, 100, 100, 0, false), silent(1, 0, 0, 0, true);
+	int16_t level[1];
+
+	Outputs::Speaker::CompoundSource<FixedSource, FixedSource> mixed(constant, unpredictable);
+	XCTAssertEqual(mixed.get_constant_samples(level), 0);
+
+	Outputs::Speaker::CompoundSource<FixedSource, FixedSource> partly_silent(silent, constant);
+	XCTAssertEqual(partly_silent.get_constant_samples(level), 50);
+	XCTAssertEqual(level[0], 100);
+
+	// If all sources are at zero level then output is silent indefinitely.
+	Outputs::Speaker::CompoundSource<FixedSource, FixedSource> all_silent(silent, silent);
+	level[0] = 1;
+	XCTAssertEqual(all_silent.get_constant_samples(level), std::numeric_limits<std::size_t>::max());
+	XCTAssertEqual(level[0], 0);
+}
+
+@end
@@ -0,0 +1,95 @@
+//
+//  FIRFilterTests.mm
+//  Clock SignalTests
+//
+//  Created by Thomas Harte on 17/10/2018.
+//  Copyright © 2018 Thomas Harte. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "FIRFilter.hpp"
+#include "PolyphaseFilter.hpp"
+
+@interface FIRFilterTests : XCTestCase
+@end
+
+@implementation FIRFilterTests
+
+- (void)testDotProductsMatchScalar
+{
+	const auto dot_products = SignalProcessing::FIRFilter::get_dot_products();
+	XCTAssert(!dot_products.empty() && dot_products.front().first == "scalar", @"The scalar implementation should be listed first");
+	if(dot_products.empty()) return;
+	const auto scalar = dot_products.front().second;
+
+	// Use pseudo-random samples across the whole 16-bit range, and coefficients small enough that no sum
+	// overflows, as with a real filter. Test every length up to a few vectors' worth, so that each
+	// implementation's remainder handling is exercised, and misaligned buffers.
+	std::minstd_rand random;
+
+	const std::size_t maximum_length = 100;
+	std::vector<short> coefficients(maximum_length + 1), samples(maximum_length + 1);
+	for(int trial = 0; trial < 20; ++trial) {
+		for(auto &coefficient: coefficients) coefficient = short(int(random() % 1024) - 512);
+		for(auto &sample: samples) sample = short(random());
+
+		// Include the extremes of the sample range.
+		samples[trial % samples.size()] = -32768;
+		samples[(trial * 7) % samples.size()] = 32767;
+
+		for(std::size_t offset = 0; offset < 2; ++offset) {
+			for(std::size_t length = 0; length <= maximum_length; ++length) {
+				const int expected = scalar(&coefficients[offset], &samples[offset], length);
+				for(const auto &dot_product: dot_products) {
+					const int result = dot_product.second(&coefficients[offset], &samples[offset], length);
+					if(result != expected) {
+						XCTAssert(false, @"%s dot product of length %zu at offset %zu should match scalar: %d versus %d", dot_product.first.c_str(), length, offset, result, expected);
+						return;
+					}
+				}
+			}
+		}
+	}
+}
+
+- (void)testApplyToConstantMatchesApply
+{
+	// apply_to_constant may differ from apply in the least significant bit where Accelerate is used.
+#ifdef __APPLE__
+	const int tolerance = 1;
+#else
+	const int tolerance = 0;
+#endif
+
+	// Use filters as a speaker would for downsampling and for upsampling, and levels that include the extremes.
+	const SignalProcessing::PolyphaseFilter filters[] = {
+		SignalProcessing::PolyphaseFilter(25, 64, 250000.0f, 22050.0f, SignalProcessing::FIRFilter::DefaultAttenuation),
+		SignalProcessing::PolyphaseFilter(15, 64, 22050.0f, 9922.5f, SignalProcessing::FIRFilter::DefaultAttenuation),
+	};
+	std::minstd_rand random;
+	std::vector<short> levels = {-32768, -1, 0, 1, 32767};
+	for(int c = 0; c < 20; ++c) levels.push_back(short(random()));
+
+	for(const auto &filter: filters) {
+		std::vector<short> window(filter.get_number_of_taps());
+		for(const auto level: levels) {
+			std::fill(window.begin(), window.end(), level);
+			for(std::size_t phase = 0; phase < filter.get_number_of_phases(); ++phase) {
+				const short expected = filter.apply(window.data(), phase);
+				const short result = filter.apply_to_constant(level, phase);
+				if(std::abs(result - expected) > tolerance) {
+					XCTAssert(false, @"Phase %zu of %zu taps applied to constant %d should match general application: %d versus %d", phase, filter.get_number_of_taps(), level, result, expected);
+					return;
+				}
+			}
+		}
+	}
+}
+
+@end
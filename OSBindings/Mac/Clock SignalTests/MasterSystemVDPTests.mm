@@ -9,8 +9,211 @@
 #import <XCTest/XCTest.h>
 #import <OpenGL/OpenGL.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
 #include "9918.hpp"
 
+namespace {
+
+/// The length of a frame in half cycles: 262 lines, each of 228 cycles.
+const int HalfCyclesPerFrame = 262*228*2;
+
+/// Seeds @c rand, from which a VDP picks its initial raster position, so that VDPs constructed subsequently start in step.
+TI::TMS::Personality seeded(TI::TMS::Personality personality) {
+	srand(1);
+	return personality;
+}
+
+/*!
+	Drives two VDPs identically other than in how their time is divided: one is run from each event
+	to the next in a single call, the other in pseudo-random short periods, so that it regularly
+	ends periods mid-tile and mid-line and draws partial tiles pixel by pixel rather than whole
+	tiles at once. Frames and status bytes from the two can then be compared.
+
+	Periods are kept long enough that the extra output spans they cause don't exhaust the CRT's
+	storage for a frame, which would leave later lines blank.
+*/
+struct VDPPair {
+	TI::TMS::TMS9918 whole, chunked;
+	Outputs::CRT::SoftwareFrame whole_frame, chunked_frame;
+	std::minstd_rand random;
+
+	VDPPair(TI::TMS::Personality personality) : whole(seeded(personality)), chunked(seeded(personality)) {
+		whole_frame.width = chunked_frame.width = 640;
+		whole_frame.height = chunked_frame.height = 480;
+	}
+
+	void run_for(int half_cycles) {
+		whole.run_for(HalfCycles(half_cycles));
+		while(half_cycles) {
+			const int period = std::min(half_cycles, 1 + int(random() % 100));
+			chunked.run_for(HalfCycles(period));
+			half_cycles -= period;
+		}
+	}
+
+	void set_register(int address, uint8_t value) {
+		whole.set_register(address, value);
+		chunked.set_register(address, value);
+	}
+
+	void write_register(int reg, uint8_t value) {
+		set_register(1, value);
+		set_register(1, uint8_t(0x80 | reg));
+	}
+
+	/// Writes @c data to VRAM, or to CRAM if @c command is @c 0xc0, from @c address onwards, allowing time for each write to complete.
+	void write_memory(uint16_t address, const std::vector<uint8_t> &data, uint8_t command = 0x40) {
+		set_register(1, uint8_t(address));
+		set_register(1, uint8_t((address >> 8) | command));
+		for(const auto value: data) {
+			set_register(0, value);
+			run_for(64);
+		}
+	}
+
+	/// @returns @c true if both VDPs report the same status; also stores that status to @c status.
+	bool status_matches(uint8_t &status) {
+		status = whole.get_register(1);
+		return chunked.get_register(1) == status;
+	}
+
+	/// Discards whatever output both VDPs have produced so far.
+	void discard_frames() {
+		whole.get_crt()->discard_frame();
+		chunked.get_crt()->discard_frame();
+	}
+
+	/// @returns @c true if both VDPs have produced the same frame.
+	bool frames_match() {
+		whole.get_crt()->draw_frame(whole_frame);
+		chunked.get_crt()->draw_frame(chunked_frame);
+		return whole_frame.pixels == chunked_frame.pixels;
+	}
+};
+
+/// @returns @c length pseudo-random bytes.
+std::vector<uint8_t> random_bytes(std::minstd_rand &random, std::size_t length) {
+	std::vector<uint8_t> bytes(length);
+	for(auto &byte: bytes) byte = uint8_t(random());
+	return bytes;
+}
+
+/*!
+	Fills VRAM with pseudo-random bytes with the display blanked, then places all 32 TMS sprites, with
+	attributes at 0x1b00, on visible lines, sharing a few lines so as to produce fifth sprites and collisions.
+*/
+void fill_tms_memory(VDPPair &pair) {
+	std::minstd_rand random;
+	pair.write_register(1, 0x00);
+	pair.write_memory(0x0000, random_bytes(random, 16384));
+
+	std::vector<uint8_t> sprite_attributes = random_bytes(random, 128);
+	for(std::size_t c = 0; c < 128; c += 4) sprite_attributes[c] = uint8_t(random() % 12) * 16;
+	pair.write_memory(0x1b00, sprite_attributes);
+}
+
+void set_up_mode4(VDPPair &pair) {
+	std::minstd_rand random;
+
+	// Fill VRAM and CRAM with display blanked; then place all 64 sprites on visible lines, sharing a few
+	// lines so as to overflow and collide.
+	pair.write_register(1, 0x00);
+	pair.write_memory(0x0000, random_bytes(random, 16384));
+	pair.write_memory(0x0000, random_bytes(random, 32), 0xc0);
+	std::vector<uint8_t> sprite_y(64);
+	for(auto &y: sprite_y) y = uint8_t(random() % 12) * 16;
+	pair.write_memory(0x3f00, sprite_y);
+
+	// Mode 4, line interrupts; display enabled, 8x16 sprites; name table at 0x3800, sprites at 0x3f00 using
+	// patterns from 0x2000; scroll and line counter as set.
+	pair.write_register(0, 0x14);
+	pair.write_register(1, 0x62);
+	pair.write_register(2, 0xff);
+	pair.write_register(5, 0xff);
+	pair.write_register(6, 0xff);
+	pair.write_register(8, 0x13);
+	pair.write_register(9, 0x05);
+}
+
+void set_up_graphics_i(VDPPair &pair) {
+	fill_tms_memory(pair);
+
+	// Graphics I, with 16x16 sprites; name table at 0x1800, colours at 0x2000, patterns at 0x0000,
+	// sprite attributes at 0x1b00 and sprite patterns at 0x3800.
+	pair.write_register(0, 0x00);
+	pair.write_register(1, 0x42);
+	pair.write_register(2, 0x06);
+	pair.write_register(3, 0x80);
+	pair.write_register(4, 0x00);
+	pair.write_register(5, 0x36);
+	pair.write_register(6, 0x07);
+	pair.write_register(7, 0x14);
+}
+
+void set_up_graphics_ii(VDPPair &pair) {
+	fill_tms_memory(pair);
+
+	// Graphics II, with magnified 8x8 sprites; patterns at 0x0000, colours at 0x2000, name table at 0x1800,
+	// sprite attributes at 0x1b00 and sprite patterns at 0x3800.
+	pair.write_register(0, 0x02);
+	pair.write_register(1, 0x41);
+	pair.write_register(2, 0x06);
+	pair.write_register(3, 0xff);
+	pair.write_register(4, 0x03);
+	pair.write_register(5, 0x36);
+	pair.write_register(6, 0x07);
+	pair.write_register(7, 0x14);
+}
+
+void set_up_multicolour(VDPPair &pair) {
+	fill_tms_memory(pair);
+
+	// Multicolour, with 8x8 sprites; name table at 0x1800, colour blocks at 0x0000, sprite attributes
+	// at 0x1b00 and sprite patterns at 0x3800.
+	pair.write_register(0, 0x00);
+	pair.write_register(1, 0x48);
+	pair.write_register(2, 0x06);
+	pair.write_register(4, 0x00);
+	pair.write_register(5, 0x36);
+	pair.write_register(6, 0x07);
+	pair.write_register(7, 0x14);
+}
+
+void set_up_text(VDPPair &pair) {
+	fill_tms_memory(pair);
+
+	// Text, which has no sprites; name table at 0x1800, patterns at 0x0000, white on dark blue.
+	pair.write_register(0, 0x00);
+	pair.write_register(1, 0x50);
+	pair.write_register(2, 0x06);
+	pair.write_register(4, 0x00);
+	pair.write_register(7, 0xf4);
+}
+
+/// @returns An FNV-1a hash of the second frame that @c vdp outputs from now, allowing the first for any change of mode to take effect.
+uint32_t checksum_of_second_frame(TI::TMS::TMS9918 &vdp) {
+	vdp.run_for(HalfCycles(HalfCyclesPerFrame));
+	vdp.get_crt()->discard_frame();
+	vdp.run_for(HalfCycles(HalfCyclesPerFrame));
+
+	Outputs::CRT::SoftwareFrame frame;
+	frame.width = 640;
+	frame.height = 480;
+	vdp.get_crt()->draw_frame(frame);
+
+	uint32_t hash = 2166136261;
+	for(const auto byte: frame.pixels) {
+		hash = (hash ^ byte) * 16777619;
+	}
+	return hash;
+}
+
+}
+
 @interface MasterSystemVDPTests : XCTestCase
 @end
 
@@ -173,4 +376,188 @@
 	}
 }
 
+#pragma mark - Output
+
+/*!
+	Runs @c pair for three frames, with status reads, VRAM writes and writes to @c registers at pseudo-random
+	points, comparing status bytes whenever read and frames at the end of each.
+*/
+- (void)compareOutputOfPair:(VDPPair &)pair mode:(NSString *)mode registers:(const std::vector<int> &)registers {
+	std::minstd_rand random;
+	pair.discard_frames();
+	for(int frame = 0; frame < 3; ++frame) {
+		int time_remaining = HalfCyclesPerFrame;
+		while(time_remaining) {
+			const int period = std::min(time_remaining, int(random() % 12000));
+			pair.run_for(period);
+			time_remaining -= period;
+
+			uint8_t status;
+			switch(random() % 3) {
+				case 0:
+					XCTAssert(pair.status_matches(status), @"%@ status should match in frame %d", mode, frame);
+				break;
+				case 1:
+					pair.set_register(1, uint8_t(random()));
+					pair.set_register(1, uint8_t(random() & 0x3f) | 0x40);
+					pair.set_register(0, uint8_t(random()));
+				break;
+				case 2:
+					pair.write_register(registers[random() % registers.size()], uint8_t(random()));
+				break;
+			}
+		}
+
+		uint8_t status;
+		XCTAssert(pair.status_matches(status), @"%@ status should match at the end of frame %d", mode, frame);
+		XCTAssert(pair.frames_match(), @"%@ frame %d should match", mode, frame);
+	}
+}
+
+- (void)testMode4Output {
+	VDPPair pair(TI::TMS::Personality::SMSVDP);
+	set_up_mode4(pair);
+	[self compareOutputOfPair:pair mode:@"Mode 4" registers:std::vector<int>{7, 8, 9, 10}];
+}
+
+- (void)testGraphicsIOutput {
+	VDPPair pair(TI::TMS::Personality::TMS9918A);
+	set_up_graphics_i(pair);
+	[self compareOutputOfPair:pair mode:@"Graphics I" registers:std::vector<int>{1, 7}];
+}
+
+- (void)testGraphicsIIOutput {
+	VDPPair pair(TI::TMS::Personality::TMS9918A);
+	set_up_graphics_ii(pair);
+	[self compareOutputOfPair:pair mode:@"Graphics II" registers:std::vector<int>{1, 7}];
+}
+
+#pragma mark - Reference output
+
+/*
+	Checksums of the second frame output in each mode, as produced by the renderer prior to bulk
+	fetching and drawing. They also depend on the CRT's software output, so will need to be
+	recaptured if that changes.
+*/
+
+- (void)testMode4Reference {
+	VDPPair pair(TI::TMS::Personality::SMSVDP);
+	set_up_mode4(pair);
+	XCTAssertEqual(checksum_of_second_frame(pair.whole), 0x168d343fu);
+}
+
+- (void)testGraphicsIReference {
+	VDPPair pair(TI::TMS::Personality::TMS9918A);
+	set_up_graphics_i(pair);
+	XCTAssertEqual(checksum_of_second_frame(pair.whole), 0x051310d8u);
+}
+
+- (void)testGraphicsIIReference {
+	VDPPair pair(TI::TMS::Personality::TMS9918A);
+	set_up_graphics_ii(pair);
+	XCTAssertEqual(checksum_of_second_frame(pair.whole), 0x93638355u);
+}
+
+- (void)testMulticolourReference {
+	VDPPair pair(TI::TMS::Personality::TMS9918A);
+	set_up_multicolour(pair);
+	XCTAssertEqual(checksum_of_second_frame(pair.whole), 0x63ea7dc4u);
+}
+
+- (void)testTextReference {
+	VDPPair pair(TI::TMS::Personality::TMS9918A);
+	set_up_text(pair);
+	XCTAssertEqual(checksum_of_second_frame(pair.whole), 0x4e21e16du);
+}
+
+#pragma mark - Sprite status
+
+/// Runs @c vdp for a frame, discarding status beforehand, and @returns the status at the end.
+- (uint8_t)statusAfterFrameOfVDP:(TI::TMS::TMS9918 &)vdp {
+	vdp.get_register(1);
+	vdp.run_for(HalfCycles(HalfCyclesPerFrame));
+	return vdp.get_register(1);
+}
+
+- (void)testTMSSpriteStatus {
+	// Only one of the pair is inspected; the pair is used for its memory and register helpers.
+	VDPPair pair(TI::TMS::Personality::TMS9918A);
+	TI::TMS::TMS9918 &vdp = pair.whole;
+
+	// Graphics I with 8x8 sprites, attributes at 0x1b00, patterns at 0x3800; sprite 0 is solid.
+	pair.write_register(1, 0x00);
+	pair.write_memory(0x3800, std::vector<uint8_t>(8, 0xff));
+	pair.write_register(0, 0x00);
+	pair.write_register(1, 0x40);
+	pair.write_register(2, 0x06);
+	pair.write_register(5, 0x36);
+	pair.write_register(6, 0x07);
+
+	// Two overlapping sprites, then a terminator.
+	pair.write_memory(0x1b00, {
+		50, 100, 0, 0x0f,
+		50, 104, 0, 0x0e,
+		0xd0
+	});
+	uint8_t status = [self statusAfterFrameOfVDP:vdp];
+	XCTAssert(status & 0x20, @"Overlapping sprites should collide");
+	XCTAssert(!(status & 0x40), @"Two sprites shouldn't overflow");
+
+	// Sprites with the transparent colour still collide.
+	pair.write_memory(0x1b03, {0x00});
+	XCTAssert([self statusAfterFrameOfVDP:vdp] & 0x20, @"Transparent sprites should collide");
+
+	// Adjacent sprites don't.
+	pair.write_memory(0x1b05, {108});
+	XCTAssert(!([self statusAfterFrameOfVDP:vdp] & 0x20), @"Adjacent sprites shouldn't collide");
+
+	// Five sprites on a line: the fifth is reported. Sprites are spaced so as not to collide.
+	pair.write_memory(0x1b00, {
+		50, 0, 0, 0x0f,
+		50, 16, 0, 0x0f,
+		50, 32, 0, 0x0f,
+		50, 48, 0, 0x0f,
+		50, 64, 0, 0x0f,
+		0xd0
+	});
+	status = [self statusAfterFrameOfVDP:vdp];
+	XCTAssert((status & 0x60) == 0x40, @"Five sprites on a line should overflow without colliding");
+	XCTAssertEqual(status & 0x1f, 4, @"The fifth sprite should be identified");
+}
+
+- (void)testMode4SpriteStatus {
+	VDPPair pair(TI::TMS::Personality::SMSVDP);
+	TI::TMS::TMS9918 &vdp = pair.whole;
+
+	// Mode 4 with 8x8 sprites; attributes at 0x3f00 and patterns from 0x2000, of which tile 1 is solid.
+	pair.write_register(1, 0x00);
+	pair.write_memory(0x2020, std::vector<uint8_t>(32, 0xff));
+	pair.write_register(0, 0x04);
+	pair.write_register(1, 0x40);
+	pair.write_register(2, 0xff);
+	pair.write_register(5, 0xff);
+	pair.write_register(6, 0xff);
+
+	// Two overlapping sprites, then a terminator.
+	pair.write_memory(0x3f00, {50, 50, 0xd0});
+	pair.write_memory(0x3f80, {100, 1, 104, 1});
+	uint8_t status = [self statusAfterFrameOfVDP:vdp];
+	XCTAssert(status & 0x20, @"Overlapping sprites should collide");
+	XCTAssert(!(status & 0x40), @"Two sprites shouldn't overflow");
+
+	// Adjacent sprites don't.
+	pair.write_memory(0x3f82, {108});
+	XCTAssert(!([self statusAfterFrameOfVDP:vdp] & 0x20), @"Adjacent sprites shouldn't collide");
+
+	// Nine sprites on a line overflow.
+	pair.write_memory(0x3f00, {50, 50, 50, 50, 50, 50, 50, 50, 50, 0xd0});
+	pair.write_memory(0x3f80, {0, 1, 16, 1, 32, 1, 48, 1, 64, 1, 80, 1, 96, 1, 112, 1, 128, 1});
+	status = [self statusAfterFrameOfVDP:vdp];
+	XCTAssert((status & 0x60) == 0x40, @"Nine sprites on a line should overflow without colliding");
+
+	// Eight don't.
+	pair.write_memory(0x3f08, {0xd0});
+	XCTAssert(!([self statusAfterFrameOfVDP:vdp] & 0x40), @"Eight sprites on a line shouldn't overflow");
+}
+
 @end
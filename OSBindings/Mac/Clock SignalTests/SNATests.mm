@@ -0,0 +1,184 @@
+//
+//  SNATests.mm
+//  Clock SignalTests
+//
+//  Created by Thomas Harte on 17/10/2018.
+//  Copyright © 2018 Thomas Harte. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SNA.hpp"
+
+namespace {
+
+std::vector<uint8_t> contents_of(const std::string &file_name) {
+	std::vector<uint8_t> contents;
+	FILE *const file = fopen(file_name.c_str(), "rb");
+	if(!file) return contents;
+
+	int next;
+	while((next = fgetc(file)) != EOF) contents.push_back(uint8_t(next));
+	fclose(file);
+	return contents;
+}
+
+/// Appends a version 3 chunk named @c name, with content @c data, to @c file.
+void append_chunk(std::vector<uint8_t> &file, const char *name, const std::vector<uint8_t> &data) {
+	file.insert(file.end(), name, name + 4);
+	const uint32_t length = uint32_t(data.size());
+	for(int shift = 0; shift < 32; shift += 8) file.push_back(uint8_t(length >> shift));
+	file.insert(file.end(), data.begin(), data.end());
+}
+
+/// Writes @c contents to @c file_name and @returns an @c SNA parsed from it, or @c nullptr if it was rejected.
+std::unique_ptr<Storage::State::SNA> parse(const std::string &file_name, const std::vector<uint8_t> &contents) {
+	FILE *const file = fopen(file_name.c_str(), "wb");
+	fwrite(contents.data(), 1, contents.size(), file);
+	fclose(file);
+
+	try {
+		return std::unique_ptr<Storage::State::SNA>(new Storage::State::SNA(file_name));
+	} catch(...) {
+		return nullptr;
+	}
+}
+
+}
+
+@interface SNATests : XCTestCase
+@end
+
+@implementation SNATests {
+	std::vector<uint8_t> _fixture;
+	std::string _temporaryFileName;
+}
+
+- (void)setUp
+{
+	[super setUp];
+
+	// 6128.sna is a version 3 snapshot of a CPC 6128, with no memory dump in the header; RAM is instead
+	// supplied by compressed MEM0 and MEM1 chunks, with an unrecognised chunk between the two.
+	NSString *const path = [[NSBundle bundleForClass:[self class]] pathForResource:@"6128" ofType:@"sna"];
+	_fixture = contents_of([path UTF8String]);
+	_temporaryFileName = [[NSTemporaryDirectory() stringByAppendingPathComponent:@"SNATests.sna"] UTF8String];
+}
+
+- (void)tearDown
+{
+	remove(_temporaryFileName.c_str());
+	[super tearDown];
+}
+
+- (void)testVersion3
+{
+	XCTAssertEqual(_fixture.size(), 1843, @"The fixture should be available");
+	const auto sna = parse(_temporaryFileName, _fixture);
+	XCTAssert(sna != nullptr, @"A version 3 snapshot should be accepted");
+	if(!sna) return;
+
+	XCTAssert(sna->model == Storage::State::SNA::Model::CPC6128, @"The model should be a 6128");
+
+	XCTAssertEqual(sna->z80.af, 0x1234);	XCTAssertEqual(sna->z80.bc, 0x5678);
+	XCTAssertEqual(sna->z80.de, 0x9abc);	XCTAssertEqual(sna->z80.hl, 0xdef0);
+	XCTAssertEqual(sna->z80.af_dash, 0x0102);	XCTAssertEqual(sna->z80.bc_dash, 0x0304);
+	XCTAssertEqual(sna->z80.de_dash, 0x0506);	XCTAssertEqual(sna->z80.hl_dash, 0x0708);
+	XCTAssertEqual(sna->z80.ix, 0x3344);	XCTAssertEqual(sna->z80.iy, 0x5566);
+	XCTAssertEqual(sna->z80.sp, 0xbff0);	XCTAssertEqual(sna->z80.pc, 0x4000);
+	XCTAssertEqual(sna->z80.r, 0x11);		XCTAssertEqual(sna->z80.i, 0x22);
+	XCTAssert(sna->z80.iff1 && !sna->z80.iff2, @"Interrupt flip-flops should be read");
+	XCTAssertEqual(sna->z80.interrupt_mode, 1);
+
+	// The fixture stores palette entries as they would be written, with bit 6 set.
+	XCTAssertEqual(sna->gate_array.selected_pen, 0x10);
+	for(int c = 0; c < 17; ++c) {
+		XCTAssertEqual(sna->gate_array.palette[c], c, @"Palette entry %d should be read without its command bits", c);
+	}
+	XCTAssertEqual(sna->gate_array.rom_and_mode_configuration, 0x89);
+	XCTAssertEqual(sna->gate_array.ram_configuration, 0xc4);
+
+	XCTAssertEqual(sna->crtc.selected_register, 0x0c);
+	for(int c = 0; c < 18; ++c) XCTAssertEqual(sna->crtc.registers[c], 0x30 + c);
+
+	XCTAssertEqual(sna->upper_rom_selection, 0x07);
+	XCTAssertEqual(sna->ppi.port_a, 0xf4);	XCTAssertEqual(sna->ppi.port_b, 0x5e);
+	XCTAssertEqual(sna->ppi.port_c, 0x76);	XCTAssertEqual(sna->ppi.control, 0x82);
+
+	XCTAssertEqual(sna->psg.selected_register, 0x07);
+	for(int c = 0; c < 16; ++c) XCTAssertEqual(sna->psg.registers[c], 0x20 + c);
+
+	// MEM0 begins with three literals, an escaped 0xe5 and a run of 255 0xaas, then is zero other than its final byte;
+	// MEM1 is entirely 0x11.
+	XCTAssertEqual(sna->ram.size(), 131072, @"Both memory chunks should be loaded");
+	if(sna->ram.size() != 131072) return;
+	XCTAssertEqual(sna->ram[0], 1);	XCTAssertEqual(sna->ram[1], 2);	XCTAssertEqual(sna->ram[2], 3);
+	XCTAssertEqual(sna->ram[3], 0xe5, @"0xe5 followed by 0 should be a literal 0xe5");
+	for(std::size_t c = 4; c < 259; ++c) XCTAssertEqual(sna->ram[c], 0xaa, @"A run should be expanded");
+	for(std::size_t c = 259; c < 65535; ++c) {
+		if(sna->ram[c]) {
+			XCTAssert(false, @"RAM at %04zx should be zero", c);
+			break;
+		}
+	}
+	XCTAssertEqual(sna->ram[65535], 0x42);
+	for(std::size_t c = 65536; c < 131072; ++c) {
+		if(sna->ram[c] != 0x11) {
+			XCTAssert(false, @"RAM at %05zx should have been filled from MEM1", c);
+			break;
+		}
+	}
+}
+
+- (void)testVersion1
+{
+	// Rewrite the fixture as a version 1 snapshot, with an uncompressed 64kb memory dump in place of chunks.
+	const auto original = parse(_temporaryFileName, _fixture);
+	XCTAssert(original != nullptr);
+	if(!original) return;
+
+	std::vector<uint8_t> contents(_fixture.begin(), _fixture.begin() + 0x100);
+	contents[0x10] = 1;
+	contents[0x6b] = 64;
+	contents[0x6c] = 0;
+	contents.insert(contents.end(), original->ram.begin(), original->ram.begin() + 65536);
+
+	const auto sna = parse(_temporaryFileName, contents);
+	XCTAssert(sna != nullptr, @"A version 1 snapshot should be accepted");
+	if(!sna) return;
+	XCTAssert(sna->model == Storage::State::SNA::Model::Unknown, @"Version 1 snapshots don't record a model");
+	XCTAssertEqual(sna->z80.pc, 0x4000);
+	XCTAssert(sna->ram == std::vector<uint8_t>(original->ram.begin(), original->ram.begin() + 65536), @"The memory dump should be read");
+}
+
+- (void)testExpansionRAMRejected
+{
+	std::vector<uint8_t> contents = _fixture;
+	append_chunk(contents, "MEM2", {0xe5, 0xff, 0x00});
+	XCTAssert(parse(_temporaryFileName, contents) == nullptr, @"A snapshot with expansion RAM beyond 128kb should be rejected");
+}
+
+- (void)testMalformedFilesRejected
+{
+	std::vector<uint8_t> contents = _fixture;
+	contents[0] = 'N';
+	XCTAssert(parse(_temporaryFileName, contents) == nullptr, @"A file without the SNA signature should be rejected");
+
+	contents = _fixture;
+	contents[0x10] = 4;
+	XCTAssert(parse(_temporaryFileName, contents) == nullptr, @"An unknown version should be rejected");
+
+	contents = std::vector<uint8_t>(_fixture.begin(), _fixture.begin() + 0x100);
+	XCTAssert(parse(_temporaryFileName, contents) == nullptr, @"A snapshot without memory should be rejected");
+
+	contents[0x10] = 2;
+	contents[0x6b] = 64;
+	XCTAssert(parse(_temporaryFileName, contents) == nullptr, @"A snapshot with a truncated memory dump should be rejected");
+}
+
+@end
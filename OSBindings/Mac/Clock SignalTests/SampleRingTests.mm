@@ -0,0 +1,177 @@
+//
+//  SampleRingTests.mm
+//  Clock SignalTests
+//
+//  Created by Thomas Harte on 17/10/2018.
+//  Copyright © 2018 Thomas Harte. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "SampleRing.hpp"
+
+namespace {
+
+/// @returns @c count consecutive samples, starting from @c first.
+std::vector<int16_t> sequence(int first, std::size_t count) {
+	std::vector<int16_t> samples(count);
+	for(std::size_t c = 0; c < count; ++c) samples[c] = int16_t(first + int(c));
+	return samples;
+}
+
+}
+
+@interface SampleRingTests : XCTestCase
+@end
+
+@implementation SampleRingTests
+
+- (void)testCapacity
+{
+	XCTAssertEqual(Outputs::Speaker::SampleRing(1).capacity(), 1);
+	XCTAssertEqual(Outputs::Speaker::SampleRing(5).capacity(), 8, @"Capacity should be rounded up to a power of two");
+	XCTAssertEqual(Outputs::Speaker::SampleRing(8).capacity(), 8, @"A power of two should be used as is");
+	XCTAssertEqual(Outputs::Speaker::SampleRing(1025).capacity(), 2048);
+}
+
+- (void)testEmpty
+{
+	Outputs::Speaker::SampleRing ring(8);
+	int16_t samples[4] = {};
+	XCTAssertEqual(ring.size(), 0);
+
+	XCTAssertEqual(ring.read(samples, 0), 0);
+	XCTAssertEqual(ring.underruns(), 0, @"Reading nothing from an empty ring shouldn't underrun");
+
+	XCTAssertEqual(ring.read(samples, 4), 0, @"Nothing should be read from an empty ring");
+	XCTAssertEqual(ring.underruns(), 1, @"Reading from an empty ring should underrun");
+
+	// Supply fewer samples than are then requested.
+	const std::vector<int16_t> written = sequence(100, 3);
+	XCTAssertEqual(ring.write(written.data(), written.size()), 3);
+	XCTAssertEqual(ring.read(samples, 4), 3, @"Only the samples available should be read");
+	XCTAssertEqual(ring.underruns(), 2, @"A partial read should underrun");
+	XCTAssert(std::equal(written.begin(), written.end(), samples), @"The samples available should be read in order");
+	XCTAssertEqual(ring.size(), 0);
+	XCTAssertEqual(ring.overruns(), 0);
+}
+
+- (void)testFull
+{
+	Outputs::Speaker::SampleRing ring(8);
+	const std::vector<int16_t> written = sequence(-4, 10);
+
+	XCTAssertEqual(ring.write(written.data(), 8), 8, @"A ring should accept as many samples as its capacity");
+	XCTAssertEqual(ring.overruns(), 0, @"Exactly filling a ring shouldn't overrun");
+	XCTAssertEqual(ring.size(), 8);
+
+	XCTAssertEqual(ring.write(written.data(), 0), 0);
+	XCTAssertEqual(ring.overruns(), 0, @"Writing nothing to a full ring shouldn't overrun");
+
+	XCTAssertEqual(ring.write(&written[8], 2), 0, @"Nothing should be written to a full ring");
+	XCTAssertEqual(ring.overruns(), 1, @"Writing to a full ring should overrun");
+
+	// Make space for three samples, then offer four: the first three should be kept.
+	int16_t samples[8];
+	XCTAssertEqual(ring.read(samples, 3), 3);
+	const std::vector<int16_t> more = sequence(1000, 4);
+	XCTAssertEqual(ring.write(more.data(), more.size()), 3, @"Only as many samples as there is space for should be written");
+	XCTAssertEqual(ring.overruns(), 2, @"A partial write should overrun");
+	XCTAssertEqual(ring.size(), 8);
+
+	XCTAssertEqual(ring.read(samples, 8), 8);
+	XCTAssert(std::equal(written.begin() + 3, written.begin() + 8, samples), @"Samples written before the overrun should be intact");
+	XCTAssert(std::equal(more.begin(), more.begin() + 3, samples + 5), @"The samples that fitted should follow");
+	XCTAssertEqual(ring.underruns(), 0);
+}
+
+- (void)testWraparound
+{
+	// Write and read pseudo-random lengths, so that both indices regularly cross the end of the buffer,
+	// checking contents, fill level and both counters against a simple model.
+	Outputs::Speaker::SampleRing ring(64);
+	std::deque<int16_t> model;
+	uint64_t overruns = 0, underruns = 0;
+	int next_sample = 0;
+
+	std::minstd_rand random;
+	std::vector<int16_t> samples(80);
+	for(int step = 0; step < 100000; ++step) {
+		const std::size_t length = random() % samples.size();
+		if(random() & 1) {
+			const std::vector<int16_t> written = sequence(next_sample, length);
+			const std::size_t expected = std::min(length, ring.capacity() - model.size());
+			if(expected < length) ++overruns;
+
+			const std::size_t result = ring.write(written.data(), length);
+			if(result != expected) {
+				XCTAssert(false, @"Write of %zu at step %d should have stored %zu samples, not %zu", length, step, expected, result);
+				return;
+			}
+			model.insert(model.end(), written.begin(), written.begin() + long(expected));
+			next_sample += int(expected);
+		} else {
+			const std::size_t expected = std::min(length, model.size());
+			if(expected < length) ++underruns;
+
+			const std::size_t result = ring.read(samples.data(), length);
+			if(result != expected || !std::equal(model.begin(), model.begin() + long(expected), samples.begin())) {
+				XCTAssert(false, @"Read of %zu at step %d should have supplied the oldest %zu samples", length, step, expected);
+				return;
+			}
+			model.erase(model.begin(), model.begin() + long(expected));
+		}
+
+		if(ring.size() != model.size() || ring.overruns() != overruns || ring.underruns() != underruns) {
+			XCTAssert(false, @"Size and counters should match after step %d", step);
+			return;
+		}
+	}
+
+	XCTAssert(overruns > 100 && underruns > 100, @"Both overruns and underruns should have been exercised");
+	XCTAssert(next_sample > 1000000, @"The ring should have wrapped many times");
+}
+
+- (void)testThreaded
+{
+	// Feed a long sequence through the ring from another thread, retrying whatever doesn't fit;
+	// everything should arrive, in order.
+	Outputs::Speaker::SampleRing ring(256);
+	const int total = 1 << 16;
+
+	std::thread writer([&ring, total] {
+		int next_sample = 0;
+		std::size_t length = 1;
+		while(next_sample < total) {
+			length = 1 + (length * 7) % 300;
+			const std::vector<int16_t> samples = sequence(next_sample, std::min(length, std::size_t(total - next_sample)));
+			const std::size_t written = ring.write(samples.data(), samples.size());
+			if(!written) std::this_thread::yield();
+			next_sample += int(written);
+		}
+	});
+
+	int expected = 0;
+	bool in_order = true;
+	int16_t samples[200];
+	while(expected < total) {
+		const std::size_t read = ring.read(samples, sizeof(samples) / sizeof(*samples));
+		if(!read) std::this_thread::yield();
+		for(std::size_t c = 0; c < read; ++c) {
+			in_order &= samples[c] == int16_t(expected);
+			++expected;
+		}
+	}
+	writer.join();
+
+	XCTAssert(in_order, @"Samples should be received in the order written");
+	XCTAssertEqual(ring.size(), 0);
+}
+
+@end
@@ -0,0 +1,302 @@
+//
+//  SerialiserTests.mm
+//  Clock SignalTests
+//
+//  Created by Thomas Harte on 17/10/2018.
+//  Copyright © 2018 Thomas Harte. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#include <vector>
+
+#include "Serialiser.hpp"
+#include "SnapshotMachine.hpp"
+
+namespace {
+
+enum class Colour: uint8_t {
+	Red, Green, Blue
+};
+
+/// A component with one of each type of field, which serialises itself within a section of the supplied version.
+struct Fields {
+	uint8_t byte = 0;
+	int16_t word = 0;
+	uint32_t long_word = 0;
+	int64_t quad_word = 0;
+	bool flag = false;
+	Colour colour = Colour::Red;
+	float single = 0.0f;
+	double real = 0.0;
+	Cycles cycles;
+	uint16_t array[3] = {0, 0, 0};
+	uint8_t byte_array[2] = {0, 0};
+	std::vector<uint8_t> vector;
+
+	void serialise(Storage::State::Serialiser &serialiser, int version = 1) {
+		serialiser.begin_section("TEST", version);
+			serialiser.field(byte);
+			serialiser.field(word);
+			serialiser.field(long_word);
+			serialiser.field(quad_word);
+			serialiser.field(flag);
+			serialiser.field(colour);
+			serialiser.field(single);
+			serialiser.field(real);
+			serialiser.field(cycles);
+			serialiser.field(array);
+			serialiser.field(byte_array);
+			serialiser.field(vector, false);
+		serialiser.end_section();
+	}
+
+	void populate() {
+		byte = 0xa5;
+		word = -1234;
+		long_word = 0x12345678;
+		quad_word = -0x123456789abLL;
+		flag = true;
+		colour = Colour::Blue;
+		single = 1.0f;
+		real = -0.1;
+		cycles = Cycles(56789);
+		array[0] = 1; array[1] = 0x203; array[2] = 0xffff;
+		byte_array[0] = 9; byte_array[1] = 10;
+		vector = {1, 2, 3, 4, 5};
+	}
+
+	bool operator ==(const Fields &rhs) const {
+		return
+			byte == rhs.byte && word == rhs.word && long_word == rhs.long_word && quad_word == rhs.quad_word &&
+			flag == rhs.flag && colour == rhs.colour && single == rhs.single && real == rhs.real &&
+			cycles == rhs.cycles &&
+			array[0] == rhs.array[0] && array[1] == rhs.array[1] && array[2] == rhs.array[2] &&
+			byte_array[0] == rhs.byte_array[0] && byte_array[1] == rhs.byte_array[1] &&
+			vector == rhs.vector;
+	}
+};
+
+/// @returns The state of @c fields, captured within a section of version @c version.
+std::vector<uint8_t> capture(Fields &fields, int version = 1) {
+	std::vector<uint8_t> state;
+	Storage::State::Serialiser serialiser(state);
+	fields.serialise(serialiser, version);
+	return state;
+}
+
+/// Restores @c fields from @c state, expecting a section of version @c version; @returns @c true on success.
+bool restore(Fields &fields, const std::vector<uint8_t> &state, int version = 1) {
+	Storage::State::Serialiser serialiser(state);
+	fields.serialise(serialiser, version);
+	return serialiser.is_valid();
+}
+
+/// A snapshot machine with two pieces of state, each in its own section.
+class TestSnapshotMachine: public SnapshotMachine::Machine {
+	public:
+		uint32_t first = 0, second = 0;
+		int second_version = 1;
+
+	protected:
+		void serialise(Storage::State::Serialiser &serialiser) override {
+			serialiser.begin_section("ONE ", 1);
+				serialiser.field(first);
+			serialiser.end_section();
+
+			serialiser.begin_section("TWO ", second_version);
+				serialiser.field(second);
+			serialiser.end_section();
+		}
+};
+
+}
+
+@interface SerialiserTests : XCTestCase
+@end
+
+@implementation SerialiserTests
+
+- (void)testRoundTrip
+{
+	Fields original;
+	original.populate();
+	const std::vector<uint8_t> state = capture(original);
+
+	Fields restored;
+	XCTAssert(restore(restored, state), @"Restoration should succeed");
+	XCTAssert(restored == original, @"All fields should be restored to their captured values");
+}
+
+- (void)testLayout
+{
+	std::vector<uint8_t> state;
+	Storage::State::Serialiser serialiser(state);
+	uint32_t integer = 0x12345678;
+	float single = 1.0f;
+	serialiser.begin_section("ABCD", 3);
+		serialiser.field(integer);
+		serialiser.field(single);
+	serialiser.end_section();
+
+	// Tag, little-endian version and length, then the integer and the float's bit pattern, both little endian.
+	const std::vector<uint8_t> expected = {
+		'A', 'B', 'C', 'D',
+		0x03, 0x00,
+		0x08, 0x00, 0x00, 0x00,
+		0x78, 0x56, 0x34, 0x12,
+		0x00, 0x00, 0x80, 0x3f,
+	};
+	XCTAssert(state == expected, @"Sections and values should be stored in the documented little-endian layout");
+}
+
+- (void)testOlderVersionAccepted
+{
+	Fields original;
+	original.populate();
+	const std::vector<uint8_t> state = capture(original, 2);
+
+	Storage::State::Serialiser serialiser(state);
+	XCTAssertEqual(serialiser.begin_section("TEST", 3), 2, @"The stored version should be reported to a reader that supports it");
+	serialiser.end_section();
+	XCTAssert(serialiser.is_valid(), @"A section no later than the reader's version should be accepted");
+
+	Fields restored;
+	XCTAssert(restore(restored, state, 3), @"A section no later than the reader's version should be restored");
+	XCTAssert(restored == original, @"All fields should be restored from an earlier version");
+}
+
+- (void)testLaterVersionRejected
+{
+	Fields original;
+	original.populate();
+	const std::vector<uint8_t> state = capture(original, 2);
+
+	Fields restored;
+	XCTAssert(!restore(restored, state, 1), @"A section later than the reader's version should be rejected");
+	XCTAssert(restored == Fields(), @"No fields should be modified by a rejected section");
+}
+
+- (void)testTagRejected
+{
+	Fields original;
+	original.populate();
+	std::vector<uint8_t> state = capture(original);
+	state[0] = 'X';
+
+	Fields restored;
+	XCTAssert(!restore(restored, state), @"A section with the wrong tag should be rejected");
+	XCTAssert(restored == Fields(), @"No fields should be modified by a rejected section");
+}
+
+- (void)testTruncationRejected
+{
+	Fields original;
+	original.populate();
+	const std::vector<uint8_t> state = capture(original);
+
+	// Every proper prefix of the state should be rejected.
+	for(size_t length = 0; length < state.size(); ++length) {
+		const std::vector<uint8_t> truncated(state.begin(), state.begin() + length);
+		Fields restored;
+		XCTAssert(!restore(restored, truncated), @"State truncated to %zu bytes should be rejected", length);
+	}
+}
+
+- (void)testOverlongSectionRejected
+{
+	Fields original;
+	original.populate();
+	std::vector<uint8_t> state = capture(original);
+
+	// Claim a section length one byte longer than the data available.
+	++state[6];
+
+	Fields restored;
+	XCTAssert(!restore(restored, state), @"A section claiming to extend beyond the end of the state should be rejected");
+}
+
+- (void)testReadBeyondSectionRejected
+{
+	std::vector<uint8_t> state;
+	Storage::State::Serialiser capturer(state);
+	uint16_t value = 0x1234;
+	capturer.begin_section("TEST", 1);
+		capturer.field(value);
+	capturer.end_section();
+	state.push_back(0x56);
+	state.push_back(0x78);
+
+	// A reader that expects a 32-bit value should not read into whatever follows the section.
+	uint32_t read_value = 0;
+	const std::vector<uint8_t> &source = state;
+	Storage::State::Serialiser serialiser(source);
+	serialiser.begin_section("TEST", 1);
+		serialiser.field(read_value);
+	serialiser.end_section();
+	XCTAssert(!serialiser.is_valid(), @"Reading beyond the end of a section should be rejected");
+	XCTAssertEqual(read_value, 0, @"A field that can't be read should be left unmodified");
+}
+
+- (void)testUnreadContentSkipped
+{
+	// Capture a section with an extra trailing field, as a later version might, followed by another section.
+	std::vector<uint8_t> state;
+	Storage::State::Serialiser capturer(state);
+	uint8_t first = 0x12, extra = 0x34, second = 0x56;
+	capturer.begin_section("ONE ", 1);
+		capturer.field(first);
+		capturer.field(extra);
+	capturer.end_section();
+	capturer.begin_section("TWO ", 1);
+		capturer.field(second);
+	capturer.end_section();
+
+	uint8_t read_first = 0, read_second = 0;
+	const std::vector<uint8_t> &source = state;
+	Storage::State::Serialiser serialiser(source);
+	serialiser.begin_section("ONE ", 1);
+		serialiser.field(read_first);
+	serialiser.end_section();
+	serialiser.begin_section("TWO ", 1);
+		serialiser.field(read_second);
+	serialiser.end_section();
+	XCTAssert(serialiser.is_valid(), @"Unread content at the end of a section should be skipped");
+	XCTAssertEqual(read_first, 0x12, @"The first section should be read");
+	XCTAssertEqual(read_second, 0x56, @"The second section should be found after the first");
+}
+
+- (void)testSnapshotRoundTrip
+{
+	TestSnapshotMachine machine;
+	machine.first = 0x1234;
+	machine.second = 0x5678;
+	const std::vector<uint8_t> state = machine.get_state();
+	XCTAssert(!state.empty(), @"State should be captured");
+
+	machine.first = machine.second = 0;
+	XCTAssert(machine.set_state(state), @"State should be restored");
+	XCTAssertEqual(machine.first, 0x1234, @"The first section should be restored");
+	XCTAssertEqual(machine.second, 0x5678, @"The second section should be restored");
+}
+
+- (void)testSnapshotFailureRestoresPriorState
+{
+	// Capture state in which the second section is of a version later than the machine will accept.
+	TestSnapshotMachine machine;
+	machine.first = 0x1234;
+	machine.second = 0x5678;
+	machine.second_version = 2;
+	const std::vector<uint8_t> state = machine.get_state();
+	machine.second_version = 1;
+
+	// Restoration will apply the first section before rejecting the second; the machine should then
+	// be returned to the state it was in beforehand.
+	machine.first = 0xabcd;
+	machine.second = 0xef01;
+	XCTAssert(!machine.set_state(state), @"State with an unsupported section should be rejected");
+	XCTAssertEqual(machine.first, 0xabcd, @"The first section should have been returned to its prior state");
+	XCTAssertEqual(machine.second, 0xef01, @"The second section should have been returned to its prior state");
+}
+
+@end
@@ -0,0 +1,217 @@
+//
+//  SoundChipTests.mm
+//  Clock SignalTests
+//
+//  Created by Thomas Harte on 17/10/2018.
+//  Copyright © 2018 Thomas Harte. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "AY38910.hpp"
+#include "KonamiSCC.hpp"
+#include "SN76489.hpp"
+
+namespace {
+
+/*!
+	Drives a pair of chips through identical register writes and periods of output, one skipping spans in
+	which its output can't change and the other stepping every tick, and compares the two.
+
+	@c write should perform a register write selected by its integer argument.
+	@returns The number of the first sample at which the two differ, or -1 if they don't.
+*/
+template <typename Chip> long first_difference(
+	Concurrency::DeferringAsyncTaskQueue &queue,
+	Chip &skipping, Chip &stepping,
+	const std::function<void(Chip &, uint32_t)> &write,
+	int iterations) {
+	stepping.set_skips_quiet_ticks(false);
+
+	std::minstd_rand random;
+	long sample = 0;
+	const std::size_t channels = skipping.get_channel_count();
+	std::vector<int16_t> skipped_output, stepped_output;
+	for(int c = 0; c < iterations; ++c) {
+		// Make a few register writes.
+		const uint32_t writes = random() % 3;
+		for(uint32_t w = 0; w < writes; ++w) {
+			const uint32_t selection = random();
+			write(skipping, selection);
+			write(stepping, selection);
+		}
+		queue.perform();
+		queue.flush();
+
+		// Then generate or skip a span of output, occasionally a long one.
+		const std::size_t length = 1 + random() % ((random() & 7) ? 512 : 16384);
+		if(!(random() & 7)) {
+			skipping.skip_samples(length);
+			stepping.skip_samples(length);
+		} else {
+			skipped_output.resize(length * channels);
+			stepped_output.resize(length * channels);
+			skipping.get_samples(length, skipped_output.data());
+			stepping.get_samples(length, stepped_output.data());
+			for(std::size_t index = 0; index < skipped_output.size(); ++index) {
+				if(skipped_output[index] != stepped_output[index]) return sample + long(index / channels);
+			}
+		}
+		sample += long(length);
+	}
+	return -1;
+}
+
+void write_ay(GI::AY38910::AY38910 &ay, uint8_t reg, uint8_t value) {
+	ay.set_data_input(reg);
+	ay.set_control_lines(GI::AY38910::ControlLines(GI::AY38910::BDIR | GI::AY38910::BC2 | GI::AY38910::BC1));
+	ay.set_control_lines(GI::AY38910::ControlLines(0));
+	ay.set_data_input(value);
+	ay.set_control_lines(GI::AY38910::ControlLines(GI::AY38910::BDIR | GI::AY38910::BC2));
+	ay.set_control_lines(GI::AY38910::ControlLines(0));
+}
+
+void write_random_ay(GI::AY38910::AY38910 &ay, uint32_t selection) {
+	// Favour short periods, so that there's plenty of activity, and use of the envelope generator.
+	const uint8_t reg = uint8_t(selection % 14);
+	uint8_t value = uint8_t(selection >> 8);
+	switch(reg) {
+		case 1: case 3: case 5: case 12:	value &= 0x01;	break;
+		case 8: case 9: case 10:
+			if(value & 0x20) value |= 0x10;
+		break;
+		default: break;
+	}
+	write_ay(ay, reg, value);
+}
+
+void write_random_sn76489(TI::SN76489 &sn, uint32_t selection) {
+	// Either latch a register, with data, or supply further tone data, favouring audible volumes.
+	uint8_t value = uint8_t(selection);
+	if((value & 0x90) == 0x90) value &= (selection & 0x100) ? 0xf3 : 0xff;
+	sn.set_register(value);
+}
+
+void write_random_scc(Konami::SCC &scc, uint32_t selection) {
+	// Write either to wave memory or to one of the control registers, with short periods.
+	const uint16_t address = (selection & 0x100) ? uint16_t(selection % 0x80) : uint16_t(0x80 + (selection % 0x10));
+	uint8_t value = uint8_t(selection >> 16);
+	if(address >= 0x81 && address <= 0x89 && (address & 1)) value = 0;
+	scc.write(address, value);
+}
+
+}
+
+@interface SoundChipTests : XCTestCase
+@end
+
+@implementation SoundChipTests
+
+- (void)testAY38910
+{
+	const Outputs::Speaker::Channels channel_options[] = {
+		Outputs::Speaker::Channels::Mono,
+		Outputs::Speaker::Channels::Stereo,
+		Outputs::Speaker::Channels::Separate,
+	};
+	for(const auto channels: channel_options) {
+		Concurrency::DeferringAsyncTaskQueue queue;
+		GI::AY38910::AY38910 skipping(queue), stepping(queue);
+		skipping.set_sample_volume_range(32767);
+		stepping.set_sample_volume_range(32767);
+		skipping.set_output_channels(channels);
+		stepping.set_output_channels(channels);
+		skipping.set_output_mixing(1.0f, 0.5f, 0.0f, 0.0f, 0.5f, 1.0f);
+		stepping.set_output_mixing(1.0f, 0.5f, 0.0f, 0.0f, 0.5f, 1.0f);
+
+		const long difference = first_difference<GI::AY38910::AY38910>(queue, skipping, stepping, write_random_ay, 20000);
+		XCTAssert(difference < 0, @"AY output should match per-tick output; first differed at sample %ld", difference);
+	}
+}
+
+- (void)testSN76489
+{
+	const TI::SN76489::Personality personalities[] = {
+		TI::SN76489::Personality::SN76489,
+		TI::SN76489::Personality::SN76494,
+		TI::SN76489::Personality::SMS,
+	};
+	for(const auto personality: personalities) {
+		for(int separate = 0; separate < 2; ++separate) {
+			Concurrency::DeferringAsyncTaskQueue queue;
+			TI::SN76489 skipping(personality, queue), stepping(personality, queue);
+			skipping.set_sample_volume_range(32767);
+			stepping.set_sample_volume_range(32767);
+			if(separate) {
+				skipping.set_output_channels(Outputs::Speaker::Channels::Separate);
+				stepping.set_output_channels(Outputs::Speaker::Channels::Separate);
+			}
+
+			const long difference = first_difference<TI::SN76489>(queue, skipping, stepping, write_random_sn76489, 20000);
+			XCTAssert(difference < 0, @"SN76489 output should match per-tick output; first differed at sample %ld", difference);
+		}
+	}
+}
+
+- (void)testSN76489NoiseShiftedByChannel2
+{
+	// Every flip of tone channel 2 also shifts the noise generator, whether or not the noise channel is
+	// tracking channel 2, and regardless of volume. So silence everything, run for a while with noise
+	// either tracking channel 2 or at its own rate, then make only noise audible: the two chips
+	// should produce the same noise.
+	const uint8_t noise_controls[] = {0xe7, 0xe4, 0xe3};
+	for(const auto noise_control: noise_controls) {
+		Concurrency::DeferringAsyncTaskQueue queue;
+		TI::SN76489 skipping(TI::SN76489::Personality::SMS, queue), stepping(TI::SN76489::Personality::SMS, queue);
+		skipping.set_sample_volume_range(32767);
+		stepping.set_sample_volume_range(32767);
+		stepping.set_skips_quiet_ticks(false);
+
+		const uint8_t setup[] = {
+			0x9f, 0xbf, 0xdf, 0xff,		// Silence all channels.
+			0xc5, 0x00,					// Set a short period for channel 2.
+			noise_control,
+		};
+		for(const auto value: setup) {
+			skipping.set_register(value);
+			stepping.set_register(value);
+		}
+		queue.perform();
+		queue.flush();
+
+		std::vector<int16_t> skipped_output(100000), stepped_output(100000);
+		skipping.get_samples(skipped_output.size(), skipped_output.data());
+		stepping.get_samples(stepped_output.size(), stepped_output.data());
+		XCTAssert(skipped_output == stepped_output, @"Silent output should match");
+
+		skipping.set_register(0xf0);
+		stepping.set_register(0xf0);
+		queue.perform();
+		queue.flush();
+
+		skipping.get_samples(skipped_output.size(), skipped_output.data());
+		stepping.get_samples(stepped_output.size(), stepped_output.data());
+		XCTAssert(skipped_output == stepped_output, @"Noise output with control %02x should match per-tick output", noise_control);
+		XCTAssert(
+			std::find_if(stepped_output.begin(), stepped_output.end(), [&] (int16_t value) { return value != stepped_output[0]; }) != stepped_output.end(),
+			@"Noise should be audible");
+	}
+}
+
+- (void)testKonamiSCC
+{
+	Concurrency::DeferringAsyncTaskQueue queue;
+	Konami::SCC skipping(queue), stepping(queue);
+	skipping.set_sample_volume_range(32767);
+	stepping.set_sample_volume_range(32767);
+
+	const long difference = first_difference<Konami::SCC>(queue, skipping, stepping, write_random_scc, 20000);
+	XCTAssert(difference < 0, @"SCC output should match per-tick output; first differed at sample %ld", difference);
+}
+
+@end
@@ -8,7 +8,11 @@
 
 #import <XCTest/XCTest.h>
 
+#include <random>
+#include <vector>
+
 #include "TIA.hpp"
+#include "TIASound.hpp"
 
 static uint8_t *line;
 static void receive_line(uint8_t *next_line)
@@ -16,6 +20,177 @@ static void receive_line(uint8_t *next_line)
 	line = next_line;
 }
 
+namespace {
+
+/*!
+	A per-sample implementation of TIA audio, as TIASound once was, against which its generation in runs
+	can be compared.
+*/
+class ReferenceTIASound {
+	public:
+		void set_volume(int channel, uint8_t volume) {
+			volume_[channel] = volume & 0xf;
+		}
+
+		void set_divider(int channel, uint8_t divider) {
+			divider_[channel] = divider & 0x1f;
+			divider_counter_[channel] = 0;
+		}
+
+		void set_control(int channel, uint8_t control) {
+			control_[channel] = control & 0xf;
+		}
+
+		void set_sample_volume_range(int16_t range) {
+			per_channel_volume_ = range / 2;
+		}
+
+		void get_samples(std::size_t number_of_samples, int16_t *target) {
+			for(std::size_t c = 0; c < number_of_samples; c++) {
+				target[c] = 0;
+				for(int channel = 0; channel < 2; channel++) {
+					divider_counter_[channel] ++;
+					const int divider_value = divider_counter_[channel] / (38 / Atari2600::CPUTicksPerAudioTick);
+					int level = 0;
+					switch(control_[channel]) {
+						case 0x0: case 0xb:	level = 1;	break;
+
+						case 0x4: case 0x5:	level = (divider_value / (divider_[channel]+1))&1;			break;
+						case 0xc: case 0xd:	level = (divider_value / ((divider_[channel]+1)*3))&1;		break;
+						case 0x6: case 0xa:	level = (divider_value / (divider_[channel]+1))%30 <= 18;	break;
+						case 0xe:			level = (divider_value / ((divider_[channel]+1)*3))%30 <= 18;	break;
+
+						case 0x1:
+							level = poly4_counter_[channel]&1;
+							if(divider_value == divider_[channel]+1) {
+								divider_counter_[channel] = 0;
+								advance_poly4(channel);
+							}
+						break;
+
+						case 0x2:
+							level = poly4_counter_[channel]&1;
+							if(divider_value%(30*(divider_[channel]+1)) == 18) {
+								advance_poly4(channel);
+							}
+						break;
+
+						case 0x3:
+							level = output_state_[channel];
+							if(divider_value == divider_[channel]+1) {
+								if(poly5_counter_[channel]&1) {
+									output_state_[channel] = poly4_counter_[channel]&1;
+									advance_poly4(channel);
+								}
+								advance_poly5(channel);
+							}
+						break;
+
+						case 0x7: case 0x9:
+							level = poly5_counter_[channel]&1;
+							if(divider_value == divider_[channel]+1) {
+								divider_counter_[channel] = 0;
+								advance_poly5(channel);
+							}
+						break;
+
+						case 0xf:
+							level = poly5_counter_[channel]&1;
+							if(divider_value == (divider_[channel]+1)*3) {
+								divider_counter_[channel] = 0;
+								advance_poly5(channel);
+							}
+						break;
+
+						case 0x8:
+							level = poly9_counter_[channel]&1;
+							if(divider_value == divider_[channel]+1) {
+								divider_counter_[channel] = 0;
+								advance_poly9(channel);
+							}
+						break;
+					}
+
+					target[c] += (volume_[channel] * per_channel_volume_ * level) >> 4;
+				}
+			}
+		}
+
+	private:
+		int volume_[2] = {0, 0}, divider_[2] = {0, 0}, control_[2] = {0, 0};
+		int poly4_counter_[2] = {0x00f, 0x00f}, poly5_counter_[2] = {0x01f, 0x01f}, poly9_counter_[2] = {0x1ff, 0x1ff};
+		int output_state_[2] = {0, 0};
+		int divider_counter_[2] = {0, 0};
+		int per_channel_volume_ = 0;
+
+		void advance_poly4(int channel) {
+			poly4_counter_[channel] = (poly4_counter_[channel] >> 1) | (((poly4_counter_[channel] << 3) ^ (poly4_counter_[channel] << 2))&0x008);
+		}
+		void advance_poly5(int channel) {
+			poly5_counter_[channel] = (poly5_counter_[channel] >> 1) | (((poly5_counter_[channel] << 4) ^ (poly5_counter_[channel] << 2))&0x010);
+		}
+		void advance_poly9(int channel) {
+			poly9_counter_[channel] = (poly9_counter_[channel] >> 1) | (((poly9_counter_[channel] << 4) ^ (poly9_counter_[channel] << 8))&0x100);
+		}
+};
+
+/// Pairs a TIASound with a ReferenceTIASound, applying every write to both.
+struct SoundPair {
+	Concurrency::DeferringAsyncTaskQueue queue;
+	Atari2600::TIASound sound;
+	ReferenceTIASound reference;
+	std::vector<int16_t> output;
+
+	SoundPair() : sound(queue) {
+		sound.set_sample_volume_range(32767);
+		reference.set_sample_volume_range(32767);
+	}
+
+	/// Writes @c value to the control register if @c reg is 0, the divider if it is 1, or the volume otherwise.
+	void write(int channel, int reg, uint8_t value) {
+		switch(reg) {
+			case 0:
+				sound.set_control(channel, value);
+				reference.set_control(channel, value);
+			break;
+			case 1:
+				sound.set_divider(channel, value);
+				reference.set_divider(channel, value);
+			break;
+			default:
+				sound.set_volume(channel, value);
+				reference.set_volume(channel, value);
+			break;
+		}
+		queue.perform();
+		queue.flush();
+	}
+
+	void set(int channel, uint8_t control, uint8_t divider, uint8_t volume) {
+		write(channel, 0, control);
+		write(channel, 1, divider);
+		write(channel, 2, volume);
+	}
+
+	/*!
+		Generates the next @c length samples from both, retaining those from the TIASound in @c output.
+
+		@returns The number of the first sample at which the two differ, or -1 if none do.
+	*/
+	long first_difference(std::size_t length) {
+		std::vector<int16_t> expected(length);
+		output.resize(length);
+		sound.get_samples(length, output.data());
+		reference.get_samples(length, expected.data());
+		for(std::size_t c = 0; c < length; ++c) {
+			if(output[c] != expected[c]) return long(c);
+		}
+		return -1;
+	}
+};
+
+}
+
 @interface TIATests : XCTestCase
 @end
 
@@ -116,4 +291,97 @@ static void receive_line(uint8_t *next_line)
 	XCTAssert(!memcmp(second_expected_line, line, sizeof(second_expected_line)));
 }
 
+#pragma mark - Audio
+
+- (void)testAudioModesMatchReference
+{
+	// Run every mode on channel 0 at a selection of dividers, with channel 1 playing something else,
+	// and compare output in runs both shorter and longer than those in which channels are generated.
+	const uint8_t dividers[] = {0, 1, 5, 17, 31};
+	const std::size_t lengths[] = {1, 37, 511, 512, 513, 4000, 100000};
+	for(uint8_t control = 0; control < 16; ++control) {
+		for(const auto divider: dividers) {
+			SoundPair pair;
+			pair.set(0, control, divider, 0xf);
+			pair.set(1, 0x7, 0x03, 0x8);
+
+			for(int repeat = 0; repeat < 3; ++repeat) {
+				for(const auto length: lengths) {
+					const long difference = pair.first_difference(length);
+					XCTAssert(difference < 0, @"Mode %x with divider %d should match reference; differed at sample %ld of %zu", control, divider, difference, length);
+				}
+			}
+		}
+	}
+}
+
+- (void)testAudioChangesMatchReference
+{
+	// Make pseudo-random writes between runs of output, including changes of mode without changes of
+	// divider, which leave the divider counter wherever the previous mode left it.
+	SoundPair pair;
+	std::minstd_rand random;
+
+	for(int c = 0; c < 20000; ++c) {
+		const uint32_t writes = random() % 3;
+		for(uint32_t w = 0; w < writes; ++w) {
+			const uint32_t selection = random();
+			pair.write(selection & 1, (selection >> 1) % 3, uint8_t(selection >> 8));
+		}
+
+		const std::size_t length = 1 + random() % ((random() & 7) ? 600 : 20000);
+		const long difference = pair.first_difference(length);
+		if(difference >= 0) {
+			XCTAssert(false, @"Output should match reference; differed at sample %ld of %zu in step %d", difference, length, c);
+			break;
+		}
+	}
+}
+
+- (void)testAudioMode2AdvancesThroughoutDivision18
+{
+	// In 4-bit poly div31 mode the divider counter is never reset, and the polynomial advances upon every
+	// sample, not just the first, for which the divided counter is 18 modulo 30 times the divider.
+	const int divider = 2;
+	const int samples_per_division = 38 / Atari2600::CPUTicksPerAudioTick;
+	const int period = samples_per_division * 30 * (divider + 1);
+	SoundPair pair;
+	pair.set(0, 0x2, divider, 0xf);
+	XCTAssertEqual(pair.first_difference(std::size_t(period * 4)), -1, @"Output should match reference");
+	const std::vector<int16_t> &output = pair.output;
+
+	int changes_in_window = 0;
+	for(std::size_t c = 1; c < output.size(); ++c) {
+		if(output[c] == output[c-1]) continue;
+
+		// Sample c - 1 was the one that advanced the polynomial; its divided counter was c / samples_per_division.
+		const int division = int(c / std::size_t(samples_per_division)) % (30 * (divider + 1));
+		XCTAssertEqual(division, 18, @"Output should change only after samples within division 18; changed at %zu", c);
+		if(c < std::size_t(period)) ++changes_in_window;
+	}
+	XCTAssert(changes_in_window > 1, @"The polynomial should advance repeatedly within a single division");
+}
+
+- (void)testAudioMode3AdvancesOnlyOnce
+{
+	// In 5/4-bit poly mode the divider counter is also never reset, so the polynomials advance only
+	// during the one division in which the divided counter equals the divider, after which output is fixed.
+	const int divider = 3;
+	const int samples_per_division = 38 / Atari2600::CPUTicksPerAudioTick;
+	SoundPair pair;
+	pair.set(0, 0x3, divider, 0xf);
+	XCTAssertEqual(pair.first_difference(100000), -1, @"Output should match reference");
+	const std::vector<int16_t> &output = pair.output;
+
+	const std::size_t window_end = std::size_t(samples_per_division * (divider + 2));
+	XCTAssertEqual(output[0], 0, @"Output should begin low");
+	XCTAssertNotEqual(output[window_end], 0, @"Output should have been set from the 4-bit polynomial");
+	for(std::size_t c = window_end; c < output.size(); ++c) {
+		if(output[c] != output[window_end]) {
+			XCTAssert(false, @"Output should not change after the divided counter passes the divider; changed at %zu", c);
+			break;
+		}
+	}
+}
+
 @end
@@ -0,0 +1,631 @@
+//
+//  main.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../Processors/AllRAMBatchRunner.hpp"
+#include "../../Processors/6502/AllRAM/6502AllRAM.hpp"
+#include "../../Processors/Z80/AllRAM/Z80AllRAM.hpp"
+
+/*
+	Runs the standard Z80 and 6502 conformance suites — ZEXDOC, ZEXALL, the FUSE unit tests, Klaus Dormann's
+	functional tests and Wolfgang Lorenz's test suite — against the all-RAM processors, reporting whether each
+	passed and the speed at which it ran. The suites themselves are those kept alongside the Xcode unit tests.
+
+	Results are written to standard output as CSV, one suite per line, with the columns:
+
+		name, result, instructions, cycles, seconds, mips, mhz
+
+	Instructions are counted as opcode fetches, so on the Z80 each prefix byte counts separately. Details of any
+	failure are written to standard error. The exit code is zero only if every suite run passed.
+*/
+
+namespace {
+
+struct Options {
+	std::string test_path = "../Mac/Clock SignalTests/";
+	std::string filter;
+	std::size_t number_of_threads = 0;
+	bool verbose = false;
+};
+
+struct Result {
+	bool passed = false;
+	std::string detail;
+	uint64_t instructions = 0;
+	uint64_t cycles = 0;
+};
+
+void print_header() {
+	std::cout << "name,result,instructions,cycles,seconds,mips,mhz" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+}
+
+/*!
+	Runs @c suite, timing it, then reports its result as @c name.
+
+	@returns @c true if the suite passed; @c false otherwise.
+*/
+bool run_suite(const std::string &name, const std::function<void(Result &)> &suite) {
+	Result result;
+
+	const auto start_time = std::chrono::high_resolution_clock::now();
+	suite(result);
+	const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+
+	const double mips = seconds > 0.0 ? static_cast<double>(result.instructions) / (seconds * 1000000.0) : 0.0;
+	const double mhz = seconds > 0.0 ? static_cast<double>(result.cycles) / (seconds * 1000000.0) : 0.0;
+	std::cout << name << ',' << (result.passed ? "pass" : "fail") << ',' << result.instructions << ',' << result.cycles << ',' << seconds << ',' << mips << ',' << mhz << std::endl;
+	if(!result.detail.empty()) {
+		std::cerr << name << ": " << result.detail << std::endl;
+	}
+
+	return result.passed;
+}
+
+/// @returns The contents of the file at @c path, or an empty vector if it couldn't be read.
+std::vector<uint8_t> read_file(const std::string &path) {
+	std::vector<uint8_t> data;
+	FILE *const file = std::fopen(path.c_str(), "rb");
+	if(!file) return data;
+
+	std::fseek(file, 0, SEEK_END);
+	data.resize(static_cast<std::size_t>(std::ftell(file)));
+	std::fseek(file, 0, SEEK_SET);
+	if(std::fread(data.data(), 1, data.size(), file) != data.size()) data.clear();
+	std::fclose(file);
+	return data;
+}
+
+std::string hex(uint16_t value) {
+	std::ostringstream stream;
+	stream << std::hex << std::setw(4) << std::setfill('0') << value;
+	return stream.str();
+}
+
+// MARK: - ZEXDOC and ZEXALL.
+
+/*!
+	Provides just enough of CP/M to run the ZEX instruction exercisers: console output via
+	BDOS at 0005h, and termination either by BDOS function 0 or by a jump to 0000h.
+*/
+class CPMTrapHandler: public CPU::AllRAMProcessor::TrapHandler {
+	public:
+		CPMTrapHandler(CPU::Z80::AllRAMProcessor &z80, bool verbose) : z80_(z80), verbose_(verbose) {}
+
+		void processor_did_trap(CPU::AllRAMProcessor &, uint16_t address) override {
+			switch(address) {
+				case 0x0005:
+					switch(z80_.get_value_of_register(CPU::Z80::Register::C)) {
+						case 0:
+							is_finished = true;
+						break;
+
+						case 2:
+						case 5:
+							append(static_cast<char>(z80_.get_value_of_register(CPU::Z80::Register::E)));
+						break;
+
+						case 9: {
+							uint16_t string_address = z80_.get_value_of_register(CPU::Z80::Register::DE);
+							while(true) {
+								uint8_t character;
+								z80_.get_data_at_address(string_address, 1, &character);
+								if(character == '$') break;
+								append(static_cast<char>(character));
+								++string_address;
+							}
+						} break;
+
+						default: break;
+					}
+				break;
+
+				case 0x0000:
+					is_finished = true;
+				break;
+
+				default: break;
+			}
+		}
+
+		std::string output;
+		bool is_finished = false;
+
+	private:
+		void append(char character) {
+			output.push_back(character);
+			if(verbose_) std::cerr << character;
+		}
+
+		CPU::Z80::AllRAMProcessor &z80_;
+		const bool verbose_;
+};
+
+void run_zex(const std::string &file_name, const Options &options, Result &result) {
+	const std::vector<uint8_t> program = read_file(options.test_path + "Zexall/" + file_name);
+	if(program.empty()) {
+		result.detail = "couldn't load " + file_name;
+		return;
+	}
+
+	std::unique_ptr<CPU::Z80::AllRAMProcessor> z80(CPU::Z80::AllRAMProcessor::Processor());
+	z80->reset_power_on();
+
+	// Install the test program at the usual CP/M place; put a RET at the BDOS entry point, with 0xffff
+	// as the top of the TPA, and a JP 0000h at 0000h so that a warm boot ends the test.
+	const uint8_t bdos[] = {0xc9, 0xff, 0xff};
+	const uint8_t warm_boot[] = {0xc3, 0x00, 0x00};
+	z80->set_data_at_address(0x0100, program.size(), program.data());
+	z80->set_data_at_address(0x0005, sizeof(bdos), bdos);
+	z80->set_data_at_address(0x0000, sizeof(warm_boot), warm_boot);
+
+	CPMTrapHandler trap_handler(*z80, options.verbose);
+	z80->set_trap_handler(&trap_handler);
+	z80->add_trap_address(0x0005);
+	z80->add_trap_address(0x0000);
+	z80->set_value_of_register(CPU::Z80::Register::ProgramCounter, 0x0100);
+
+	// A complete run of ZEXALL is a little under fifty billion cycles; allow twice that.
+	const int cycles_per_step = 10000000;
+	const uint64_t cycle_limit = 100000000000;
+	while(!trap_handler.is_finished && result.cycles < cycle_limit) {
+		z80->run_for(Cycles(cycles_per_step));
+		result.cycles += cycles_per_step;
+	}
+	result.instructions = z80->get_opcode_fetch_count();
+
+	// Each exercise reports a line naming it followed by a run of dots and then either OK or ERROR.
+	int passes = 0;
+	std::vector<std::string> failures;
+	std::istringstream output(trap_handler.output);
+	std::string line;
+	while(std::getline(output, line)) {
+		if(line.find("OK") != std::string::npos) ++passes;
+		if(line.find("ERROR") != std::string::npos) failures.push_back(line.substr(0, line.find("..")));
+	}
+
+	const bool completed = trap_handler.output.find("Tests complete") != std::string::npos;
+	result.passed = completed && passes > 0 && failures.empty();
+	if(!result.passed) {
+		std::ostringstream detail;
+		detail << passes << " exercises OK, " << failures.size() << " failed";
+		for(const auto &failure: failures) detail << "; " << failure;
+		if(!completed) detail << "; didn't complete";
+		result.detail = detail.str();
+	}
+}
+
+// MARK: - FUSE.
+
+/*!
+	A processor state as described by the FUSE tests: twelve register pairs, in the order
+	AF, BC, DE, HL, AF', BC', DE', HL', IX, IY, SP, PC, then I, R, IFF1, IFF2, the interrupt mode,
+	whether the processor is halted and the number of T states; plus some memory contents.
+*/
+struct FUSEState {
+	uint16_t registers[12];
+	unsigned int i, r;
+	int iff1, iff2, interrupt_mode, is_halted, t_states;
+	std::vector<std::pair<uint16_t, std::vector<uint8_t>>> memory;
+};
+
+const CPU::Z80::Register fuse_registers[12] = {
+	CPU::Z80::Register::AF, CPU::Z80::Register::BC, CPU::Z80::Register::DE, CPU::Z80::Register::HL,
+	CPU::Z80::Register::AFDash, CPU::Z80::Register::BCDash, CPU::Z80::Register::DEDash, CPU::Z80::Register::HLDash,
+	CPU::Z80::Register::IX, CPU::Z80::Register::IY, CPU::Z80::Register::StackPointer, CPU::Z80::Register::ProgramCounter
+};
+
+/// Reads the two register lines of a FUSE test from @c file into @c state; @returns @c true on success.
+bool read_fuse_registers(std::istream &file, const std::string &first_line, FUSEState &state) {
+	std::istringstream registers(first_line);
+	registers >> std::hex;
+	for(auto &value: state.registers) registers >> value;
+
+	std::string line;
+	std::getline(file, line);
+	std::istringstream others(line);
+	others >> std::hex >> state.i >> state.r >> std::dec >> state.iff1 >> state.iff2 >> state.interrupt_mode >> state.is_halted >> state.t_states;
+
+	return !registers.fail() && !others.fail();
+}
+
+/// Reads memory lines, each an address, some bytes and -1, until a line that is blank or just -1.
+void read_fuse_memory(std::istream &file, FUSEState &state) {
+	std::string line;
+	while(std::getline(file, line)) {
+		std::istringstream memory(line);
+		int address;
+		if(!(memory >> std::hex >> address) || address < 0) break;
+
+		std::vector<uint8_t> bytes;
+		int value;
+		while(memory >> value && value >= 0) bytes.push_back(static_cast<uint8_t>(value));
+		state.memory.emplace_back(static_cast<uint16_t>(address), bytes);
+	}
+}
+
+void run_fuse(const Options &options, Result &result) {
+	std::ifstream inputs(options.test_path + "FUSE/tests.in");
+	std::ifstream expectations(options.test_path + "FUSE/tests.expected");
+	if(!inputs.is_open() || !expectations.is_open()) {
+		result.detail = "couldn't load tests.in and tests.expected";
+		return;
+	}
+
+	int passes = 0;
+	std::vector<std::string> failures;
+	std::string name, line;
+	while(std::getline(inputs, name)) {
+		if(name.empty()) continue;
+
+		// Read the initial state.
+		FUSEState initial;
+		std::getline(inputs, line);
+		if(!read_fuse_registers(inputs, line, initial)) break;
+		read_fuse_memory(inputs, initial);
+
+		// Read the expected state, skipping the list of bus events that precedes it.
+		FUSEState expected;
+		std::string expected_name;
+		while(std::getline(expectations, expected_name) && expected_name.empty());
+		do {
+			std::getline(expectations, line);
+		} while(!line.empty() && line[0] == ' ');
+		if(expected_name != name || !read_fuse_registers(expectations, line, expected)) {
+			result.detail = "expectations don't match inputs at " + name;
+			return;
+		}
+		read_fuse_memory(expectations, expected);
+
+		// Set up and run.
+		std::unique_ptr<CPU::Z80::AllRAMProcessor> z80(CPU::Z80::AllRAMProcessor::Processor());
+		z80->reset_power_on();
+		for(int c = 0; c < 12; ++c) z80->set_value_of_register(fuse_registers[c], initial.registers[c]);
+		z80->set_value_of_register(CPU::Z80::Register::I, static_cast<uint16_t>(initial.i));
+		z80->set_value_of_register(CPU::Z80::Register::R, static_cast<uint16_t>(initial.r));
+		z80->set_value_of_register(CPU::Z80::Register::IFF1, static_cast<uint16_t>(initial.iff1));
+		z80->set_value_of_register(CPU::Z80::Register::IFF2, static_cast<uint16_t>(initial.iff2));
+		z80->set_value_of_register(CPU::Z80::Register::IM, static_cast<uint16_t>(initial.interrupt_mode));
+		for(const auto &block: initial.memory) z80->set_data_at_address(block.first, block.second.size(), block.second.data());
+
+		z80->run_for(Cycles(expected.t_states));
+		result.cycles += static_cast<uint64_t>(expected.t_states);
+		result.instructions += z80->get_opcode_fetch_count();
+
+		// Compare. As per the Xcode tests, bits 3 and 5 of the flags aren't tested: the FUSE expectations for
+		// those are inconsistent with other documentation.
+		std::string failure;
+		if(z80->get_timestamp() != HalfCycles(expected.t_states * 2)) failure = "instruction length";
+		for(int c = 0; c < 12; ++c) {
+			const bool is_flags = fuse_registers[c] == CPU::Z80::Register::AF || fuse_registers[c] == CPU::Z80::Register::AFDash;
+			const uint16_t mask = is_flags ? 0xffd7 : 0xffff;
+			if((z80->get_value_of_register(fuse_registers[c]) ^ expected.registers[c]) & mask) failure = "registers";
+		}
+		if(
+			z80->get_value_of_register(CPU::Z80::Register::I) != expected.i ||
+			z80->get_value_of_register(CPU::Z80::Register::R) != expected.r ||
+			z80->get_value_of_register(CPU::Z80::Register::IFF1) != expected.iff1 ||
+			z80->get_value_of_register(CPU::Z80::Register::IFF2) != expected.iff2 ||
+			z80->get_value_of_register(CPU::Z80::Register::IM) != expected.interrupt_mode ||
+			z80->get_halt_line() != !!expected.is_halted
+		) failure = "registers";
+		for(const auto &block: expected.memory) {
+			std::vector<uint8_t> contents(block.second.size());
+			z80->get_data_at_address(block.first, contents.size(), contents.data());
+			if(contents != block.second) failure = "memory";
+		}
+
+		if(failure.empty()) {
+			++passes;
+		} else {
+			failures.push_back(name + " (" + failure + ")");
+		}
+	}
+
+	result.passed = passes > 0 && failures.empty();
+	if(!result.passed) {
+		std::ostringstream detail;
+		detail << passes << " tests passed, " << failures.size() << " failed";
+		for(const auto &failure: failures) detail << "; " << failure;
+		result.detail = detail.str();
+	}
+}
+
+// MARK: - Klaus Dormann.
+
+/*!
+	Runs one of Klaus Dormann's tests, which signal completion — successful or otherwise — by entering
+	a tight loop. Success is indicated by the address of that loop matching @c success_address.
+*/
+void run_klaus_dormann(const std::string &file_name, CPU::MOS6502::Personality personality, uint16_t success_address, const Options &options, Result &result) {
+	const std::vector<uint8_t> test = read_file(options.test_path + "Klaus Dormann/" + file_name);
+	if(test.empty()) {
+		result.detail = "couldn't load " + file_name;
+		return;
+	}
+
+	std::unique_ptr<CPU::MOS6502::AllRAMProcessor> mos6502(CPU::MOS6502::AllRAMProcessor::Processor(personality));
+	mos6502->set_data_at_address(0, test.size(), test.data());
+	mos6502->set_value_of_register(CPU::MOS6502::Register::ProgramCounter, 0x400);
+
+	const uint64_t cycle_limit = 1000000000;
+	uint16_t address = 0;
+	while(result.cycles < cycle_limit) {
+		const uint16_t old_address = mos6502->get_value_of_register(CPU::MOS6502::Register::LastOperationAddress);
+		mos6502->run_for(Cycles(1000));
+		result.cycles += 1000;
+
+		address = mos6502->get_value_of_register(CPU::MOS6502::Register::LastOperationAddress);
+		if(address == old_address) {
+			mos6502->run_for(Cycles(7));
+			result.cycles += 7;
+			if(mos6502->get_value_of_register(CPU::MOS6502::Register::LastOperationAddress) == old_address) break;
+		}
+	}
+	result.instructions = mos6502->get_opcode_fetch_count();
+
+	result.passed = address == success_address;
+	if(!result.passed) {
+		result.detail = (result.cycles < cycle_limit) ? "trapped at " + hex(address) : "didn't complete";
+	}
+}
+
+// MARK: - Wolfgang Lorenz.
+
+const char *const lorenz_tests[] = {
+	" start", "ldab", "ldaz", "ldazx", "ldaa", "ldaax", "ldaay", "ldaix", "ldaiy", "staz", "stazx", "staa",
+	"staax", "staay", "staix", "staiy", "ldxb", "ldxz", "ldxzy", "ldxa", "ldxay", "stxz", "stxzy", "stxa",
+	"ldyb", "ldyz", "ldyzx", "ldya", "ldyax", "styz", "styzx", "stya", "taxn", "tayn", "txan", "tyan", "tsxn",
+	"txsn", "phan", "plan", "phpn", "plpn", "inxn", "inyn", "dexn", "deyn", "incz", "inczx", "inca", "incax",
+	"decz", "deczx", "deca", "decax", "asln", "aslz", "aslzx", "asla", "aslax", "lsrn", "lsrz", "lsrzx", "lsra",
+	"lsrax", "roln", "rolz", "rolzx", "rola", "rolax", "rorn", "rorz", "rorzx", "rora", "rorax", "andb", "andz",
+	"andzx", "anda", "andax", "anday", "andix", "andiy", "orab", "oraz", "orazx", "oraa", "oraax", "oraay",
+	"oraix", "oraiy", "eorb", "eorz", "eorzx", "eora", "eorax", "eoray", "eorix", "eoriy", "clcn", "secn",
+	"cldn", "sedn", "clin", "sein", "clvn", "adcb", "adcz", "adczx", "adca", "adcax", "adcay", "adcix", "adciy",
+	"sbcb", "sbcz", "sbczx", "sbca", "sbcax", "sbcay", "sbcix", "sbciy", "cmpb", "cmpz", "cmpzx", "cmpa",
+	"cmpax", "cmpay", "cmpix", "cmpiy", "cpxb", "cpxz", "cpxa", "cpyb", "cpyz", "cpya", "bitz", "bita", "brkn",
+	"rtin", "jsrw", "rtsn", "jmpw", "jmpi", "beqr", "bner", "bmir", "bplr", "bcsr", "bccr", "bvsr", "bvcr",
+	"nopn", "nopb", "nopz", "nopzx", "nopa", "nopax", "asoz", "asozx", "asoa", "asoax", "asoay", "asoix",
+	"asoiy", "rlaz", "rlazx", "rlaa", "rlaax", "rlaay", "rlaix", "rlaiy", "lsez", "lsezx", "lsea", "lseax",
+	"lseay", "lseix", "lseiy", "rraz", "rrazx", "rraa", "rraax", "rraay", "rraix", "rraiy", "dcmz", "dcmzx",
+	"dcma", "dcmax", "dcmay", "dcmix", "dcmiy", "insz", "inszx", "insa", "insax", "insay", "insix", "insiy",
+	"laxz", "laxzy", "laxa", "laxay", "laxix", "laxiy", "axsz", "axszy", "axsa", "axsix", "alrb", "arrb",
+	"sbxb", "shaay", "shaiy", "shxay", "shyax", "shsay", "lxab", "aneb", "ancb", "lasay", "sbcb(eb)"
+};
+
+/*!
+	Provides the few C64 KERNAL entry points that Wolfgang Lorenz's tests use: character output, which
+	is captured, keyboard input, which always returns RUN/STOP, and the two exits taken upon failure.
+*/
+class LorenzTrapHandler: public CPU::AllRAMProcessor::TrapHandler {
+	public:
+		LorenzTrapHandler(CPU::MOS6502::AllRAMProcessor &mos6502) : mos6502_(mos6502) {}
+
+		void processor_did_trap(CPU::AllRAMProcessor &, uint16_t address) override {
+			switch(address) {
+				case 0xffd2: {
+					const uint8_t zero = 0;
+					mos6502_.set_data_at_address(0x030c, 1, &zero);
+					output.push_back(petscii_to_ascii(static_cast<uint8_t>(mos6502_.get_value_of_register(CPU::MOS6502::Register::A))));
+				} break;
+
+				case 0xffe4:
+					mos6502_.set_value_of_register(CPU::MOS6502::Register::A, 0x03);
+				break;
+
+				case 0x8000:
+				case 0xa474:
+					has_failed = true;
+				break;
+
+				default: break;
+			}
+		}
+
+		std::string output;
+		bool has_failed = false;
+
+	private:
+		static char petscii_to_ascii(uint8_t character) {
+			if(character == 0x0d) return ' ';
+			if(character >= 0x41 && character <= 0x5a) return static_cast<char>(character + 0x20);
+			if(character >= 0xc1 && character <= 0xda) return static_cast<char>(character - 0x80);
+			if(character >= 0x20 && character < 0x41) return static_cast<char>(character);
+			return '?';
+		}
+
+		CPU::MOS6502::AllRAMProcessor &mos6502_;
+};
+
+/*!
+	Prepares the named test from Wolfgang Lorenz's suite as a job for @c runner; each test signals success
+	by attempting to load the next, at which point a jam opcode has been installed.
+
+	@returns @c true if the test could be loaded; @c false otherwise.
+*/
+bool prepare_lorenz_test(const std::string &name, const Options &options, CPU::AllRAMBatchRunner::Job &job, std::unique_ptr<LorenzTrapHandler> &trap_handler) {
+	const std::vector<uint8_t> test = read_file(options.test_path + "Wolfgang Lorenz 6502 test suite/" + name);
+	if(test.size() < 4) return false;
+
+	CPU::MOS6502::AllRAMProcessor *const mos6502 = CPU::MOS6502::AllRAMProcessor::Processor(CPU::MOS6502::Personality::P6502);
+	job.processor.reset(mos6502);
+
+	// Files begin with a load address; as per the Xcode tests, the final two bytes aren't loaded.
+	const uint16_t load_address = static_cast<uint16_t>(test[0] | (test[1] << 8));
+	mos6502->set_data_at_address(load_address, test.size() - 4, &test[2]);
+
+	// Establish the parts of C64 memory that the tests rely upon, including an IRQ handler.
+	const auto poke = [mos6502] (uint16_t address, uint8_t value) {
+		mos6502->set_data_at_address(address, 1, &value);
+	};
+	poke(0x0002, 0x00);
+	poke(0xa002, 0x00);
+	poke(0xa003, 0x80);
+	poke(0x01fe, 0xff);
+	poke(0x01ff, 0x7f);
+	poke(0xfffe, 0x48);
+	poke(0xffff, 0xff);
+
+	const uint8_t irq_handler[] = {
+		0x48, 0x8a, 0x48, 0x98, 0x48, 0xba, 0xbd, 0x04, 0x01,
+		0x29, 0x10, 0xf0, 0x03, 0x6c, 0x16, 0x03, 0x6c, 0x14, 0x03
+	};
+	mos6502->set_data_at_address(0xff48, sizeof(irq_handler), irq_handler);
+
+	// Trap the KERNAL calls used and the exits taken upon failure; each is an RTS.
+	trap_handler.reset(new LorenzTrapHandler(*mos6502));
+	mos6502->set_trap_handler(trap_handler.get());
+	for(const uint16_t address: {0xffd2, 0xffe4, 0x8000, 0xa474}) {
+		mos6502->add_trap_address(address);
+		poke(address, 0x60);
+	}
+
+	// Jam upon an attempt to load the next test.
+	poke(0xe16f, CPU::MOS6502::JamOpcode);
+
+	mos6502->set_value_of_register(CPU::MOS6502::Register::ProgramCounter, 0x0801);
+	mos6502->set_value_of_register(CPU::MOS6502::Register::StackPointer, 0xfd);
+	mos6502->set_value_of_register(CPU::MOS6502::Register::Flags, 0x04);
+
+	LorenzTrapHandler *const handler = trap_handler.get();
+	job.budget = Cycles(2000000000);
+	job.is_finished = [mos6502, handler] (CPU::AllRAMProcessor &) {
+		return mos6502->is_jammed() || handler->has_failed;
+	};
+	return true;
+}
+
+/*!
+	Runs all of Wolfgang Lorenz's tests, in parallel.
+*/
+void run_lorenz(const Options &options, Result &result) {
+	const std::size_t number_of_tests = sizeof(lorenz_tests) / sizeof(*lorenz_tests);
+	std::vector<CPU::AllRAMBatchRunner::Job> jobs(number_of_tests);
+	std::vector<std::unique_ptr<LorenzTrapHandler>> trap_handlers(number_of_tests);
+	std::vector<bool> is_loaded(number_of_tests);
+	for(std::size_t c = 0; c < number_of_tests; ++c) {
+		is_loaded[c] = prepare_lorenz_test(lorenz_tests[c], options, jobs[c], trap_handlers[c]);
+	}
+
+	// Tests that couldn't be loaded are left with no budget, and so aren't run.
+	CPU::AllRAMBatchRunner runner(options.number_of_threads);
+	runner.run(jobs);
+
+	int passes = 0;
+	std::vector<std::string> failures;
+	for(std::size_t c = 0; c < number_of_tests; ++c) {
+		std::string failure;
+		if(!is_loaded[c]) {
+			failure = "couldn't load";
+		} else {
+			const auto mos6502 = static_cast<CPU::MOS6502::AllRAMProcessor *>(jobs[c].processor.get());
+			result.cycles += static_cast<uint64_t>(jobs[c].cycles_run.as_int());
+			result.instructions += mos6502->get_opcode_fetch_count();
+
+			if(trap_handlers[c]->has_failed) {
+				failure = trap_handlers[c]->output;
+			} else if(!mos6502->is_jammed()) {
+				failure = "didn't complete";
+			} else {
+				const uint16_t jam_address = mos6502->get_value_of_register(CPU::MOS6502::Register::LastOperationAddress);
+				if(jam_address != 0xe16f) failure = "jammed at " + hex(jam_address);
+			}
+		}
+
+		if(failure.empty()) {
+			++passes;
+		} else {
+			failures.push_back(std::string(lorenz_tests[c]) + " (" + failure + ")");
+		}
+	}
+
+	result.passed = failures.empty();
+	if(!result.passed) {
+		std::ostringstream detail;
+		detail << passes << " tests passed, " << failures.size() << " failed";
+		for(const auto &failure: failures) detail << "; " << failure;
+		result.detail = detail.str();
+	}
+}
+
+}
+
+int main(int argc, char *argv[]) {
+	Options options;
+
+	// Accepted arguments are --tests={path to the Xcode test resources}, --filter={substring of suite names to run},
+	// --threads={number of threads to use for suites that run in parallel; 0 for one per core} and --verbose,
+	// which echoes the output of the ZEX exercisers as they run.
+	for(int index = 1; index < argc; ++index) {
+		const std::string argument = argv[index];
+		const std::size_t split_index = argument.find("=");
+		const std::string name = argument.substr(0, split_index);
+		const std::string value = (split_index == std::string::npos) ? "" : argument.substr(split_index + 1);
+
+		if(name == "--tests") {
+			options.test_path = (value.empty() || value.back() == '/') ? value : value + "/";
+		} else if(name == "--filter") {
+			options.filter = value;
+		} else if(name == "--threads") {
+			options.number_of_threads = static_cast<std::size_t>(std::atoi(value.c_str()));
+		} else if(name == "--verbose") {
+			options.verbose = true;
+		} else if(name == "--help" || name == "-h") {
+			std::cout << "Usage: " << argv[0] << " [--tests={path to Clock SignalTests}] [--filter={name substring}] [--threads={count}] [--verbose]" << std::endl;
+			std::cout << "Suites are z80/fuse, z80/zexdoc, z80/zexall, 6502/klaus-dormann, 65c02/klaus-dormann and 6502/wolfgang-lorenz." << std::endl;
+			std::cout << "Results are printed as CSV; details of failures are reported to stderr." << std::endl;
+			return 0;
+		} else {
+			std::cerr << "Unrecognised option " << argument << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	const auto is_selected = [&options] (const std::string &name) {
+		return options.filter.empty() || name.find(options.filter) != std::string::npos;
+	};
+
+	bool all_passed = true;
+	const auto run = [&all_passed, &is_selected] (const std::string &name, const std::function<void(Result &)> &suite) {
+		if(is_selected(name)) all_passed &= run_suite(name, suite);
+	};
+
+	print_header();
+	run("z80/fuse", [&options] (Result &result) {
+		run_fuse(options, result);
+	});
+	run("z80/zexdoc", [&options] (Result &result) {
+		run_zex("zexdoc.com", options, result);
+	});
+	run("z80/zexall", [&options] (Result &result) {
+		run_zex("zexall.com", options, result);
+	});
+	run("6502/klaus-dormann", [&options] (Result &result) {
+		run_klaus_dormann("6502_functional_test.bin", CPU::MOS6502::Personality::P6502, 0x3399, options, result);
+	});
+	run("65c02/klaus-dormann", [&options] (Result &result) {
+		run_klaus_dormann("65C02_extended_opcodes_test.bin", CPU::MOS6502::Personality::PWDC65C02, 0x24f1, options, result);
+	});
+	run("6502/wolfgang-lorenz", [&options] (Result &result) {
+		run_lorenz(options, result);
+	});
+
+	return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
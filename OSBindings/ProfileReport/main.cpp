@@ -0,0 +1,139 @@
+//
+//  main.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../../Processors/Profile.hpp"
+
+/*
+	Summarises processor profiles, as saved by a build with PROFILE_PROCESSORS defined: for each file
+	supplied it lists the addresses at which most time was spent, the most-frequently decoded opcodes
+	and the number of reads and writes to each page of memory.
+*/
+
+namespace {
+
+/// @returns The conventional name of opcode page @c page for the processor that produced @c profile.
+std::string page_name(const CPU::Profile &profile, int page) {
+	if(profile.get_name() == "Z80") {
+		const char *const names[] = {"", "ED ", "FD ", "DD ", "CB ", "FDCB ", "DDCB "};
+		if(page < 7) return names[page];
+	}
+	return (profile.get_number_of_opcode_pages() > 1) ? std::to_string(page) + ":" : "";
+}
+
+/// @returns @c part as a percentage of @c whole.
+double percentage(uint64_t part, uint64_t whole) {
+	return whole ? (100.0 * static_cast<double>(part)) / static_cast<double>(whole) : 0.0;
+}
+
+/// @returns The indices of the @c count largest non-zero entries in @c table, in descending order of value.
+std::vector<std::size_t> top_entries(const std::vector<uint64_t> &table, std::size_t count) {
+	std::vector<std::size_t> indices;
+	for(std::size_t c = 0; c < table.size(); ++c) {
+		if(table[c]) indices.push_back(c);
+	}
+
+	count = std::min(count, indices.size());
+	std::partial_sort(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(count), indices.end(), [&table] (std::size_t lhs, std::size_t rhs) {
+		return table[lhs] > table[rhs] || (table[lhs] == table[rhs] && lhs < rhs);
+	});
+	indices.resize(count);
+	return indices;
+}
+
+uint64_t sum(const std::vector<uint64_t> &table) {
+	uint64_t total = 0;
+	for(const auto value: table) total += value;
+	return total;
+}
+
+void report(const std::string &file_name, const CPU::Profile &profile, std::size_t count) {
+	const auto &instructions = profile.get_instructions();
+	const auto &time = profile.get_time();
+	const auto &opcodes = profile.get_opcodes();
+	const auto &reads = profile.get_reads();
+	const auto &writes = profile.get_writes();
+
+	const uint64_t total_instructions = sum(instructions);
+	const uint64_t total_time = sum(time);
+	const uint64_t total_opcodes = sum(opcodes);
+	const double units_per_cycle = static_cast<double>(profile.get_time_units_per_cycle());
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << file_name << ": " << profile.get_name() << ", " << total_instructions << " instructions in " << (static_cast<double>(total_time) / units_per_cycle) << " cycles" << std::endl;
+
+	std::cout << std::endl << "Addresses by time:" << std::endl;
+	std::cout << "\taddress\tcycles\t%\tinstructions\tcycles/instruction" << std::endl;
+	for(const auto address: top_entries(time, count)) {
+		const double cycles = static_cast<double>(time[address]) / units_per_cycle;
+		std::cout << '\t' << std::hex << std::setfill('0') << std::setw(4) << address << std::dec << std::setfill(' ');
+		std::cout << '\t' << cycles << '\t' << percentage(time[address], total_time) << '\t' << instructions[address];
+		std::cout << '\t' << (instructions[address] ? cycles / static_cast<double>(instructions[address]) : 0.0) << std::endl;
+	}
+
+	std::cout << std::endl << "Opcodes by frequency:" << std::endl;
+	std::cout << "\topcode\tcount\t%" << std::endl;
+	for(const auto index: top_entries(opcodes, count)) {
+		std::cout << '\t' << page_name(profile, static_cast<int>(index >> 8));
+		std::cout << std::hex << std::setfill('0') << std::setw(2) << (index & 0xff) << std::dec << std::setfill(' ');
+		std::cout << '\t' << opcodes[index] << '\t' << percentage(opcodes[index], total_opcodes) << std::endl;
+	}
+
+	std::cout << std::endl << "Memory pages:" << std::endl;
+	std::cout << "\tpage\treads\twrites" << std::endl;
+	for(std::size_t page = 0; page < reads.size(); ++page) {
+		if(!reads[page] && !writes[page]) continue;
+		std::cout << '\t' << std::hex << std::setfill('0') << std::setw(2) << page << "xx" << std::dec << std::setfill(' ');
+		std::cout << '\t' << reads[page] << '\t' << writes[page] << std::endl;
+	}
+	std::cout << std::endl;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+	std::size_t count = 20;
+	std::vector<std::string> file_names;
+
+	// Accepted arguments are --top={number of addresses and opcodes to list} and any number of profiles.
+	for(int index = 1; index < argc; ++index) {
+		const std::string argument = argv[index];
+		if(argument.compare(0, 6, "--top=") == 0) {
+			count = static_cast<std::size_t>(std::atoi(argument.c_str() + 6));
+		} else if(argument == "--help" || argument == "-h") {
+			std::cout << "Usage: " << argv[0] << " [--top={count}] profile..." << std::endl;
+			std::cout << "Profiles are produced by, e.g., clksignal-headless --profile={path prefix} when built with PROFILE_PROCESSORS defined." << std::endl;
+			return 0;
+		} else {
+			file_names.push_back(argument);
+		}
+	}
+
+	if(file_names.empty()) {
+		std::cerr << "Usage: " << argv[0] << " [--top={count}] profile..." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	for(const auto &file_name: file_names) {
+		CPU::Profile profile;
+		if(!profile.load(file_name)) {
+			std::cerr << "Could not read a profile from " << file_name << std::endl;
+			return EXIT_FAILURE;
+		}
+		report(file_name, profile, count);
+	}
+
+	return 0;
+}
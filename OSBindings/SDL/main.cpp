@@ -8,6 +8,8 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
@@ -23,6 +25,8 @@
 #include "../../Machines/MediaTarget.hpp"
 #include "../../Machines/CRTMachine.hpp"
 
+#include "../../Outputs/Speaker/SampleRing.hpp"
+
 #include "../../Concurrency/BestEffortUpdater.hpp"
 
 #include "../../Activity/Observer.hpp"
@@ -30,50 +34,57 @@
 
 namespace {
 
+/// The number of fields received per field displayed while in turbo mode.
+const unsigned int TurboFieldDecimation = 10;
+
+/// The emulated length of each call to run_for while in turbo mode.
+const Time::Seconds TurboTimeSlice = 0.02;
+
 struct BestEffortUpdaterDelegate: public Concurrency::BestEffortUpdater::Delegate {
 	void update(Concurrency::BestEffortUpdater *updater, Time::Seconds duration, bool did_skip_previous_update) override {
-		machine->crt_machine()->run_for(duration);
+		if(!is_turbo) {
+			machine->crt_machine()->run_for(duration);
+			return;
+		}
+
+		// In turbo mode, spend the real time that has elapsed running the machine for as long as
+		// possible, rather than for the same amount of emulated time.
+		const auto start_time = std::chrono::high_resolution_clock::now();
+		do {
+			machine->crt_machine()->run_for(TurboTimeSlice);
+		} while(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count() < duration);
 	}
 
 	Machine::DynamicMachine *machine;
+	std::atomic<bool> is_turbo{false};
 };
 
-struct SpeakerDelegate: public Outputs::Speaker::Speaker::Delegate {
+struct AudioOutput {
 	// This is set to a relatively large number for now.
 	static const int buffer_size = 1024;
 
-	void speaker_did_complete_samples(Outputs::Speaker::Speaker *speaker, const std::vector<int16_t> &buffer) override {
-		std::lock_guard<std::mutex> lock_guard(audio_buffer_mutex_);
-		if(audio_buffer_.size() > buffer_size) {
-			audio_buffer_.erase(audio_buffer_.begin(), audio_buffer_.end() - buffer_size);
-		}
-		audio_buffer_.insert(audio_buffer_.end(), buffer.begin(), buffer.end());
-	}
-
 	void audio_callback(Uint8 *stream, int len) {
 		updater->update();
-		std::lock_guard<std::mutex> lock_guard(audio_buffer_mutex_);
 
-		std::size_t sample_length = static_cast<std::size_t>(len) / sizeof(int16_t);
-		std::size_t copy_length = std::min(sample_length, audio_buffer_.size());
+		const std::size_t sample_length = static_cast<std::size_t>(len) / sizeof(int16_t);
 		int16_t *target = static_cast<int16_t *>(static_cast<void *>(stream));
 
-		std::memcpy(stream, audio_buffer_.data(), copy_length * sizeof(int16_t));
+		const std::size_t copy_length = ring.read(target, sample_length);
 		if(copy_length < sample_length) {
 			std::memset(&target[copy_length], 0, (sample_length - copy_length) * sizeof(int16_t));
 		}
-		audio_buffer_.erase(audio_buffer_.begin(), audio_buffer_.begin() + copy_length);
 	}
 
 	static void SDL_audio_callback(void *userdata, Uint8 *stream, int len) {
-		reinterpret_cast<SpeakerDelegate *>(userdata)->audio_callback(stream, len);
+		reinterpret_cast<AudioOutput *>(userdata)->audio_callback(stream, len);
 	}
 
 	SDL_AudioDeviceID audio_device;
 	Concurrency::BestEffortUpdater *updater;
 
-	std::mutex audio_buffer_mutex_;
-	std::vector<int16_t> audio_buffer_;
+	// Samples are written by the speaker on the machine's audio thread and read here on SDL's;
+	// allow up to two buffers of stereo frames in flight so that neither side ever needs to wait for the other.
+	Outputs::Speaker::SampleRing ring{buffer_size * 2 * 2};
 };
 
 class ActivityObserver: public Activity::Observer {
@@ -313,7 +324,7 @@ int main(int argc, char *argv[]) {
 	// Print a help message if requested.
 	if(arguments.selections.find("help") != arguments.selections.end() || arguments.selections.find("h") != arguments.selections.end()) {
 		std::cout << "Usage: " << final_path_component(argv[0]) << usage_suffix << std::endl;
-		std::cout << "Use alt+enter to toggle full screen display. Use control+shift+V to paste text." << std::endl;
+		std::cout << "Use alt+enter to toggle full screen display. Use control+shift+V to paste text. Use control+shift+T to toggle turbo mode." << std::endl;
 		std::cout << "Required machine type and configuration is determined from the file. Machines with further options:" << std::endl << std::endl;
 
 		auto all_options = Machine::AllOptionsByMachineName();
@@ -356,7 +367,7 @@ int main(int argc, char *argv[]) {
 
 	Concurrency::BestEffortUpdater updater;
 	BestEffortUpdaterDelegate best_effort_updater_delegate;
-	SpeakerDelegate speaker_delegate;
+	AudioOutput audio_output;
 
 	// For vanilla SDL purposes, assume system ROMs can be found in one of:
 	//
@@ -433,7 +444,7 @@ int main(int argc, char *argv[]) {
 	}
 
 	best_effort_updater_delegate.machine = machine.get();
-	speaker_delegate.updater = &updater;
+	audio_output.updater = &updater;
 	updater.set_delegate(&best_effort_updater_delegate);
 
 	// Attempt to set up video and audio.
@@ -481,16 +492,17 @@ int main(int argc, char *argv[]) {
 		SDL_zero(desired_audio_spec);
 		desired_audio_spec.freq = 48000;	// TODO: how can I get SDL to reveal the output rate of this machine?
 		desired_audio_spec.format = AUDIO_S16;
-		desired_audio_spec.channels = 1;
-		desired_audio_spec.samples = SpeakerDelegate::buffer_size;
-		desired_audio_spec.callback = SpeakerDelegate::SDL_audio_callback;
-		desired_audio_spec.userdata = &speaker_delegate;
+		desired_audio_spec.channels = 2;
+		desired_audio_spec.samples = AudioOutput::buffer_size;
+		desired_audio_spec.callback = AudioOutput::SDL_audio_callback;
+		desired_audio_spec.userdata = &audio_output;
 
-		speaker_delegate.audio_device = SDL_OpenAudioDevice(nullptr, 0, &desired_audio_spec, &obtained_audio_spec, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+		audio_output.audio_device = SDL_OpenAudioDevice(nullptr, 0, &desired_audio_spec, &obtained_audio_spec, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
 
 		speaker->set_output_rate(obtained_audio_spec.freq, desired_audio_spec.samples);
-		speaker->set_delegate(&speaker_delegate);
-		SDL_PauseAudioDevice(speaker_delegate.audio_device, 0);
+		speaker->set_output_channels(Outputs::Speaker::Channels::Stereo);
+		speaker->set_sample_ring(&audio_output.ring);
+		SDL_PauseAudioDevice(audio_output.audio_device, 0);
 	}
 
 	int window_width, window_height;
@@ -617,6 +629,17 @@ int main(int argc, char *argv[]) {
 						}
 					}
 
+					// Capture ctrl+shift+t as a toggle for turbo mode, in which the machine runs as quickly as
+					// possible, with only some fields being displayed and no audio.
+					if(event.key.keysym.sym == SDLK_t && (SDL_GetModState()&KMOD_CTRL) && (SDL_GetModState()&KMOD_SHIFT)) {
+						if(!event.key.repeat) {
+							const bool is_turbo = !best_effort_updater_delegate.is_turbo;
+							machine->crt_machine()->set_turbo_mode(is_turbo, TurboFieldDecimation, 0.0f);
+							best_effort_updater_delegate.is_turbo = is_turbo;
+						}
+						break;
+					}
+
 					// Capture ctrl+shift+d as a take-a-screenshot command.
 					if(event.key.keysym.sym == SDLK_d && (SDL_GetModState()&KMOD_CTRL) && (SDL_GetModState()&KMOD_SHIFT)) {
 						// Pick a width to capture that will preserve a 4:3 output aspect ratio.
@@ -59,6 +59,15 @@ void CRT::set_new_timing(unsigned int cycles_per_line, unsigned int height_of_di
 	vertical_flywheel_output_divider_ = static_cast<uint16_t>(ceilf(real_clock_scan_period / 65536.0f) * (time_multiplier_ * common_output_divisor_));
 
 	openGL_output_builder_.set_timing(cycles_per_line, multiplied_cycles_per_line, height_of_display, horizontal_flywheel_->get_scan_period(), vertical_flywheel_->get_scan_period(), vertical_flywheel_output_divider_);
+
+	// The software output builder is not thread safe, so is updated only upon the next draw.
+	const unsigned int horizontal_scan_period = horizontal_flywheel_->get_scan_period();
+	const unsigned int vertical_scan_period = vertical_flywheel_->get_scan_period();
+	const unsigned int vertical_period_divider = vertical_flywheel_output_divider_;
+	enqueue_openGL_function([=] {
+		software_output_builder_.set_colour_format(colour_space, colour_cycle_numerator, colour_cycle_denominator);
+		software_output_builder_.set_timing(cycles_per_line, multiplied_cycles_per_line, height_of_display, horizontal_scan_period, vertical_scan_period, vertical_period_divider);
+	});
 }
 
 void CRT::set_new_display_type(unsigned int cycles_per_line, DisplayType displayType) {
@@ -83,6 +92,12 @@ void CRT::set_composite_function_type(CompositeSourceType type, float offset_of_
 	}
 }
 
+void CRT::set_field_decimation(unsigned int decimation) {
+	std::unique_lock<std::mutex> output_lock = openGL_output_builder_.get_output_lock();
+	field_decimation_ = std::max(decimation, 1u);
+	fields_since_composition_ %= field_decimation_;
+}
+
 void CRT::set_input_gamma(float gamma) {
 	input_gamma_ = gamma;
 	update_gamma();
@@ -96,6 +111,9 @@ void CRT::set_output_gamma(float gamma) {
 void CRT::update_gamma() {
 	float gamma_ratio = input_gamma_ / output_gamma_;
 	openGL_output_builder_.set_gamma(gamma_ratio);
+	enqueue_openGL_function([gamma_ratio, this] {
+		software_output_builder_.set_gamma(gamma_ratio);
+	});
 }
 
 CRT::CRT(unsigned int common_output_divisor, unsigned int buffer_depth) :
@@ -119,6 +137,38 @@ CRT::CRT(unsigned int cycles_per_line, unsigned int common_output_divisor, Displ
 	set_new_display_type(cycles_per_line, displayType);
 }
 
+// MARK: - Software output
+
+void CRT::draw_frame(SoftwareFrame &frame) {
+	perform_enqueued_openGL_functions();
+
+	{
+		// Source runs are painted while the output lock is held, since they refer to
+		// source data that the machine will otherwise overwrite.
+		std::unique_lock<std::mutex> output_lock = openGL_output_builder_.get_output_lock();
+		openGL_output_builder_.array_builder.submit([this] (bool is_input, uint8_t *data, std::size_t size) {
+			if(is_input) {
+				software_output_builder_.submit_source_runs(data, size, openGL_output_builder_.texture_builder);
+			} else {
+				software_output_builder_.submit_output_runs(data, size);
+			}
+		});
+		openGL_output_builder_.texture_builder.submit_without_upload();
+		openGL_output_builder_.reset_composite_output_y();
+	}
+
+	software_output_builder_.draw_frame(frame);
+}
+
+void CRT::discard_frame() {
+	perform_enqueued_openGL_functions();
+
+	std::unique_lock<std::mutex> output_lock = openGL_output_builder_.get_output_lock();
+	openGL_output_builder_.array_builder.submit([] (bool is_input, uint8_t *data, std::size_t size) {});
+	openGL_output_builder_.texture_builder.submit_without_upload();
+	openGL_output_builder_.reset_composite_output_y();
+}
+
 // MARK: - Sync loop
 
 Flywheel::SyncEvent CRT::get_next_vertical_sync_event(bool vsync_is_requested, unsigned int cycles_to_run_for, unsigned int *cycles_advanced) {
@@ -161,7 +211,7 @@ void CRT::advance_cycles(unsigned int number_of_cycles, bool hsync_requested, bo
 		hsync_requested = false;
 		vsync_requested = false;
 
-		bool is_output_segment = ((is_output_run && next_run_length) && !horizontal_flywheel_->is_in_retrace() && !vertical_flywheel_->is_in_retrace());
+		bool is_output_segment = ((is_output_run && next_run_length) && is_composing_field_ && !horizontal_flywheel_->is_in_retrace() && !vertical_flywheel_->is_in_retrace());
 		uint8_t *next_run = nullptr;
 		if(is_output_segment && !openGL_output_builder_.composite_output_buffer_is_full()) {
 			bool did_retain_source_data = openGL_output_builder_.texture_builder.retain_latest();
@@ -195,6 +245,12 @@ void CRT::advance_cycles(unsigned int number_of_cycles, bool hsync_requested, bo
 			source_output_position_x2() = static_cast<uint16_t>(horizontal_flywheel_->get_current_output_position());
 		}
 
+		// if this is the end of vertical retrace then determine whether the field that is beginning will be composed
+		if(next_run_length == time_until_vertical_sync_event && next_vertical_sync_event == Flywheel::SyncEvent::EndRetrace) {
+			is_composing_field_ = !fields_since_composition_;
+			fields_since_composition_ = (fields_since_composition_ + 1) % field_decimation_;
+		}
+
 		// if this is horizontal retrace then advance the output line counter and bookend an output run
 		Flywheel::SyncEvent honoured_event = Flywheel::SyncEvent::None;
 		if(next_run_length == time_until_vertical_sync_event && next_vertical_sync_event != Flywheel::SyncEvent::None) honoured_event = next_vertical_sync_event;
@@ -205,7 +261,7 @@ void CRT::advance_cycles(unsigned int number_of_cycles, bool hsync_requested, bo
 
 		if(next_run_length == time_until_horizontal_sync_event && next_horizontal_sync_event == Flywheel::SyncEvent::StartRetrace) is_alernate_line_ ^= phase_alternates_;
 
-		if(needs_endpoint) {
+		if(needs_endpoint && is_composing_field_) {
 			if(
 				!openGL_output_builder_.array_builder.is_full() &&
 				!openGL_output_builder_.composite_output_buffer_is_full()) {
@@ -251,7 +307,7 @@ void CRT::advance_cycles(unsigned int number_of_cycles, bool hsync_requested, bo
 			}
 		}
 
-		if(next_run_length == time_until_horizontal_sync_event && next_horizontal_sync_event == Flywheel::SyncEvent::StartRetrace) {
+		if(is_composing_field_ && next_run_length == time_until_horizontal_sync_event && next_horizontal_sync_event == Flywheel::SyncEvent::StartRetrace) {
 			openGL_output_builder_.increment_composite_output_y();
 		}
 
@@ -14,6 +14,7 @@
 #include "CRTTypes.hpp"
 #include "Internals/Flywheel.hpp"
 #include "Internals/CRTOpenGL.hpp"
+#include "Internals/CRTSoftware.hpp"
 #include "Internals/ArrayBuilder.hpp"
 #include "Internals/TextureBuilder.hpp"
 
@@ -70,6 +71,9 @@ class CRT {
 		// OpenGL state
 		OpenGLOutputBuilder openGL_output_builder_;
 
+		// CPU-side output, used only if draw_frame is called with a SoftwareFrame
+		SoftwareOutputBuilder software_output_builder_;
+
 		// temporary storage used during the construction of output runs
 		struct {
 			uint16_t x1, y;
@@ -79,13 +83,20 @@ class CRT {
 		Delegate *delegate_ = nullptr;
 		unsigned int frames_since_last_delegate_call_ = 0;
 
-		// queued tasks for the OpenGL queue; performed before the next draw
+		// queued tasks for the OpenGL queue; performed before the next draw, whether via OpenGL or in software
 		std::mutex function_mutex_;
 		std::vector<std::function<void(void)>> enqueued_openGL_functions_;
 		inline void enqueue_openGL_function(const std::function<void(void)> &function) {
 			std::lock_guard<std::mutex> function_guard(function_mutex_);
 			enqueued_openGL_functions_.push_back(function);
 		}
+		inline void perform_enqueued_openGL_functions() {
+			std::lock_guard<std::mutex> function_guard(function_mutex_);
+			for(std::function<void(void)> function : enqueued_openGL_functions_) {
+				function();
+			}
+			enqueued_openGL_functions_.clear();
+		}
 
 		// sync counter, for determining vertical sync
 		bool is_receiving_sync_ = false;					// true if the CRT is currently receiving sync (i.e. this is for edge triggering of horizontal sync)
@@ -97,6 +108,10 @@ class CRT {
 
 		unsigned int cycles_per_line_ = 1;
 
+		// field decimation: only one field in every field_decimation_ is composed; the others merely track sync
+		unsigned int field_decimation_ = 1, fields_since_composition_ = 0;
+		bool is_composing_field_ = true;
+
 		float input_gamma_ = 1.0f, output_gamma_ = 1.0f;
 		void update_gamma();
 
@@ -241,16 +256,28 @@ class CRT {
 			The caller is responsible for ensuring that a valid OpenGL context exists for the duration of this call.
 		*/
 		inline void draw_frame(unsigned int output_width, unsigned int output_height, bool only_if_dirty) {
-			{
-				std::lock_guard<std::mutex> function_guard(function_mutex_);
-				for(std::function<void(void)> function : enqueued_openGL_functions_) {
-					function();
-				}
-				enqueued_openGL_functions_.clear();
-			}
+			perform_enqueued_openGL_functions();
 			openGL_output_builder_.draw_frame(output_width, output_height, only_if_dirty);
 		}
 
+		/*!	Draws the current CRT state to @c frame without the use of OpenGL; no context is required.
+
+			The software sampling function appropriate to the current video signal must have been supplied,
+			and @c frame should be sized by the caller. Each frame should be drawn to by only one CRT, and a CRT
+			should be drawn via either this method or OpenGL, not both.
+
+			@see @c set_software_rgb_sampling_function , @c set_software_composite_sampling_function ,
+			@c set_software_svideo_sampling_function
+		*/
+		void draw_frame(SoftwareFrame &frame);
+
+		/*!	Discards all output accumulated since the last draw without painting it; no OpenGL context is required.
+
+			Machines may decline to generate video once the CRT's buffers are full, so a caller that runs a
+			machine without displaying its output should call this periodically for representative behaviour.
+		*/
+		void discard_frame();
+
 		/*! Sets the OpenGL framebuffer to which output is drawn. */
 		inline void set_target_framebuffer(GLint framebuffer) {
 			enqueue_openGL_function( [framebuffer, this] {
@@ -258,6 +285,16 @@ class CRT {
 			});
 		}
 
+		/*!	Sets the proportion of fields that are composed for output: one field in every @c decimation
+			is composed, and the rest are discarded as they are received, with only sync being tracked. This
+			reduces the cost of running a machine at many times real speed.
+
+			Changes take effect from the start of the next field.
+
+			@param decimation The number of fields received per field composed; 1, the default, composes every field.
+		*/
+		void set_field_decimation(unsigned int decimation);
+
 		/*!	Sets the gamma exponent for the simulated screen. */
 		void set_input_gamma(float gamma);
 
@@ -345,15 +382,47 @@ class CRT {
 			});
 		}
 
+		/*!	Sets a function that will map from whatever data the machine provided to a composite signal
+			when drawing in software. It is the CPU equivalent of the function supplied to
+			@c set_composite_sampling_function and should produce the same results.
+		*/
+		inline void set_software_composite_sampling_function(const SoftwareCompositeSamplingFunction &function) {
+			enqueue_openGL_function([function, this] {
+				software_output_builder_.set_composite_sampling_function(function);
+			});
+		}
+
+		/*!	Sets a function that will map from whatever data the machine provided to an s-video signal
+			when drawing in software. It is the CPU equivalent of the function supplied to
+			@c set_svideo_sampling_function and should produce the same results.
+		*/
+		inline void set_software_svideo_sampling_function(const SoftwareSVideoSamplingFunction &function) {
+			enqueue_openGL_function([function, this] {
+				software_output_builder_.set_svideo_sampling_function(function);
+			});
+		}
+
+		/*!	Sets a function that will map from whatever data the machine provided to an RGB signal
+			when drawing in software. It is the CPU equivalent of the function supplied to
+			@c set_rgb_sampling_function and should produce the same results.
+		*/
+		inline void set_software_rgb_sampling_function(const SoftwareRGBSamplingFunction &function) {
+			enqueue_openGL_function([function, this] {
+				software_output_builder_.set_rgb_sampling_function(function);
+			});
+		}
+
 		inline void set_video_signal(VideoSignal video_signal) {
 			enqueue_openGL_function([video_signal, this] {
 				openGL_output_builder_.set_video_signal(video_signal);
+				software_output_builder_.set_video_signal(video_signal);
 			});
 		}
 
 		inline void set_visible_area(Rect visible_area) {
 			enqueue_openGL_function([visible_area, this] {
 				openGL_output_builder_.set_visible_area(visible_area);
+				software_output_builder_.set_visible_area(visible_area);
 			});
 		}
 
@@ -68,21 +68,38 @@ ArrayBuilder::Submission ArrayBuilder::submit() {
 	return submission;
 }
 
+ArrayBuilder::Submission ArrayBuilder::submit(const std::function<void(bool is_input, uint8_t *, std::size_t)> &submission_function) {
+	ArrayBuilder::Submission submission;
+
+	submission.input_size = input_.submit(true, submission_function);
+	submission.output_size = output_.submit(false, submission_function);
+	if(is_full_) {
+		is_full_ = false;
+		input_.reset();
+		output_.reset();
+	}
+
+	return submission;
+}
+
 ArrayBuilder::Buffer::Buffer(std::size_t size, std::function<void(bool is_input, uint8_t *, std::size_t)> submission_function) :
 		submission_function_(submission_function) {
-	if(!submission_function_) {
-		glGenBuffers(1, &buffer);
-		glBindBuffer(GL_ARRAY_BUFFER, buffer);
-		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW);
-	}
 	data.resize(size);
 }
 
 ArrayBuilder::Buffer::~Buffer() {
-	if(!submission_function_)
+	if(buffer)
 		glDeleteBuffers(1, &buffer);
 }
 
+void ArrayBuilder::Buffer::create_buffer() {
+	if(buffer) return;
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)data.size(), NULL, GL_STREAM_DRAW);
+}
+
 uint8_t *ArrayBuilder::get_storage(std::size_t size, Buffer &buffer) {
 	uint8_t *pointer = buffer.get_storage(size);
 	if(!pointer) is_full_ = true;
@@ -119,10 +136,15 @@ void ArrayBuilder::Buffer::flush() {
 }
 
 std::size_t ArrayBuilder::Buffer::submit(bool is_input) {
+	return submit(is_input, submission_function_);
+}
+
+std::size_t ArrayBuilder::Buffer::submit(bool is_input, const std::function<void(bool is_input, uint8_t *, std::size_t)> &submission_function) {
 	std::size_t length = flushed_data;
-	if(submission_function_) {
-		submission_function_(is_input, data.data(), length);
+	if(submission_function) {
+		submission_function(is_input, data.data(), length);
 	} else {
+		create_buffer();
 		glBindBuffer(GL_ARRAY_BUFFER, buffer);
 		uint8_t *destination = static_cast<uint8_t *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)length, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
 		if(!glGetError() && destination) {
@@ -138,6 +160,7 @@ std::size_t ArrayBuilder::Buffer::submit(bool is_input) {
 }
 
 void ArrayBuilder::Buffer::bind() {
+	create_buffer();
 	glBindBuffer(GL_ARRAY_BUFFER, buffer);
 }
 
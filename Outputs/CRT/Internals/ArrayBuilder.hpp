@@ -23,6 +23,9 @@ namespace CRT {
 	plus a flush function to lock provisional data into place. Also supplies a submit method to transfer all currently locked
 	data to the GPU and bind_input/output methods to bind the internal buffers.
 
+	OpenGL buffers are created upon first bind or submission, so an ArrayBuilder may be constructed and used without a context
+	by an owner that only ever submits via a function.
+
 	It is safe for one thread to communicate via the get_*_storage and flush inputs asynchronously from another that is making
 	use of the bind and submit outputs.
 */
@@ -67,6 +70,11 @@ class ArrayBuilder {
 		/// @returns A @c Submission record, indicating how much data of each type was submitted.
 		Submission submit();
 
+		/// Submits all flushed input and output data to @c submission_function rather than to the corresponding
+		/// arrays, regardless of how this ArrayBuilder was constructed. Input data is supplied first.
+		/// @returns A @c Submission record, indicating how much data of each type was submitted.
+		Submission submit(const std::function<void(bool is_input, uint8_t *, std::size_t)> &submission_function);
+
 	private:
 		class Buffer {
 			public:
@@ -78,12 +86,14 @@ class ArrayBuilder {
 
 				void flush();
 				std::size_t submit(bool is_input);
+				std::size_t submit(bool is_input, const std::function<void(bool is_input, uint8_t *, std::size_t)> &submission_function);
 				void bind();
 				void reset();
 
 			private:
 				bool is_full = false;
 				GLuint buffer = 0;
+				void create_buffer();
 				std::function<void(bool is_input, uint8_t *, std::size_t)> submission_function_;
 				std::vector<uint8_t> data;
 				std::size_t allocated_data = 0;
@@ -36,6 +36,11 @@ OpenGLOutputBuilder::OpenGLOutputBuilder(std::size_t bytes_per_pixel) :
 		fence_(nullptr),
 		texture_builder(bytes_per_pixel, source_data_texture_unit),
 		array_builder(SourceVertexBufferDataSize, OutputVertexBufferDataSize) {
+	// No OpenGL calls are made here; resources are created upon the first draw_frame, so that
+	// an output builder can exist without a context for the benefit of CPU-only output.
+}
+
+void OpenGLOutputBuilder::establish_OpenGL_state() {
 	glBlendFunc(GL_SRC_ALPHA, GL_CONSTANT_COLOR);
 	glBlendColor(0.4f, 0.4f, 0.4f, 1.0f);
 
@@ -68,7 +73,7 @@ OpenGLOutputBuilder::OpenGLOutputBuilder(std::size_t bytes_per_pixel) :
 }
 
 OpenGLOutputBuilder::~OpenGLOutputBuilder() {
-	glDeleteVertexArrays(1, &output_vertex_array_);
+	if(output_vertex_array_) glDeleteVertexArrays(1, &output_vertex_array_);
 }
 
 void OpenGLOutputBuilder::set_target_framebuffer(GLint target_framebuffer) {
@@ -80,6 +85,9 @@ void OpenGLOutputBuilder::draw_frame(unsigned int output_width, unsigned int out
 	draw_mutex_.lock();
 
 	// establish essentials
+	if(!composite_texture_) {
+		establish_OpenGL_state();
+	}
 	if(!output_shader_program_) {
 		prepare_composite_input_shaders();
 		prepare_svideo_input_shaders();
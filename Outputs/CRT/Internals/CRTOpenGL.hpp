@@ -89,8 +89,8 @@ class OpenGLOutputBuilder {
 
 		std::unique_ptr<OpenGL::TextureTarget> framebuffer_;		// the current pixel output
 
-		GLuint output_vertex_array_;
-		GLuint source_vertex_array_;
+		GLuint output_vertex_array_ = 0;
+		GLuint source_vertex_array_ = 0;
 
 		unsigned int last_output_width_, last_output_height_;
 
@@ -164,6 +164,11 @@ class OpenGLOutputBuilder {
 				composite_src_output_y_++;
 		}
 
+		/// Restarts composite buffer usage from 0; for use by owners that consume data other than via draw_frame.
+		inline void reset_composite_output_y() {
+			composite_src_output_y_ = 0;
+		}
+
 		void set_target_framebuffer(GLint);
 		void draw_frame(unsigned int output_width, unsigned int output_height, bool only_if_dirty);
 		void set_openGL_context_will_change(bool should_delete_resources);
@@ -0,0 +1,985 @@
+//
+//  CRTSoftware.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 24/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#include "CRTSoftware.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define CRT_X86
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CRT_NEON
+#endif
+
+using namespace Outputs::CRT;
+
+namespace {
+	const float pi = 3.141592654f;
+
+	const float rgb_to_yuv[] = {0.299f, -0.14713f, 0.615f, 0.587f, -0.28886f, -0.51499f, 0.114f, 0.436f, -0.10001f};
+	const float rgb_to_yiq[] = {0.299f, 0.596f, 0.211f, 0.587f, -0.274f, -0.523f, 0.114f, -0.322f, 0.312f};
+	const float yuv_to_rgb[] = {1.0f, 1.0f, 1.0f, 0.0f, -0.39465f, 2.03211f, 1.13983f, -0.58060f, 0.0f};
+	const float yiq_to_rgb[] = {1.0f, 1.0f, 1.0f, 0.956f, -0.272f, -1.106f, 0.621f, -0.647f, 1.703f};
+
+	inline float clamped_unit(float value) {
+		return std::min(std::max(value, 0.0f), 1.0f);
+	}
+
+	/// @returns @c value, nominally in the range [0, 1], mapped to [0, 255] and clamped. Clamping is performed
+	/// on the integer result as that form is the more readily vectorised.
+	inline int clamped_byte(float value) {
+		return std::min(std::max(static_cast<int>(value * 255.0f + 0.5f), 0), 255);
+	}
+
+	/// Packs the three components of a colour into a single word with red in the lowest byte.
+	inline uint32_t pack_rgb(float red, float green, float blue) {
+		return uint32_t(clamped_byte(red) | (clamped_byte(green) << 8) | (clamped_byte(blue) << 16));
+	}
+
+	/*!
+		@returns The first texel in a run that covers [start, end), i.e. the first for which
+		the centre is at or to the right of @c start; and via @c end_texel the first texel
+		beyond the run. Both are limited to the intermediate buffer width.
+	*/
+	inline int texel_range(float start, float end, int &end_texel) {
+		end_texel = std::min(std::max(static_cast<int>(std::ceil(end - 0.5f)), 0), int(IntermediateBufferWidth));
+		return std::min(std::max(static_cast<int>(std::ceil(start - 0.5f)), 0), int(IntermediateBufferWidth));
+	}
+
+	/// Describes the separation of composite levels into luminance and modulated chrominance, as per separate_composite_run.
+	struct Separation {
+		const float *levels;
+		float weights[4];
+		float chrominance_multiplier, luminance_multiplier;
+		const float *cosine, *sine;
+		float *luminance, *chrominance_x, *chrominance_y;
+	};
+
+	/// Describes the demodulation of chrominance and conversion to RGB, as per filter_chrominance.
+	struct Filter {
+		const float *luminance, *separated_x, *separated_y;
+		const float *matrix;
+		uint32_t *target;
+	};
+
+	/*
+		Separation, filter and blend implementations. The vector versions perform exactly the same arithmetic as the
+		scalar, in the same order, and therefore produce identical results; they merely process four or eight texels
+		at a time, or sixteen or thirty-two bytes, with any remainder handled as per the scalar version.
+	*/
+
+	void separate_scalar(const Separation &separation, int begin, int end) {
+		const float *const levels = separation.levels;
+		const float *const weights = separation.weights;
+		for(int c = begin; c < end; ++c) {
+			const float luminance =
+				levels[c + 0] * weights[0] + levels[c + 1] * weights[1] +
+				levels[c + 2] * weights[2] + levels[c + 3] * weights[3];
+			const float chrominance = (levels[c + 2] - luminance) * separation.chrominance_multiplier;
+			separation.chrominance_x[c] = chrominance * separation.cosine[c & 3];
+			separation.chrominance_y[c] = chrominance * separation.sine[c & 3];
+			separation.luminance[c] = luminance * separation.luminance_multiplier;
+		}
+	}
+
+	void filter_scalar(const Filter &filter, int begin, int end) {
+		const float *const m = filter.matrix;
+		for(int c = begin; c < end; ++c) {
+			const float y = filter.luminance[c];
+			const float i = (filter.separated_x[c] + filter.separated_x[c + 1] + filter.separated_x[c + 2] + filter.separated_x[c + 3]) * 0.5f;
+			const float q = (filter.separated_y[c] + filter.separated_y[c + 1] + filter.separated_y[c + 2] + filter.separated_y[c + 3]) * 0.5f;
+			filter.target[c] = pack_rgb(
+				m[0] * y + m[3] * i + m[6] * q,
+				m[1] * y + m[4] * i + m[7] * q,
+				m[2] * y + m[5] * i + m[8] * q);
+		}
+	}
+
+	/// Blends as per the OpenGL pipeline: 64% of the new colour plus 40% of whatever was there, saturating.
+	void blend_scalar(const uint8_t *scan, uint8_t *pixels, int begin, int end) {
+		for(int c = begin; c < end; ++c) {
+			pixels[c] = static_cast<uint8_t>(std::min(255, (scan[c] * 164 + pixels[c] * 102 + 128) >> 8));
+		}
+	}
+
+#if !defined(CRT_X86) && !defined(CRT_NEON)
+
+	void separate_entire_scalar(const Separation &separation, int count) {
+		separate_scalar(separation, 0, count);
+	}
+
+	void filter_entire_scalar(const Filter &filter, int count) {
+		filter_scalar(filter, 0, count);
+	}
+
+	void blend_entire_scalar(const uint8_t *scan, uint8_t *pixels, int length) {
+		blend_scalar(scan, pixels, 0, length);
+	}
+
+#endif
+
+#ifdef CRT_X86
+
+	void separate_sse2(const Separation &separation, int count) {
+		const float *const levels = separation.levels;
+		const __m128 weight0 = _mm_set1_ps(separation.weights[0]);
+		const __m128 weight1 = _mm_set1_ps(separation.weights[1]);
+		const __m128 weight2 = _mm_set1_ps(separation.weights[2]);
+		const __m128 weight3 = _mm_set1_ps(separation.weights[3]);
+		const __m128 chrominance_multiplier = _mm_set1_ps(separation.chrominance_multiplier);
+		const __m128 luminance_multiplier = _mm_set1_ps(separation.luminance_multiplier);
+
+		// Four texels are exactly one colour cycle, so the subcarrier is the same for every vector.
+		const __m128 cosine = _mm_loadu_ps(separation.cosine);
+		const __m128 sine = _mm_loadu_ps(separation.sine);
+
+		int c = 0;
+		for(; c + 4 <= count; c += 4) {
+			const __m128 centre = _mm_loadu_ps(&levels[c + 2]);
+			const __m128 luminance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_loadu_ps(&levels[c + 0]), weight0),
+				_mm_mul_ps(_mm_loadu_ps(&levels[c + 1]), weight1)),
+				_mm_mul_ps(centre, weight2)),
+				_mm_mul_ps(_mm_loadu_ps(&levels[c + 3]), weight3));
+			const __m128 chrominance = _mm_mul_ps(_mm_sub_ps(centre, luminance), chrominance_multiplier);
+			_mm_storeu_ps(&separation.chrominance_x[c], _mm_mul_ps(chrominance, cosine));
+			_mm_storeu_ps(&separation.chrominance_y[c], _mm_mul_ps(chrominance, sine));
+			_mm_storeu_ps(&separation.luminance[c], _mm_mul_ps(luminance, luminance_multiplier));
+		}
+		separate_scalar(separation, c, count);
+	}
+
+	/// @returns @c value mapped to [0, 255] and clamped, as per clamped_byte, in each lane of a vector of 32-bit integers.
+	inline __m128i clamped_bytes_sse2(__m128 value) {
+		// Clamping before conversion is equivalent to clamping afterwards, given truncation towards zero.
+		const __m128 scaled = _mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+		return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(scaled, _mm_setzero_ps()), _mm_set1_ps(255.0f)));
+	}
+
+	void filter_sse2(const Filter &filter, int count) {
+		const float *const m = filter.matrix;
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]);
+		const __m128 m3 = _mm_set1_ps(m[3]), m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]);
+		const __m128 m6 = _mm_set1_ps(m[6]), m7 = _mm_set1_ps(m[7]), m8 = _mm_set1_ps(m[8]);
+
+		int c = 0;
+		for(; c + 4 <= count; c += 4) {
+			const __m128 y = _mm_loadu_ps(&filter.luminance[c]);
+			const __m128 i = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_loadu_ps(&filter.separated_x[c + 0]), _mm_loadu_ps(&filter.separated_x[c + 1])),
+				_mm_loadu_ps(&filter.separated_x[c + 2])), _mm_loadu_ps(&filter.separated_x[c + 3])), half);
+			const __m128 q = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_loadu_ps(&filter.separated_y[c + 0]), _mm_loadu_ps(&filter.separated_y[c + 1])),
+				_mm_loadu_ps(&filter.separated_y[c + 2])), _mm_loadu_ps(&filter.separated_y[c + 3])), half);
+
+			const __m128i red = clamped_bytes_sse2(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, y), _mm_mul_ps(m3, i)), _mm_mul_ps(m6, q)));
+			const __m128i green = clamped_bytes_sse2(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, y), _mm_mul_ps(m4, i)), _mm_mul_ps(m7, q)));
+			const __m128i blue = clamped_bytes_sse2(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, y), _mm_mul_ps(m5, i)), _mm_mul_ps(m8, q)));
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i *>(&filter.target[c]),
+				_mm_or_si128(red, _mm_or_si128(_mm_slli_epi32(green, 8), _mm_slli_epi32(blue, 16))));
+		}
+		filter_scalar(filter, c, count);
+	}
+
+	void blend_sse2(const uint8_t *scan, uint8_t *pixels, int length) {
+		// Scan and pixel values are interleaved as pairs of 16-bit values so that a multiply-add produces
+		// scan * 164 + pixel * 102; the final packs saturate.
+		const __m128i weights = _mm_set1_epi32(164 | (102 << 16));
+		const __m128i rounding = _mm_set1_epi32(128);
+		const __m128i zero = _mm_setzero_si128();
+
+		int c = 0;
+		for(; c + 16 <= length; c += 16) {
+			const __m128i new_colour = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&scan[c]));
+			const __m128i old_colour = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&pixels[c]));
+			const __m128i new_low = _mm_unpacklo_epi8(new_colour, zero), new_high = _mm_unpackhi_epi8(new_colour, zero);
+			const __m128i old_low = _mm_unpacklo_epi8(old_colour, zero), old_high = _mm_unpackhi_epi8(old_colour, zero);
+
+			const __m128i result0 = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(new_low, old_low), weights), rounding), 8);
+			const __m128i result1 = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(new_low, old_low), weights), rounding), 8);
+			const __m128i result2 = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(new_high, old_high), weights), rounding), 8);
+			const __m128i result3 = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(new_high, old_high), weights), rounding), 8);
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i *>(&pixels[c]),
+				_mm_packus_epi16(_mm_packs_epi32(result0, result1), _mm_packs_epi32(result2, result3)));
+		}
+		blend_scalar(scan, pixels, c, length);
+	}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CRT_AVX2
+
+	__attribute__((target("avx2"))) void separate_avx2(const Separation &separation, int count) {
+		const float *const levels = separation.levels;
+		const __m256 weight0 = _mm256_set1_ps(separation.weights[0]);
+		const __m256 weight1 = _mm256_set1_ps(separation.weights[1]);
+		const __m256 weight2 = _mm256_set1_ps(separation.weights[2]);
+		const __m256 weight3 = _mm256_set1_ps(separation.weights[3]);
+		const __m256 chrominance_multiplier = _mm256_set1_ps(separation.chrominance_multiplier);
+		const __m256 luminance_multiplier = _mm256_set1_ps(separation.luminance_multiplier);
+
+		// Each vector is two colour cycles.
+		const __m128 cosine_cycle = _mm_loadu_ps(separation.cosine);
+		const __m128 sine_cycle = _mm_loadu_ps(separation.sine);
+		const __m256 cosine = _mm256_insertf128_ps(_mm256_castps128_ps256(cosine_cycle), cosine_cycle, 1);
+		const __m256 sine = _mm256_insertf128_ps(_mm256_castps128_ps256(sine_cycle), sine_cycle, 1);
+
+		int c = 0;
+		for(; c + 8 <= count; c += 8) {
+			const __m256 centre = _mm256_loadu_ps(&levels[c + 2]);
+			const __m256 luminance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(_mm256_loadu_ps(&levels[c + 0]), weight0),
+				_mm256_mul_ps(_mm256_loadu_ps(&levels[c + 1]), weight1)),
+				_mm256_mul_ps(centre, weight2)),
+				_mm256_mul_ps(_mm256_loadu_ps(&levels[c + 3]), weight3));
+			const __m256 chrominance = _mm256_mul_ps(_mm256_sub_ps(centre, luminance), chrominance_multiplier);
+			_mm256_storeu_ps(&separation.chrominance_x[c], _mm256_mul_ps(chrominance, cosine));
+			_mm256_storeu_ps(&separation.chrominance_y[c], _mm256_mul_ps(chrominance, sine));
+			_mm256_storeu_ps(&separation.luminance[c], _mm256_mul_ps(luminance, luminance_multiplier));
+		}
+
+		// See dot_product_avx2 in FIRFilter.cpp as to the explicit zeroupper.
+		_mm256_zeroupper();
+		separate_scalar(separation, c, count);
+	}
+
+	__attribute__((target("avx2"))) inline __m256i clamped_bytes_avx2(__m256 value) {
+		const __m256 scaled = _mm256_add_ps(_mm256_mul_ps(value, _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f));
+		return _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(scaled, _mm256_setzero_ps()), _mm256_set1_ps(255.0f)));
+	}
+
+	__attribute__((target("avx2"))) void filter_avx2(const Filter &filter, int count) {
+		const float *const m = filter.matrix;
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]), m2 = _mm256_set1_ps(m[2]);
+		const __m256 m3 = _mm256_set1_ps(m[3]), m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]);
+		const __m256 m6 = _mm256_set1_ps(m[6]), m7 = _mm256_set1_ps(m[7]), m8 = _mm256_set1_ps(m[8]);
+
+		int c = 0;
+		for(; c + 8 <= count; c += 8) {
+			const __m256 y = _mm256_loadu_ps(&filter.luminance[c]);
+			const __m256 i = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+				_mm256_loadu_ps(&filter.separated_x[c + 0]), _mm256_loadu_ps(&filter.separated_x[c + 1])),
+				_mm256_loadu_ps(&filter.separated_x[c + 2])), _mm256_loadu_ps(&filter.separated_x[c + 3])), half);
+			const __m256 q = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+				_mm256_loadu_ps(&filter.separated_y[c + 0]), _mm256_loadu_ps(&filter.separated_y[c + 1])),
+				_mm256_loadu_ps(&filter.separated_y[c + 2])), _mm256_loadu_ps(&filter.separated_y[c + 3])), half);
+
+			const __m256i red = clamped_bytes_avx2(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m0, y), _mm256_mul_ps(m3, i)), _mm256_mul_ps(m6, q)));
+			const __m256i green = clamped_bytes_avx2(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m1, y), _mm256_mul_ps(m4, i)), _mm256_mul_ps(m7, q)));
+			const __m256i blue = clamped_bytes_avx2(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m2, y), _mm256_mul_ps(m5, i)), _mm256_mul_ps(m8, q)));
+			_mm256_storeu_si256(
+				reinterpret_cast<__m256i *>(&filter.target[c]),
+				_mm256_or_si256(red, _mm256_or_si256(_mm256_slli_epi32(green, 8), _mm256_slli_epi32(blue, 16))));
+		}
+
+		_mm256_zeroupper();
+		filter_scalar(filter, c, count);
+	}
+
+	__attribute__((target("avx2"))) void blend_avx2(const uint8_t *scan, uint8_t *pixels, int length) {
+		// As per the SSE2 version; unpacking and packing both operate within 128-bit lanes, so byte order is preserved.
+		const __m256i weights = _mm256_set1_epi32(164 | (102 << 16));
+		const __m256i rounding = _mm256_set1_epi32(128);
+		const __m256i zero = _mm256_setzero_si256();
+
+		int c = 0;
+		for(; c + 32 <= length; c += 32) {
+			const __m256i new_colour = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&scan[c]));
+			const __m256i old_colour = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&pixels[c]));
+			const __m256i new_low = _mm256_unpacklo_epi8(new_colour, zero), new_high = _mm256_unpackhi_epi8(new_colour, zero);
+			const __m256i old_low = _mm256_unpacklo_epi8(old_colour, zero), old_high = _mm256_unpackhi_epi8(old_colour, zero);
+
+			const __m256i result0 = _mm256_srli_epi32(_mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(new_low, old_low), weights), rounding), 8);
+			const __m256i result1 = _mm256_srli_epi32(_mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(new_low, old_low), weights), rounding), 8);
+			const __m256i result2 = _mm256_srli_epi32(_mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(new_high, old_high), weights), rounding), 8);
+			const __m256i result3 = _mm256_srli_epi32(_mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(new_high, old_high), weights), rounding), 8);
+			_mm256_storeu_si256(
+				reinterpret_cast<__m256i *>(&pixels[c]),
+				_mm256_packus_epi16(_mm256_packs_epi32(result0, result1), _mm256_packs_epi32(result2, result3)));
+		}
+
+		_mm256_zeroupper();
+		blend_scalar(scan, pixels, c, length);
+	}
+
+#endif
+#endif
+
+#ifdef CRT_NEON
+
+	void separate_neon(const Separation &separation, int count) {
+		const float *const levels = separation.levels;
+		const float32x4_t weight0 = vdupq_n_f32(separation.weights[0]);
+		const float32x4_t weight1 = vdupq_n_f32(separation.weights[1]);
+		const float32x4_t weight2 = vdupq_n_f32(separation.weights[2]);
+		const float32x4_t weight3 = vdupq_n_f32(separation.weights[3]);
+		const float32x4_t chrominance_multiplier = vdupq_n_f32(separation.chrominance_multiplier);
+		const float32x4_t luminance_multiplier = vdupq_n_f32(separation.luminance_multiplier);
+		const float32x4_t cosine = vld1q_f32(separation.cosine);
+		const float32x4_t sine = vld1q_f32(separation.sine);
+
+		// Multiplies and adds are kept separate, rather than fused, so as to match the scalar version.
+		int c = 0;
+		for(; c + 4 <= count; c += 4) {
+			const float32x4_t centre = vld1q_f32(&levels[c + 2]);
+			const float32x4_t luminance = vaddq_f32(vaddq_f32(vaddq_f32(
+				vmulq_f32(vld1q_f32(&levels[c + 0]), weight0),
+				vmulq_f32(vld1q_f32(&levels[c + 1]), weight1)),
+				vmulq_f32(centre, weight2)),
+				vmulq_f32(vld1q_f32(&levels[c + 3]), weight3));
+			const float32x4_t chrominance = vmulq_f32(vsubq_f32(centre, luminance), chrominance_multiplier);
+			vst1q_f32(&separation.chrominance_x[c], vmulq_f32(chrominance, cosine));
+			vst1q_f32(&separation.chrominance_y[c], vmulq_f32(chrominance, sine));
+			vst1q_f32(&separation.luminance[c], vmulq_f32(luminance, luminance_multiplier));
+		}
+		separate_scalar(separation, c, count);
+	}
+
+	inline uint32x4_t clamped_bytes_neon(float32x4_t value) {
+		const float32x4_t scaled = vaddq_f32(vmulq_f32(value, vdupq_n_f32(255.0f)), vdupq_n_f32(0.5f));
+		return vreinterpretq_u32_s32(vcvtq_s32_f32(vminq_f32(vmaxq_f32(scaled, vdupq_n_f32(0.0f)), vdupq_n_f32(255.0f))));
+	}
+
+	void filter_neon(const Filter &filter, int count) {
+		const float *const m = filter.matrix;
+		const float32x4_t half = vdupq_n_f32(0.5f);
+
+		int c = 0;
+		for(; c + 4 <= count; c += 4) {
+			const float32x4_t y = vld1q_f32(&filter.luminance[c]);
+			const float32x4_t i = vmulq_f32(vaddq_f32(vaddq_f32(vaddq_f32(
+				vld1q_f32(&filter.separated_x[c + 0]), vld1q_f32(&filter.separated_x[c + 1])),
+				vld1q_f32(&filter.separated_x[c + 2])), vld1q_f32(&filter.separated_x[c + 3])), half);
+			const float32x4_t q = vmulq_f32(vaddq_f32(vaddq_f32(vaddq_f32(
+				vld1q_f32(&filter.separated_y[c + 0]), vld1q_f32(&filter.separated_y[c + 1])),
+				vld1q_f32(&filter.separated_y[c + 2])), vld1q_f32(&filter.separated_y[c + 3])), half);
+
+			const uint32x4_t red = clamped_bytes_neon(vaddq_f32(vaddq_f32(vmulq_n_f32(y, m[0]), vmulq_n_f32(i, m[3])), vmulq_n_f32(q, m[6])));
+			const uint32x4_t green = clamped_bytes_neon(vaddq_f32(vaddq_f32(vmulq_n_f32(y, m[1]), vmulq_n_f32(i, m[4])), vmulq_n_f32(q, m[7])));
+			const uint32x4_t blue = clamped_bytes_neon(vaddq_f32(vaddq_f32(vmulq_n_f32(y, m[2]), vmulq_n_f32(i, m[5])), vmulq_n_f32(q, m[8])));
+			vst1q_u32(&filter.target[c], vorrq_u32(red, vorrq_u32(vshlq_n_u32(green, 8), vshlq_n_u32(blue, 16))));
+		}
+		filter_scalar(filter, c, count);
+	}
+
+	void blend_neon(const uint8_t *scan, uint8_t *pixels, int length) {
+		// Products are formed at 16 bits, summed at 32 and then narrowed with saturation.
+		const uint8x8_t new_weight = vdup_n_u8(164), old_weight = vdup_n_u8(102);
+		const uint32x4_t rounding = vdupq_n_u32(128);
+
+		int c = 0;
+		for(; c + 16 <= length; c += 16) {
+			const uint8x16_t new_colour = vld1q_u8(&scan[c]);
+			const uint8x16_t old_colour = vld1q_u8(&pixels[c]);
+			const uint16x8_t new_low = vmull_u8(vget_low_u8(new_colour), new_weight), new_high = vmull_u8(vget_high_u8(new_colour), new_weight);
+			const uint16x8_t old_low = vmull_u8(vget_low_u8(old_colour), old_weight), old_high = vmull_u8(vget_high_u8(old_colour), old_weight);
+
+			const uint32x4_t result0 = vshrq_n_u32(vaddq_u32(vaddl_u16(vget_low_u16(new_low), vget_low_u16(old_low)), rounding), 8);
+			const uint32x4_t result1 = vshrq_n_u32(vaddq_u32(vaddl_u16(vget_high_u16(new_low), vget_high_u16(old_low)), rounding), 8);
+			const uint32x4_t result2 = vshrq_n_u32(vaddq_u32(vaddl_u16(vget_low_u16(new_high), vget_low_u16(old_high)), rounding), 8);
+			const uint32x4_t result3 = vshrq_n_u32(vaddq_u32(vaddl_u16(vget_high_u16(new_high), vget_high_u16(old_high)), rounding), 8);
+			vst1q_u8(&pixels[c], vcombine_u8(
+				vqmovn_u16(vcombine_u16(vqmovn_u32(result0), vqmovn_u32(result1))),
+				vqmovn_u16(vcombine_u16(vqmovn_u32(result2), vqmovn_u32(result3)))));
+		}
+		blend_scalar(scan, pixels, c, length);
+	}
+
+#endif
+}
+
+struct SoftwareOutputBuilder::Kernels {
+	void (*separate)(const Separation &separation, int count);
+	void (*filter)(const Filter &filter, int count);
+	void (*blend)(const uint8_t *scan, uint8_t *pixels, int length);
+};
+
+const SoftwareOutputBuilder::Kernels *SoftwareOutputBuilder::select_kernels() {
+#if defined(CRT_AVX2)
+	static const Kernels avx2 = {separate_avx2, filter_avx2, blend_avx2};
+	if(__builtin_cpu_supports("avx2")) return &avx2;
+#endif
+#if defined(CRT_X86)
+	static const Kernels sse2 = {separate_sse2, filter_sse2, blend_sse2};
+	return &sse2;
+#elif defined(CRT_NEON)
+	static const Kernels neon = {separate_neon, filter_neon, blend_neon};
+	return &neon;
+#else
+	static const Kernels scalar = {separate_entire_scalar, filter_entire_scalar, blend_entire_scalar};
+	return &scalar;
+#endif
+}
+
+SoftwareOutputBuilder::SoftwareOutputBuilder() :
+		visible_area_(Rect(0, 0, 1, 1)),
+		kernels_(select_kernels()) {
+	set_gamma(1.0f);
+	std::memcpy(rgb_to_luma_chroma_, rgb_to_yiq, sizeof(rgb_to_luma_chroma_));
+	std::memcpy(luma_chroma_to_rgb_, yiq_to_rgb, sizeof(luma_chroma_to_rgb_));
+}
+
+// MARK: - Configuration
+
+void SoftwareOutputBuilder::set_rgb_sampling_function(const SoftwareRGBSamplingFunction &function) {
+	rgb_sampler_ = function;
+}
+
+void SoftwareOutputBuilder::set_composite_sampling_function(const SoftwareCompositeSamplingFunction &function) {
+	composite_sampler_ = function;
+}
+
+void SoftwareOutputBuilder::set_svideo_sampling_function(const SoftwareSVideoSamplingFunction &function) {
+	svideo_sampler_ = function;
+}
+
+void SoftwareOutputBuilder::set_video_signal(VideoSignal video_signal) {
+	video_signal_ = video_signal;
+}
+
+void SoftwareOutputBuilder::set_visible_area(Rect visible_area) {
+	visible_area_ = visible_area;
+	geometry_is_dirty_ = true;
+}
+
+void SoftwareOutputBuilder::set_gamma(float gamma) {
+	gamma_is_identity_ = true;
+	for(int c = 0; c < 256; ++c) {
+		gamma_table_[c] = static_cast<uint8_t>(clamped_byte(powf(static_cast<float>(c) / 255.0f, gamma)));
+		gamma_is_identity_ &= gamma_table_[c] == c;
+	}
+}
+
+void SoftwareOutputBuilder::set_colour_format(ColourSpace colour_space, unsigned int colour_cycle_numerator, unsigned int colour_cycle_denominator) {
+	colour_space_ = colour_space;
+	colour_cycle_numerator_ = colour_cycle_numerator;
+	colour_cycle_denominator_ = colour_cycle_denominator;
+	std::memcpy(rgb_to_luma_chroma_, (colour_space == ColourSpace::YUV) ? rgb_to_yuv : rgb_to_yiq, sizeof(rgb_to_luma_chroma_));
+	std::memcpy(luma_chroma_to_rgb_, (colour_space == ColourSpace::YUV) ? yuv_to_rgb : yiq_to_rgb, sizeof(luma_chroma_to_rgb_));
+}
+
+void SoftwareOutputBuilder::set_timing(unsigned int input_frequency, unsigned int cycles_per_line, unsigned int height_of_display, unsigned int horizontal_scan_period, unsigned int vertical_scan_period, unsigned int vertical_period_divider) {
+	input_frequency_ = input_frequency;
+	cycles_per_line_ = cycles_per_line;
+	height_of_display_ = height_of_display;
+	horizontal_scan_period_ = horizontal_scan_period;
+	vertical_scan_period_ = vertical_scan_period;
+	vertical_period_divider_ = vertical_period_divider;
+	geometry_is_dirty_ = true;
+}
+
+/*!
+	@returns The multiplier to apply to horizontal flywheel positions in order to produce locations in the composite
+		intermediate buffer; as per the OpenGLOutputBuilder this places four samples in each colour cycle.
+*/
+float SoftwareOutputBuilder::get_composite_output_width() const {
+	return static_cast<float>(colour_cycle_numerator_ * 4) / static_cast<float>(colour_cycle_denominator_ * cycles_per_line_);
+}
+
+// MARK: - Intermediate buffers
+
+float *SoftwareOutputBuilder::composite_row(uint16_t row, int first, int end) {
+	if(composite_.empty()) {
+		composite_.resize(IntermediateBufferWidth * IntermediateBufferHeight);
+		composite_row_is_populated_.resize(IntermediateBufferHeight, false);
+	}
+
+	row %= IntermediateBufferHeight;
+	float *const pointer = &composite_[row * IntermediateBufferWidth];
+	if(!composite_row_is_populated_[row]) {
+		std::fill(pointer, pointer + first, 0.0f);
+		std::fill(pointer + std::max(first, end), pointer + IntermediateBufferWidth, 0.0f);
+		composite_row_is_populated_[row] = true;
+	}
+	return pointer;
+}
+
+uint32_t *SoftwareOutputBuilder::filtered_row(uint16_t row, int first, int end) {
+	if(filtered_.empty()) {
+		filtered_.resize(IntermediateBufferWidth * IntermediateBufferHeight);
+		filtered_row_is_populated_.resize(IntermediateBufferHeight, false);
+	}
+
+	row %= IntermediateBufferHeight;
+	uint32_t *const pointer = &filtered_[row * IntermediateBufferWidth];
+	if(!filtered_row_is_populated_[row]) {
+		std::fill(pointer, pointer + first, 0);
+		std::fill(pointer + std::max(first, end), pointer + IntermediateBufferWidth, 0);
+		filtered_row_is_populated_[row] = true;
+	}
+	return pointer;
+}
+
+// MARK: - Sampling
+
+void SoftwareOutputBuilder::rgb_sample(const uint8_t *sample, float *rgb) {
+	rgb_sampler_(sample, rgb);
+	rgb[0] = clamped_unit(rgb[0]);
+	rgb[1] = clamped_unit(rgb[1]);
+	rgb[2] = clamped_unit(rgb[2]);
+}
+
+void SoftwareOutputBuilder::luma_chroma_sample(const uint8_t *sample, float *luma_chroma) {
+	float rgb[3];
+	rgb_sample(sample, rgb);
+	for(int c = 0; c < 3; ++c) {
+		luma_chroma[c] =
+			rgb_to_luma_chroma_[c] * rgb[0] +
+			rgb_to_luma_chroma_[3 + c] * rgb[1] +
+			rgb_to_luma_chroma_[6 + c] * rgb[2];
+	}
+}
+
+// MARK: - Source runs
+
+void SoftwareOutputBuilder::submit_source_runs(const uint8_t *runs, std::size_t size, const TextureBuilder &texture_builder) {
+	source_runs_.clear();
+	for(std::size_t offset = 0; offset + SourceVertexSize <= size; offset += SourceVertexSize) {
+		const uint8_t *const vertex = &runs[offset];
+		SourceRun run;
+		run.input_x[0] = *reinterpret_cast<const uint16_t *>(&vertex[SourceVertexOffsetOfInputStart + 0]);
+		run.input_y = *reinterpret_cast<const uint16_t *>(&vertex[SourceVertexOffsetOfInputStart + 2]);
+		run.output_x[0] = *reinterpret_cast<const uint16_t *>(&vertex[SourceVertexOffsetOfOutputStart + 0]);
+		run.output_y = *reinterpret_cast<const uint16_t *>(&vertex[SourceVertexOffsetOfOutputStart + 2]);
+		run.input_x[1] = *reinterpret_cast<const uint16_t *>(&vertex[SourceVertexOffsetOfEnds + 0]);
+		run.output_x[1] = *reinterpret_cast<const uint16_t *>(&vertex[SourceVertexOffsetOfEnds + 2]);
+
+		// Phase is in units of 1/64th of a quarter cycle; amplitude is biased by 128.
+		run.phase = static_cast<float>(vertex[SourceVertexOffsetOfPhaseTimeAndAmplitude + 0]) / 64.0f;
+		run.amplitude = static_cast<float>(int(vertex[SourceVertexOffsetOfPhaseTimeAndAmplitude + 1]) - 128) / 127.0f;
+		source_runs_.push_back(run);
+	}
+
+	switch(video_signal_) {
+		case VideoSignal::RGB:
+			if(!rgb_sampler_) break;
+			for(const auto &run: source_runs_) paint_rgb_run(run, texture_builder);
+		break;
+
+		case VideoSignal::SVideo:
+			if(!svideo_sampler_ && !rgb_sampler_) break;
+			for(const auto &run: source_runs_) paint_svideo_run(run, texture_builder);
+		break;
+
+		case VideoSignal::Composite:
+			if(!composite_sampler_ && !svideo_sampler_ && !rgb_sampler_) break;
+			for(const auto &run: source_runs_) paint_composite_run(run, texture_builder);
+			for(const auto &run: source_runs_) separate_composite_run(run);
+		break;
+	}
+}
+
+/*
+	Each of the paint_ methods maps from the input positions of a source run to the output positions,
+	sampling the nearest input pixel for the centre of each output texel.
+*/
+
+void SoftwareOutputBuilder::reserve_run_buffers() {
+	// Separated values are produced for up to two texels either side of the widest possible run, plus two
+	// more of composite samples either side of those; reserve all of that plus some padding.
+	const std::size_t size = IntermediateBufferWidth + 16;
+	if(source_indices_.size() < size) {
+		source_indices_.resize(size);
+		composite_levels_.resize(size);
+		separated_luminance_.resize(size);
+		separated_chrominance_[0].resize(size);
+		separated_chrominance_[1].resize(size);
+	}
+}
+
+const int *SoftwareOutputBuilder::map_source_indices(const SourceRun &run, float output_width, int first, int count) {
+	// Sample indices are limited to the run plus the one pixel of padding the TextureBuilder places either side.
+	const float input_step = float(run.input_x[1] - run.input_x[0]) / (float(run.output_x[1] - run.output_x[0]) * output_width);
+	const float input_x = float(run.input_x[0]) + (float(first) + 0.5f - float(run.output_x[0]) * output_width) * input_step;
+	const int minimum = std::max(int(run.input_x[0]) - 1, 0);
+	const int maximum = std::min(int(run.input_x[1]), int(InputBufferBuilderWidth - 1));
+
+	reserve_run_buffers();
+	int *const indices = source_indices_.data();
+	for(int c = 0; c < count; ++c) {
+		indices[c] = std::min(std::max(static_cast<int>(input_x + float(c) * input_step), minimum), maximum);
+	}
+	return indices;
+}
+
+void SoftwareOutputBuilder::paint_rgb_run(const SourceRun &run, const TextureBuilder &texture_builder) {
+	int end;
+	const int texel = texel_range(run.output_x[0], run.output_x[1], end);
+	if(texel >= end) return;
+
+	const int count = end - texel;
+	const int *const indices = map_source_indices(run, 1.0f, texel, count);
+	uint32_t *const target = &filtered_row(run.output_y, texel, end)[texel];
+	const std::size_t bytes_per_pixel = texture_builder.get_bytes_per_pixel();
+	const uint8_t *const source = texture_builder.get_image() + run.input_y * InputBufferBuilderWidth * bytes_per_pixel;
+
+	// Most runs are substantially wider in output than in input, and most sources repeat samples, so
+	// proceed in spans of the same sample and sample only upon a change of value.
+	SampleCache cache;
+	uint32_t colour = 0;
+	for(int c = 0; c < count;) {
+		const int span_end = SoftwareOutputBuilder::span_end(indices, c, count);
+		const uint8_t *const sample = &source[indices[c] * bytes_per_pixel];
+		if(cache.is_stale(SampleCache::get_key(sample, indices[c], bytes_per_pixel), 0)) {
+			float rgb[3];
+			rgb_sample(sample, rgb);
+			colour = pack_rgb(rgb[0], rgb[1], rgb[2]);
+		}
+		std::fill(target + c, target + span_end, colour);
+		c = span_end;
+	}
+}
+
+/*
+	Both the s-video and composite paths follow the OpenGL pipeline in producing separated luminance and
+	chrominance, the latter being already multiplied by the colour subcarrier, and then averaging chrominance
+	over a complete colour cycle to complete demodulation.
+
+	Since there are exactly four intermediate texels per colour cycle, the subcarrier has only four distinct
+	phases per run; cosines and sines are therefore looked up by texel index modulo four rather than evaluated
+	per texel, and sampling function results are cached per phase, as most sources repeat the same sample
+	across many successive texels. Runs are otherwise processed as flat arrays of floats, so that the
+	separation and filter loops map directly onto four-lane vector arithmetic.
+*/
+
+void SoftwareOutputBuilder::Quadrature::set(float run_phase, float amplitude, int first_texel) {
+	// Phase at texel t is (t + 0.5 + run_phase) quarter-cycles; the sign of the amplitude
+	// indicates the direction of the second component, which is how PAL alternation is expressed.
+	const float sign = (amplitude < 0.0f) ? -1.0f : 1.0f;
+	for(int c = 0; c < 4; ++c) {
+		phase[c] = (float((first_texel + c) & 3) + 0.5f + run_phase) * 0.5f * pi;
+		cosine[c] = cosf(phase[c]);
+		sine[c] = sinf(phase[c]) * sign;
+	}
+}
+
+void SoftwareOutputBuilder::paint_svideo_run(const SourceRun &run, const TextureBuilder &texture_builder) {
+	const float output_width = get_composite_output_width();
+	int end;
+	const int texel = texel_range(float(run.output_x[0]) * output_width, float(run.output_x[1]) * output_width, end);
+	if(texel >= end) return;
+
+	// The chrominance filter needs separated values for two texels either side of the run.
+	const int first = texel - 2;
+	const int count = end + 1 - first;
+	const int *const indices = map_source_indices(run, output_width, first, count);
+	const std::size_t bytes_per_pixel = texture_builder.get_bytes_per_pixel();
+	const uint8_t *const source = texture_builder.get_image() + run.input_y * InputBufferBuilderWidth * bytes_per_pixel;
+
+	Quadrature quadrature;
+	quadrature.set(run.phase, run.amplitude, first);
+	const float absolute_amplitude = fabsf(run.amplitude);
+	const float chrominance_multiplier = (absolute_amplitude > 0.05f) ? 0.5f / absolute_amplitude : 0.0f;
+
+	float *const luminance = separated_luminance_.data();
+	float *const chrominance_x = separated_chrominance_[0].data();
+	float *const chrominance_y = separated_chrominance_[1].data();
+	SampleCache cache;
+	for(int c = 0; c < count;) {
+		const int span_end = SoftwareOutputBuilder::span_end(indices, c, count);
+		const uint8_t *const sample = &source[indices[c] * bytes_per_pixel];
+		const uint32_t key = SampleCache::get_key(sample, indices[c], bytes_per_pixel);
+
+		// Ensure that results are cached for every phase the span touches, then fill without further tests.
+		const int phases_end = std::min(span_end, c + 4);
+		for(int t = c; t < phases_end; ++t) {
+			const int phase_index = t & 3;
+			float *const luma_chroma = cache.results[phase_index];
+			if(!cache.is_stale(key, phase_index)) continue;
+
+			if(svideo_sampler_) {
+				svideo_sampler_(sample, quadrature.phase[phase_index], run.amplitude, luma_chroma);
+			} else {
+				// As per the OpenGL fallback: chrominance is biased by 0.5 and halved.
+				float yuv[3];
+				luma_chroma_sample(sample, yuv);
+				luma_chroma[0] = yuv[0];
+				luma_chroma[1] = 0.5f + (quadrature.cosine[phase_index] * yuv[1] + quadrature.sine[phase_index] * yuv[2]) * 0.5f;
+			}
+		}
+
+		for(; c < span_end; ++c) {
+			const int phase_index = c & 3;
+			const float *const luma_chroma = cache.results[phase_index];
+			luminance[c] = luma_chroma[0];
+			chrominance_x[c] = luma_chroma[1] * quadrature.cosine[phase_index] * chrominance_multiplier;
+			chrominance_y[c] = luma_chroma[1] * quadrature.sine[phase_index] * chrominance_multiplier;
+		}
+	}
+
+	filter_chrominance(run.output_y, texel, end);
+}
+
+void SoftwareOutputBuilder::paint_composite_run(const SourceRun &run, const TextureBuilder &texture_builder) {
+	const float output_width = get_composite_output_width();
+	int end;
+	const int texel = texel_range(float(run.output_x[0]) * output_width, float(run.output_x[1]) * output_width, end);
+	if(texel >= end) return;
+
+	const int count = end - texel;
+	const int *const indices = map_source_indices(run, output_width, texel, count);
+	float *const target = &composite_row(run.output_y, texel, end)[texel];
+	const std::size_t bytes_per_pixel = texture_builder.get_bytes_per_pixel();
+	const uint8_t *const source = texture_builder.get_image() + run.input_y * InputBufferBuilderWidth * bytes_per_pixel;
+
+	Quadrature quadrature;
+	quadrature.set(run.phase, run.amplitude, texel);
+	const float absolute_amplitude = fabsf(run.amplitude);
+
+	SampleCache cache;
+	for(int c = 0; c < count;) {
+		const int span_end = SoftwareOutputBuilder::span_end(indices, c, count);
+		const uint8_t *const sample = &source[indices[c] * bytes_per_pixel];
+		const uint32_t key = SampleCache::get_key(sample, indices[c], bytes_per_pixel);
+
+		// Ensure that results are cached for every phase the span touches, then fill without further tests.
+		const int phases_end = std::min(span_end, c + 4);
+		for(int t = c; t < phases_end; ++t) {
+			const int phase_index = t & 3;
+			float *const level = cache.results[phase_index];
+			if(!cache.is_stale(key, phase_index)) continue;
+
+			if(composite_sampler_) {
+				level[0] = composite_sampler_(sample, quadrature.phase[phase_index], run.amplitude);
+			} else if(svideo_sampler_) {
+				float luma_chroma[2];
+				svideo_sampler_(sample, quadrature.phase[phase_index], run.amplitude, luma_chroma);
+				level[0] = luma_chroma[0] * (1.0f - absolute_amplitude) + luma_chroma[1] * absolute_amplitude;
+			} else {
+				float luma_chroma[3];
+				luma_chroma_sample(sample, luma_chroma);
+				level[0] =
+					luma_chroma[0] * (1.0f - absolute_amplitude) +
+					(luma_chroma[1] * quadrature.cosine[phase_index] + luma_chroma[2] * quadrature.sine[phase_index]) * absolute_amplitude;
+			}
+
+			// The intermediate buffer in the OpenGL pipeline is of normalised bytes, so clamps.
+			level[0] = clamped_unit(level[0]);
+		}
+
+		for(; c < span_end; ++c) {
+			target[c] = cache.results[c & 3][0];
+		}
+	}
+}
+
+void SoftwareOutputBuilder::separate_composite_run(const SourceRun &run) {
+	// As per the OpenGL pipeline, separation is applied to an extra one and a half
+	// colour cycles at each end of the run.
+	const float output_width = get_composite_output_width();
+	const float extension = 6.0f;
+	int end;
+	const int texel = texel_range(float(run.output_x[0]) * output_width - extension, float(run.output_x[1]) * output_width + extension, end);
+	if(texel >= end) return;
+
+	// Separated values are needed for two texels either side of the extended run, each of which
+	// in turn needs composite levels from two texels before to one after. Work is rounded up to
+	// whole colour cycles.
+	reserve_run_buffers();
+	const int first = texel - 2;
+	const int count = (end + 1 - first + 3) & ~3;
+	const float *const source = composite_row(run.output_y);
+	const int source_start = std::max(first - 2, 0);
+	const int source_end = std::min(first + count + 1, int(IntermediateBufferWidth));
+
+	// Levels can be read directly from the row unless the run reaches beyond either end of it,
+	// in which case the edge values are repeated.
+	const float *levels;
+	if(source_start == first - 2 && source_end == first + count + 1) {
+		levels = &source[source_start];
+	} else {
+		float *const padded_levels = composite_levels_.data();
+		std::fill(padded_levels, padded_levels + (source_start - (first - 2)), source[0]);
+		std::copy(source + source_start, source + source_end, padded_levels + (source_start - (first - 2)));
+		std::fill(padded_levels + (source_end - (first - 2)), padded_levels + count + 3, source[IntermediateBufferWidth - 1]);
+		levels = padded_levels;
+	}
+
+	Quadrature quadrature;
+	quadrature.set(run.phase, run.amplitude, first);
+	const float absolute_amplitude = fabsf(run.amplitude);
+	const bool has_colour_burst = absolute_amplitude > 0.05f;
+	const float chrominance_multiplier = has_colour_burst ? 0.5f / absolute_amplitude : 0.0f;
+	const float luminance_multiplier = (absolute_amplitude < 1.0f) ? 1.0f / (1.0f - absolute_amplitude) : 1.0f;
+
+	// Luminance is either the straight average of the samples, if a colour subcarrier
+	// was present, or else a weighted sample around the third sample if not. Chrominance
+	// is whatever was here, minus luminance, multiplied by the subcarrier.
+	const Separation separation = {
+		levels,
+		{
+			has_colour_burst ? 0.25f : 0.0f,
+			has_colour_burst ? 0.25f : 0.16f,
+			has_colour_burst ? 0.25f : 0.66f,
+			has_colour_burst ? 0.25f : 0.16f,
+		},
+		chrominance_multiplier, luminance_multiplier,
+		quadrature.cosine, quadrature.sine,
+		separated_luminance_.data(), separated_chrominance_[0].data(), separated_chrominance_[1].data()
+	};
+	kernels_->separate(separation, count);
+
+	filter_chrominance(run.output_y, texel, end);
+}
+
+void SoftwareOutputBuilder::filter_chrominance(uint16_t row, int texel, int end) {
+	// The separated buffers begin two texels before texel; chrominance is averaged over the
+	// four texels from two before to one after each output, then all is converted to RGB.
+	const Filter filter = {
+		&separated_luminance_[2], separated_chrominance_[0].data(), separated_chrominance_[1].data(),
+		luma_chroma_to_rgb_,
+		&filtered_row(row, texel, end)[texel]
+	};
+	kernels_->filter(filter, end - texel);
+}
+
+// MARK: - Output runs
+
+void SoftwareOutputBuilder::submit_output_runs(const uint8_t *runs, std::size_t size) {
+	output_runs_.insert(output_runs_.end(), runs, runs + size);
+}
+
+void SoftwareOutputBuilder::update_geometry(const SoftwareFrame &frame) {
+	// Adjust the visible area for the aspect ratio of the output, as per the OutputShader.
+	const float aspect_ratio_multiplier = (static_cast<float>(frame.width) / static_cast<float>(frame.height)) / (4.0f / 3.0f);
+	const float bonus_width = (aspect_ratio_multiplier - 1.0f) * visible_area_.size.width;
+
+	bounds_origin_[0] = visible_area_.origin.x - bonus_width * 0.5f;
+	bounds_origin_[1] = visible_area_.origin.y;
+	bounds_size_[0] = visible_area_.size.width * aspect_ratio_multiplier;
+	bounds_size_[1] = visible_area_.size.height;
+
+	// Crop the left- and right-hand 1% of the display, as per the OpenGLOutputBuilder; extents are
+	// in the range [-1, 1] here, and are converted to pixel columns.
+	const float left_extent = ((-1.0f / aspect_ratio_multiplier) / visible_area_.size.width) * 0.98f;
+	const float right_extent = ((1.0f / aspect_ratio_multiplier) / visible_area_.size.width) * 0.98f;
+	left_gutter_ = (left_extent + 1.0f) * 0.5f * static_cast<float>(frame.width);
+	right_gutter_ = (right_extent + 1.0f) * 0.5f * static_cast<float>(frame.width);
+
+	// Each scan has a thickness of the vertical component of the scan normal.
+	const float scan_angle = atan2f(1.0f / static_cast<float>(height_of_display_), 1.0f);
+	const float multiplier = static_cast<float>(cycles_per_line_) / (static_cast<float>(height_of_display_) * static_cast<float>(horizontal_scan_period_));
+	scan_thickness_ = cosf(scan_angle) * multiplier;
+
+	last_output_width_ = frame.width;
+	last_output_height_ = frame.height;
+	geometry_is_dirty_ = false;
+}
+
+void SoftwareOutputBuilder::draw_frame(SoftwareFrame &frame) {
+	if(!frame.width || !frame.height) {
+		output_runs_.clear();
+		return;
+	}
+
+	// Ensure the frame is appropriately sized; if it isn't then start from black.
+	const std::size_t frame_size = frame.width * frame.height * 4;
+	if(frame.pixels.size() != frame_size) {
+		frame.pixels.resize(frame_size);
+		for(std::size_t c = 0; c < frame_size; c += 4) {
+			frame.pixels[c + 0] = frame.pixels[c + 1] = frame.pixels[c + 2] = 0;
+			frame.pixels[c + 3] = 255;
+		}
+	}
+	if(geometry_is_dirty_ || frame.width != last_output_width_ || frame.height != last_output_height_) {
+		update_geometry(frame);
+	}
+	output_scan_.resize(frame.width * 4);
+
+	const float width = static_cast<float>(frame.width);
+	const float height = static_cast<float>(frame.height);
+	const float input_scaler = (video_signal_ == VideoSignal::RGB) ? 1.0f : get_composite_output_width();
+	const float vertical_conversion = static_cast<float>(vertical_scan_period_) / static_cast<float>(vertical_period_divider_);
+
+	// Horizontal flywheel positions map to columns as below; it'll also be necessary to do the reverse.
+	const float x_scale = width / (bounds_size_[0] * static_cast<float>(horizontal_scan_period_));
+	const float x_offset = -bounds_origin_[0] * width / bounds_size_[0];
+
+	const int first_visible_column = std::max(0, static_cast<int>(std::ceil(left_gutter_ - 0.5f)));
+	const int last_visible_column = std::min(int(frame.width), static_cast<int>(std::ceil(right_gutter_ - 0.5f)));
+
+	// Each column samples the same intermediate texel regardless of the run, so determine those up front.
+	column_texels_.resize(frame.width);
+	const float texel_step = input_scaler / x_scale;
+	for(int column = 0; column < int(frame.width); ++column) {
+		const float texel_x = (static_cast<float>(column) + 0.5f - x_offset) * texel_step;
+		column_texels_[column] = std::min(std::max(static_cast<int>(texel_x), 0), int(IntermediateBufferWidth - 1));
+	}
+
+	for(std::size_t offset = 0; offset + OutputVertexSize <= output_runs_.size(); offset += OutputVertexSize) {
+		const uint8_t *const vertex = &output_runs_[offset];
+		const uint16_t x1 = *reinterpret_cast<const uint16_t *>(&vertex[OutputVertexOffsetOfHorizontal + 0]);
+		const uint16_t x2 = *reinterpret_cast<const uint16_t *>(&vertex[OutputVertexOffsetOfHorizontal + 2]);
+		const uint16_t position_y = *reinterpret_cast<const uint16_t *>(&vertex[OutputVertexOffsetOfVertical + 0]);
+		const uint16_t tex_y = *reinterpret_cast<const uint16_t *>(&vertex[OutputVertexOffsetOfVertical + 2]);
+
+		// Determine the rows and columns covered.
+		const float top = ((static_cast<float>(position_y) / vertical_conversion) - bounds_origin_[1]) * height / bounds_size_[1];
+		const float bottom = top + scan_thickness_ * height / bounds_size_[1];
+		const int first_row = std::max(0, static_cast<int>(std::ceil(top - 0.5f)));
+		const int end_row = std::min(int(frame.height), static_cast<int>(std::ceil(bottom - 0.5f)));
+		if(first_row >= end_row) continue;
+
+		const int first_column = std::max(first_visible_column, static_cast<int>(std::ceil(static_cast<float>(x1) * x_scale + x_offset - 0.5f)));
+		const int end_column = std::min(last_visible_column, static_cast<int>(std::ceil(static_cast<float>(x2) * x_scale + x_offset - 0.5f)));
+		if(first_column >= end_column) continue;
+
+		const uint16_t row = tex_y % IntermediateBufferHeight;
+		const uint32_t *const source = (!filtered_.empty() && filtered_row_is_populated_[row]) ? &filtered_[row * IntermediateBufferWidth] : nullptr;
+
+		// Sample the intermediate buffer once per column, applying gamma. Colours are packed with red in
+		// the lowest byte, so if gamma is the identity then each needs only an alpha channel to be a pixel.
+		const int columns = end_column - first_column;
+		uint8_t *const scan = &output_scan_[static_cast<std::size_t>(first_column) * 4];
+		if(source) {
+			const int *const texels = &column_texels_[first_column];
+			if(gamma_is_identity_) {
+				for(int column = 0; column < columns; ++column) {
+					const uint32_t colour = source[texels[column]];
+					scan[column*4 + 0] = static_cast<uint8_t>(colour);
+					scan[column*4 + 1] = static_cast<uint8_t>(colour >> 8);
+					scan[column*4 + 2] = static_cast<uint8_t>(colour >> 16);
+					scan[column*4 + 3] = 255;
+				}
+			} else {
+				for(int column = 0; column < columns; ++column) {
+					const uint32_t colour = source[texels[column]];
+					scan[column*4 + 0] = gamma_table_[colour & 0xff];
+					scan[column*4 + 1] = gamma_table_[(colour >> 8) & 0xff];
+					scan[column*4 + 2] = gamma_table_[(colour >> 16) & 0xff];
+					scan[column*4 + 3] = 255;
+				}
+			}
+		} else {
+			for(int column = 0; column < columns; ++column) {
+				scan[column*4 + 0] = scan[column*4 + 1] = scan[column*4 + 2] = 0;
+				scan[column*4 + 3] = 255;
+			}
+		}
+
+		// Paint, blending as per the OpenGL pipeline. Alpha is included for uniformity; it saturates at 255.
+		for(int y = first_row; y < end_row; ++y) {
+			uint8_t *const pixels = &frame.pixels[(static_cast<std::size_t>(y) * frame.width + static_cast<std::size_t>(first_column)) * 4];
+			kernels_->blend(scan, pixels, columns * 4);
+		}
+	}
+	output_runs_.clear();
+
+	// All intermediate rows are now available for reuse.
+	std::fill(composite_row_is_populated_.begin(), composite_row_is_populated_.end(), false);
+	std::fill(filtered_row_is_populated_.begin(), filtered_row_is_populated_.end(), false);
+}
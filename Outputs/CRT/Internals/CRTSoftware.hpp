@@ -0,0 +1,213 @@
+//
+//  CRTSoftware.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 24/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#ifndef CRTSoftware_hpp
+#define CRTSoftware_hpp
+
+#include "../CRTTypes.hpp"
+#include "CRTConstants.hpp"
+#include "TextureBuilder.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Outputs {
+namespace CRT {
+
+/*!
+	A CPU-side frame buffer, to which a @c SoftwareOutputBuilder can draw.
+
+	Pixels are stored as four bytes each — red, green, blue and then alpha, which is always 255 —
+	with the top row first and no padding between rows. Contents persist between draws, serving
+	as the phosphor; callers may resize or clear the buffer at will.
+*/
+struct SoftwareFrame {
+	unsigned int width = 0, height = 0;
+	std::vector<uint8_t> pixels;
+};
+
+/*!
+	The CPU equivalent of a GLSL `rgb_sample`: maps from the source sample at @c sample to an RGB
+	colour, storing the three components, each nominally in the range [0, 1], to @c rgb.
+*/
+typedef std::function<void(const uint8_t *sample, float *rgb)> SoftwareRGBSamplingFunction;
+
+/*!
+	The CPU equivalent of a GLSL `composite_sample`: evaluates to the composite signal level produced by the
+	source sample at @c sample given the instantaneous colour subcarrier @c phase, in radians, and @c amplitude.
+*/
+typedef std::function<float(const uint8_t *sample, float phase, float amplitude)> SoftwareCompositeSamplingFunction;
+
+/*!
+	The CPU equivalent of a GLSL `svideo_sample`: stores the luminance and then the chrominance of the
+	source sample at @c sample to @c luminance_chrominance, given the instantaneous colour subcarrier
+	@c phase, in radians, and @c amplitude.
+*/
+typedef std::function<void(const uint8_t *sample, float phase, float amplitude, float *luminance_chrominance)> SoftwareSVideoSamplingFunction;
+
+/*!
+	Provides a CPU-only alternative to the OpenGLOutputBuilder: consumes the same source and output
+	runs, as accumulated by the ArrayBuilder and TextureBuilder, and paints them to a @c SoftwareFrame.
+
+	Usage is in three steps, mirroring the OpenGL pipeline:
+
+		(i)		call @c submit_source_runs with the array builder's input data while the texture builder's contents are still valid;
+		(ii)	call @c submit_output_runs with the array builder's output data; and
+		(iii)	call @c draw_frame, which need not occur while the output lock is held.
+
+	This class is not thread safe; all calls are expected to come from the same thread.
+*/
+class SoftwareOutputBuilder {
+	public:
+		SoftwareOutputBuilder();
+
+		void set_rgb_sampling_function(const SoftwareRGBSamplingFunction &);
+		void set_composite_sampling_function(const SoftwareCompositeSamplingFunction &);
+		void set_svideo_sampling_function(const SoftwareSVideoSamplingFunction &);
+
+		void set_video_signal(VideoSignal);
+		void set_visible_area(Rect);
+		void set_gamma(float);
+		void set_colour_format(ColourSpace colour_space, unsigned int colour_cycle_numerator, unsigned int colour_cycle_denominator);
+		void set_timing(unsigned int input_frequency, unsigned int cycles_per_line, unsigned int height_of_display, unsigned int horizontal_scan_period, unsigned int vertical_scan_period, unsigned int vertical_period_divider);
+
+		/// Paints the @c size bytes of source vertices at @c runs to the intermediate buffers, reading source data from @c texture_builder.
+		void submit_source_runs(const uint8_t *runs, std::size_t size, const TextureBuilder &texture_builder);
+
+		/// Takes a copy of the @c size bytes of output vertices at @c runs, to be painted upon the next @c draw_frame.
+		void submit_output_runs(const uint8_t *runs, std::size_t size);
+
+		/// Paints all output runs submitted since the last draw to @c frame, then discards them.
+		void draw_frame(SoftwareFrame &frame);
+
+	private:
+		// Sampling functions.
+		SoftwareRGBSamplingFunction rgb_sampler_;
+		SoftwareCompositeSamplingFunction composite_sampler_;
+		SoftwareSVideoSamplingFunction svideo_sampler_;
+
+		// Colour and timing information, as per the OpenGLOutputBuilder.
+		VideoSignal video_signal_ = VideoSignal::RGB;
+		Rect visible_area_;
+		ColourSpace colour_space_ = ColourSpace::YIQ;
+		unsigned int colour_cycle_numerator_ = 1, colour_cycle_denominator_ = 1;
+		unsigned int input_frequency_ = 1, cycles_per_line_ = 1, height_of_display_ = 1;
+		unsigned int horizontal_scan_period_ = 1, vertical_scan_period_ = 1, vertical_period_divider_ = 1;
+		float get_composite_output_width() const;
+
+		// Gamma is applied by lookup table, unless it is the identity.
+		uint8_t gamma_table_[256];
+		bool gamma_is_identity_ = true;
+
+		// Derived output geometry; recalculated whenever the visible area or the output size changes.
+		bool geometry_is_dirty_ = true;
+		float bounds_origin_[2], bounds_size_[2];
+		float left_gutter_, right_gutter_;
+		float scan_thickness_;
+		void update_geometry(const SoftwareFrame &frame);
+		unsigned int last_output_width_ = 0, last_output_height_ = 0;
+
+		// Intermediate buffers: composite_ receives raw composite levels; filtered_ receives RGB
+		// packed as per pack_rgb. Rows are marked as populated upon first use since the last draw;
+		// unpopulated rows are implicitly black. Upon first use a row is cleared other than within
+		// [first, end), which the caller is about to write in full.
+		std::vector<float> composite_;
+		std::vector<uint32_t> filtered_;
+		std::vector<bool> composite_row_is_populated_, filtered_row_is_populated_;
+		float *composite_row(uint16_t row, int first = 0, int end = 0);
+		uint32_t *filtered_row(uint16_t row, int first = 0, int end = 0);
+
+		// Source runs are retained between the composite sampling and separation steps.
+		struct SourceRun {
+			uint16_t input_x[2], input_y;
+			uint16_t output_x[2], output_y;
+			float phase, amplitude;
+		};
+		std::vector<SourceRun> source_runs_;
+		void paint_rgb_run(const SourceRun &, const TextureBuilder &);
+		void paint_composite_run(const SourceRun &, const TextureBuilder &);
+		void paint_svideo_run(const SourceRun &, const TextureBuilder &);
+		void separate_composite_run(const SourceRun &);
+
+		// With four intermediate texels per colour cycle, each run sees only four phases of the subcarrier;
+		// this records them and the quadrature components at each, indexed by distance from first_texel modulo four.
+		struct Quadrature {
+			float phase[4], cosine[4], sine[4];
+			void set(float run_phase, float amplitude, int first_texel);
+		};
+
+		// Retains the most recent sampling function result for each of the four subcarrier phases, keyed by
+		// the contents of the sample; samples of more than four bytes are keyed by index instead.
+		struct SampleCache {
+			bool is_populated[4] = {false, false, false, false};
+			uint32_t keys[4] = {0, 0, 0, 0};
+			float results[4][2];
+
+			/// @returns The key for @c sample, which is at @c index.
+			static inline uint32_t get_key(const uint8_t *sample, int index, std::size_t bytes_per_pixel) {
+				switch(bytes_per_pixel) {
+					case 1:		return sample[0];
+					case 2:		return uint32_t(sample[0] | (sample[1] << 8));
+					case 3:		return uint32_t(sample[0] | (sample[1] << 8) | (sample[2] << 16));
+					case 4:		return uint32_t(sample[0] | (sample[1] << 8) | (sample[2] << 16)) | (uint32_t(sample[3]) << 24);
+					default:	return uint32_t(index);
+				}
+			}
+
+			/// @returns @c true if the result for @c key is not cached for @c phase_index, in which case the caller should populate it.
+			inline bool is_stale(uint32_t key, int phase_index) {
+				if(is_populated[phase_index] && keys[phase_index] == key) return false;
+				is_populated[phase_index] = true;
+				keys[phase_index] = key;
+				return true;
+			}
+		};
+
+		/// @returns The index beyond the end of the span of equal values that starts at @c indices[c], limited to @c count.
+		static inline int span_end(const int *indices, int c, int count) {
+			const int index = indices[c];
+			do { ++c; } while(c < count && indices[c] == index);
+			return c;
+		}
+
+		// Per-run working storage: the input index sampled for each texel; composite levels; and separated
+		// luminance and chrominance, the latter not yet demodulated, beginning two texels before the first
+		// output texel.
+		std::vector<int> source_indices_;
+		std::vector<float> composite_levels_;
+		std::vector<float> separated_luminance_;
+		std::vector<float> separated_chrominance_[2];
+		void reserve_run_buffers();
+		const int *map_source_indices(const SourceRun &run, float output_width, int first, int count);
+		void filter_chrominance(uint16_t row, int texel, int end);
+
+		// Separation, filtering and blending have vector implementations; this points to those suited to the host.
+		struct Kernels;
+		const Kernels *kernels_;
+		static const Kernels *select_kernels();
+
+		// RGB to luminance/chrominance, used when the machine supplies only an RGB sampler
+		// but composite or s-video output is selected, and the reverse.
+		float rgb_to_luma_chroma_[9];
+		float luma_chroma_to_rgb_[9];
+		void rgb_sample(const uint8_t *sample, float *rgb);
+		void luma_chroma_sample(const uint8_t *sample, float *luma_chroma);
+
+		// Output runs, as copied during submit_output_runs, storage for a single scan's worth of
+		// pixels as they are about to be blended into the frame, and the intermediate texel
+		// sampled by each column of the frame.
+		std::vector<uint8_t> output_runs_;
+		std::vector<uint8_t> output_scan_;
+		std::vector<int> column_texels_;
+};
+
+}
+}
+
+#endif /* CRTSoftware_hpp */
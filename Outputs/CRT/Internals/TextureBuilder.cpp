@@ -41,23 +41,36 @@ const GLenum formatForDepth(std::size_t depth) {
 TextureBuilder::TextureBuilder(std::size_t bytes_per_pixel, GLenum texture_unit) :
 		bytes_per_pixel_(bytes_per_pixel), texture_unit_(texture_unit) {
 	image_.resize(bytes_per_pixel * InputBufferBuilderWidth * InputBufferBuilderHeight);
-	glGenTextures(1, &texture_name_);
-
-	bind();
-	glTexImage2D(GL_TEXTURE_2D, 0, internalFormatForDepth(bytes_per_pixel), InputBufferBuilderWidth, InputBufferBuilderHeight, 0, formatForDepth(bytes_per_pixel), GL_UNSIGNED_BYTE, nullptr);
 }
 
 TextureBuilder::~TextureBuilder() {
-	glDeleteTextures(1, &texture_name_);
+	if(texture_name_) glDeleteTextures(1, &texture_name_);
 }
 
 void TextureBuilder::bind() {
+	// Create the texture upon first use, so that no OpenGL context is required
+	// if this texture builder is never used with one.
+	const bool is_new_texture = !texture_name_;
+	if(is_new_texture) glGenTextures(1, &texture_name_);
+
 	glActiveTexture(texture_unit_);
 	glBindTexture(GL_TEXTURE_2D, texture_name_);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+	if(is_new_texture) {
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormatForDepth(bytes_per_pixel_), InputBufferBuilderWidth, InputBufferBuilderHeight, 0, formatForDepth(bytes_per_pixel_), GL_UNSIGNED_BYTE, nullptr);
+	}
+}
+
+const uint8_t *TextureBuilder::get_image() const {
+	return image_.data();
+}
+
+std::size_t TextureBuilder::get_bytes_per_pixel() const {
+	return bytes_per_pixel_;
 }
 
 inline uint8_t *TextureBuilder::pointer_to_location(uint16_t x, uint16_t y) {
@@ -164,6 +177,10 @@ void TextureBuilder::submit() {
 							image_.data() + first_unsubmitted_y_ * bytes_per_pixel_ * InputBufferBuilderWidth);
 	}
 
+	submit_without_upload();
+}
+
+void TextureBuilder::submit_without_upload() {
 	// Update the starting location for the next submission, and mark definitively that the buffer is once again not full.
 	first_unsubmitted_y_ = write_areas_start_y_;
 	is_full_ = false;
@@ -61,8 +61,8 @@ namespace CRT {
 */
 class TextureBuilder {
 	public:
-		/// Constructs an instance of InputTextureBuilder that contains a texture of colour depth @c bytes_per_pixel;
-		/// this creates a new texture and binds it to the current active texture unit.
+		/// Constructs an instance of InputTextureBuilder that contains a texture of colour depth @c bytes_per_pixel.
+		/// No OpenGL calls are made until the first call to @c bind, which creates the texture.
 		TextureBuilder(std::size_t bytes_per_pixel, GLenum texture_unit);
 		virtual ~TextureBuilder();
 
@@ -90,6 +90,17 @@ class TextureBuilder {
 		/// Updates the currently-bound texture with all new data provided since the last @c submit.
 		void submit();
 
+		/// Performs the same bookkeeping as @c submit but without uploading anything to OpenGL; for use by
+		/// owners that instead read source data directly via @c get_image.
+		void submit_without_upload();
+
+		/// @returns A pointer to the CPU-side copy of the texture, which is @c InputBufferBuilderWidth pixels
+		/// wide and @c InputBufferBuilderHeight pixels high, without padding between rows.
+		const uint8_t *get_image() const;
+
+		/// @returns The number of bytes in each pixel of the texture.
+		std::size_t get_bytes_per_pixel() const;
+
 		struct WriteArea {
 			uint16_t x = 0, y = 0, length = 0;
 		};
@@ -108,7 +119,7 @@ class TextureBuilder {
 
 		// the buffer
 		std::vector<uint8_t> image_;
-		GLuint texture_name_;
+		GLuint texture_name_ = 0;
 
 		// the current write area
 		WriteArea write_area_;
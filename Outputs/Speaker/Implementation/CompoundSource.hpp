@@ -11,8 +11,10 @@
 
 #include "SampleSource.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <limits>
 
 namespace Outputs {
 namespace Speaker {
@@ -20,6 +22,10 @@ namespace Speaker {
 /*!
 	A CompoundSource adds together the sound generated by multiple individual SampleSources.
 	An owner may optionally assign relative volumes.
+
+	If separate channels are requested then the channels of each source are instead placed
+	side by side, in the order the sources were supplied. Otherwise any single-channel source
+	is added to every channel of any stereo source.
 */
 template <typename... T> class CompoundSource:
 	public Outputs::Speaker::SampleSource {
@@ -33,13 +39,37 @@ template <typename... T> class CompoundSource:
 		}
 
 		void get_samples(std::size_t number_of_samples, std::int16_t *target) {
-			source_holder_.get_samples(number_of_samples, target);
+			if(channel_count_ == 1) {
+				source_holder_.get_samples(number_of_samples, target);
+			} else {
+				std::memset(target, 0, sizeof(std::int16_t) * number_of_samples * channel_count_);
+				source_holder_.add_samples(number_of_samples, target, channel_count_, channels_ == Channels::Separate);
+			}
+		}
+
+		void set_output_channels(Channels channels) {
+			channels_ = channels;
+			source_holder_.set_output_channels(channels);
+			channel_count_ = (channels == Channels::Separate) ? source_holder_.total_channel_count() : source_holder_.max_channel_count();
+		}
+
+		std::size_t get_channel_count() {
+			return channel_count_;
 		}
 
 		void skip_samples(const std::size_t number_of_samples) {
 			source_holder_.skip_samples(number_of_samples);
 		}
 
+		/*!
+			Output is constant for as long as that of every source is; the constant is their sum,
+			arranged as per get_samples.
+		*/
+		std::size_t get_constant_samples(std::int16_t *level) {
+			std::fill_n(level, channel_count_, 0);
+			return source_holder_.add_constant_level(level, channel_count_, channels_ == Channels::Separate);
+		}
+
 		void set_sample_volume_range(int16_t range) {
 			volume_range_ = range;
 			push_volumes();
@@ -68,8 +98,24 @@ template <typename... T> class CompoundSource:
 					std::memset(target, 0, sizeof(std::int16_t) * number_of_samples);
 				}
 
+				void add_samples(std::size_t number_of_samples, std::int16_t *target, std::size_t channels, bool separate) {}
+
+				std::size_t add_constant_level(std::int16_t *level, std::size_t channels, bool separate) {
+					return std::numeric_limits<std::size_t>::max();
+				}
+
 				void set_scaled_volume_range(int16_t range, float *volumes) {}
 
+				void set_output_channels(Channels channels) {}
+
+				std::size_t total_channel_count() {
+					return 0;
+				}
+
+				std::size_t max_channel_count() {
+					return 1;
+				}
+
 				std::size_t size() {
 					return 0;
 				}
@@ -93,11 +139,85 @@ template <typename... T> class CompoundSource:
 					}
 				}
 
+				/*!
+					Adds this source's next @c number_of_samples to @c target, which holds @c channels values per frame,
+					either filling its first columns if @c separate is @c true, or else being mixed into all columns.
+					Then does likewise for the remaining sources, in the columns that follow if separate.
+				*/
+				void add_samples(std::size_t number_of_samples, std::int16_t *target, std::size_t channels, bool separate) {
+					const std::size_t source_channels = source_.get_channel_count();
+					if(source_.is_zero_level()) {
+						source_.skip_samples(number_of_samples);
+					} else {
+						int16_t samples[number_of_samples * source_channels];
+						source_.get_samples(number_of_samples, samples);
+
+						if(separate || source_channels == channels) {
+							for(std::size_t sample = 0; sample < number_of_samples; ++sample) {
+								for(std::size_t channel = 0; channel < source_channels; ++channel) {
+									target[sample * channels + channel] += samples[sample * source_channels + channel];
+								}
+							}
+						} else {
+							assert(source_channels == 1);
+							for(std::size_t sample = 0; sample < number_of_samples; ++sample) {
+								for(std::size_t channel = 0; channel < channels; ++channel) {
+									target[sample * channels + channel] += samples[sample];
+								}
+							}
+						}
+					}
+
+					next_source_.add_samples(number_of_samples, separate ? &target[source_channels] : target, channels, separate);
+				}
+
+				/*!
+					Adds this source's constant level to @c level, in the same arrangement as add_samples, then
+					does likewise for the remaining sources. @returns The number of samples for which all are
+					constant, or 0 if any isn't, in which case @c level is incomplete.
+				*/
+				std::size_t add_constant_level(std::int16_t *level, std::size_t channels, bool separate) {
+					const std::size_t source_channels = source_.get_channel_count();
+					std::size_t constant_samples = std::numeric_limits<std::size_t>::max();
+					if(!source_.is_zero_level()) {
+						int16_t source_level[source_channels];
+						constant_samples = source_.get_constant_samples(source_level);
+						if(!constant_samples) return 0;
+
+						if(separate || source_channels == channels) {
+							for(std::size_t channel = 0; channel < source_channels; ++channel) {
+								level[channel] += source_level[channel];
+							}
+						} else {
+							for(std::size_t channel = 0; channel < channels; ++channel) {
+								level[channel] += source_level[0];
+							}
+						}
+					}
+
+					return std::min(
+						constant_samples,
+						next_source_.add_constant_level(separate ? &level[source_channels] : level, channels, separate));
+				}
+
 				void skip_samples(const std::size_t number_of_samples) {
 					source_.skip_samples(number_of_samples);
 					next_source_.skip_samples(number_of_samples);
 				}
 
+				void set_output_channels(Channels channels) {
+					source_.set_output_channels(channels);
+					next_source_.set_output_channels(channels);
+				}
+
+				std::size_t total_channel_count() {
+					return source_.get_channel_count() + next_source_.total_channel_count();
+				}
+
+				std::size_t max_channel_count() {
+					return std::max(source_.get_channel_count(), next_source_.max_channel_count());
+				}
+
 				void set_scaled_volume_range(int16_t range, float *volumes) {
 					source_.set_sample_volume_range(static_cast<int16_t>(static_cast<float>(range * volumes[0])));
 					next_source_.set_scaled_volume_range(range, &volumes[1]);
@@ -115,6 +235,9 @@ template <typename... T> class CompoundSource:
 		CompoundSourceHolder<T...> source_holder_;
 		std::vector<float> volumes_;
 		int16_t volume_range_ = 0;
+
+		Channels channels_ = Channels::Mono;
+		std::size_t channel_count_ = 1;
 };
 
 }
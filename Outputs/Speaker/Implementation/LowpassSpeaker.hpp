@@ -10,12 +10,13 @@
 #define FilteringSpeaker_h
 
 #include "../Speaker.hpp"
-#include "../../../SignalProcessing/Stepper.hpp"
-#include "../../../SignalProcessing/FIRFilter.hpp"
+#include "../../../SignalProcessing/PolyphaseFilter.hpp"
 #include "../../../ClockReceiver/ClockReceiver.hpp"
 #include "../../../Concurrency/AsyncTaskQueue.hpp"
 
 #include <mutex>
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 
 namespace Outputs {
@@ -26,6 +27,12 @@ namespace Speaker {
 	template class, and uses the instance supplied to its constructor as the
 	source of a high-frequency stream of audio which it filters down to a
 	lower-frequency output.
+
+	If the source supplies more than one channel then each is filtered independently.
+
+	Whenever the source reports that its output will be constant for a while, per get_constant_samples,
+	that span is skipped rather than generated. Once the filter's whole window holds the constant,
+	each output sample is produced from the constant alone.
 */
 template <typename T> class LowpassSpeaker: public Speaker {
 	public:
@@ -60,8 +67,29 @@ template <typename T> class LowpassSpeaker: public Speaker {
 		void set_output_rate(float cycles_per_second, int buffer_size) {
 			std::lock_guard<std::mutex> lock_guard(filter_parameters_mutex_);
 			filter_parameters_.output_cycles_per_second = cycles_per_second;
+			filter_parameters_.output_buffer_size = static_cast<std::size_t>(buffer_size);
+			filter_parameters_.parameters_are_dirty = true;
+		}
+
+		// Implemented as per Speaker.
+		void set_output_channels(Channels channels) {
+			std::lock_guard<std::mutex> lock_guard(filter_parameters_mutex_);
+			filter_parameters_.channels = channels;
+			filter_parameters_.channels_are_dirty = true;
+
+			// The number of separate channels will be known only once the source has been told.
+			switch(channels) {
+				case Channels::Mono:		output_channel_count_ = 1;	break;
+				case Channels::Stereo:		output_channel_count_ = 2;	break;
+				case Channels::Separate:								break;
+			}
+		}
+
+		// Implemented as per Speaker.
+		void set_input_rate_multiplier(float multiplier) {
+			std::lock_guard<std::mutex> lock_guard(filter_parameters_mutex_);
+			filter_parameters_.input_rate_multiplier = multiplier;
 			filter_parameters_.parameters_are_dirty = true;
-			output_buffer_.resize(static_cast<std::size_t>(buffer_size));
 		}
 
 		/*!
@@ -103,7 +131,7 @@ template <typename T> class LowpassSpeaker: public Speaker {
 			at construction, filtering it and passing it on to the speaker's delegate if there is one.
 		*/
 		void run_for(const Cycles cycles) {
-			if(!delegate_) return;
+			if(!delegate_ && !ring_) return;
 
 			std::size_t cycles_remaining = static_cast<size_t>(cycles.as_int());
 			if(!cycles_remaining) return;
@@ -112,11 +140,39 @@ template <typename T> class LowpassSpeaker: public Speaker {
 			{
 				std::lock_guard<std::mutex> lock_guard(filter_parameters_mutex_);
 				filter_parameters = filter_parameters_;
-				filter_parameters_.parameters_are_dirty = false;
-				filter_parameters_.input_rate_changed = false;
+
+				// If output is suspended, leave any changes pending for when it resumes.
+				if(filter_parameters.input_rate_multiplier > 0.0f) {
+					filter_parameters_.parameters_are_dirty = false;
+					filter_parameters_.input_rate_changed = false;
+					filter_parameters_.channels_are_dirty = false;
+				}
 			}
+
+			// If output is suspended then just consume input. Skip in bounded steps, as
+			// sample sources may implement skip_samples using the stack.
+			if(filter_parameters.input_rate_multiplier <= 0.0f) {
+				while(cycles_remaining) {
+					const std::size_t cycles_to_skip = std::min(cycles_remaining, static_cast<std::size_t>(2048));
+					sample_source_.skip_samples(cycles_to_skip);
+					cycles_remaining -= cycles_to_skip;
+				}
+				return;
+			}
+
+			// Pass on any change in channel layout; the source determines how many channels then need filtering.
+			if(filter_parameters.channels_are_dirty) {
+				sample_source_.set_output_channels(filter_parameters.channels);
+				input_channels_ = sample_source_.get_channel_count();
+				output_channels_ = (filter_parameters.channels == Channels::Stereo && input_channels_ == 1) ? 2 : input_channels_;
+				output_channel_count_ = output_channels_;
+				filter_parameters.parameters_are_dirty = true;
+			}
+
+			// Filter as though input were at its effective rate.
+			filter_parameters.input_cycles_per_second *= filter_parameters.input_rate_multiplier;
 			if(filter_parameters.parameters_are_dirty) update_filter_coefficients(filter_parameters);
-			if(filter_parameters.input_rate_changed) {
+			if(filter_parameters.input_rate_changed && delegate_) {
 				delegate_->speaker_did_change_input_clock(this);
 			}
 
@@ -124,16 +180,35 @@ template <typename T> class LowpassSpeaker: public Speaker {
 			// just accumulate results and pass on.
 			if(	filter_parameters.input_cycles_per_second == filter_parameters.output_cycles_per_second &&
 				filter_parameters.high_frequency_cutoff < 0.0) {
+				const std::size_t output_buffer_frames = output_buffer_.size() / output_channels_;
 				while(cycles_remaining) {
-					std::size_t cycles_to_read = std::min(output_buffer_.size() - output_buffer_pointer_, cycles_remaining);
-
-					sample_source_.get_samples(cycles_to_read, &output_buffer_[output_buffer_pointer_]);
+					std::size_t cycles_to_read = std::min(output_buffer_frames - output_buffer_pointer_, cycles_remaining);
+
+					int16_t *const target = &output_buffer_[output_buffer_pointer_ * output_channels_];
+					const std::size_t constant_samples = sample_source_.get_constant_samples(next_level_.data());
+					if(constant_samples) {
+						cycles_to_read = std::min(cycles_to_read, constant_samples);
+						for(std::size_t c = 0; c < cycles_to_read; ++c) {
+							for(std::size_t channel = 0; channel < output_channels_; ++channel) {
+								target[c*output_channels_ + channel] = next_level_[channel % input_channels_];
+							}
+						}
+						sample_source_.skip_samples(cycles_to_read);
+					} else {
+						sample_source_.get_samples(cycles_to_read, target);
+					}
+					if(!constant_samples && output_channels_ != input_channels_) {
+						// Duplicate mono input to both stereo channels, working backwards so as not to overwrite unread input.
+						for(std::size_t c = cycles_to_read; c--;) {
+							target[c*2 + 1] = target[c*2] = target[c];
+						}
+					}
 					output_buffer_pointer_ += cycles_to_read;
 
 					// announce to delegate if full
-					if(output_buffer_pointer_ == output_buffer_.size()) {
+					if(output_buffer_pointer_ == output_buffer_frames) {
 						output_buffer_pointer_ = 0;
-						delegate_->speaker_did_complete_samples(this, output_buffer_);
+						announce_output_buffer();
 					}
 
 					cycles_remaining -= cycles_to_read;
@@ -142,67 +217,156 @@ template <typename T> class LowpassSpeaker: public Speaker {
 				return;
 			}
 
-			// if the output rate is less than the input rate, or an additional cut-off has been specified, use the filter.
-			if(	filter_parameters.input_cycles_per_second > filter_parameters.output_cycles_per_second ||
-				(filter_parameters.input_cycles_per_second == filter_parameters.output_cycles_per_second && filter_parameters.high_frequency_cutoff >= 0.0)) {
-				while(cycles_remaining) {
-					std::size_t cycles_to_read = std::min(cycles_remaining, input_buffer_.size() - input_buffer_depth_);
-					sample_source_.get_samples(cycles_to_read, &input_buffer_[input_buffer_depth_]);
-					cycles_remaining -= cycles_to_read;
-					input_buffer_depth_ += cycles_to_read;
+			// Otherwise resample, whether up or down. Each output sample is the result of applying the
+			// filter phase at or immediately before its position to the most recent window of input.
+			const std::size_t number_of_taps = filter_->get_number_of_taps();
+			const std::size_t output_buffer_frames = output_buffer_.size() / output_channels_;
+			while(true) {
+				// Produce as many output samples as the current window permits.
+				while(!input_samples_until_output_) {
+					int16_t *const frame = &output_buffer_[output_buffer_pointer_ * output_channels_];
+					if(constant_samples_in_history_ == number_of_taps) {
+						for(std::size_t channel = 0; channel < input_channels_; ++channel) {
+							frame[channel] = filter_->apply_to_constant(constant_level_[channel], phase_);
+						}
+					} else {
+						for(std::size_t channel = 0; channel < input_channels_; ++channel) {
+							frame[channel] = filter_->apply(&history_[channel * number_of_taps * 2 + history_pointer_], phase_);
+						}
+					}
+					if(output_channels_ != input_channels_) frame[1] = frame[0];
+					output_buffer_pointer_++;
 
-					if(input_buffer_depth_ == input_buffer_.size()) {
-						output_buffer_[output_buffer_pointer_] = filter_->apply(input_buffer_.data());
-						output_buffer_pointer_++;
+					// Announce to delegate if full.
+					if(output_buffer_pointer_ == output_buffer_frames) {
+						output_buffer_pointer_ = 0;
+						announce_output_buffer();
+					}
 
-						// Announce to delegate if full.
-						if(output_buffer_pointer_ == output_buffer_.size()) {
-							output_buffer_pointer_ = 0;
-							delegate_->speaker_did_complete_samples(this, output_buffer_);
-						}
+					// Determine the position of the next output sample, as a whole number of input samples plus a phase.
+					phase_accumulator_ += input_rate_;
+					input_samples_until_output_ = static_cast<std::size_t>(phase_accumulator_ / output_rate_);
+					phase_accumulator_ %= output_rate_;
+					phase_ = static_cast<std::size_t>((phase_accumulator_ * filter_->get_number_of_phases()) / output_rate_);
+				}
+				if(!cycles_remaining) break;
+
+				// Skip any input that will have left the window before the next output sample is due.
+				if(input_samples_until_output_ > number_of_taps) {
+					const std::size_t cycles_to_skip = std::min(cycles_remaining, input_samples_until_output_ - number_of_taps);
+					sample_source_.skip_samples(cycles_to_skip);
+					cycles_remaining -= cycles_to_skip;
+					input_samples_until_output_ -= cycles_to_skip;
+					continue;
+				}
+
+				// If the source is able to promise constant output for a while, note the level. Once the window
+				// is entirely that level it can't change while the level persists, so input up to the next output
+				// sample can just be skipped; until then the window is filled with the level without
+				// generating it.
+				std::size_t cycles_to_read =
+					std::min(std::min(cycles_remaining, input_samples_until_output_), number_of_taps - history_pointer_);
+				const std::size_t constant_samples = sample_source_.get_constant_samples(next_level_.data());
+				if(constant_samples) {
+					if(next_level_ != constant_level_) {
+						constant_level_ = next_level_;
+						constant_samples_in_history_ = 0;
+					}
+
+					if(constant_samples_in_history_ == number_of_taps) {
+						const std::size_t cycles_to_skip =
+							std::min(std::min(cycles_remaining, input_samples_until_output_), constant_samples);
+						sample_source_.skip_samples(cycles_to_skip);
+						cycles_remaining -= cycles_to_skip;
+						input_samples_until_output_ -= cycles_to_skip;
+						continue;
+					}
+
+					cycles_to_read = std::min(cycles_to_read, constant_samples);
+					for(std::size_t channel = 0; channel < input_channels_; ++channel) {
+						int16_t *const window = &history_[channel * number_of_taps * 2 + history_pointer_];
+						std::fill_n(window, cycles_to_read, constant_level_[channel]);
+						std::fill_n(window + number_of_taps, cycles_to_read, constant_level_[channel]);
+					}
+					sample_source_.skip_samples(cycles_to_read);
+					constant_samples_in_history_ = std::min(constant_samples_in_history_ + cycles_to_read, number_of_taps);
 
-						// If the next loop around is going to reuse some of the samples just collected, use a memmove to
-						// preserve them in the correct locations (TODO: use a longer buffer to fix that) and don't skip
-						// anything. Otherwise skip as required to get to the next sample batch and don't expect to reuse.
-						uint64_t steps = stepper_->step();
-						if(steps < input_buffer_.size()) {
-							int16_t *input_buffer = input_buffer_.data();
-							std::memmove(	input_buffer,
-											&input_buffer[steps],
-											sizeof(int16_t) * (input_buffer_.size() - steps));
-							input_buffer_depth_ -= steps;
-						} else {
-							if(steps > input_buffer_.size())
-								sample_source_.skip_samples(steps - input_buffer_.size());
-							input_buffer_depth_ = 0;
+					history_pointer_ += cycles_to_read;
+					if(history_pointer_ == number_of_taps) history_pointer_ = 0;
+					cycles_remaining -= cycles_to_read;
+					input_samples_until_output_ -= cycles_to_read;
+					continue;
+				}
+				constant_samples_in_history_ = 0;
+
+				// The history holds two copies of the window so that the most recent number_of_taps samples
+				// are always contiguous, starting from history_pointer_. Read directly into the first copy,
+				// up to the next output sample or its end, then duplicate into the second. If there are
+				// multiple channels then the history holds one such pair of windows per channel, and input
+				// is distributed amongst them.
+				if(input_channels_ == 1) {
+					sample_source_.get_samples(cycles_to_read, &history_[history_pointer_]);
+					std::memcpy(&history_[history_pointer_ + number_of_taps], &history_[history_pointer_], cycles_to_read * sizeof(int16_t));
+				} else {
+					sample_source_.get_samples(cycles_to_read, input_buffer_.data());
+					for(std::size_t channel = 0; channel < input_channels_; ++channel) {
+						int16_t *const window = &history_[channel * number_of_taps * 2 + history_pointer_];
+						for(std::size_t c = 0; c < cycles_to_read; ++c) {
+							window[c] = window[c + number_of_taps] = input_buffer_[c * input_channels_ + channel];
 						}
 					}
 				}
 
-				return;
+				history_pointer_ += cycles_to_read;
+				if(history_pointer_ == number_of_taps) history_pointer_ = 0;
+				cycles_remaining -= cycles_to_read;
+				input_samples_until_output_ -= cycles_to_read;
 			}
+		}
 
-			// TODO: input rate is less than output rate
+		/*!
+			Passes a completed output buffer to the sample ring and to the delegate, whichever
+			have been set.
+		*/
+		void announce_output_buffer() {
+			if(ring_) ring_->write(output_buffer_.data(), output_buffer_.size());
+			if(delegate_) delegate_->speaker_did_complete_samples(this, output_buffer_);
 		}
 
 		T &sample_source_;
+		std::size_t input_channels_ = 1, output_channels_ = 1;
 
+		// The output buffer pointer counts frames.
 		std::size_t output_buffer_pointer_ = 0;
-		std::size_t input_buffer_depth_ = 0;
-		std::vector<int16_t> input_buffer_;
 		std::vector<int16_t> output_buffer_;
 
-		std::unique_ptr<SignalProcessing::Stepper> stepper_;
-		std::unique_ptr<SignalProcessing::FIRFilter> filter_;
+		std::unique_ptr<SignalProcessing::PolyphaseFilter> filter_;
+		std::vector<int16_t> history_;
+		std::vector<int16_t> input_buffer_;
+		std::size_t history_pointer_ = 0;
+
+		// The most recent constant level reported by the source, the number of samples at the end of the
+		// history known to be that level, and storage for the next report.
+		std::vector<int16_t> constant_level_, next_level_;
+		std::size_t constant_samples_in_history_ = 0;
+
+		uint64_t input_rate_ = 1, output_rate_ = 1;
+		uint64_t phase_accumulator_ = 0;
+		std::size_t phase_ = 0;
+		std::size_t input_samples_until_output_ = 1;
 
 		std::mutex filter_parameters_mutex_;
 		struct FilterParameters {
 			float input_cycles_per_second = 0.0f;
 			float output_cycles_per_second = 0.0f;
 			float high_frequency_cutoff = -1.0;
+			float input_rate_multiplier = 1.0f;
+			std::size_t output_buffer_size = 0;
+			Channels channels = Channels::Mono;
 
 			bool parameters_are_dirty = true;
 			bool input_rate_changed = false;
+			bool channels_are_dirty = false;
 		} filter_parameters_;
 
 		void update_filter_coefficients(const FilterParameters &filter_parameters) {
@@ -211,27 +375,46 @@ template <typename T> class LowpassSpeaker: public Speaker {
 				high_pass_frequency = std::min(filter_parameters.high_frequency_cutoff, high_pass_frequency);
 			}
 
+			// If upsampling, the input can't contain anything above its Nyquist frequency; cut off a little
+			// below that in order to remove the images that interpolation would otherwise produce.
+			high_pass_frequency = std::min(high_pass_frequency, filter_parameters.input_cycles_per_second * 0.45f);
+
 			// Make a guess at a good number of taps.
 			std::size_t number_of_taps = static_cast<std::size_t>(
 				ceilf((filter_parameters.input_cycles_per_second + high_pass_frequency) / high_pass_frequency)
 			);
 			number_of_taps = (number_of_taps * 2) | 1;
+			if(number_of_taps < MinimumNumberOfTaps) number_of_taps = MinimumNumberOfTaps;
 
 			output_buffer_pointer_ = 0;
-			stepper_.reset(new SignalProcessing::Stepper(
-				static_cast<uint64_t>(filter_parameters.input_cycles_per_second),
-				static_cast<uint64_t>(filter_parameters.output_cycles_per_second)));
-
-			filter_.reset(new SignalProcessing::FIRFilter(
-				static_cast<unsigned int>(number_of_taps),
+			output_buffer_.resize(filter_parameters.output_buffer_size * output_channels_);
+			input_rate_ = std::max(static_cast<uint64_t>(filter_parameters.input_cycles_per_second), static_cast<uint64_t>(1));
+			output_rate_ = std::max(static_cast<uint64_t>(filter_parameters.output_cycles_per_second), static_cast<uint64_t>(1));
+			phase_accumulator_ = 0;
+			phase_ = 0;
+			input_samples_until_output_ = 1;
+
+			filter_.reset(new SignalProcessing::PolyphaseFilter(
+				number_of_taps,
+				NumberOfPhases,
 				filter_parameters.input_cycles_per_second,
-				0.0,
 				high_pass_frequency,
 				SignalProcessing::FIRFilter::DefaultAttenuation));
 
-			input_buffer_.resize(static_cast<std::size_t>(number_of_taps));
-			input_buffer_depth_ = 0;
+			history_.clear();
+			history_.resize(filter_->get_number_of_taps() * 2 * input_channels_);
+			input_buffer_.resize(input_channels_ > 1 ? filter_->get_number_of_taps() * input_channels_ : 0);
+			history_pointer_ = 0;
+
+			constant_level_.assign(input_channels_, 0);
+			next_level_.resize(input_channels_);
+			constant_samples_in_history_ = 0;
 		}
+
+		// Phases are provided at 1/NumberOfPhases of an input sample; the minimum number of taps
+		// preserves some quality when upsampling, where the formula above produces very few.
+		static const std::size_t NumberOfPhases = 64;
+		static const std::size_t MinimumNumberOfTaps = 15;
 };
 
 }
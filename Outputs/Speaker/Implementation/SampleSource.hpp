@@ -9,6 +9,8 @@
 #ifndef SampleSource_hpp
 #define SampleSource_hpp
 
+#include "../Speaker.hpp"
+
 #include <cstddef>
 #include <cstdint>
 
@@ -23,15 +25,33 @@ namespace Speaker {
 class SampleSource {
 	public:
 		/*!
-			Should write the next @c number_of_samples to @c target.
+			Should write the next @c number_of_samples to @c target. Each sample is a frame of
+			get_channel_count() values, interleaved.
 		*/
 		void get_samples(std::size_t number_of_samples, std::int16_t *target) {}
 
+		/*!
+			Requests the layout in which samples should be provided. Sources should produce a single
+			channel if @c channels is Channels::Mono and no more than two if it is Channels::Stereo,
+			in which case a single channel will be duplicated to both sides. Sources that can provide
+			only a single channel need not implement this.
+		*/
+		void set_output_channels(Channels channels) {}
+
+		/*!
+			@returns The number of values per sample that get_samples will currently write.
+		*/
+		std::size_t get_channel_count() {
+			return 1;
+		}
+
 		/*!
 			Should skip the next @c number_of_samples. Subclasses of this SampleSource
 			need not implement this if it would no more efficient to do so than it is
 			merely to call get_samples and throw the result away, as per the default
-			implementation below.
+			implementation below. Note that the default implementation can reach only
+			this base class's get_samples, so sources with any internal state that
+			evolves over time should implement this.
 		*/
 		void skip_samples(const std::size_t number_of_samples) {
 			std::int16_t scratch_pad[number_of_samples];
@@ -47,6 +67,19 @@ class SampleSource {
 			return false;
 		}
 
+		/*!
+			Provides a broadphase test for constant output, e.g. silence or a fixed DC level.
+
+			@returns The number of forthcoming samples, possibly zero, over which it is certain that
+				every sample will be the same, absent any change in state by the source's owner. If
+				non-zero then that sample, a frame of get_channel_count() values, is written to @c level.
+				An owner may then use skip_samples to pass over as many of those samples as it wishes.
+				Sources that can't easily predict their output need not implement this.
+		*/
+		std::size_t get_constant_samples(std::int16_t *level) {
+			return 0;
+		}
+
 		/*!
 			Sets the proper output range for this sample source; it should write values
 			between 0 and volume.
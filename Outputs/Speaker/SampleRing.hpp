@@ -0,0 +1,123 @@
+//
+//  SampleRing.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#ifndef SampleRing_hpp
+#define SampleRing_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Outputs {
+namespace Speaker {
+
+/*!
+	Provides a fixed-size ring of audio samples that can be written to by exactly one thread
+	and read from by exactly one other without either ever taking a lock, making it suitable
+	for feeding a real-time audio callback.
+
+	If the writer finds insufficient space then the samples that don't fit are discarded
+	and an overrun is counted; if the reader finds insufficient samples then it receives only
+	those that are available and an underrun is counted. So the ring's capacity is also the
+	maximum latency it can introduce.
+*/
+class SampleRing {
+	public:
+		/// Constructs a ring that can hold at least @c minimum_capacity samples.
+		SampleRing(std::size_t minimum_capacity) {
+			std::size_t capacity = 1;
+			while(capacity < minimum_capacity) capacity <<= 1;
+			buffer_.resize(capacity);
+			mask_ = capacity - 1;
+		}
+
+		/*!
+			Appends up to @c count samples from @c samples. To be called only by the writing thread.
+
+			@returns the number of samples actually written.
+		*/
+		std::size_t write(const int16_t *samples, std::size_t count) {
+			const std::size_t write_index = write_index_.load(std::memory_order_relaxed);
+			const std::size_t read_index = read_index_.load(std::memory_order_acquire);
+
+			const std::size_t space = buffer_.size() - (write_index - read_index);
+			if(count > space) {
+				overruns_.fetch_add(1, std::memory_order_relaxed);
+				count = space;
+			}
+
+			const std::size_t write_offset = write_index & mask_;
+			const std::size_t first_length = std::min(count, buffer_.size() - write_offset);
+			std::memcpy(&buffer_[write_offset], samples, first_length * sizeof(int16_t));
+			std::memcpy(buffer_.data(), &samples[first_length], (count - first_length) * sizeof(int16_t));
+			write_index_.store(write_index + count, std::memory_order_release);
+			return count;
+		}
+
+		/*!
+			Removes up to @c count samples, storing them to @c samples. To be called only by the reading thread.
+
+			@returns the number of samples actually read.
+		*/
+		std::size_t read(int16_t *samples, std::size_t count) {
+			const std::size_t read_index = read_index_.load(std::memory_order_relaxed);
+			const std::size_t write_index = write_index_.load(std::memory_order_acquire);
+
+			const std::size_t available = write_index - read_index;
+			if(count > available) {
+				underruns_.fetch_add(1, std::memory_order_relaxed);
+				count = available;
+			}
+
+			const std::size_t read_offset = read_index & mask_;
+			const std::size_t first_length = std::min(count, buffer_.size() - read_offset);
+			std::memcpy(samples, &buffer_[read_offset], first_length * sizeof(int16_t));
+			std::memcpy(&samples[first_length], buffer_.data(), (count - first_length) * sizeof(int16_t));
+			read_index_.store(read_index + count, std::memory_order_release);
+			return count;
+		}
+
+		/// @returns the number of samples currently held; exact only if called from the reading or writing thread.
+		std::size_t size() const {
+			return write_index_.load(std::memory_order_acquire) - read_index_.load(std::memory_order_acquire);
+		}
+
+		/// @returns the number of samples this ring can hold.
+		std::size_t capacity() const {
+			return buffer_.size();
+		}
+
+		/// @returns the number of calls to @c write that were unable to store all of their samples.
+		uint64_t overruns() const {
+			return overruns_.load(std::memory_order_relaxed);
+		}
+
+		/// @returns the number of calls to @c read that were unable to obtain all of the samples requested.
+		uint64_t underruns() const {
+			return underruns_.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::vector<int16_t> buffer_;
+		std::size_t mask_;
+
+		// Indices increase without bound, wrapping naturally; the ring's capacity is a power of
+		// two so they can be masked directly, and their difference is always the fill level.
+		std::atomic<std::size_t> write_index_{0};
+		std::atomic<std::size_t> read_index_{0};
+
+		std::atomic<uint64_t> overruns_{0};
+		std::atomic<uint64_t> underruns_{0};
+};
+
+}
+}
+
+#endif /* SampleRing_hpp */
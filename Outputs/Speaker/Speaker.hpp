@@ -9,12 +9,29 @@
 #ifndef Speaker_hpp
 #define Speaker_hpp
 
+#include "SampleRing.hpp"
+
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
 namespace Outputs {
 namespace Speaker {
 
+/*!
+	Describes the layout of the sample frames a speaker's owner would like to receive.
+*/
+enum class Channels {
+	/// One sample per frame, with all channels mixed together.
+	Mono,
+	/// Two samples per frame, left then right. Machines without stereo output will place the same sample in both.
+	Stereo,
+	/// One sample per frame for each distinct sound channel of the machine, unmixed; e.g. for capturing each
+	/// channel of a sound chip separately. The number of samples per frame is machine-dependent.
+	Separate
+};
+
 /*!
 	Provides a communication point for sound; machines that have a speaker provide an
 	audio output.
@@ -26,7 +43,32 @@ class Speaker {
 		virtual float get_ideal_clock_rate_in_range(float minimum, float maximum) = 0;
 		virtual void set_output_rate(float cycles_per_second, int buffer_size) = 0;
 
+		/*!
+			Sets the rate at which input is to be consumed relative to its nominal rate, for
+			machines that are being run faster than real time.
+
+			A multiplier greater than 1 compresses input audio in time, raising its pitch, so
+			that output can keep pace with the machine. A multiplier of 0 causes all input to
+			be consumed without any output being produced. The default is 1.
+		*/
+		virtual void set_input_rate_multiplier(float multiplier) = 0;
+
+		/*!
+			Sets the layout of output frames; the default is Channels::Mono. Output is always interleaved,
+			i.e. all samples for a frame appear consecutively.
+		*/
+		virtual void set_output_channels(Channels channels) = 0;
+
+		/*!
+			@returns The number of samples per frame in the buffers most recently supplied to the delegate
+				and sample ring, or to be supplied if none have been yet.
+		*/
+		std::size_t get_output_channel_count() {
+			return output_channel_count_;
+		}
+
 		struct Delegate {
+			/// Supplies a completed buffer of samples, which holds frames with the layout requested via set_output_channels.
 			virtual void speaker_did_complete_samples(Speaker *speaker, const std::vector<int16_t> &buffer) = 0;
 			virtual void speaker_did_change_input_clock(Speaker *speaker) {}
 		};
@@ -34,8 +76,19 @@ class Speaker {
 			delegate_ = delegate;
 		}
 
+		/*!
+			Nominates a ring into which all output samples will be written directly as they are
+			completed, for consumption by a single reader such as a real-time audio callback.
+			This is independent of the delegate; either, both or neither may be set.
+		*/
+		virtual void set_sample_ring(SampleRing *ring) {
+			ring_ = ring;
+		}
+
 	protected:
 		Delegate *delegate_ = nullptr;
+		SampleRing *ring_ = nullptr;
+		std::atomic<std::size_t> output_channel_count_{1};
 };
 
 }
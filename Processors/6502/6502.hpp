@@ -9,12 +9,15 @@
 #ifndef MOS6502_cpp
 #define MOS6502_cpp
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <cstdint>
 
+#include "../Profile.hpp"
 #include "../RegisterSizes.hpp"
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Storage/State/Serialiser.hpp"
 
 namespace CPU {
 namespace MOS6502 {
@@ -117,6 +120,39 @@ class BusHandler {
 			bus handlers to perform any deferred output work.
 		*/
 		void flush() {}
+
+		/*!
+			Queried whenever the 6502 completes an iteration of a tight idle loop with no interrupt pending. Two
+			forms are recognised: a JMP to itself; and a BIT or LDA absolute, followed by a branch back to it, reading
+			an address for which @c is_static_address returns @c true. Either will repeat unchanged until an interrupt
+			arrives. Bus handlers that don't need to observe the repeated bus cycles individually may return a period
+			during which they guarantee not to change any interrupt input, the ready line, or any memory that the
+			loop reads. The 6502 will then skip as many whole iterations of the loop as fit within both that period and
+			the remainder of its current run_for, announcing them via @c perform_idle_cycles.
+
+			@returns The period that may be skipped. The default of Cycles(0) means that nothing is skipped.
+		*/
+		Cycles get_idle_limit() {
+			return Cycles(0);
+		}
+
+		/*!
+			@returns @c true if reading from @c address has no side effects and produces a value that can be changed
+			only by a write from the 6502; @c false otherwise. The default is @c false, so only JMP-to-self loops are
+			considered for skipping.
+		*/
+		bool is_static_address(uint16_t address) {
+			return false;
+		}
+
+		/*!
+			Announces that the 6502 has skipped @c cycles cycles of an idle loop, as permitted by @c get_idle_limit.
+
+			@returns The number of cycles that passed in objective time; see @c perform_bus_operation.
+		*/
+		Cycles perform_idle_cycles(Cycles cycles) {
+			return cycles;
+		}
 };
 
 #include "Implementation/6502Storage.hpp"
@@ -196,6 +232,21 @@ class ProcessorBase: public ProcessorStorage {
 			@returns @c true if the 6502 is jammed; @c false otherwise.
 		*/
 		bool is_jammed();
+
+		/*!
+			Captures or restores the complete state of this 6502, including that of any
+			partially-completed instruction.
+		*/
+		void serialise(Storage::State::Serialiser &serialiser);
+
+#ifdef PROFILE_PROCESSORS
+		/*!
+			@returns The execution profile accumulated by this 6502 since its creation.
+		*/
+		const Profile &get_profile() const {
+			return profile_;
+		}
+#endif
 };
 
 /*!
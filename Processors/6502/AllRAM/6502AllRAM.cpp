@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <limits>
 
 using namespace CPU::MOS6502;
 
@@ -26,6 +27,7 @@ template <Personality personality> class ConcreteAllRAMProcessor: public AllRAMP
 			timestamp_ += Cycles(1);
 
 			if(operation == BusOperation::ReadOpcode) {
+				++opcode_fetch_count_;
 				check_address_for_trap(address);
 			}
 
@@ -38,6 +40,17 @@ template <Personality personality> class ConcreteAllRAMProcessor: public AllRAMP
 			return Cycles(1);
 		}
 
+		// Interrupt inputs change only via set_irq_line and set_nmi_line, so idle loops can be skipped right up
+		// to the end of each run_for. Traps are not re-checked for the skipped fetches.
+		Cycles get_idle_limit() {
+			return Cycles(std::numeric_limits<int>::max());
+		}
+
+		Cycles perform_idle_cycles(Cycles cycles) {
+			timestamp_ += cycles;
+			return cycles;
+		}
+
 		void run_for(const Cycles cycles) {
 			mos6502_.run_for(cycles);
 		}
@@ -8,10 +8,80 @@
 
 #include "../6502.hpp"
 
+#include <utility>
+
 using namespace CPU::MOS6502;
 
 const uint8_t CPU::MOS6502::JamOpcode = 0xf2;
 
+const ProcessorStorage::MicroOp ProcessorStorage::fetch_decode_execute_[] = {
+	CycleFetchOperation,
+	CycleFetchOperand,
+	OperationDecodeOperation
+};
+
+const ProcessorStorage::MicroOp ProcessorStorage::do_branch_[] = {
+	CycleReadFromPC,
+	CycleAddSignedOperandToPC,
+	OperationMoveToNextProgram
+};
+
+const ProcessorStorage::MicroOp ProcessorStorage::do_bbr_bbs_branch_[] = {
+	CycleFetchOperand,			// Fetch offset.
+	OperationIncrementPC,
+	CycleFetchFromHalfUpdatedPC,
+	OperationAddSignedOperandToPC16,
+	OperationMoveToNextProgram
+};
+
+const ProcessorStorage::MicroOp ProcessorStorage::do_not_bbr_bbs_branch_[] = {
+	CycleFetchOperand,
+	OperationIncrementPC,
+	CycleFetchFromHalfUpdatedPC,
+	OperationMoveToNextProgram
+};
+
+const ProcessorStorage::MicroOp ProcessorStorage::reset_program_[] = {
+	CycleFetchOperand,
+	CycleFetchOperand,
+	CycleNoWritePush,
+	CycleNoWritePush,
+	OperationRSTPickVector,
+	CycleNoWritePush,
+	OperationSetNMIRSTFlags,
+	CycleReadVectorLow,
+	CycleReadVectorHigh,
+	OperationMoveToNextProgram
+};
+
+const ProcessorStorage::MicroOp ProcessorStorage::irq_program_[] = {
+	CycleFetchOperand,
+	CycleFetchOperand,
+	CyclePushPCH,
+	CyclePushPCL,
+	OperationBRKPickVector,
+	OperationSetOperandFromFlags,
+	CyclePushOperand,
+	OperationSetIRQFlags,
+	CycleReadVectorLow,
+	CycleReadVectorHigh,
+	OperationMoveToNextProgram
+};
+
+const ProcessorStorage::MicroOp ProcessorStorage::nmi_program_[] = {
+	CycleFetchOperand,
+	CycleFetchOperand,
+	CyclePushPCH,
+	CyclePushPCL,
+	OperationNMIPickVector,
+	OperationSetOperandFromFlags,
+	CyclePushOperand,
+	OperationSetNMIRSTFlags,
+	CycleReadVectorLow,
+	CycleReadVectorHigh,
+	OperationMoveToNextProgram
+};
+
 uint16_t ProcessorBase::get_value_of_register(Register r) {
 	switch (r) {
 		case Register::ProgramCounter:			return pc_.full;
@@ -42,3 +112,104 @@ void ProcessorBase::set_value_of_register(Register r, uint16_t value) {
 bool ProcessorBase::is_jammed() {
 	return is_jammed_;
 }
+
+void ProcessorBase::serialise(Storage::State::Serialiser &serialiser) {
+	serialiser.begin_section("6502", 1);
+
+	// Registers.
+	serialiser.field(pc_.full);
+	serialiser.field(last_operation_pc_.full);
+	serialiser.field(a_);
+	serialiser.field(x_);
+	serialiser.field(y_);
+	serialiser.field(s_);
+
+	// Flags, in their unpacked form.
+	serialiser.field(carry_flag_);
+	serialiser.field(negative_result_);
+	serialiser.field(zero_result_);
+	serialiser.field(decimal_flag_);
+	serialiser.field(overflow_flag_);
+	serialiser.field(inverse_interrupt_flag_);
+
+	// Inputs and interrupt state.
+	serialiser.field(interrupt_requests_);
+	serialiser.field(irq_line_);
+	serialiser.field(irq_request_history_);
+	serialiser.field(nmi_line_is_enabled_);
+	serialiser.field(set_overflow_line_is_enabled_);
+	serialiser.field(ready_is_active_);
+	serialiser.field(ready_line_is_enabled_);
+	serialiser.field(stop_is_active_);
+	serialiser.field(wait_is_active_);
+	serialiser.field(is_jammed_);
+
+	// Execution state.
+	serialiser.field(cycles_left_to_run_);
+	serialiser.field(operation_);
+	serialiser.field(operand_);
+	serialiser.field(address_.full);
+	serialiser.field(next_address_.full);
+	serialiser.field(next_bus_operation_);
+	serialiser.field(bus_address_);
+	serialiser.field(throwaway_target_);
+
+	// The record of the previous operation serves only to spot idle loops, so it is forgotten rather than stored.
+	previous_operation_ = 0x00;
+
+	// The pending bus value is stored as an index into the list of possible targets.
+	uint8_t *const bus_values[] = {
+		nullptr,
+		&a_, &x_, &y_,
+		&operation_, &operand_,
+		&address_.bytes.low, &address_.bytes.high,
+		&pc_.bytes.low, &pc_.bytes.high,
+		&throwaway_target_,
+	};
+	const int bus_value_count = sizeof(bus_values) / sizeof(*bus_values);
+
+	// The program position is stored as an index into either the operation table or the
+	// list of other programs, plus an offset. Index -1 indicates no program.
+	const std::pair<const MicroOp *, size_t> programs[] = {
+		{fetch_decode_execute_, sizeof(fetch_decode_execute_) / sizeof(MicroOp)},
+		{do_branch_, sizeof(do_branch_) / sizeof(MicroOp)},
+		{do_bbr_bbs_branch_, sizeof(do_bbr_bbs_branch_) / sizeof(MicroOp)},
+		{do_not_bbr_bbs_branch_, sizeof(do_not_bbr_bbs_branch_) / sizeof(MicroOp)},
+		{reset_program_, sizeof(reset_program_) / sizeof(MicroOp)},
+		{irq_program_, sizeof(irq_program_) / sizeof(MicroOp)},
+		{nmi_program_, sizeof(nmi_program_) / sizeof(MicroOp)},
+		{&operations_[0][0], sizeof(operations_) / sizeof(MicroOp)},
+	};
+	const int program_count = sizeof(programs) / sizeof(*programs);
+
+	int bus_value = 0, program = -1, offset = 0;
+	if(serialiser.is_capturing()) {
+		for(int c = 0; c < bus_value_count; ++c) {
+			if(bus_values[c] == bus_value_) bus_value = c;
+		}
+		for(int c = 0; c < program_count; ++c) {
+			if(scheduled_program_counter_ >= programs[c].first && scheduled_program_counter_ < programs[c].first + programs[c].second) {
+				program = c;
+				offset = static_cast<int>(scheduled_program_counter_ - programs[c].first);
+			}
+		}
+	}
+	serialiser.field(bus_value);
+	serialiser.field(program);
+	serialiser.field(offset);
+
+	if(!serialiser.is_capturing() && serialiser.is_valid()) {
+		if(
+			bus_value < 0 || bus_value >= bus_value_count ||
+			program >= program_count ||
+			(program >= 0 && (offset < 0 || static_cast<size_t>(offset) >= programs[program].second))
+		) {
+			serialiser.set_invalid();
+		} else {
+			bus_value_ = bus_values[bus_value];
+			scheduled_program_counter_ = (program >= 0) ? programs[program].first + offset : nullptr;
+		}
+	}
+
+	serialiser.end_section();
+}
@@ -12,19 +12,15 @@
 	6502.hpp, but it's implementation stuff.
 */
 
-template <Personality personality, typename T, bool uses_ready_line> void Processor<personality, T, uses_ready_line>::run_for(const Cycles cycles) {
-	static const MicroOp do_branch[] = {
-		CycleReadFromPC,
-		CycleAddSignedOperandToPC,
-		OperationMoveToNextProgram
-	};
-	static uint8_t throwaway_target;
-	static const MicroOp fetch_decode_execute[] = {
-		CycleFetchOperation,
-		CycleFetchOperand,
-		OperationDecodeOperation
-	};
+/*
+	GCC and Clang support taking the addresses of labels, which permits micro-ops to be dispatched with a single
+	indirect jump rather than via a switch; other compilers use the switch.
+*/
+#if defined(__GNUC__) || defined(__clang__)
+#define MOS6502_USES_COMPUTED_GOTO
+#endif
 
+template <Personality personality, typename T, bool uses_ready_line> void Processor<personality, T, uses_ready_line>::run_for(const Cycles cycles) {
 	// These plus program below act to give the compiler permission to update these values
 	// without touching the class storage (i.e. it explicitly says they need be completely up
 	// to date in this stack frame only); which saves some complicated addressing
@@ -46,7 +42,7 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 			scheduled_program_counter_ = get_irq_program();\
 		} \
 	} else {\
-		scheduled_program_counter_ = fetch_decode_execute;\
+		scheduled_program_counter_ = fetch_decode_execute_;\
 	}\
 		op;\
 	}
@@ -54,10 +50,63 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 #define bus_access() \
 	interrupt_requests_ = (interrupt_requests_ & ~InterruptRequestFlags::IRQ) | irq_request_history_;	\
 	irq_request_history_ = irq_line_ & inverse_interrupt_flag_;	\
+	profile_processor(profile_bus_access(nextBusOperation, busAddress));	\
 	number_of_cycles -= bus_handler_.perform_bus_operation(nextBusOperation, busAddress, busValue);	\
 	nextBusOperation = BusOperation::None;	\
 	if(number_of_cycles <= Cycles(0)) break;
 
+#ifdef MOS6502_USES_COMPUTED_GOTO
+	// Label addresses for each micro-op, in the same order as the MicroOp enum. Micro-ops that don't
+	// end in a bus access dispatch directly to their successor via next_micro_op(), giving each its
+	// own indirect jump and therefore its own branch history.
+	static void *const dispatch_table[] = {
+		&&CycleFetchOperation_label, &&CycleFetchOperand_label, &&OperationDecodeOperation_label,
+		&&OperationMoveToNextProgram_label, &&CycleIncPCPushPCH_label, &&CyclePushPCL_label, &&CyclePushPCH_label,
+		&&CyclePushA_label, &&CyclePushX_label, &&CyclePushY_label, &&CyclePushOperand_label,
+		&&OperationSetIRQFlags_label, &&OperationSetNMIRSTFlags_label, &&OperationBRKPickVector_label,
+		&&OperationNMIPickVector_label, &&OperationRSTPickVector_label, &&CycleReadVectorLow_label,
+		&&CycleReadVectorHigh_label, &&CycleReadFromS_label, &&CycleReadFromPC_label, &&CyclePullPCL_label,
+		&&CyclePullPCH_label, &&CyclePullA_label, &&CyclePullX_label, &&CyclePullY_label, &&CyclePullOperand_label,
+		&&CycleNoWritePush_label, &&CycleReadAndIncrementPC_label, &&CycleIncrementPCAndReadStack_label,
+		&&CycleIncrementPCReadPCHLoadPCL_label, &&CycleReadPCHLoadPCL_label, &&CycleReadAddressHLoadAddressL_label,
+		&&CycleReadPCLFromAddress_label, &&CycleReadPCHFromAddressLowInc_label, &&CycleReadPCHFromAddressFixed_label,
+		&&CycleReadPCHFromAddressInc_label, &&CycleLoadAddressAbsolute_label, &&OperationLoadAddressZeroPage_label,
+		&&CycleLoadAddessZeroX_label, &&CycleLoadAddessZeroY_label, &&CycleAddXToAddressLow_label,
+		&&CycleAddYToAddressLow_label, &&CycleAddXToAddressLowRead_label, &&CycleAddYToAddressLowRead_label,
+		&&OperationCorrectAddressHigh_label, &&OperationIncrementPC_label, &&CycleFetchOperandFromAddress_label,
+		&&CycleWriteOperandToAddress_label, &&CycleIncrementPCFetchAddressLowFromOperand_label,
+		&&CycleAddXToOperandFetchAddressLow_label, &&CycleIncrementOperandFetchAddressHigh_label,
+		&&OperationDecrementOperand_label, &&OperationIncrementOperand_label, &&CycleFetchAddressLowFromOperand_label,
+		&&OperationORA_label, &&OperationAND_label, &&OperationEOR_label, &&OperationINS_label, &&OperationADC_label,
+		&&OperationSBC_label, &&OperationCMP_label, &&OperationCPX_label, &&OperationCPY_label, &&OperationBIT_label,
+		&&OperationBITNoNV_label, &&OperationLDA_label, &&OperationLDX_label, &&OperationLDY_label,
+		&&OperationLAX_label, &&OperationCopyOperandToA_label, &&OperationSTA_label, &&OperationSTX_label,
+		&&OperationSTY_label, &&OperationSTZ_label, &&OperationSAX_label, &&OperationSHA_label, &&OperationSHX_label,
+		&&OperationSHY_label, &&OperationSHS_label, &&OperationASL_label, &&OperationASO_label, &&OperationROL_label,
+		&&OperationRLA_label, &&OperationLSR_label, &&OperationLSE_label, &&OperationASR_label, &&OperationROR_label,
+		&&OperationRRA_label, &&OperationCLC_label, &&OperationCLI_label, &&OperationCLV_label, &&OperationCLD_label,
+		&&OperationSEC_label, &&OperationSEI_label, &&OperationSED_label, &&OperationRMB_label, &&OperationSMB_label,
+		&&OperationTRB_label, &&OperationTSB_label, &&OperationINC_label, &&OperationDEC_label, &&OperationINX_label,
+		&&OperationDEX_label, &&OperationINY_label, &&OperationDEY_label, &&OperationINA_label, &&OperationDEA_label,
+		&&OperationBPL_label, &&OperationBMI_label, &&OperationBVC_label, &&OperationBVS_label, &&OperationBCC_label,
+		&&OperationBCS_label, &&OperationBNE_label, &&OperationBEQ_label, &&OperationBRA_label,
+		&&OperationBBRBBS_label, &&OperationTXA_label, &&OperationTYA_label, &&OperationTXS_label,
+		&&OperationTAY_label, &&OperationTAX_label, &&OperationTSX_label, &&OperationARR_label, &&OperationSBX_label,
+		&&OperationLXA_label, &&OperationANE_label, &&OperationANC_label, &&OperationLAS_label,
+		&&CycleFetchFromHalfUpdatedPC_label, &&CycleAddSignedOperandToPC_label,
+		&&OperationAddSignedOperandToPC16_label, &&OperationSetFlagsFromOperand_label,
+		&&OperationSetOperandFromFlagsWithBRKSet_label, &&OperationSetOperandFromFlags_label,
+		&&OperationSetFlagsFromA_label, &&OperationSetFlagsFromX_label, &&OperationSetFlagsFromY_label,
+		&&OperationScheduleJam_label, &&OperationScheduleWait_label, &&OperationScheduleStop_label
+	};
+	static_assert(sizeof(dispatch_table) / sizeof(*dispatch_table) == OperationScheduleStop + 1, "Dispatch table should have one entry per MicroOp");
+#define micro_op_case(x)	case x: x##_label
+#define next_micro_op()		{ cycle = *scheduled_program_counter_; scheduled_program_counter_++; goto *dispatch_table[cycle]; }
+#else
+#define next_micro_op()		continue
+#define micro_op_case(x)	case x
+#endif
+
 	checkSchedule();
 	Cycles number_of_cycles = cycles + cycles_left_to_run_;
 
@@ -65,11 +114,13 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 
 		// Deal with a potential RDY state, if this 6502 has anything connected to ready.
 		while(uses_ready_line && ready_is_active_ && number_of_cycles > Cycles(0)) {
+			profile_processor(profile_.did_run_for(1));
 			number_of_cycles -= bus_handler_.perform_bus_operation(BusOperation::Ready, busAddress, busValue);
 		}
 
 		// Deal with a potential STP state, if this 6502 implements STP.
 		while(has_stpwai(personality) && stop_is_active_ && number_of_cycles > Cycles(0)) {
+			profile_processor(profile_.did_run_for(1));
 			number_of_cycles -= bus_handler_.perform_bus_operation(BusOperation::Ready, busAddress, busValue);
 			if(interrupt_requests_ & InterruptRequestFlags::Reset) {
 				stop_is_active_ = false;
@@ -80,6 +131,7 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 
 		// Deal with a potential WAI state, if this 6502 implements WAI.
 		while(has_stpwai(personality) && wait_is_active_ && number_of_cycles > Cycles(0)) {
+			profile_processor(profile_.did_run_for(1));
 			number_of_cycles -= bus_handler_.perform_bus_operation(BusOperation::Ready, busAddress, busValue);
 			interrupt_requests_ |= (irq_line_ & inverse_interrupt_flag_);
 			if(interrupt_requests_ & InterruptRequestFlags::NMI || irq_line_) {
@@ -96,25 +148,31 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 
 			while(1) {
 
-				const MicroOp cycle = *scheduled_program_counter_;
+				MicroOp cycle = *scheduled_program_counter_;
 				scheduled_program_counter_++;
 
 #define read_op(val, addr)		nextBusOperation = BusOperation::ReadOpcode;	busAddress = addr;		busValue = &val;				val = 0xff
 #define read_mem(val, addr)		nextBusOperation = BusOperation::Read;			busAddress = addr;		busValue = &val;				val	= 0xff
-#define throwaway_read(addr)	nextBusOperation = BusOperation::Read;			busAddress = addr;		busValue = &throwaway_target;	throwaway_target = 0xff
+#define throwaway_read(addr)	nextBusOperation = BusOperation::Read;			busAddress = addr;		busValue = &throwaway_target_;	throwaway_target_ = 0xff
 #define write_mem(val, addr)	nextBusOperation = BusOperation::Write;			busAddress = addr;		busValue = &val
 
+#ifdef MOS6502_USES_COMPUTED_GOTO
+				goto *dispatch_table[cycle];
+#endif
 				switch(cycle) {
 
 // MARK: - Fetch/Decode
 
-					case CycleFetchOperation: {
+					micro_op_case(CycleFetchOperation): {
+						profile_processor(profile_.did_begin_instruction(pc_.full));
+						previous_operation_ = operation_;
+						previous_operation_pc_ = last_operation_pc_;
 						last_operation_pc_ = pc_;
 						pc_.full++;
 						read_op(operation_, last_operation_pc_.full);
 					} break;
 
-					case CycleFetchOperand:
+					micro_op_case(CycleFetchOperand):
 						// This is supposed to produce the 65C02's 1-cycle NOPs; they're
 						// treated as a special case because they break the rule that
 						// governs everything else on the 6502: that two bytes will always
@@ -128,32 +186,63 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 							read_mem(operand_, pc_.full);
 							break;
 						} else {
-							continue;
+							next_micro_op();
 						}
 					break;
 
-					case OperationDecodeOperation:
+					micro_op_case(OperationDecodeOperation):
+						profile_processor(profile_.did_decode(0, operation_));
 						scheduled_program_counter_ = operations_[operation_];
-					continue;
+					next_micro_op();
+
+					micro_op_case(OperationMoveToNextProgram):
+						// An idle loop will repeat unchanged until an interrupt arrives, provided that anything it reads
+						// doesn't change; if the bus handler permits then skip whole iterations of it. Two forms are
+						// recognised: a JMP to itself, and a BIT or LDA absolute followed by a branch back to it.
+						if(
+							(operation_ == 0x4c || (operation_ & 0x1f) == 0x10) &&
+							!interrupt_requests_ && !irq_request_history_ && !(irq_line_ & inverse_interrupt_flag_)
+						) {
+							int iteration_length = 0;
+							if(operation_ == 0x4c) {
+								if(pc_.full == last_operation_pc_.full) iteration_length = 3;
+							} else if(
+								(previous_operation_ == 0x2c || previous_operation_ == 0xad) &&
+								previous_operation_pc_.full == pc_.full &&
+								static_cast<uint16_t>(pc_.full + 3) == last_operation_pc_.full &&
+								!((pc_.full ^ (last_operation_pc_.full + 2)) & 0xff00) &&
+								bus_handler_.is_static_address(address_.full)
+							) {
+								// i.e. four cycles for the read, three for a taken branch that doesn't cross a page.
+								iteration_length = 7;
+							}
+
+							if(iteration_length) {
+								const int iterations = std::min(bus_handler_.get_idle_limit(), number_of_cycles).as_int() / iteration_length;
+								if(iterations > 0) {
+									number_of_cycles -= bus_handler_.perform_idle_cycles(Cycles(iterations * iteration_length));
+									profile_processor(profile_.did_run_for(iterations * iteration_length));
+								}
+							}
+						}
 
-					case OperationMoveToNextProgram:
 						scheduled_program_counter_ = nullptr;
 						checkSchedule();
-					continue;
+					next_micro_op();
 
 #define push(v) {\
 	uint16_t targetAddress = s_ | 0x100; s_--;\
 	write_mem(v, targetAddress);\
 }
 
-					case CycleIncPCPushPCH:				pc_.full++;														// deliberate fallthrough
-					case CyclePushPCH:					push(pc_.bytes.high);											break;
-					case CyclePushPCL:					push(pc_.bytes.low);											break;
-					case CyclePushOperand:				push(operand_);													break;
-					case CyclePushA:					push(a_);														break;
-					case CyclePushX:					push(x_);														break;
-					case CyclePushY:					push(y_);														break;
-					case CycleNoWritePush: {
+					micro_op_case(CycleIncPCPushPCH):				pc_.full++;														// deliberate fallthrough
+					micro_op_case(CyclePushPCH):					push(pc_.bytes.high);											break;
+					micro_op_case(CyclePushPCL):					push(pc_.bytes.low);											break;
+					micro_op_case(CyclePushOperand):				push(operand_);													break;
+					micro_op_case(CyclePushA):					push(a_);														break;
+					micro_op_case(CyclePushX):					push(x_);														break;
+					micro_op_case(CyclePushY):					push(y_);														break;
+					micro_op_case(CycleNoWritePush): {
 						uint16_t targetAddress = s_ | 0x100; s_--;
 						read_mem(operand_, targetAddress);
 					}
@@ -161,10 +250,10 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 
 #undef push
 
-					case CycleReadFromS:				throwaway_read(s_ | 0x100);										break;
-					case CycleReadFromPC:				throwaway_read(pc_.full);										break;
+					micro_op_case(CycleReadFromS):				throwaway_read(s_ | 0x100);										break;
+					micro_op_case(CycleReadFromPC):				throwaway_read(pc_.full);										break;
 
-					case OperationBRKPickVector:
+					micro_op_case(OperationBRKPickVector):
 						if(is_65c02(personality)) {
 							nextAddress.full = 0xfffe;
 						} else {
@@ -172,39 +261,39 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 							nextAddress.full = (interrupt_requests_ & InterruptRequestFlags::NMI) ? 0xfffa : 0xfffe;
 							interrupt_requests_ &= ~InterruptRequestFlags::NMI;
 						}
-					continue;
-					case OperationNMIPickVector:		nextAddress.full = 0xfffa;											continue;
-					case OperationRSTPickVector:		nextAddress.full = 0xfffc;											continue;
-					case CycleReadVectorLow:			read_mem(pc_.bytes.low, nextAddress.full);							break;
-					case CycleReadVectorHigh:			read_mem(pc_.bytes.high, nextAddress.full+1);						break;
-					case OperationSetIRQFlags:
+					next_micro_op();
+					micro_op_case(OperationNMIPickVector):		nextAddress.full = 0xfffa;											next_micro_op();
+					micro_op_case(OperationRSTPickVector):		nextAddress.full = 0xfffc;											next_micro_op();
+					micro_op_case(CycleReadVectorLow):			read_mem(pc_.bytes.low, nextAddress.full);							break;
+					micro_op_case(CycleReadVectorHigh):			read_mem(pc_.bytes.high, nextAddress.full+1);						break;
+					micro_op_case(OperationSetIRQFlags):
 						inverse_interrupt_flag_ = 0;
 						if(is_65c02(personality)) decimal_flag_ = false;
-					continue;
-					case OperationSetNMIRSTFlags:
+					next_micro_op();
+					micro_op_case(OperationSetNMIRSTFlags):
 						if(is_65c02(personality)) decimal_flag_ = false;
-					continue;
-
-					case CyclePullPCL:					s_++; read_mem(pc_.bytes.low, s_ | 0x100);							break;
-					case CyclePullPCH:					s_++; read_mem(pc_.bytes.high, s_ | 0x100);							break;
-					case CyclePullA:					s_++; read_mem(a_, s_ | 0x100);										break;
-					case CyclePullX:					s_++; read_mem(x_, s_ | 0x100);										break;
-					case CyclePullY:					s_++; read_mem(y_, s_ | 0x100);										break;
-					case CyclePullOperand:				s_++; read_mem(operand_, s_ | 0x100);								break;
-					case OperationSetFlagsFromOperand:	set_flags(operand_);												continue;
-					case OperationSetOperandFromFlagsWithBRKSet: operand_ = get_flags() | Flag::Break;						continue;
-					case OperationSetOperandFromFlags:  operand_ = get_flags();												continue;
-					case OperationSetFlagsFromA:		zero_result_ = negative_result_ = a_;								continue;
-					case OperationSetFlagsFromX:		zero_result_ = negative_result_ = x_;								continue;
-					case OperationSetFlagsFromY:		zero_result_ = negative_result_ = y_;								continue;
-
-					case CycleIncrementPCAndReadStack:	pc_.full++; throwaway_read(s_ | 0x100);													break;
-					case CycleReadPCLFromAddress:		read_mem(pc_.bytes.low, address_.full);													break;
-					case CycleReadPCHFromAddressLowInc:	address_.bytes.low++; read_mem(pc_.bytes.high, address_.full);							break;
-					case CycleReadPCHFromAddressFixed:	if(!address_.bytes.low) address_.bytes.high++; read_mem(pc_.bytes.high, address_.full);	break;
-					case CycleReadPCHFromAddressInc:	address_.full++; read_mem(pc_.bytes.high, address_.full);								break;
-
-					case CycleReadAndIncrementPC: {
+					next_micro_op();
+
+					micro_op_case(CyclePullPCL):					s_++; read_mem(pc_.bytes.low, s_ | 0x100);							break;
+					micro_op_case(CyclePullPCH):					s_++; read_mem(pc_.bytes.high, s_ | 0x100);							break;
+					micro_op_case(CyclePullA):					s_++; read_mem(a_, s_ | 0x100);										break;
+					micro_op_case(CyclePullX):					s_++; read_mem(x_, s_ | 0x100);										break;
+					micro_op_case(CyclePullY):					s_++; read_mem(y_, s_ | 0x100);										break;
+					micro_op_case(CyclePullOperand):				s_++; read_mem(operand_, s_ | 0x100);								break;
+					micro_op_case(OperationSetFlagsFromOperand):	set_flags(operand_);												next_micro_op();
+					micro_op_case(OperationSetOperandFromFlagsWithBRKSet): operand_ = get_flags() | Flag::Break;						next_micro_op();
+					micro_op_case(OperationSetOperandFromFlags):  operand_ = get_flags();												next_micro_op();
+					micro_op_case(OperationSetFlagsFromA):		zero_result_ = negative_result_ = a_;								next_micro_op();
+					micro_op_case(OperationSetFlagsFromX):		zero_result_ = negative_result_ = x_;								next_micro_op();
+					micro_op_case(OperationSetFlagsFromY):		zero_result_ = negative_result_ = y_;								next_micro_op();
+
+					micro_op_case(CycleIncrementPCAndReadStack):	pc_.full++; throwaway_read(s_ | 0x100);													break;
+					micro_op_case(CycleReadPCLFromAddress):		read_mem(pc_.bytes.low, address_.full);													break;
+					micro_op_case(CycleReadPCHFromAddressLowInc):	address_.bytes.low++; read_mem(pc_.bytes.high, address_.full);							break;
+					micro_op_case(CycleReadPCHFromAddressFixed):	if(!address_.bytes.low) address_.bytes.high++; read_mem(pc_.bytes.high, address_.full);	break;
+					micro_op_case(CycleReadPCHFromAddressInc):	address_.full++; read_mem(pc_.bytes.high, address_.full);								break;
+
+					micro_op_case(CycleReadAndIncrementPC): {
 						uint16_t oldPC = pc_.full;
 						pc_.full++;
 						throwaway_read(oldPC);
@@ -212,99 +301,99 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 
 // MARK: - JAM, WAI, STP
 
-					case OperationScheduleJam: {
+					micro_op_case(OperationScheduleJam): {
 						is_jammed_ = true;
 						scheduled_program_counter_ = operations_[CPU::MOS6502::JamOpcode];
-					} continue;
+					} next_micro_op();
 
-					case OperationScheduleStop:
+					micro_op_case(OperationScheduleStop):
 						stop_is_active_ = true;
 					break;
 
-					case OperationScheduleWait:
+					micro_op_case(OperationScheduleWait):
 						wait_is_active_ = true;
 					break;
 
 // MARK: - Bitwise
 
-					case OperationORA:	a_ |= operand_;	negative_result_ = zero_result_ = a_;		continue;
-					case OperationAND:	a_ &= operand_;	negative_result_ = zero_result_ = a_;		continue;
-					case OperationEOR:	a_ ^= operand_;	negative_result_ = zero_result_ = a_;		continue;
+					micro_op_case(OperationORA):	a_ |= operand_;	negative_result_ = zero_result_ = a_;		next_micro_op();
+					micro_op_case(OperationAND):	a_ &= operand_;	negative_result_ = zero_result_ = a_;		next_micro_op();
+					micro_op_case(OperationEOR):	a_ ^= operand_;	negative_result_ = zero_result_ = a_;		next_micro_op();
 
 // MARK: - Load and Store
 
-					case OperationLDA:	a_ = negative_result_ = zero_result_ = operand_;			continue;
-					case OperationLDX:	x_ = negative_result_ = zero_result_ = operand_;			continue;
-					case OperationLDY:	y_ = negative_result_ = zero_result_ = operand_;			continue;
-					case OperationLAX:	a_ = x_ = negative_result_ = zero_result_ = operand_;		continue;
-					case OperationCopyOperandToA:		a_ = operand_;								continue;
-
-					case OperationSTA:	operand_ = a_;											continue;
-					case OperationSTX:	operand_ = x_;											continue;
-					case OperationSTY:	operand_ = y_;											continue;
-					case OperationSTZ:	operand_ = 0;											continue;
-					case OperationSAX:	operand_ = a_ & x_;										continue;
-					case OperationSHA:	operand_ = a_ & x_ & (address_.bytes.high+1);			continue;
-					case OperationSHX:	operand_ = x_ & (address_.bytes.high+1);				continue;
-					case OperationSHY:	operand_ = y_ & (address_.bytes.high+1);				continue;
-					case OperationSHS:	s_ = a_ & x_; operand_ = s_ & (address_.bytes.high+1);	continue;
-
-					case OperationLXA:
+					micro_op_case(OperationLDA):	a_ = negative_result_ = zero_result_ = operand_;			next_micro_op();
+					micro_op_case(OperationLDX):	x_ = negative_result_ = zero_result_ = operand_;			next_micro_op();
+					micro_op_case(OperationLDY):	y_ = negative_result_ = zero_result_ = operand_;			next_micro_op();
+					micro_op_case(OperationLAX):	a_ = x_ = negative_result_ = zero_result_ = operand_;		next_micro_op();
+					micro_op_case(OperationCopyOperandToA):		a_ = operand_;								next_micro_op();
+
+					micro_op_case(OperationSTA):	operand_ = a_;											next_micro_op();
+					micro_op_case(OperationSTX):	operand_ = x_;											next_micro_op();
+					micro_op_case(OperationSTY):	operand_ = y_;											next_micro_op();
+					micro_op_case(OperationSTZ):	operand_ = 0;											next_micro_op();
+					micro_op_case(OperationSAX):	operand_ = a_ & x_;										next_micro_op();
+					micro_op_case(OperationSHA):	operand_ = a_ & x_ & (address_.bytes.high+1);			next_micro_op();
+					micro_op_case(OperationSHX):	operand_ = x_ & (address_.bytes.high+1);				next_micro_op();
+					micro_op_case(OperationSHY):	operand_ = y_ & (address_.bytes.high+1);				next_micro_op();
+					micro_op_case(OperationSHS):	s_ = a_ & x_; operand_ = s_ & (address_.bytes.high+1);	next_micro_op();
+
+					micro_op_case(OperationLXA):
 						a_ = x_ = (a_ | 0xee) & operand_;
 						negative_result_ = zero_result_ = a_;
-					continue;
+					next_micro_op();
 
 // MARK: - Compare
 
-					case OperationCMP: {
+					micro_op_case(OperationCMP): {
 						const uint16_t temp16 = a_ - operand_;
 						negative_result_ = zero_result_ = static_cast<uint8_t>(temp16);
 						carry_flag_ = ((~temp16) >> 8)&1;
-					} continue;
-					case OperationCPX: {
+					} next_micro_op();
+					micro_op_case(OperationCPX): {
 						const uint16_t temp16 = x_ - operand_;
 						negative_result_ = zero_result_ = static_cast<uint8_t>(temp16);
 						carry_flag_ = ((~temp16) >> 8)&1;
-					} continue;
-					case OperationCPY: {
+					} next_micro_op();
+					micro_op_case(OperationCPY): {
 						const uint16_t temp16 = y_ - operand_;
 						negative_result_ = zero_result_ = static_cast<uint8_t>(temp16);
 						carry_flag_ = ((~temp16) >> 8)&1;
-					} continue;
+					} next_micro_op();
 
 // MARK: - BIT, TSB, TRB
 
-					case OperationBIT:
+					micro_op_case(OperationBIT):
 						zero_result_ = operand_ & a_;
 						negative_result_ = operand_;
 						overflow_flag_ = operand_&Flag::Overflow;
-					continue;
-					case OperationBITNoNV:
+					next_micro_op();
+					micro_op_case(OperationBITNoNV):
 						zero_result_ = operand_ & a_;
-					continue;
-					case OperationTRB:
+					next_micro_op();
+					micro_op_case(OperationTRB):
 						zero_result_ = operand_ & a_;
 						operand_ &= ~a_;
-					continue;
-					case OperationTSB:
+					next_micro_op();
+					micro_op_case(OperationTSB):
 						zero_result_ = operand_ & a_;
 						operand_ |= a_;
-					continue;
+					next_micro_op();
 
 // MARK: - RMB and SMB
 
-					case OperationRMB:
+					micro_op_case(OperationRMB):
 						operand_ &= ~(1 << (operation_ >> 4));
-					continue;
-					case OperationSMB:
+					next_micro_op();
+					micro_op_case(OperationSMB):
 						operand_ |= 1 << ((operation_ >> 4)&7);
-					continue;
+					next_micro_op();
 
 // MARK: - ADC/SBC (and INS)
 
-					case OperationINS:
+					micro_op_case(OperationINS):
 						operand_++;			// deliberate fallthrough
-					case OperationSBC:
+					micro_op_case(OperationSBC):
 						if(decimal_flag_ && has_decimal_mode(personality)) {
 							const uint16_t notCarry = carry_flag_ ^ 0x1;
 							const uint16_t decimalResult = static_cast<uint16_t>(a_) - static_cast<uint16_t>(operand_) - notCarry;
@@ -329,13 +418,13 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 								read_mem(operand_, address_.full);
 								break;
 							}
-							continue;
+							next_micro_op();
 						} else {
 							operand_ = ~operand_;
 						}
 
 					// deliberate fallthrough
-					case OperationADC:
+					micro_op_case(OperationADC):
 						if(decimal_flag_ && has_decimal_mode(personality)) {
 							const uint16_t decimalResult = static_cast<uint16_t>(a_) + static_cast<uint16_t>(operand_) + static_cast<uint16_t>(carry_flag_);
 
@@ -364,105 +453,105 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 
 						// fix up in case this was INS
 						if(cycle == OperationINS) operand_ = ~operand_;
-					continue;
+					next_micro_op();
 
 // MARK: - Shifts and Rolls
 
-					case OperationASL:
+					micro_op_case(OperationASL):
 						carry_flag_ = operand_ >> 7;
 						operand_ <<= 1;
 						negative_result_ = zero_result_ = operand_;
-					continue;
+					next_micro_op();
 
-					case OperationASO:
+					micro_op_case(OperationASO):
 						carry_flag_ = operand_ >> 7;
 						operand_ <<= 1;
 						a_ |= operand_;
 						negative_result_ = zero_result_ = a_;
-					continue;
+					next_micro_op();
 
-					case OperationROL: {
+					micro_op_case(OperationROL): {
 						const uint8_t temp8 = static_cast<uint8_t>((operand_ << 1) | carry_flag_);
 						carry_flag_ = operand_ >> 7;
 						operand_ = negative_result_ = zero_result_ = temp8;
-					} continue;
+					} next_micro_op();
 
-					case OperationRLA: {
+					micro_op_case(OperationRLA): {
 						const uint8_t temp8 = static_cast<uint8_t>((operand_ << 1) | carry_flag_);
 						carry_flag_ = operand_ >> 7;
 						operand_ = temp8;
 						a_ &= operand_;
 						negative_result_ = zero_result_ = a_;
-					} continue;
+					} next_micro_op();
 
-					case OperationLSR:
+					micro_op_case(OperationLSR):
 						carry_flag_ = operand_ & 1;
 						operand_ >>= 1;
 						negative_result_ = zero_result_ = operand_;
-					continue;
+					next_micro_op();
 
-					case OperationLSE:
+					micro_op_case(OperationLSE):
 						carry_flag_ = operand_ & 1;
 						operand_ >>= 1;
 						a_ ^= operand_;
 						negative_result_ = zero_result_ = a_;
-					continue;
+					next_micro_op();
 
-					case OperationASR:
+					micro_op_case(OperationASR):
 						a_ &= operand_;
 						carry_flag_ = a_ & 1;
 						a_ >>= 1;
 						negative_result_ = zero_result_ = a_;
-					continue;
+					next_micro_op();
 
-					case OperationROR: {
+					micro_op_case(OperationROR): {
 						const uint8_t temp8 = static_cast<uint8_t>((operand_ >> 1) | (carry_flag_ << 7));
 						carry_flag_ = operand_ & 1;
 						operand_ = negative_result_ = zero_result_ = temp8;
-					} continue;
+					} next_micro_op();
 
-					case OperationRRA: {
+					micro_op_case(OperationRRA): {
 						const uint8_t temp8 = static_cast<uint8_t>((operand_ >> 1) | (carry_flag_ << 7));
 						carry_flag_ = operand_ & 1;
 						operand_ = temp8;
-					} continue;
-
-					case OperationDecrementOperand: operand_--; continue;
-					case OperationIncrementOperand: operand_++; continue;
-
-					case OperationCLC: carry_flag_ = 0;								continue;
-					case OperationCLI: inverse_interrupt_flag_ = Flag::Interrupt;	continue;
-					case OperationCLV: overflow_flag_ = 0;							continue;
-					case OperationCLD: decimal_flag_ = 0;							continue;
-
-					case OperationSEC: carry_flag_ = Flag::Carry;		continue;
-					case OperationSEI: inverse_interrupt_flag_ = 0;		continue;
-					case OperationSED: decimal_flag_ = Flag::Decimal;	continue;
-
-					case OperationINC: operand_++; negative_result_ = zero_result_ = operand_; continue;
-					case OperationDEC: operand_--; negative_result_ = zero_result_ = operand_; continue;
-					case OperationINA: a_++; negative_result_ = zero_result_ = a_; continue;
-					case OperationDEA: a_--; negative_result_ = zero_result_ = a_; continue;
-					case OperationINX: x_++; negative_result_ = zero_result_ = x_; continue;
-					case OperationDEX: x_--; negative_result_ = zero_result_ = x_; continue;
-					case OperationINY: y_++; negative_result_ = zero_result_ = y_; continue;
-					case OperationDEY: y_--; negative_result_ = zero_result_ = y_; continue;
-
-					case OperationANE:
+					} next_micro_op();
+
+					micro_op_case(OperationDecrementOperand): operand_--; next_micro_op();
+					micro_op_case(OperationIncrementOperand): operand_++; next_micro_op();
+
+					micro_op_case(OperationCLC): carry_flag_ = 0;								next_micro_op();
+					micro_op_case(OperationCLI): inverse_interrupt_flag_ = Flag::Interrupt;	next_micro_op();
+					micro_op_case(OperationCLV): overflow_flag_ = 0;							next_micro_op();
+					micro_op_case(OperationCLD): decimal_flag_ = 0;							next_micro_op();
+
+					micro_op_case(OperationSEC): carry_flag_ = Flag::Carry;		next_micro_op();
+					micro_op_case(OperationSEI): inverse_interrupt_flag_ = 0;		next_micro_op();
+					micro_op_case(OperationSED): decimal_flag_ = Flag::Decimal;	next_micro_op();
+
+					micro_op_case(OperationINC): operand_++; negative_result_ = zero_result_ = operand_; next_micro_op();
+					micro_op_case(OperationDEC): operand_--; negative_result_ = zero_result_ = operand_; next_micro_op();
+					micro_op_case(OperationINA): a_++; negative_result_ = zero_result_ = a_; next_micro_op();
+					micro_op_case(OperationDEA): a_--; negative_result_ = zero_result_ = a_; next_micro_op();
+					micro_op_case(OperationINX): x_++; negative_result_ = zero_result_ = x_; next_micro_op();
+					micro_op_case(OperationDEX): x_--; negative_result_ = zero_result_ = x_; next_micro_op();
+					micro_op_case(OperationINY): y_++; negative_result_ = zero_result_ = y_; next_micro_op();
+					micro_op_case(OperationDEY): y_--; negative_result_ = zero_result_ = y_; next_micro_op();
+
+					micro_op_case(OperationANE):
 						a_ = (a_ | 0xee) & operand_ & x_;
 						negative_result_ = zero_result_ = a_;
-					continue;
+					next_micro_op();
 
-					case OperationANC:
+					micro_op_case(OperationANC):
 						a_ &= operand_;
 						negative_result_ = zero_result_ = a_;
 						carry_flag_ = a_ >> 7;
-					continue;
+					next_micro_op();
 
-					case OperationLAS:
+					micro_op_case(OperationLAS):
 						a_ = x_ = s_ = s_ & operand_;
 						negative_result_ = zero_result_ = a_;
-					continue;
+					next_micro_op();
 
 // MARK: - Addressing Mode Work
 
@@ -473,28 +562,28 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 		throwaway_read(address_.full);	\
 	}
 
-					case CycleAddXToAddressLow:
+					micro_op_case(CycleAddXToAddressLow):
 						nextAddress.full = address_.full + x_;
 						address_.bytes.low = nextAddress.bytes.low;
 						if(address_.bytes.high != nextAddress.bytes.high) {		
 							page_crossing_stall_read();
 							break;
 						}
-					continue;
-					case CycleAddXToAddressLowRead:
+					next_micro_op();
+					micro_op_case(CycleAddXToAddressLowRead):
 						nextAddress.full = address_.full + x_;
 						address_.bytes.low = nextAddress.bytes.low;
 						page_crossing_stall_read();
 					break;
-					case CycleAddYToAddressLow:
+					micro_op_case(CycleAddYToAddressLow):
 						nextAddress.full = address_.full + y_;
 						address_.bytes.low = nextAddress.bytes.low;
 						if(address_.bytes.high != nextAddress.bytes.high) {
 							page_crossing_stall_read();
 							break;
 						}
-					continue;
-					case CycleAddYToAddressLowRead:
+					next_micro_op();
+					micro_op_case(CycleAddYToAddressLowRead):
 						nextAddress.full = address_.full + y_;
 						address_.bytes.low = nextAddress.bytes.low;
 						page_crossing_stall_read();
@@ -502,86 +591,86 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 
 #undef page_crossing_stall_read
 
-					case OperationCorrectAddressHigh:
+					micro_op_case(OperationCorrectAddressHigh):
 						address_.full = nextAddress.full;
-					continue;
-					case CycleIncrementPCFetchAddressLowFromOperand:
+					next_micro_op();
+					micro_op_case(CycleIncrementPCFetchAddressLowFromOperand):
 						pc_.full++;
 						read_mem(address_.bytes.low, operand_);
 					break;
-					case CycleAddXToOperandFetchAddressLow:
+					micro_op_case(CycleAddXToOperandFetchAddressLow):
 						operand_ += x_;
 						read_mem(address_.bytes.low, operand_);
 					break;
-					case CycleFetchAddressLowFromOperand:
+					micro_op_case(CycleFetchAddressLowFromOperand):
 						read_mem(address_.bytes.low, operand_);
 					break;
-					case CycleIncrementOperandFetchAddressHigh:
+					micro_op_case(CycleIncrementOperandFetchAddressHigh):
 						operand_++;
 						read_mem(address_.bytes.high, operand_);
 					break;
-					case CycleIncrementPCReadPCHLoadPCL:	// deliberate fallthrough
+					micro_op_case(CycleIncrementPCReadPCHLoadPCL):	// deliberate fallthrough
 						pc_.full++;
-					case CycleReadPCHLoadPCL: {
+					micro_op_case(CycleReadPCHLoadPCL): {
 						uint16_t oldPC = pc_.full;
 						pc_.bytes.low = operand_;
 						read_mem(pc_.bytes.high, oldPC);
 					} break;
 
-					case CycleReadAddressHLoadAddressL:
+					micro_op_case(CycleReadAddressHLoadAddressL):
 						address_.bytes.low = operand_; pc_.full++;
 						read_mem(address_.bytes.high, pc_.full);
 					break;
 
-					case CycleLoadAddressAbsolute: {
+					micro_op_case(CycleLoadAddressAbsolute): {
 						uint16_t nextPC = pc_.full+1;
 						pc_.full += 2;
 						address_.bytes.low = operand_;
 						read_mem(address_.bytes.high, nextPC);
 					} break;
 
-					case OperationLoadAddressZeroPage:
+					micro_op_case(OperationLoadAddressZeroPage):
 						pc_.full++;
 						address_.full = operand_;
-					continue;
+					next_micro_op();
 
-					case CycleLoadAddessZeroX:
+					micro_op_case(CycleLoadAddessZeroX):
 						pc_.full++;
 						address_.full = (operand_ + x_)&0xff;
 						throwaway_read(operand_);
 					break;
 
-					case CycleLoadAddessZeroY:
+					micro_op_case(CycleLoadAddessZeroY):
 						pc_.full++;
 						address_.full = (operand_ + y_)&0xff;
 						throwaway_read(operand_);
 					break;
 
-					case OperationIncrementPC:			pc_.full++;						continue;
-					case CycleFetchOperandFromAddress:	read_mem(operand_, address_.full);	break;
-					case CycleWriteOperandToAddress:	write_mem(operand_, address_.full);	break;
+					micro_op_case(OperationIncrementPC):			pc_.full++;						next_micro_op();
+					micro_op_case(CycleFetchOperandFromAddress):	read_mem(operand_, address_.full);	break;
+					micro_op_case(CycleWriteOperandToAddress):	write_mem(operand_, address_.full);	break;
 
 // MARK: - Branching
 
 #define BRA(condition)	\
 	pc_.full++; \
 	if(condition) {	\
-		scheduled_program_counter_ = do_branch;	\
+		scheduled_program_counter_ = do_branch_;	\
 	}
 
-					case OperationBPL: BRA(!(negative_result_&0x80));				continue;
-					case OperationBMI: BRA(negative_result_&0x80);					continue;
-					case OperationBVC: BRA(!overflow_flag_);						continue;
-					case OperationBVS: BRA(overflow_flag_);							continue;
-					case OperationBCC: BRA(!carry_flag_);							continue;
-					case OperationBCS: BRA(carry_flag_);							continue;
-					case OperationBNE: BRA(zero_result_);							continue;
-					case OperationBEQ: BRA(!zero_result_);							continue;
-					case OperationBRA: BRA(true);									continue;
+					micro_op_case(OperationBPL): BRA(!(negative_result_&0x80));				next_micro_op();
+					micro_op_case(OperationBMI): BRA(negative_result_&0x80);					next_micro_op();
+					micro_op_case(OperationBVC): BRA(!overflow_flag_);						next_micro_op();
+					micro_op_case(OperationBVS): BRA(overflow_flag_);							next_micro_op();
+					micro_op_case(OperationBCC): BRA(!carry_flag_);							next_micro_op();
+					micro_op_case(OperationBCS): BRA(carry_flag_);							next_micro_op();
+					micro_op_case(OperationBNE): BRA(zero_result_);							next_micro_op();
+					micro_op_case(OperationBEQ): BRA(!zero_result_);							next_micro_op();
+					micro_op_case(OperationBRA): BRA(true);									next_micro_op();
 
 #undef BRA
 
-					case CycleAddSignedOperandToPC:
+					micro_op_case(CycleAddSignedOperandToPC):
 						nextAddress.full = static_cast<uint16_t>(pc_.full + (int8_t)operand_);
 						pc_.bytes.low = nextAddress.bytes.low;
 						if(nextAddress.bytes.high != pc_.bytes.high) {
@@ -593,53 +682,40 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 							// 65C02 modification to all branches: a branch that is taken but requires only a single cycle
 							// to target its destination skips any pending interrupts.
 							// Cf. http://forum.6502.org/viewtopic.php?f=4&t=1634
-							scheduled_program_counter_ = fetch_decode_execute;
+							scheduled_program_counter_ = fetch_decode_execute_;
 						}
-					continue;
+					next_micro_op();
 
-					case CycleFetchFromHalfUpdatedPC: {
+					micro_op_case(CycleFetchFromHalfUpdatedPC): {
 						uint16_t halfUpdatedPc = static_cast<uint16_t>(((pc_.bytes.low + (int8_t)operand_) & 0xff) | (pc_.bytes.high << 8));
 						throwaway_read(halfUpdatedPc);
 					} break;
 
-					case OperationAddSignedOperandToPC16:
+					micro_op_case(OperationAddSignedOperandToPC16):
 						pc_.full = static_cast<uint16_t>(pc_.full + (int8_t)operand_);
-					continue;
+					next_micro_op();
 
-					case OperationBBRBBS: {
+					micro_op_case(OperationBBRBBS): {
 						// To reach here, the 6502 has (i) read the operation; (ii) read the first operand;
 						// and (iii) read from the corresponding zero page.
 						const uint8_t mask = static_cast<uint8_t>(1 << ((operation_ >> 4)&7));
 						if((operand_ & mask) == ((operation_ & 0x80) ? mask : 0)) {
-							static const MicroOp do_branch[] = {
-								CycleFetchOperand,			// Fetch offset.
-								OperationIncrementPC,
-								CycleFetchFromHalfUpdatedPC,
-								OperationAddSignedOperandToPC16,
-								OperationMoveToNextProgram
-							};
-							scheduled_program_counter_ = do_branch;
+							scheduled_program_counter_ = do_bbr_bbs_branch_;
 						} else {
-							static const MicroOp do_not_branch[] = {
-								CycleFetchOperand,
-								OperationIncrementPC,
-								CycleFetchFromHalfUpdatedPC,
-								OperationMoveToNextProgram
-							};
-							scheduled_program_counter_ = do_not_branch;
+							scheduled_program_counter_ = do_not_bbr_bbs_branch_;
 						}
 					} break;
 
 // MARK: - Transfers
 
-					case OperationTXA: zero_result_ = negative_result_ = a_ = x_;	continue;
-					case OperationTYA: zero_result_ = negative_result_ = a_ = y_;	continue;
-					case OperationTXS: s_ = x_;										continue;
-					case OperationTAY: zero_result_ = negative_result_ = y_ = a_;	continue;
-					case OperationTAX: zero_result_ = negative_result_ = x_ = a_;	continue;
-					case OperationTSX: zero_result_ = negative_result_ = x_ = s_;	continue;
+					micro_op_case(OperationTXA): zero_result_ = negative_result_ = a_ = x_;	next_micro_op();
+					micro_op_case(OperationTYA): zero_result_ = negative_result_ = a_ = y_;	next_micro_op();
+					micro_op_case(OperationTXS): s_ = x_;										next_micro_op();
+					micro_op_case(OperationTAY): zero_result_ = negative_result_ = y_ = a_;	next_micro_op();
+					micro_op_case(OperationTAX): zero_result_ = negative_result_ = x_ = a_;	next_micro_op();
+					micro_op_case(OperationTSX): zero_result_ = negative_result_ = x_ = s_;	next_micro_op();
 
-					case OperationARR:
+					micro_op_case(OperationARR):
 						if(decimal_flag_) {
 							a_ &= operand_;
 							uint8_t unshiftedA = a_;
@@ -658,15 +734,15 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 							carry_flag_ = (a_ >> 6)&1;
 							overflow_flag_ = (a_^(a_ << 1))&Flag::Overflow;
 						}
-					continue;
+					next_micro_op();
 
-					case OperationSBX:
+					micro_op_case(OperationSBX):
 						x_ &= a_;
 						uint16_t difference = x_ - operand_;
 						x_ = static_cast<uint8_t>(difference);
 						negative_result_ = zero_result_ = x_;
 						carry_flag_ = ((difference >> 8)&1)^1;
-					continue;
+					next_micro_op();
 				}
 
 				if(has_stpwai(personality) && (stop_is_active_ || wait_is_active_)) {
@@ -688,6 +764,8 @@ template <Personality personality, typename T, bool uses_ready_line> void Proces
 	bus_value_ = busValue;
 
 	bus_handler_.flush();
+
+#undef micro_op_case
 }
 
 template <Personality personality, typename T, bool uses_ready_line> void Processor<personality, T, uses_ready_line>::set_ready_line(bool active) {
@@ -731,53 +809,15 @@ void ProcessorBase::set_nmi_line(bool active) {
 }
 
 inline const ProcessorStorage::MicroOp *ProcessorStorage::get_reset_program() {
-	static const MicroOp reset[] = {
-		CycleFetchOperand,
-		CycleFetchOperand,
-		CycleNoWritePush,
-		CycleNoWritePush,
-		OperationRSTPickVector,
-		CycleNoWritePush,
-		OperationSetNMIRSTFlags,
-		CycleReadVectorLow,
-		CycleReadVectorHigh,
-		OperationMoveToNextProgram
-	};
-	return reset;
+	return reset_program_;
 }
 
 inline const ProcessorStorage::MicroOp *ProcessorStorage::get_irq_program() {
-	static const MicroOp reset[] = {
-		CycleFetchOperand,
-		CycleFetchOperand,
-		CyclePushPCH,
-		CyclePushPCL,
-		OperationBRKPickVector,
-		OperationSetOperandFromFlags,
-		CyclePushOperand,
-		OperationSetIRQFlags,
-		CycleReadVectorLow,
-		CycleReadVectorHigh,
-		OperationMoveToNextProgram
-	};
-	return reset;
+	return irq_program_;
 }
 
 inline const ProcessorStorage::MicroOp *ProcessorStorage::get_nmi_program() {
-	static const MicroOp reset[] = {
-		CycleFetchOperand,
-		CycleFetchOperand,
-		CyclePushPCH,
-		CyclePushPCL,
-		OperationNMIPickVector,
-		OperationSetOperandFromFlags,
-		CyclePushOperand,
-		OperationSetNMIRSTFlags,
-		CycleReadVectorLow,
-		CycleReadVectorHigh,
-		OperationMoveToNextProgram
-	};
-	return reset;
+	return nmi_program_;
 }
 
 uint8_t ProcessorStorage::get_flags() {
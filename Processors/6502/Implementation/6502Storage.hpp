@@ -202,6 +202,18 @@ class ProcessorStorage {
 
 		const MicroOp *scheduled_program_counter_ = nullptr;
 
+		/*
+			Programs that aren't specific to a single operation; these are kept here rather than
+			locally to run_for so that a position within any of them can be serialised.
+		*/
+		static const MicroOp fetch_decode_execute_[];
+		static const MicroOp do_branch_[];
+		static const MicroOp do_bbr_bbs_branch_[];
+		static const MicroOp do_not_bbr_bbs_branch_[];
+		static const MicroOp reset_program_[];
+		static const MicroOp irq_program_[];
+		static const MicroOp nmi_program_[];
+
 		/*
 			Storage for the 6502 registers; F is stored as individual flags.
 		*/
@@ -215,6 +227,12 @@ class ProcessorStorage {
 		uint8_t operation_, operand_;
 		RegisterPair address_, next_address_;
 
+		/*
+			The operation before the current one, and its address; kept only to spot idle loops.
+		*/
+		uint8_t previous_operation_ = 0x00;
+		RegisterPair previous_operation_pc_;
+
 		/*
 			Temporary storage allowing a common dispatch point for calling perform_bus_operation;
 			possibly deferring is no longer of value.
@@ -222,6 +240,7 @@ class ProcessorStorage {
 		BusOperation next_bus_operation_ = BusOperation::None;
 		uint16_t bus_address_;
 		uint8_t *bus_value_;
+		uint8_t throwaway_target_;
 
 		/*!
 			Gets the flags register.
@@ -261,6 +280,17 @@ class ProcessorStorage {
 		uint8_t irq_line_ = 0, irq_request_history_ = 0;
 		bool nmi_line_is_enabled_ = false, set_overflow_line_is_enabled_ = false;
 
+#ifdef PROFILE_PROCESSORS
+		ProcessorProfile profile_{"6502", 1, 1};
+
+		/// Records a bus access for profiling purposes; each is counted as a single cycle.
+		inline void profile_bus_access(BusOperation operation, uint16_t address) {
+			profile_.did_run_for(1);
+			if(operation == BusOperation::Write) profile_.did_write(address);
+			else if(isReadOperation(operation)) profile_.did_read(address);
+		}
+#endif
+
 		/*!
 			Gets the program representing an RST response.
 
@@ -0,0 +1,50 @@
+//
+//  AllRAMBatchRunner.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#include "AllRAMBatchRunner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+using namespace CPU;
+
+AllRAMBatchRunner::AllRAMBatchRunner(std::size_t number_of_threads) :
+	number_of_threads_(number_of_threads ? number_of_threads : std::max(std::thread::hardware_concurrency(), 1u)) {}
+
+void AllRAMBatchRunner::run(std::vector<Job> &jobs) {
+	// Workers claim jobs in order until none remain.
+	std::atomic<std::size_t> next_job(0);
+	const auto worker = [&jobs, &next_job] {
+		while(true) {
+			const std::size_t index = next_job.fetch_add(1, std::memory_order_relaxed);
+			if(index >= jobs.size()) return;
+
+			Job &job = jobs[index];
+			const Cycles step = (job.step > Cycles(0)) ? job.step : job.budget;
+			Cycles cycles_run(0);
+			while(cycles_run < job.budget) {
+				const Cycles next_step = std::min(step, job.budget - cycles_run);
+				job.processor->run_for(next_step);
+				cycles_run += next_step;
+				if(job.is_finished && job.is_finished(*job.processor)) break;
+			}
+			job.cycles_run = cycles_run;
+		}
+	};
+
+	const std::size_t number_of_threads = std::min(number_of_threads_, jobs.size());
+	std::vector<std::thread> threads;
+	for(std::size_t c = 1; c < number_of_threads; ++c) {
+		threads.emplace_back(worker);
+	}
+	worker();
+	for(auto &thread: threads) {
+		thread.join();
+	}
+}
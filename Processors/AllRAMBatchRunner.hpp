@@ -0,0 +1,65 @@
+//
+//  AllRAMBatchRunner.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#ifndef AllRAMBatchRunner_hpp
+#define AllRAMBatchRunner_hpp
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "AllRAMProcessor.hpp"
+
+namespace CPU {
+
+/*!
+	Runs any number of independent all-RAM processors, of any mix of types, across a pool of worker threads.
+
+	Jobs share nothing: each processor has its own memory and traps, and each job is claimed by exactly
+	one worker, so no locks are taken while running. Trap handlers and completion tests are called on
+	whichever thread is running the relevant job, and should touch nothing other than that job's state.
+*/
+class AllRAMBatchRunner {
+	public:
+		struct Job {
+			/// The processor to run.
+			std::unique_ptr<AllRAMProcessor> processor;
+
+			/// The maximum number of cycles for which to run.
+			Cycles budget = Cycles(0);
+
+			/// The granularity at which @c is_finished is tested.
+			Cycles step = Cycles(1000);
+
+			/// If supplied, called after each step; the job ends as soon as it returns @c true.
+			std::function<bool(AllRAMProcessor &)> is_finished;
+
+			/// Set upon completion to the number of cycles actually run.
+			Cycles cycles_run = Cycles(0);
+		};
+
+		/*!
+			Constructs a runner with @c number_of_threads workers; if that is zero then one worker
+			is used per hardware thread.
+		*/
+		AllRAMBatchRunner(std::size_t number_of_threads = 0);
+
+		/*!
+			Runs every job in @c jobs until it either exhausts its budget or declares itself finished,
+			returning only once all have done so. The calling thread acts as one of the workers.
+		*/
+		void run(std::vector<Job> &jobs);
+
+	private:
+		std::size_t number_of_threads_;
+};
+
+}
+
+#endif /* AllRAMBatchRunner_hpp */
@@ -8,12 +8,15 @@
 
 #include "AllRAMProcessor.hpp"
 
+#include <cstring>
+
 using namespace CPU;
 
 AllRAMProcessor::AllRAMProcessor(std::size_t memory_size) :
 	memory_(memory_size),
-	traps_(memory_size, false),
-	timestamp_(0) {}
+	timestamp_(0),
+	opcode_fetch_count_(0),
+	traps_(memory_size, false) {}
 
 void AllRAMProcessor::set_data_at_address(uint16_t startAddress, std::size_t length, const uint8_t *data) {
 	std::size_t endAddress = std::min(startAddress + length, static_cast<std::size_t>(65536));
@@ -29,6 +32,10 @@ HalfCycles AllRAMProcessor::get_timestamp() {
 	return timestamp_;
 }
 
+uint64_t AllRAMProcessor::get_opcode_fetch_count() {
+	return opcode_fetch_count_;
+}
+
 void AllRAMProcessor::set_trap_handler(TrapHandler *trap_handler) {
 	trap_handler_ = trap_handler;
 }
@@ -20,7 +20,11 @@ namespace CPU {
 class AllRAMProcessor {
 	public:
 		AllRAMProcessor(std::size_t memory_size);
+		virtual ~AllRAMProcessor() {}
+
+		virtual void run_for(const Cycles cycles) = 0;
 		HalfCycles get_timestamp();
+		uint64_t get_opcode_fetch_count();
 		void set_data_at_address(uint16_t startAddress, std::size_t length, const uint8_t *data);
 		void get_data_at_address(uint16_t startAddress, std::size_t length, uint8_t *data);
 
@@ -34,6 +38,7 @@ class AllRAMProcessor {
 	protected:
 		std::vector<uint8_t> memory_;
 		HalfCycles timestamp_;
+		uint64_t opcode_fetch_count_;
 
 		inline void check_address_for_trap(uint16_t address) {
 			if(traps_[address]) {
@@ -0,0 +1,139 @@
+//
+//  Profile.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#include "Profile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+using namespace CPU;
+
+namespace {
+
+const char signature[] = "CLKPROF1";
+const std::size_t signature_length = 8;
+
+void put_le(std::ostream &stream, uint64_t value, int bytes) {
+	for(int c = 0; c < bytes; ++c) {
+		stream.put(static_cast<char>(value & 0xff));
+		value >>= 8;
+	}
+}
+
+uint64_t get_le(std::istream &stream, int bytes) {
+	uint64_t result = 0;
+	for(int c = 0; c < bytes; ++c) {
+		result |= static_cast<uint64_t>(static_cast<uint8_t>(stream.get())) << (c * 8);
+	}
+	return result;
+}
+
+void put_table(std::ostream &stream, const std::vector<uint64_t> &table) {
+	for(const auto value: table) put_le(stream, value, 8);
+}
+
+void get_table(std::istream &stream, std::vector<uint64_t> &table) {
+	for(auto &value: table) value = get_le(stream, 8);
+}
+
+std::mutex &registry_mutex() {
+	static std::mutex mutex;
+	return mutex;
+}
+
+std::vector<const Profile *> &registry() {
+	static std::vector<const Profile *> profiles;
+	return profiles;
+}
+
+}
+
+Profile::Profile(const std::string &name, int opcode_pages, int time_units_per_cycle) :
+	name_(name),
+	opcode_pages_(opcode_pages),
+	time_units_per_cycle_(time_units_per_cycle),
+	instructions_(65536),
+	time_(65536),
+	opcodes_(static_cast<std::size_t>(opcode_pages) * 256),
+	reads_(256),
+	writes_(256) {}
+
+void Profile::reset() {
+	current_address_ = 0;
+	for(auto table: {&instructions_, &time_, &opcodes_, &reads_, &writes_}) {
+		std::fill(table->begin(), table->end(), 0);
+	}
+}
+
+bool Profile::save(const std::string &file_name) const {
+	std::ofstream file(file_name, std::ios::binary);
+	if(!file) return false;
+
+	file.write(signature, signature_length);
+	put_le(file, name_.size(), 4);
+	file.write(name_.data(), static_cast<std::streamsize>(name_.size()));
+	put_le(file, static_cast<uint64_t>(opcode_pages_), 4);
+	put_le(file, static_cast<uint64_t>(time_units_per_cycle_), 4);
+
+	put_table(file, instructions_);
+	put_table(file, time_);
+	put_table(file, opcodes_);
+	put_table(file, reads_);
+	put_table(file, writes_);
+
+	return !!file;
+}
+
+bool Profile::load(const std::string &file_name) {
+	std::ifstream file(file_name, std::ios::binary);
+	if(!file) return false;
+
+	char file_signature[signature_length];
+	file.read(file_signature, signature_length);
+	if(!file || std::memcmp(file_signature, signature, signature_length)) return false;
+
+	// Names and page counts are sanity checked before anything is allocated.
+	const auto name_length = static_cast<std::size_t>(get_le(file, 4));
+	if(!file || name_length > 256) return false;
+	std::string name(name_length, '\0');
+	if(name_length) file.read(&name[0], static_cast<std::streamsize>(name_length));
+
+	const auto opcode_pages = static_cast<int>(get_le(file, 4));
+	const auto time_units_per_cycle = static_cast<int>(get_le(file, 4));
+	if(!file || opcode_pages < 1 || opcode_pages > 256 || time_units_per_cycle < 1) return false;
+
+	Profile profile(name, opcode_pages, time_units_per_cycle);
+	get_table(file, profile.instructions_);
+	get_table(file, profile.time_);
+	get_table(file, profile.opcodes_);
+	get_table(file, profile.reads_);
+	get_table(file, profile.writes_);
+	if(!file) return false;
+
+	*this = std::move(profile);
+	return true;
+}
+
+ProcessorProfile::ProcessorProfile(const std::string &name, int opcode_pages, int time_units_per_cycle) :
+	Profile(name, opcode_pages, time_units_per_cycle) {
+	std::lock_guard<std::mutex> lock_guard(registry_mutex());
+	registry().push_back(this);
+}
+
+ProcessorProfile::~ProcessorProfile() {
+	std::lock_guard<std::mutex> lock_guard(registry_mutex());
+	auto &profiles = registry();
+	profiles.erase(std::remove(profiles.begin(), profiles.end(), this), profiles.end());
+}
+
+std::vector<const Profile *> ProcessorProfile::all() {
+	std::lock_guard<std::mutex> lock_guard(registry_mutex());
+	return registry();
+}
@@ -0,0 +1,132 @@
+//
+//  Profile.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#ifndef Processors_Profile_hpp
+#define Processors_Profile_hpp
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+	Processor profiling is optional, and is compiled out completely unless PROFILE_PROCESSORS
+	is defined. Processors wrap each profiling hook in profile_processor(...) so that, when it
+	isn't, not even the hook's arguments are evaluated.
+*/
+#ifdef PROFILE_PROCESSORS
+#define profile_processor(...)	__VA_ARGS__
+#else
+#define profile_processor(...)
+#endif
+
+namespace CPU {
+
+/*!
+	Accumulates an execution profile for a processor with a 16-bit address bus: the number of instructions
+	begun at, and the time spent executing instructions from, each address; the number of times each opcode
+	was decoded, per opcode page; and the number of reads and writes to each 256-byte page of memory.
+
+	All counts are held in fixed-size tables, allocated at construction, so recording never allocates.
+
+	A profile can be saved to and loaded from a file. The format is:
+
+		8 bytes: "CLKPROF1"
+		4 bytes: length of processor name, n
+		n bytes: processor name
+		4 bytes: number of opcode pages, p
+		4 bytes: number of time units per processor cycle
+		65536 * 8 bytes: instructions begun, by address
+		65536 * 8 bytes: time spent, by address of instruction
+		p * 256 * 8 bytes: opcodes decoded, by page then opcode
+		256 * 8 bytes: reads, by memory page
+		256 * 8 bytes: writes, by memory page
+
+	All numbers are little endian and unsigned.
+*/
+class Profile {
+	public:
+		/*!
+			Constructs an empty profile for the processor named @c name, which has @c opcode_pages pages of
+			256 opcodes and will report time in units of 1/@c time_units_per_cycle of a cycle.
+		*/
+		Profile(const std::string &name = "", int opcode_pages = 1, int time_units_per_cycle = 1);
+
+		/// Records that an instruction is beginning at @c address; subsequent time is attributed to it.
+		inline void did_begin_instruction(uint16_t address) {
+			current_address_ = address;
+			++instructions_[address];
+		}
+
+		/// Records that @c opcode has been decoded from opcode page @c page.
+		inline void did_decode(int page, uint8_t opcode) {
+			++opcodes_[static_cast<std::size_t>((page << 8) | opcode)];
+		}
+
+		/// Records that @c time units have passed during the current instruction.
+		inline void did_run_for(int time) {
+			time_[current_address_] += static_cast<uint64_t>(time);
+		}
+
+		/// Records a read from @c address.
+		inline void did_read(uint16_t address) {
+			++reads_[address >> 8];
+		}
+
+		/// Records a write to @c address.
+		inline void did_write(uint16_t address) {
+			++writes_[address >> 8];
+		}
+
+		/// Resets all counts to zero.
+		void reset();
+
+		/// Writes this profile to @c file_name. @returns @c true on success; @c false otherwise.
+		bool save(const std::string &file_name) const;
+
+		/// Replaces this profile with that in @c file_name. @returns @c true on success; @c false otherwise.
+		bool load(const std::string &file_name);
+
+		const std::string &get_name() const					{	return name_;					}
+		int get_number_of_opcode_pages() const				{	return opcode_pages_;			}
+		int get_time_units_per_cycle() const				{	return time_units_per_cycle_;	}
+
+		const std::vector<uint64_t> &get_instructions() const	{	return instructions_;	}
+		const std::vector<uint64_t> &get_time() const			{	return time_;			}
+		const std::vector<uint64_t> &get_opcodes() const		{	return opcodes_;		}
+		const std::vector<uint64_t> &get_reads() const			{	return reads_;			}
+		const std::vector<uint64_t> &get_writes() const			{	return writes_;			}
+
+	private:
+		std::string name_;
+		int opcode_pages_;
+		int time_units_per_cycle_;
+
+		uint16_t current_address_ = 0;
+		std::vector<uint64_t> instructions_, time_, opcodes_, reads_, writes_;
+};
+
+/*!
+	A profile that is owned by a live processor. Every such profile registers itself upon construction
+	and unregisters upon destruction, so that a host can find and save the profiles of all processors
+	that currently exist without needing to know which machine owns them.
+*/
+class ProcessorProfile: public Profile {
+	public:
+		ProcessorProfile(const std::string &name, int opcode_pages, int time_units_per_cycle);
+		~ProcessorProfile();
+
+		ProcessorProfile(const ProcessorProfile &) = delete;
+		ProcessorProfile &operator =(const ProcessorProfile &) = delete;
+
+		/// @returns All processor profiles currently in existence, in order of creation.
+		static std::vector<const Profile *> all();
+};
+
+}
+
+#endif /* Processors_Profile_hpp */
@@ -8,11 +8,13 @@
 
 #include "Z80AllRAM.hpp"
 #include <algorithm>
+#include <cstdio>
+#include <limits>
 
 using namespace CPU::Z80;
 namespace {
 
-class ConcreteAllRAMProcessor: public AllRAMProcessor, public BusHandler {
+template <bool coalesces_bus_cycles> class ConcreteAllRAMProcessor: public AllRAMProcessor, public BusHandler {
 	public:
 		ConcreteAllRAMProcessor() : AllRAMProcessor(), z80_(*this) {}
 
@@ -25,6 +27,7 @@ class ConcreteAllRAMProcessor: public AllRAMProcessor, public BusHandler {
 			uint16_t address = cycle.address ? *cycle.address : 0x0000;
 			switch(cycle.operation) {
 				case PartialMachineCycle::ReadOpcode:
+					++opcode_fetch_count_;
 					check_address_for_trap(address);
 				case PartialMachineCycle::Read:
 					*cycle.value = memory_[address];
@@ -63,6 +66,12 @@ class ConcreteAllRAMProcessor: public AllRAMProcessor, public BusHandler {
 			return HalfCycles(0);
 		}
 
+		HalfCycles get_idle_limit() {
+			// Interrupt inputs change only between calls to run_for, so a coalescing processor may fold cycles
+			// together indefinitely. The precise processor continues to observe every cycle.
+			return coalesces_bus_cycles ? HalfCycles(std::numeric_limits<int>::max()) : HalfCycles(0);
+		}
+
 		void run_for(const Cycles cycles) {
 			z80_.run_for(cycles);
 		}
@@ -96,11 +105,12 @@ class ConcreteAllRAMProcessor: public AllRAMProcessor, public BusHandler {
 		}
 
 	private:
-		CPU::Z80::Processor<ConcreteAllRAMProcessor, false, true> z80_;
+		CPU::Z80::Processor<ConcreteAllRAMProcessor, false, true, coalesces_bus_cycles> z80_;
 };
 
 }
 
-AllRAMProcessor *AllRAMProcessor::Processor() {
-	return new ConcreteAllRAMProcessor;
+AllRAMProcessor *AllRAMProcessor::Processor(bool coalesces_bus_cycles) {
+	if(coalesces_bus_cycles) return new ConcreteAllRAMProcessor<true>;
+	return new ConcreteAllRAMProcessor<false>;
 }
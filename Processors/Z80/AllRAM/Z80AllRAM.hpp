@@ -19,7 +19,12 @@ class AllRAMProcessor:
 	public ::CPU::AllRAMProcessor {
 
 	public:
-		static AllRAMProcessor *Processor();
+		/*!
+			@returns A new all-RAM Z80. If @c coalesces_bus_cycles is @c true then the memory access delegate
+			will be informed only of reads, writes, inputs, outputs and interrupt acknowledges, with the time
+			spent in all other partial machine cycles accumulated into their time stamps.
+		*/
+		static AllRAMProcessor *Processor(bool coalesces_bus_cycles = false);
 
 		struct MemoryAccessDelegate {
 			virtual void z80_all_ram_processor_did_perform_bus_operation(CPU::Z80::AllRAMProcessor &processor, CPU::Z80::PartialMachineCycle::Operation operation, uint16_t address, uint8_t value, HalfCycles time_stamp) = 0;
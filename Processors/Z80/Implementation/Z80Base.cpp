@@ -15,6 +15,12 @@ void ProcessorBase::reset_power_on() {
 	last_request_status_ &= ~Interrupt::PowerOn;
 }
 
+void ProcessorBase::abandon_instruction() {
+	reset_power_on();
+	scheduled_program_counter_ = nullptr;
+	halt_mask_ = 0xff;
+}
+
 uint16_t ProcessorBase::get_value_of_register(Register r) {
 	switch (r) {
 		case Register::ProgramCounter:			return pc_.full;
@@ -119,3 +125,89 @@ void ProcessorBase::set_value_of_register(Register r, uint16_t value) {
 		default: break;
 	}
 }
+
+void ProcessorBase::serialise(Storage::State::Serialiser &serialiser) {
+	serialiser.begin_section("Z80 ", 2);
+
+	// Registers.
+	serialiser.field(a_);
+	serialiser.field(bc_.full);
+	serialiser.field(de_.full);
+	serialiser.field(hl_.full);
+	serialiser.field(afDash_.full);
+	serialiser.field(bcDash_.full);
+	serialiser.field(deDash_.full);
+	serialiser.field(hlDash_.full);
+	serialiser.field(ix_.full);
+	serialiser.field(iy_.full);
+	serialiser.field(pc_.full);
+	serialiser.field(sp_.full);
+	serialiser.field(ir_.full);
+	serialiser.field(refresh_addr_.full);
+	serialiser.field(iff1_);
+	serialiser.field(iff2_);
+	serialiser.field(interrupt_mode_);
+
+	// Flags, in their unpacked form.
+	serialiser.field(sign_result_);
+	serialiser.field(zero_result_);
+	serialiser.field(half_carry_result_);
+	serialiser.field(bit53_result_);
+	serialiser.field(parity_overflow_result_);
+	serialiser.field(subtract_flag_);
+	serialiser.field(carry_result_);
+	serialiser.field(flag_adjustment_history_);
+
+	// Inputs and interrupt state.
+	serialiser.field(halt_mask_);
+	serialiser.field(request_status_);
+	serialiser.field(last_request_status_);
+	serialiser.field(irq_line_);
+	serialiser.field(nmi_line_);
+	serialiser.field(bus_request_line_);
+	serialiser.field(wait_line_);
+
+	// Execution state.
+	serialiser.field(number_of_cycles_);
+	serialiser.field(pc_increment_);
+	serialiser.field(operation_);
+	serialiser.field(temp16_.full);
+	serialiser.field(memptr_.full);
+	serialiser.field(temp8_);
+
+	// The current instruction page is stored as an index into the fixed list of instruction
+	// pages, and the program position as an offset into the table of micro-ops.
+	InstructionPage *const pages[] = {
+		&base_page_, &ed_page_, &fd_page_, &dd_page_, &cb_page_, &fdcb_page_, &ddcb_page_
+	};
+	const int page_count = sizeof(pages) / sizeof(*pages);
+
+	int page = -1, offset = -1;
+	if(serialiser.is_capturing()) {
+		for(int c = 0; c < page_count; ++c) {
+			if(pages[c] == current_instruction_page_) page = c;
+		}
+		if(scheduled_program_counter_) offset = static_cast<int>(scheduled_program_counter_ - micro_ops_.data());
+	}
+	serialiser.field(page);
+	serialiser.field(offset);
+
+	if(!serialiser.is_capturing() && serialiser.is_valid()) {
+		if(
+			page < 0 || page >= page_count ||
+			offset < -1 || offset >= static_cast<int>(micro_ops_.size())
+		) {
+			serialiser.set_invalid();
+		} else {
+			current_instruction_page_ = pages[page];
+			scheduled_program_counter_ = (offset >= 0) ? &micro_ops_[static_cast<size_t>(offset)] : nullptr;
+		}
+	}
+
+	serialiser.end_section();
+}
+
+void ProcessorBase::set_direct_memory(uint16_t address, const uint8_t *read, uint8_t *write) {
+	direct_read_pointers_[address >> 10] = read;
+	direct_write_pointers_[address >> 10] = write;
+}
@@ -8,7 +8,8 @@
 
 template <	class T,
 			bool uses_bus_request,
-			bool uses_wait_line> Processor <T, uses_bus_request, uses_wait_line>
+			bool uses_wait_line,
+			bool coalesces_bus_cycles> Processor <T, uses_bus_request, uses_wait_line, coalesces_bus_cycles>
 				::Processor(T &bus_handler) :
 					bus_handler_(bus_handler) {
 	install_default_instruction_set();
@@ -16,7 +17,8 @@ template <	class T,
 
 template <	class T,
 			bool uses_bus_request,
-			bool uses_wait_line> void Processor <T, uses_bus_request, uses_wait_line>
+			bool uses_wait_line,
+			bool coalesces_bus_cycles> void Processor <T, uses_bus_request, uses_wait_line, coalesces_bus_cycles>
 				::run_for(const HalfCycles cycles) {
 #define advance_operation() \
 	pc_increment_ = 1;	\
@@ -24,19 +26,29 @@ template <	class T,
 		halt_mask_ = 0xff;	\
 		if(last_request_status_ & (Interrupt::PowerOn | Interrupt::Reset)) {	\
 			request_status_ &= ~Interrupt::PowerOn;	\
-			scheduled_program_counter_ = reset_program_.data();	\
+			scheduled_program_counter_ = &micro_ops_[reset_program_];	\
 		} else if(last_request_status_ & Interrupt::NMI) {	\
 			request_status_ &= ~Interrupt::NMI;	\
-			scheduled_program_counter_ = nmi_program_.data();	\
+			scheduled_program_counter_ = &micro_ops_[nmi_program_];	\
 		} else if(last_request_status_ & Interrupt::IRQ) {	\
-			scheduled_program_counter_ = irq_program_[interrupt_mode_].data();	\
+			scheduled_program_counter_ = &micro_ops_[irq_program_[interrupt_mode_]];	\
 		}	\
 	} else {	\
 		current_instruction_page_ = &base_page_;	\
-		scheduled_program_counter_ = base_page_.fetch_decode_execute_data;	\
+		scheduled_program_counter_ = &micro_ops_[base_page_.fetch_decode_execute];	\
+		profile_processor(profile_.did_begin_instruction(pc_.full));	\
+		if(!halt_mask_ && !request_status_) skip_halted_fetches();	\
+	}
+
+#define announce_coalesced_cycles() \
+	if(coalesces_bus_cycles && coalesced_length_ > HalfCycles(0)) {	\
+		number_of_cycles_ -= bus_handler_.perform_machine_cycle(PartialMachineCycle(PartialMachineCycle::Internal, coalesced_length_, nullptr, nullptr, false));	\
+		coalesced_length_ = 0;	\
+		coalesced_limit_ = bus_handler_.get_idle_limit();	\
 	}
 
 	number_of_cycles_ += cycles;
+	if(coalesces_bus_cycles) coalesced_limit_ = bus_handler_.get_idle_limit();
 	if(!scheduled_program_counter_) {
 		advance_operation();
 	}
@@ -45,8 +57,10 @@ template <	class T,
 
 		do_bus_acknowledge:
 		while(uses_bus_request && bus_request_line_) {
+			announce_coalesced_cycles();
 			static PartialMachineCycle bus_acknowledge_cycle = {PartialMachineCycle::BusAcknowledge, HalfCycles(2), nullptr, nullptr, false};
 			number_of_cycles_ -= bus_handler_.perform_machine_cycle(bus_acknowledge_cycle) + HalfCycles(1);
+			if(coalesces_bus_cycles) coalesced_limit_ = bus_handler_.get_idle_limit();
 			if(!number_of_cycles_) {
 				bus_handler_.flush();
 				return;
@@ -54,7 +68,7 @@ template <	class T,
 		}
 
 		while(true) {
-			const MicroOp *const operation = scheduled_program_counter_;
+			const CompiledMicroOp *const operation = scheduled_program_counter_;
 			scheduled_program_counter_++;
 
 #define set_did_compute_flags()	\
@@ -67,45 +81,63 @@ template <	class T,
 	parity_overflow_result_ ^= parity_overflow_result_ >> 1;
 
 			switch(operation->type) {
-				case MicroOp::BusOperation:
-					if(number_of_cycles_ < operation->machine_cycle.length) {
+				case MicroOp::BusOperation: {
+					const PartialMachineCycle &machine_cycle = machine_cycles_[operation->machine_cycle];
+					if(number_of_cycles_ < machine_cycle.length) {
 						scheduled_program_counter_--;
+						announce_coalesced_cycles();
 						bus_handler_.flush();
 						return;
 					}
-					if(uses_wait_line && operation->machine_cycle.was_requested) {
+					if(uses_wait_line && machine_cycle.was_requested) {
 						if(wait_line_) {
 							scheduled_program_counter_--;
 						} else {
 							continue;
 						}
 					}
-					number_of_cycles_ -= operation->machine_cycle.length;
+					number_of_cycles_ -= machine_cycle.length;
 					last_request_status_ = request_status_;
-					number_of_cycles_ -= bus_handler_.perform_machine_cycle(operation->machine_cycle);
+					profile_processor(profile_machine_cycle(machine_cycle));
+					if(coalesces_bus_cycles) {
+						// Fold this cycle into those pending if the bus handler has permitted that much time to pass
+						// unobserved, and if it either doesn't access the bus or can be performed directly upon memory.
+						const HalfCycles folded_length = coalesced_length_ + machine_cycle.length;
+						if(folded_length < coalesced_limit_ && (!machine_cycle.expects_action() || perform_direct_access(machine_cycle))) {
+							coalesced_length_ = folded_length;
+							break;
+						}
+						number_of_cycles_ -= bus_handler_.perform_machine_cycle(PartialMachineCycle(machine_cycle, folded_length));
+						coalesced_length_ = 0;
+						coalesced_limit_ = bus_handler_.get_idle_limit();
+					} else {
+						number_of_cycles_ -= bus_handler_.perform_machine_cycle(machine_cycle);
+					}
 					if(uses_bus_request && bus_request_line_) goto do_bus_acknowledge;
-				break;
+				} break;
 				case MicroOp::MoveToNextProgram:
 					advance_operation();
 				break;
 				case MicroOp::DecodeOperation:
+					profile_processor(profile_decode());
 					refresh_addr_ = ir_;
 					ir_.bytes.low = (ir_.bytes.low & 0x80) | ((ir_.bytes.low + current_instruction_page_->r_step) & 0x7f);
 					pc_.full += pc_increment_ & static_cast<uint16_t>(halt_mask_);
-					scheduled_program_counter_ = current_instruction_page_->instructions[operation_ & halt_mask_];
+					scheduled_program_counter_ = &micro_ops_[current_instruction_page_->instructions[operation_ & halt_mask_]];
 					flag_adjustment_history_ <<= 1;
 				break;
 				case MicroOp::DecodeOperationNoRChange:
+					profile_processor(profile_decode());
 					refresh_addr_ = ir_;
 					pc_.full += pc_increment_ & static_cast<uint16_t>(halt_mask_);
-					scheduled_program_counter_ = current_instruction_page_->instructions[operation_ & halt_mask_];
+					scheduled_program_counter_ = &micro_ops_[current_instruction_page_->instructions[operation_ & halt_mask_]];
 				break;
 
-				case MicroOp::Increment16:			(*static_cast<uint16_t *>(operation->source))++;		break;
+				case MicroOp::Increment16:			(*static_cast<uint16_t *>(operands_[operation->source]))++;		break;
 				case MicroOp::IncrementPC:			pc_.full += pc_increment_;								break;
-				case MicroOp::Decrement16:			(*static_cast<uint16_t *>(operation->source))--;		break;
-				case MicroOp::Move8:				*static_cast<uint8_t *>(operation->destination) = *static_cast<uint8_t *>(operation->source);		break;
-				case MicroOp::Move16:				*static_cast<uint16_t *>(operation->destination) = *static_cast<uint16_t *>(operation->source);		break;
+				case MicroOp::Decrement16:			(*static_cast<uint16_t *>(operands_[operation->source]))--;		break;
+				case MicroOp::Move8:				*static_cast<uint8_t *>(operands_[operation->destination]) = *static_cast<uint8_t *>(operands_[operation->source]);		break;
+				case MicroOp::Move16:				*static_cast<uint16_t *>(operands_[operation->destination]) = *static_cast<uint16_t *>(operands_[operation->source]);		break;
 
 				case MicroOp::AssembleAF:
 					temp16_.bytes.high = a_;
@@ -128,17 +160,17 @@ template <	class T,
 	set_did_compute_flags();
 
 				case MicroOp::And:
-					a_ &= *static_cast<uint8_t *>(operation->source);
+					a_ &= *static_cast<uint8_t *>(operands_[operation->source]);
 					set_logical_flags(Flag::HalfCarry);
 				break;
 
 				case MicroOp::Or:
-					a_ |= *static_cast<uint8_t *>(operation->source);
+					a_ |= *static_cast<uint8_t *>(operands_[operation->source]);
 					set_logical_flags(0);
 				break;
 
 				case MicroOp::Xor:
-					a_ ^= *static_cast<uint8_t *>(operation->source);
+					a_ ^= *static_cast<uint8_t *>(operands_[operation->source]);
 					set_logical_flags(0);
 				break;
 
@@ -201,7 +233,7 @@ template <	class T,
 	set_did_compute_flags();
 
 				case MicroOp::CP8: {
-					const uint8_t value = *static_cast<uint8_t *>(operation->source);
+					const uint8_t value = *static_cast<uint8_t *>(operands_[operation->source]);
 					const int result = a_ - value;
 					const int half_result = (a_&0xf) - (value&0xf);
 
@@ -214,7 +246,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::SUB8: {
-					const uint8_t value = *static_cast<uint8_t *>(operation->source);
+					const uint8_t value = *static_cast<uint8_t *>(operands_[operation->source]);
 					const int result = a_ - value;
 					const int half_result = (a_&0xf) - (value&0xf);
 
@@ -227,7 +259,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::SBC8: {
-					const uint8_t value = *static_cast<uint8_t *>(operation->source);
+					const uint8_t value = *static_cast<uint8_t *>(operands_[operation->source]);
 					const int result = a_ - value - (carry_result_ & Flag::Carry);
 					const int half_result = (a_&0xf) - (value&0xf) - (carry_result_ & Flag::Carry);
 
@@ -240,7 +272,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::ADD8: {
-					const uint8_t value = *static_cast<uint8_t *>(operation->source);
+					const uint8_t value = *static_cast<uint8_t *>(operands_[operation->source]);
 					const int result = a_ + value;
 					const int half_result = (a_&0xf) + (value&0xf);
 
@@ -253,7 +285,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::ADC8: {
-					const uint8_t value = *static_cast<uint8_t *>(operation->source);
+					const uint8_t value = *static_cast<uint8_t *>(operands_[operation->source]);
 					const int result = a_ + value + (carry_result_ & Flag::Carry);
 					const int half_result = (a_&0xf) + (value&0xf) + (carry_result_ & Flag::Carry);
 
@@ -282,7 +314,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::Increment8: {
-					const uint8_t value = *static_cast<uint8_t *>(operation->source);
+					const uint8_t value = *static_cast<uint8_t *>(operands_[operation->source]);
 					const int result = value + 1;
 
 					// with an increment, overflow occurs if the sign changes from
@@ -290,7 +322,7 @@ template <	class T,
 					const int overflow = (value ^ result) & ~value;
 					const int half_result = (value&0xf) + 1;
 
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>(result);
+					*static_cast<uint8_t *>(operands_[operation->source]) = static_cast<uint8_t>(result);
 
 					// sign, zero and 5 & 3 are set directly from the result
 					bit53_result_ = sign_result_ = zero_result_ = static_cast<uint8_t>(result);
@@ -301,7 +333,7 @@ template <	class T,
 				} break;
 
 				case MicroOp::Decrement8: {
-					const uint8_t value = *static_cast<uint8_t *>(operation->source);
+					const uint8_t value = *static_cast<uint8_t *>(operands_[operation->source]);
 					const int result = value - 1;
 
 					// with a decrement, overflow occurs if the sign changes from
@@ -309,7 +341,7 @@ template <	class T,
 					const int overflow = (value ^ result) & value;
 					const int half_result = (value&0xf) - 1;
 
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>(result);
+					*static_cast<uint8_t *>(operands_[operation->source]) = static_cast<uint8_t>(result);
 
 					// sign, zero and 5 & 3 are set directly from the result
 					bit53_result_ = sign_result_ = zero_result_ = static_cast<uint8_t>(result);
@@ -365,8 +397,8 @@ template <	class T,
 // MARK: - 16-bit arithmetic
 
 				case MicroOp::ADD16: {
-					memptr_.full = *static_cast<uint16_t *>(operation->destination);
-					const uint16_t sourceValue = *static_cast<uint16_t *>(operation->source);
+					memptr_.full = *static_cast<uint16_t *>(operands_[operation->destination]);
+					const uint16_t sourceValue = *static_cast<uint16_t *>(operands_[operation->source]);
 					const uint16_t destinationValue = memptr_.full;
 					const int result = sourceValue + destinationValue;
 					const int halfResult = (sourceValue&0xfff) + (destinationValue&0xfff);
@@ -377,13 +409,13 @@ template <	class T,
 					subtract_flag_ = 0;
 					set_did_compute_flags();
 
-					*static_cast<uint16_t *>(operation->destination) = static_cast<uint16_t>(result);
+					*static_cast<uint16_t *>(operands_[operation->destination]) = static_cast<uint16_t>(result);
 					memptr_.full++;
 				} break;
 
 				case MicroOp::ADC16: {
-					memptr_.full = *static_cast<uint16_t *>(operation->destination);
-					const uint16_t sourceValue = *static_cast<uint16_t *>(operation->source);
+					memptr_.full = *static_cast<uint16_t *>(operands_[operation->destination]);
+					const uint16_t sourceValue = *static_cast<uint16_t *>(operands_[operation->source]);
 					const uint16_t destinationValue = memptr_.full;
 					const int result = sourceValue + destinationValue + (carry_result_ & Flag::Carry);
 					const int halfResult = (sourceValue&0xfff) + (destinationValue&0xfff) + (carry_result_ & Flag::Carry);
@@ -399,13 +431,13 @@ template <	class T,
 					parity_overflow_result_ = static_cast<uint8_t>(overflow >> 13);
 					set_did_compute_flags();
 
-					*static_cast<uint16_t *>(operation->destination) = static_cast<uint16_t>(result);
+					*static_cast<uint16_t *>(operands_[operation->destination]) = static_cast<uint16_t>(result);
 					memptr_.full++;
 				} break;
 
 				case MicroOp::SBC16: {
-					memptr_.full = *static_cast<uint16_t *>(operation->destination);
-					const uint16_t sourceValue = *static_cast<uint16_t *>(operation->source);
+					memptr_.full = *static_cast<uint16_t *>(operands_[operation->destination]);
+					const uint16_t sourceValue = *static_cast<uint16_t *>(operands_[operation->source]);
 					const uint16_t destinationValue = memptr_.full;
 					const int result = destinationValue - sourceValue - (carry_result_ & Flag::Carry);
 					const int halfResult = (destinationValue&0xfff) - (sourceValue&0xfff) - (carry_result_ & Flag::Carry);
@@ -424,7 +456,7 @@ template <	class T,
 					parity_overflow_result_ = static_cast<uint8_t>(overflow >> 13);
 					set_did_compute_flags();
 
-					*static_cast<uint16_t *>(operation->destination) = static_cast<uint16_t>(result);
+					*static_cast<uint16_t *>(operands_[operation->destination]) = static_cast<uint16_t>(result);
 					memptr_.full++;
 				} break;
 
@@ -432,7 +464,7 @@ template <	class T,
 
 #define decline_conditional()	\
 	if(operation->source) {		\
-		scheduled_program_counter_ = (MicroOp *)operation->source;	\
+		scheduled_program_counter_ = &micro_ops_[*static_cast<ProgramIndex *>(operands_[operation->source])];	\
 	} else {	\
 		advance_operation();	\
 	}
@@ -635,12 +667,12 @@ template <	class T,
 // MARK: - Bit Manipulation
 
 				case MicroOp::BIT: {
-					const uint8_t result = *static_cast<uint8_t *>(operation->source) & (1 << ((operation_ >> 3)&7));
+					const uint8_t result = *static_cast<uint8_t *>(operands_[operation->source]) & (1 << ((operation_ >> 3)&7));
 
 					if(current_instruction_page_->is_indexed || ((operation_&0x07) == 6)) {
 						bit53_result_ = memptr_.bytes.high;
 					} else {
-						bit53_result_ = *static_cast<uint8_t *>(operation->source);
+						bit53_result_ = *static_cast<uint8_t *>(operands_[operation->source]);
 					}
 
 					sign_result_ = zero_result_ = result;
@@ -651,11 +683,11 @@ template <	class T,
 				} break;
 
 				case MicroOp::RES:
-					*static_cast<uint8_t *>(operation->source) &= ~(1 << ((operation_ >> 3)&7));
+					*static_cast<uint8_t *>(operands_[operation->source]) &= ~(1 << ((operation_ >> 3)&7));
 				break;
 
 				case MicroOp::SET:
-					*static_cast<uint8_t *>(operation->source) |= (1 << ((operation_ >> 3)&7));
+					*static_cast<uint8_t *>(operands_[operation->source]) |= (1 << ((operation_ >> 3)&7));
 				break;
 
 // MARK: - Rotation and shifting
@@ -693,59 +725,59 @@ template <	class T,
 #undef set_rotate_flags
 
 #define set_shift_flags()	\
-	sign_result_ = zero_result_ = bit53_result_ = *static_cast<uint8_t *>(operation->source);	\
+	sign_result_ = zero_result_ = bit53_result_ = *static_cast<uint8_t *>(operands_[operation->source]);	\
 	set_parity(sign_result_);	\
 	half_carry_result_ = 0;	\
 	subtract_flag_ = 0;	\
 	set_did_compute_flags();
 
 				case MicroOp::RLC:
-					carry_result_ = *static_cast<uint8_t *>(operation->source) >> 7;
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) << 1) | carry_result_);
+					carry_result_ = *static_cast<uint8_t *>(operands_[operation->source]) >> 7;
+					*static_cast<uint8_t *>(operands_[operation->source]) = static_cast<uint8_t>((*static_cast<uint8_t *>(operands_[operation->source]) << 1) | carry_result_);
 					set_shift_flags();
 				break;
 
 				case MicroOp::RRC:
-					carry_result_ = *static_cast<uint8_t *>(operation->source);
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) >> 1) | (carry_result_ << 7));
+					carry_result_ = *static_cast<uint8_t *>(operands_[operation->source]);
+					*static_cast<uint8_t *>(operands_[operation->source]) = static_cast<uint8_t>((*static_cast<uint8_t *>(operands_[operation->source]) >> 1) | (carry_result_ << 7));
 					set_shift_flags();
 				break;
 
 				case MicroOp::RL: {
-					const uint8_t next_carry = *static_cast<uint8_t *>(operation->source) >> 7;
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) << 1) | (carry_result_ & Flag::Carry));
+					const uint8_t next_carry = *static_cast<uint8_t *>(operands_[operation->source]) >> 7;
+					*static_cast<uint8_t *>(operands_[operation->source]) = static_cast<uint8_t>((*static_cast<uint8_t *>(operands_[operation->source]) << 1) | (carry_result_ & Flag::Carry));
 					carry_result_ = next_carry;
 					set_shift_flags();
 				} break;
 
 				case MicroOp::RR: {
-					const uint8_t next_carry = *static_cast<uint8_t *>(operation->source);
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) >> 1) | (carry_result_ << 7));
+					const uint8_t next_carry = *static_cast<uint8_t *>(operands_[operation->source]);
+					*static_cast<uint8_t *>(operands_[operation->source]) = static_cast<uint8_t>((*static_cast<uint8_t *>(operands_[operation->source]) >> 1) | (carry_result_ << 7));
 					carry_result_ = next_carry;
 					set_shift_flags();
 				} break;
 
 				case MicroOp::SLA:
-					carry_result_ = *static_cast<uint8_t *>(operation->source) >> 7;
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>(*static_cast<uint8_t *>(operation->source) << 1);
+					carry_result_ = *static_cast<uint8_t *>(operands_[operation->source]) >> 7;
+					*static_cast<uint8_t *>(operands_[operation->source]) = static_cast<uint8_t>(*static_cast<uint8_t *>(operands_[operation->source]) << 1);
 					set_shift_flags();
 				break;
 
 				case MicroOp::SRA:
-					carry_result_ = *static_cast<uint8_t *>(operation->source);
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) >> 1) | (*static_cast<uint8_t *>(operation->source) & 0x80));
+					carry_result_ = *static_cast<uint8_t *>(operands_[operation->source]);
+					*static_cast<uint8_t *>(operands_[operation->source]) = static_cast<uint8_t>((*static_cast<uint8_t *>(operands_[operation->source]) >> 1) | (*static_cast<uint8_t *>(operands_[operation->source]) & 0x80));
 					set_shift_flags();
 				break;
 
 				case MicroOp::SLL:
-					carry_result_ = *static_cast<uint8_t *>(operation->source) >> 7;
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>(*static_cast<uint8_t *>(operation->source) << 1) | 1;
+					carry_result_ = *static_cast<uint8_t *>(operands_[operation->source]) >> 7;
+					*static_cast<uint8_t *>(operands_[operation->source]) = static_cast<uint8_t>(*static_cast<uint8_t *>(operands_[operation->source]) << 1) | 1;
 					set_shift_flags();
 				break;
 
 				case MicroOp::SRL:
-					carry_result_ = *static_cast<uint8_t *>(operation->source);
-					*static_cast<uint8_t *>(operation->source) = static_cast<uint8_t>((*static_cast<uint8_t *>(operation->source) >> 1));
+					carry_result_ = *static_cast<uint8_t *>(operands_[operation->source]);
+					*static_cast<uint8_t *>(operands_[operation->source]) = static_cast<uint8_t>((*static_cast<uint8_t *>(operands_[operation->source]) >> 1));
 					set_shift_flags();
 				break;
 
@@ -802,7 +834,7 @@ template <	class T,
 
 				case MicroOp::SetInFlags:
 					subtract_flag_ = half_carry_result_ = 0;
-					sign_result_ = zero_result_ = bit53_result_ = *static_cast<uint8_t *>(operation->source);
+					sign_result_ = zero_result_ = bit53_result_ = *static_cast<uint8_t *>(operands_[operation->source]);
 					set_parity(sign_result_);
 					set_did_compute_flags();
 				break;
@@ -862,16 +894,16 @@ template <	class T,
 // MARK: - Internal bookkeeping
 
 				case MicroOp::SetInstructionPage:
-					current_instruction_page_ = (InstructionPage *)operation->source;
-					scheduled_program_counter_ = current_instruction_page_->fetch_decode_execute_data;
+					current_instruction_page_ = static_cast<InstructionPage *>(operands_[operation->source]);
+					scheduled_program_counter_ = &micro_ops_[current_instruction_page_->fetch_decode_execute];
 				break;
 
 				case MicroOp::CalculateIndexAddress:
-					memptr_.full = static_cast<uint16_t>(*static_cast<uint16_t *>(operation->source) + (int8_t)temp8_);
+					memptr_.full = static_cast<uint16_t>(*static_cast<uint16_t *>(operands_[operation->source]) + (int8_t)temp8_);
 				break;
 
 				case MicroOp::SetAddrAMemptr:
-					memptr_.full = static_cast<uint16_t>(((*static_cast<uint16_t *>(operation->source) + 1)&0xff) + (a_ << 8));
+					memptr_.full = static_cast<uint16_t>(((*static_cast<uint16_t *>(operands_[operation->source]) + 1)&0xff) + (a_ << 8));
 				break;
 
 				case MicroOp::IndexedPlaceHolder:
@@ -885,7 +917,8 @@ template <	class T,
 
 template <	class T,
 			bool uses_bus_request,
-			bool uses_wait_line> void Processor <T, uses_bus_request, uses_wait_line>
+			bool uses_wait_line,
+			bool coalesces_bus_cycles> void Processor <T, uses_bus_request, uses_wait_line, coalesces_bus_cycles>
 				::set_bus_request_line(bool value) {
 	assert(uses_bus_request);
 	bus_request_line_ = value;
@@ -893,14 +926,16 @@ template <	class T,
 
 template <	class T,
 			bool uses_bus_request,
-			bool uses_wait_line> bool Processor <T, uses_bus_request, uses_wait_line>
+			bool uses_wait_line,
+			bool coalesces_bus_cycles> bool Processor <T, uses_bus_request, uses_wait_line, coalesces_bus_cycles>
 				::get_bus_request_line() {
 	return bus_request_line_;
 }
 
 template <	class T,
 			bool uses_bus_request,
-			bool uses_wait_line> void Processor <T, uses_bus_request, uses_wait_line>
+			bool uses_wait_line,
+			bool coalesces_bus_cycles> void Processor <T, uses_bus_request, uses_wait_line, coalesces_bus_cycles>
 				::set_wait_line(bool value) {
 	assert(uses_wait_line);
 	wait_line_ = value;
@@ -908,94 +943,117 @@ template <	class T,
 
 template <	class T,
 			bool uses_bus_request,
-			bool uses_wait_line> bool Processor <T, uses_bus_request, uses_wait_line>
+			bool uses_wait_line,
+			bool coalesces_bus_cycles> bool Processor <T, uses_bus_request, uses_wait_line, coalesces_bus_cycles>
 				::get_wait_line() {
 	return wait_line_;
 }
 
+template <	class T,
+			bool uses_bus_request,
+			bool uses_wait_line,
+			bool coalesces_bus_cycles> void Processor <T, uses_bus_request, uses_wait_line, coalesces_bus_cycles>
+				::skip_halted_fetches() {
+	const HalfCycles limit = std::min(bus_handler_.get_idle_limit() - coalesced_length_, number_of_cycles_);
+	const HalfCycles fetch_length = halt_fetch_length_ + bus_handler_.get_opcode_fetch_penalty();
+	const int fetches = limit.as_int() / fetch_length.as_int();
+	if(fetches <= 0) return;
+
+	// Apply the net effect of the skipped fetches: R and the refresh address advance once per fetch,
+	// and the record of which operations computed flags shifts along once per fetch.
+	refresh_addr_ = ir_;
+	refresh_addr_.bytes.low = static_cast<uint8_t>((ir_.bytes.low & 0x80) | ((ir_.bytes.low + fetches - 1) & 0x7f));
+	ir_.bytes.low = static_cast<uint8_t>((ir_.bytes.low & 0x80) | ((ir_.bytes.low + fetches) & 0x7f));
+	flag_adjustment_history_ = (fetches < 32) ? (flag_adjustment_history_ << fetches) : 0;
+
+	const HalfCycles length(fetch_length.as_int() * fetches);
+	number_of_cycles_ -= length;
+	profile_processor(profile_.did_run_for(length.as_int()));
+	number_of_cycles_ -= bus_handler_.perform_machine_cycle(PartialMachineCycle(PartialMachineCycle::Internal, coalesced_length_ + length, nullptr, nullptr, false));
+	if(coalesces_bus_cycles) {
+		coalesced_length_ = 0;
+		coalesced_limit_ = bus_handler_.get_idle_limit();
+	}
+}
+
 #define isTerminal(n)	(n == MicroOp::MoveToNextProgram || n == MicroOp::DecodeOperation || n == MicroOp::DecodeOperationNoRChange)
 
 template <	class T,
 			bool uses_bus_request,
-			bool uses_wait_line> void Processor <T, uses_bus_request, uses_wait_line>
+			bool uses_wait_line,
+			bool coalesces_bus_cycles> void Processor <T, uses_bus_request, uses_wait_line, coalesces_bus_cycles>
 				::assemble_page(InstructionPage &target, InstructionTable &table, bool add_offsets) {
-	std::size_t number_of_micro_ops = 0;
-	std::size_t lengths[256];
-
-	// Count number of micro-ops required.
-	for(int c = 0; c < 256; c++) {
-		std::size_t length = 0;
-		while(!isTerminal(table[c][length].type)) length++;
-		length++;
-		lengths[c] = length;
-		number_of_micro_ops += length;
+	for(std::size_t c = 0; c < 256; c++) {
+		target.instructions[c] = compile_program(table[c], add_offsets);
 	}
+}
 
-	// Allocate a landing area.
-	std::vector<std::size_t> operation_indices;
-	target.all_operations.reserve(number_of_micro_ops);
-	target.instructions.resize(256, nullptr);
+template <	class T,
+			bool uses_bus_request,
+			bool uses_wait_line,
+			bool coalesces_bus_cycles> typename Processor <T, uses_bus_request, uses_wait_line, coalesces_bus_cycles>::ProgramIndex Processor <T, uses_bus_request, uses_wait_line, coalesces_bus_cycles>
+				::compile_program(const MicroOp *source, bool add_offsets) {
+	std::vector<CompiledMicroOp> program;
+	program.reserve(32);
+	HalfCycles pending_length;
+	std::size_t t = 0;
+	while(true) {
+		const MicroOp &operation = source[t];
 
-	// Copy in all programs, recording where they go.
-	std::size_t destination = 0;
-	for(std::size_t c = 0; c < 256; c++) {
-		operation_indices.push_back(target.all_operations.size());
-		for(std::size_t t = 0; t < lengths[c];) {
-			// Skip zero-length bus cycles.
-			if(table[c][t].type == MicroOp::BusOperation && table[c][t].machine_cycle.length.as_int() == 0) {
+		// Skip zero-length bus cycles.
+		if(operation.type == MicroOp::BusOperation && operation.machine_cycle.length.as_int() == 0) {
+			t++;
+			continue;
+		}
+
+		// Skip optional waits if this instance doesn't use the wait line.
+		if(operation.machine_cycle.was_requested && !uses_wait_line) {
+			t++;
+			continue;
+		}
+
+		// If an index placeholder is hit then drop it, and if offsets aren't being added,
+		// then also drop the indexing that follows, which is assumed to be everything
+		// up to and including the next ::CalculateIndexAddress. Coupled to the INDEX() macro.
+		if(operation.type == MicroOp::IndexedPlaceHolder) {
+			t++;
+			if(!add_offsets) {
+				while(source[t].type != MicroOp::CalculateIndexAddress) t++;
 				t++;
-				continue;
 			}
+			continue;
+		}
 
-			// Skip optional waits if this instance doesn't use the wait line.
-			if(table[c][t].machine_cycle.was_requested && !uses_wait_line) {
+		// If bus cycles are being coalesced then fold each run of bus cycles that doesn't expect
+		// action into the length of the one that follows it, if it does. Optional waits are kept
+		// separate, as are any other micro-ops, and any remainder becomes a single internal cycle.
+		if(coalesces_bus_cycles) {
+			const bool is_bus_operation = operation.type == MicroOp::BusOperation;
+			if(is_bus_operation && !operation.machine_cycle.was_requested) {
+				if(!operation.machine_cycle.expects_action()) {
+					pending_length += operation.machine_cycle.length;
+				} else {
+					MicroOp merged_operation = {MicroOp::BusOperation, nullptr, nullptr, PartialMachineCycle(operation.machine_cycle, pending_length + operation.machine_cycle.length)};
+					program.push_back(compile_micro_op(merged_operation));
+					pending_length = 0;
+				}
 				t++;
 				continue;
 			}
 
-			// If an index placeholder is hit then drop it, and if offsets aren't being added,
-			// then also drop the indexing that follows, which is assumed to be everything
-			// up to and including the next ::CalculateIndexAddress. Coupled to the INDEX() macro.
-			if(table[c][t].type == MicroOp::IndexedPlaceHolder) {
-				t++;
-				if(!add_offsets) {
-					while(table[c][t].type != MicroOp::CalculateIndexAddress) t++;
-					t++;
-				}
+			if(pending_length > HalfCycles(0)) {
+				MicroOp internal_operation = {MicroOp::BusOperation, nullptr, nullptr, PartialMachineCycle(PartialMachineCycle::Internal, pending_length, nullptr, nullptr, false)};
+				program.push_back(compile_micro_op(internal_operation));
+				pending_length = 0;
 			}
-			target.all_operations.emplace_back(table[c][t]);
-			destination++;
-			t++;
 		}
-	}
 
-	// Since the vector won't change again, it's now safe to set pointers.
-	std::size_t c = 0;
-	for(std::size_t index : operation_indices) {
-		target.instructions[c] = &target.all_operations[index];
-		c++;
+		program.push_back(compile_micro_op(operation));
+		if(isTerminal(operation.type)) break;
+		t++;
 	}
-}
 
-template <	class T,
-			bool uses_bus_request,
-			bool uses_wait_line> void Processor <T, uses_bus_request, uses_wait_line>
-		::copy_program(const MicroOp *source, std::vector<MicroOp> &destination) {
-	std::size_t length = 0;
-	while(!isTerminal(source[length].type)) length++;
-	std::size_t pointer = 0;
-	while(true) {
-		// TODO: This test is duplicated from assemble_page; can a better factoring be found?
-		// Skip optional waits if this instance doesn't use the wait line.
-		if(source[pointer].machine_cycle.was_requested && !uses_wait_line) {
-			pointer++;
-			continue;
-		}
-
-		destination.emplace_back(source[pointer]);
-		if(isTerminal(source[pointer].type)) break;
-		pointer++;
-	}
+	return add_program(program);
 }
 
 #undef isTerminal
@@ -12,6 +12,8 @@
 using namespace CPU::Z80;
 
 ProcessorStorage::ProcessorStorage() {
+	operands_[0] = nullptr;
+	operand_indices_[nullptr] = 0;
 	set_flags(0xff);
 }
 
@@ -105,7 +107,7 @@ ProcessorStorage::ProcessorStorage() {
 #define NOP						Sequence(BusOp(Refresh(4)))
 
 #define JP(cc)					StdInstr(Read16Inc(pc_, temp16_), {MicroOp::cc, nullptr}, {MicroOp::Move16, &temp16_.full, &pc_.full})
-#define CALL(cc)				StdInstr(ReadInc(pc_, temp16_.bytes.low), {MicroOp::cc, conditional_call_untaken_program_.data()}, Read4Inc(pc_, temp16_.bytes.high), Push(pc_), {MicroOp::Move16, &temp16_.full, &pc_.full})
+#define CALL(cc)				StdInstr(ReadInc(pc_, temp16_.bytes.low), {MicroOp::cc, &conditional_call_untaken_program_}, Read4Inc(pc_, temp16_.bytes.high), Push(pc_), {MicroOp::Move16, &temp16_.full, &pc_.full})
 #define RET(cc)					Instr(6, {MicroOp::cc, nullptr}, Pop(memptr_), {MicroOp::Move16, &memptr_.full, &pc_.full})
 #define JR(cc)					StdInstr(ReadInc(pc_, temp8_), {MicroOp::cc, nullptr}, InternalOperation(10), {MicroOp::CalculateIndexAddress, &pc_.full}, {MicroOp::Move16, &memptr_.full, &pc_.full})
 #define RST()					Instr(6, {MicroOp::CalculateRSTDestination}, Push(pc_), {MicroOp::Move16, &memptr_.full, &pc_.full})
@@ -166,8 +168,14 @@ ProcessorStorage::ProcessorStorage() {
 #define SBC16(d, s) StdInstr(InternalOperation(8), InternalOperation(6), {MicroOp::SBC16, &s.full, &d.full})
 
 void ProcessorStorage::install_default_instruction_set() {
+	// Reserve enough space for the default instruction set, to avoid reallocation as it is compiled.
+	micro_ops_.reserve(4608);
+	machine_cycles_.reserve(512);
+	machine_cycle_indices_.reserve(512);
+	program_indices_.reserve(768);
+
 	MicroOp conditional_call_untaken_program[] = Sequence(ReadInc(pc_, temp16_.bytes.high));
-	copy_program(conditional_call_untaken_program, conditional_call_untaken_program_);
+	conditional_call_untaken_program_ = compile_program(conditional_call_untaken_program, false);
 
 	assemble_base_page(base_page_, hl_, false, cb_page_);
 	assemble_base_page(dd_page_, ix_, true, ddcb_page_);
@@ -235,11 +243,83 @@ void ProcessorStorage::install_default_instruction_set() {
 		{ MicroOp::MoveToNextProgram }
 	};
 
-	copy_program(reset_program, reset_program_);
-	copy_program(nmi_program, nmi_program_);
-	copy_program(irq_mode0_program, irq_program_[0]);
-	copy_program(irq_mode1_program, irq_program_[1]);
-	copy_program(irq_mode2_program, irq_program_[2]);
+	reset_program_ = compile_program(reset_program, false);
+	nmi_program_ = compile_program(nmi_program, false);
+	irq_program_[0] = compile_program(irq_mode0_program, false);
+	irq_program_[1] = compile_program(irq_mode1_program, false);
+	irq_program_[2] = compile_program(irq_mode2_program, false);
+
+	// While halted, the Z80 repeats a standard opcode fetch followed by a NOP. Total the length of that, excluding
+	// optional waits, for use when skipping such fetches.
+	const auto program_length = [this] (ProgramIndex index) {
+		HalfCycles length;
+		for(const CompiledMicroOp *operation = &micro_ops_[index];; ++operation) {
+			if(operation->type == MicroOp::BusOperation && !machine_cycles_[operation->machine_cycle].was_requested) {
+				length += machine_cycles_[operation->machine_cycle].length;
+			}
+			if(
+				operation->type == MicroOp::MoveToNextProgram ||
+				operation->type == MicroOp::DecodeOperation ||
+				operation->type == MicroOp::DecodeOperationNoRChange
+			) break;
+		}
+		return length;
+	};
+	halt_fetch_length_ = program_length(base_page_.fetch_decode_execute) + program_length(base_page_.instructions[0]);
+
+	// All programs are now in place; the lookups used to share their parts are no longer needed.
+	operand_indices_ = decltype(operand_indices_)();
+	machine_cycle_indices_ = decltype(machine_cycle_indices_)();
+	program_indices_ = decltype(program_indices_)();
+	micro_ops_.shrink_to_fit();
+	machine_cycles_.shrink_to_fit();
+}
+
+ProcessorStorage::CompiledMicroOp ProcessorStorage::compile_micro_op(const MicroOp &micro_op) {
+	const auto operand_index = [this] (void *operand) -> uint8_t {
+		const auto existing = operand_indices_.find(operand);
+		if(existing != operand_indices_.end()) return existing->second;
+
+		assert(number_of_operands_ < sizeof(operands_) / sizeof(*operands_));
+		operands_[number_of_operands_] = operand;
+		const uint8_t index = static_cast<uint8_t>(number_of_operands_++);
+		operand_indices_[operand] = index;
+		return index;
+	};
+
+	CompiledMicroOp result;
+	result.type = static_cast<uint8_t>(micro_op.type);
+	result.source = operand_index(micro_op.source);
+	result.destination = operand_index(micro_op.destination);
+	result.machine_cycle = 0;
+
+	if(micro_op.type == MicroOp::BusOperation) {
+		const PartialMachineCycle &cycle = micro_op.machine_cycle;
+		const auto existing = machine_cycle_indices_.find(cycle);
+		if(existing != machine_cycle_indices_.end()) {
+			result.machine_cycle = existing->second;
+		} else {
+			assert(machine_cycles_.size() <= 0xffff);
+			result.machine_cycle = static_cast<uint16_t>(machine_cycles_.size());
+			machine_cycles_.push_back(cycle);
+			machine_cycle_indices_.emplace(cycle, result.machine_cycle);
+		}
+	}
+
+	return result;
+}
+
+ProcessorStorage::ProgramIndex ProcessorStorage::add_program(const std::vector<CompiledMicroOp> &program) {
+	// Identical programs are stored only once; many instructions differ only in their operands, but the
+	// same instruction often appears unmodified on several pages.
+	const auto existing = program_indices_.find(program);
+	if(existing != program_indices_.end()) return existing->second;
+
+	assert(micro_ops_.size() + program.size() <= 0x10000);
+	const ProgramIndex index = static_cast<ProgramIndex>(micro_ops_.size());
+	micro_ops_.insert(micro_ops_.end(), program.begin(), program.end());
+	program_indices_.emplace(program, index);
+	return index;
 }
 
 void ProcessorStorage::assemble_ed_page(InstructionPage &target) {
@@ -540,6 +620,5 @@ void ProcessorStorage::assemble_fetch_decode_execute(InstructionPage &target, in
 		BusOp(ReadOpcodeEnd()),
 		{ MicroOp::DecodeOperation }
 	};
-	copy_program((length == 4) ? normal_fetch_decode_execute : short_fetch_decode_execute, target.fetch_decode_execute);
-	target.fetch_decode_execute_data = target.fetch_decode_execute.data();
+	target.fetch_decode_execute = compile_program((length == 4) ? normal_fetch_decode_execute : short_fetch_decode_execute, false);
 }
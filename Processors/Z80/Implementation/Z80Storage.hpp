@@ -101,11 +101,66 @@ class ProcessorStorage {
 			PartialMachineCycle machine_cycle;
 		};
 
+		/*!
+			The form in which micro-ops are executed. MicroOps are compiled into these, with
+			pointers replaced by small indices: operands become indices into operands_ and bus
+			operations become indices into machine_cycles_. All programs are then stored
+			consecutively in micro_ops_, with duplicates shared, so that the entire instruction
+			set occupies a single dense table.
+		*/
+		struct CompiledMicroOp {
+			uint16_t machine_cycle;		// An index into machine_cycles_, if this is a bus operation.
+			uint8_t type;				// A MicroOp::Type.
+			uint8_t source;				// An index into operands_.
+			uint8_t destination;		// An index into operands_.
+
+			bool operator ==(const CompiledMicroOp &rhs) const {
+				return
+					type == rhs.type &&
+					source == rhs.source &&
+					destination == rhs.destination &&
+					machine_cycle == rhs.machine_cycle;
+			}
+		};
+
+		// Hashes and comparisons for the lookups used to deduplicate operands, machine cycles
+		// and programs while compiling.
+		struct MachineCycleHash {
+			std::size_t operator()(const PartialMachineCycle &cycle) const {
+				return
+					std::hash<const void *>()(cycle.address) ^
+					(std::hash<const void *>()(cycle.value) * 31) ^
+					static_cast<std::size_t>((cycle.length.as_int() << 8) | (cycle.operation << 1) | (cycle.was_requested ? 1 : 0));
+			}
+		};
+		struct MachineCycleEqual {
+			bool operator()(const PartialMachineCycle &lhs, const PartialMachineCycle &rhs) const {
+				return
+					lhs.operation == rhs.operation &&
+					lhs.length == rhs.length &&
+					lhs.address == rhs.address &&
+					lhs.value == rhs.value &&
+					lhs.was_requested == rhs.was_requested;
+			}
+		};
+		struct ProgramHash {
+			std::size_t operator()(const std::vector<CompiledMicroOp> &program) const {
+				std::size_t hash = program.size();
+				for(const auto &operation: program) {
+					hash = (hash * 31) ^ static_cast<std::size_t>(
+						(operation.machine_cycle << 24) | (operation.type << 16) | (operation.source << 8) | operation.destination
+					);
+				}
+				return hash;
+			}
+		};
+
+		/// A program is identified by the index of its first micro-op within micro_ops_.
+		typedef uint16_t ProgramIndex;
+
 		struct InstructionPage {
-			std::vector<MicroOp *> instructions;
-			std::vector<MicroOp> all_operations;
-			std::vector<MicroOp> fetch_decode_execute;
-			MicroOp *fetch_decode_execute_data;
+			ProgramIndex instructions[256];
+			ProgramIndex fetch_decode_execute;
 			uint8_t r_step;
 			bool is_indexed;
 
@@ -139,6 +194,9 @@ class ProcessorStorage {
 													// correct for SCF and CCF.
 
 		HalfCycles number_of_cycles_;
+		HalfCycles coalesced_length_;
+		HalfCycles coalesced_limit_;		// the length that coalesced_length_ must remain below for cycles to continue being folded into it
+		HalfCycles halt_fetch_length_;		// the length of one iteration of the idle fetch that repeats while halted
 
 		enum Interrupt: uint8_t {
 			IRQ			= 0x01,
@@ -156,13 +214,21 @@ class ProcessorStorage {
 		RegisterPair temp16_, memptr_;
 		uint8_t temp8_;
 
-		const MicroOp *scheduled_program_counter_ = nullptr;
+		const CompiledMicroOp *scheduled_program_counter_ = nullptr;
 
-		std::vector<MicroOp> conditional_call_untaken_program_;
-		std::vector<MicroOp> reset_program_;
-		std::vector<MicroOp> irq_program_[3];
-		std::vector<MicroOp> nmi_program_;
-		InstructionPage *current_instruction_page_;
+		std::vector<CompiledMicroOp> micro_ops_;
+		std::vector<PartialMachineCycle> machine_cycles_;
+		void *operands_[256];
+		std::size_t number_of_operands_ = 1;
+		std::unordered_map<const void *, uint8_t> operand_indices_;
+		std::unordered_map<PartialMachineCycle, uint16_t, MachineCycleHash, MachineCycleEqual> machine_cycle_indices_;
+		std::unordered_map<std::vector<CompiledMicroOp>, ProgramIndex, ProgramHash> program_indices_;
+
+		ProgramIndex conditional_call_untaken_program_;
+		ProgramIndex reset_program_;
+		ProgramIndex irq_program_[3];
+		ProgramIndex nmi_program_;
+		InstructionPage *current_instruction_page_ = &base_page_;
 
 		InstructionPage base_page_;
 		InstructionPage ed_page_;
@@ -173,6 +239,61 @@ class ProcessorStorage {
 		InstructionPage fdcb_page_;
 		InstructionPage ddcb_page_;
 
+		// Memory that may be accessed without involving the bus handler, in 1kb pages.
+		const uint8_t *direct_read_pointers_[64] = {};
+		uint8_t *direct_write_pointers_[64] = {};
+
+		/*!
+			Performs @c cycle directly upon memory if it is a read, opcode read or write of a page that permits it.
+
+			@returns @c true if the access was performed; @c false if the bus handler needs to perform it.
+		*/
+		inline bool perform_direct_access(const PartialMachineCycle &cycle) {
+			switch(cycle.operation) {
+				case PartialMachineCycle::ReadOpcode:
+				case PartialMachineCycle::Read: {
+					const uint8_t *const page = direct_read_pointers_[*cycle.address >> 10];
+					if(!page) return false;
+					*cycle.value = page[*cycle.address & 1023];
+				} return true;
+
+				case PartialMachineCycle::Write: {
+					uint8_t *const page = direct_write_pointers_[*cycle.address >> 10];
+					if(!page) return false;
+					page[*cycle.address & 1023] = *cycle.value;
+				} return true;
+
+				default: return false;
+			}
+		}
+
+#ifdef PROFILE_PROCESSORS
+		// Opcodes are profiled per page, with pages in the same order as they're serialised:
+		// base, ED, FD, DD, CB, FDCB then DDCB. Time is recorded in half cycles.
+		ProcessorProfile profile_{"Z80", 7, 2};
+
+		/// Records the decoding of @c operation_ from the current instruction page.
+		inline void profile_decode() {
+			const InstructionPage *const pages[] = {
+				&base_page_, &ed_page_, &fd_page_, &dd_page_, &cb_page_, &fdcb_page_, &ddcb_page_
+			};
+			int page = 0;
+			while(pages[page] != current_instruction_page_) ++page;
+			profile_.did_decode(page, operation_ & halt_mask_);
+		}
+
+		/// Records the passage of @c cycle and any memory access that it completes.
+		inline void profile_machine_cycle(const PartialMachineCycle &cycle) {
+			profile_.did_run_for(cycle.length.as_int());
+			switch(cycle.operation) {
+				case PartialMachineCycle::ReadOpcode:
+				case PartialMachineCycle::Read:		profile_.did_read(*cycle.address);	break;
+				case PartialMachineCycle::Write:	profile_.did_write(*cycle.address);	break;
+				default: break;
+			}
+		}
+#endif
+
 		/*!
 			Gets the flags register.
 
@@ -210,7 +331,10 @@ class ProcessorStorage {
 		}
 
 		virtual void assemble_page(InstructionPage &target, InstructionTable &table, bool add_offsets) = 0;
-		virtual void copy_program(const MicroOp *source, std::vector<MicroOp> &destination) = 0;
+		virtual ProgramIndex compile_program(const MicroOp *source, bool add_offsets) = 0;
+
+		CompiledMicroOp compile_micro_op(const MicroOp &micro_op);
+		ProgramIndex add_program(const std::vector<CompiledMicroOp> &program);
 
 		void assemble_fetch_decode_execute(InstructionPage &target, int length);
 		void assemble_ed_page(InstructionPage &target);
@@ -9,12 +9,16 @@
 #ifndef Z80_hpp
 #define Z80_hpp
 
+#include <algorithm>
 #include <cassert>
+#include <unordered_map>
 #include <vector>
 #include <cstdint>
 
+#include "../Profile.hpp"
 #include "../RegisterSizes.hpp"
 #include "../../ClockReceiver/ClockReceiver.hpp"
+#include "../../Storage/State/Serialiser.hpp"
 
 namespace CPU {
 namespace Z80 {
@@ -125,6 +129,9 @@ struct PartialMachineCycle {
 	}
 
 	PartialMachineCycle(const PartialMachineCycle &rhs) noexcept;
+	/// Constructs a copy of @c rhs but with the supplied @c length.
+	PartialMachineCycle(const PartialMachineCycle &rhs, HalfCycles length) noexcept :
+		operation(rhs.operation), length(length), address(rhs.address), value(rhs.value), was_requested(rhs.was_requested) {}
 	PartialMachineCycle(Operation operation, HalfCycles length, uint16_t *address, uint8_t *value, bool was_requested) noexcept;
 	PartialMachineCycle() noexcept;
 };
@@ -153,6 +160,33 @@ class BusHandler {
 			bus handlers to perform any deferred output work.
 		*/
 		void flush() {}
+
+		/*!
+			Queried whenever the Z80 is halted with no interrupt pending, and would therefore do nothing but repeat
+			the same opcode fetch and refresh until one arrives. Bus handlers that don't need to observe those cycles
+			individually may return a period during which they guarantee not to change any interrupt input. The Z80
+			will then skip as many whole halted fetches as fit within both that period and the remainder of its
+			current run_for, announcing them via a single @c Internal partial machine cycle of their total length,
+			including any @c get_opcode_fetch_penalty.
+
+			Z80s that coalesce bus cycles also query this after each call to @c perform_machine_cycle, and fold
+			cycles together only for as long as the total remains less than the period returned.
+
+			@returns The period that may be skipped. The default of HalfCycles(0) means that nothing is skipped.
+		*/
+		HalfCycles get_idle_limit() {
+			return HalfCycles(0);
+		}
+
+		/*!
+			Bus handlers that lengthen every opcode fetch, by returning additional time from @c perform_machine_cycle,
+			should return that length here so that skipped halted fetches can be timed correctly.
+
+			@returns The additional time taken by each opcode fetch.
+		*/
+		HalfCycles get_opcode_fetch_penalty() {
+			return HalfCycles(0);
+		}
 };
 
 #include "Implementation/Z80Storage.hpp"
@@ -223,6 +257,42 @@ class ProcessorBase: public ProcessorStorage {
 			reset at the first opportunity. Use @c reset_power_on to disable that behaviour.
 		*/
 		void reset_power_on();
+
+		/*!
+			Abandons any partially-completed instruction and cancels any pending power-on reset,
+			so that execution next proceeds with an instruction fetch from the current program
+			counter. Intended for use when registers are being installed wholesale, e.g. from a
+			snapshot.
+		*/
+		void abandon_instruction();
+
+		/*!
+			Nominates memory that a Z80 which coalesces bus cycles may read from and write to directly, without
+			calling its bus handler, when accessing the 1kb page that contains @c address. Such accesses are
+			treated like any other cycle that doesn't expect action, and are folded into the next call to the bus
+			handler. So they should be nominated only for plain memory, without side effects or wait states.
+
+			@param read The 1kb from which reads and opcode reads of this page may be satisfied, or @c nullptr if
+			the bus handler should continue to observe them.
+			@param write The 1kb to which writes to this page may be made, or @c nullptr if the bus handler should
+			continue to observe them.
+		*/
+		void set_direct_memory(uint16_t address, const uint8_t *read, uint8_t *write);
+
+		/*!
+			Captures or restores the complete state of this Z80, including that of any
+			partially-completed instruction.
+		*/
+		void serialise(Storage::State::Serialiser &serialiser);
+
+#ifdef PROFILE_PROCESSORS
+		/*!
+			@returns The execution profile accumulated by this Z80 since its creation.
+		*/
+		const Profile &get_profile() const {
+			return profile_;
+		}
+#endif
 };
 
 /*!
@@ -232,8 +302,19 @@ class ProcessorBase: public ProcessorStorage {
 	will announce its activity via the bus handler, which is responsible for marrying it to a bus. Users
 	can also nominate whether the processor includes support for the bus request and/or wait lines. Declining to
 	support either can produce a minor runtime performance improvement.
+
+	Users that act only upon reads, writes, inputs, outputs and interrupt acknowledges, and otherwise just
+	accumulate time, can also nominate that partial machine cycles be coalesced. Then the bus handler will
+	usually be offered only those cycles for which @c expects_action() is true, with the lengths of all others folded
+	into the length of the next such cycle. Reads and writes of memory nominated via @c set_direct_memory are
+	also folded in. Any time left over at the end of a @c run_for is announced as a single @c Internal cycle prior
+	to @c flush. So the total time announced is unchanged but the number of calls is much reduced.
+
+	Folding continues only while the total is less than that returned by the bus handler's @c get_idle_limit,
+	after which the next cycle is announced regardless of its type. Bus handlers that accurately report when
+	they will next change an interrupt input therefore lose no precision in the timing of interrupts.
 */
-template <class T, bool uses_bus_request, bool uses_wait_line> class Processor: public ProcessorBase {
+template <class T, bool uses_bus_request, bool uses_wait_line, bool coalesces_bus_cycles = false> class Processor: public ProcessorBase {
 	public:
 		Processor(T &bus_handler);
 
@@ -272,7 +353,8 @@ template <class T, bool uses_bus_request, bool uses_wait_line> class Processor:
 		T &bus_handler_;
 
 		void assemble_page(InstructionPage &target, InstructionTable &table, bool add_offsets);
-		void copy_program(const MicroOp *source, std::vector<MicroOp> &destination);
+		ProgramIndex compile_program(const MicroOp *source, bool add_offsets);
+		inline void skip_halted_fetches();
 };
 
 #include "Implementation/Z80Implementation.hpp"
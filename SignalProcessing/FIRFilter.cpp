@@ -7,10 +7,128 @@
 //
 
 #include "FIRFilter.hpp"
+#include <algorithm>
 #include <cmath>
+#include <numeric>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define FIR_X86
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FIR_NEON
+#endif
 
 using namespace SignalProcessing;
 
+namespace {
+
+/*
+	Dot product implementations. All accumulate exact 32-bit sums of 16x16-bit products, so produce
+	identical results; the vector versions merely process eight or sixteen taps at a time, with any
+	remainder handled as per the scalar version.
+*/
+
+int dot_product_scalar(const short *coefficients, const short *samples, std::size_t length) {
+	int result = 0;
+	for(std::size_t c = 0; c < length; ++c) {
+		result += coefficients[c] * samples[c];
+	}
+	return result;
+}
+
+#ifdef FIR_X86
+
+int dot_product_sse2(const short *coefficients, const short *samples, std::size_t length) {
+	__m128i sums = _mm_setzero_si128();
+	std::size_t c = 0;
+	for(; c + 8 <= length; c += 8) {
+		const __m128i coefficient_vector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&coefficients[c]));
+		const __m128i sample_vector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&samples[c]));
+		sums = _mm_add_epi32(sums, _mm_madd_epi16(coefficient_vector, sample_vector));
+	}
+
+	sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+	sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sums) + dot_product_scalar(&coefficients[c], &samples[c], length - c);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FIR_AVX2
+
+__attribute__((target("avx2"))) int dot_product_avx2(const short *coefficients, const short *samples, std::size_t length) {
+	__m256i sums = _mm256_setzero_si256();
+	std::size_t c = 0;
+	for(; c + 16 <= length; c += 16) {
+		const __m256i coefficient_vector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&coefficients[c]));
+		const __m256i sample_vector = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&samples[c]));
+		sums = _mm256_add_epi32(sums, _mm256_madd_epi16(coefficient_vector, sample_vector));
+	}
+
+	__m128i half_sums = _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+	half_sums = _mm_add_epi32(half_sums, _mm_shuffle_epi32(half_sums, _MM_SHUFFLE(1, 0, 3, 2)));
+	half_sums = _mm_add_epi32(half_sums, _mm_shuffle_epi32(half_sums, _MM_SHUFFLE(2, 3, 0, 1)));
+	const int result = _mm_cvtsi128_si32(half_sums);
+
+	// Clear the upper halves of the vector registers explicitly before anything else runs; not all compilers
+	// do so for functions with a target attribute, and legacy SSE code is heavily penalised otherwise.
+	_mm256_zeroupper();
+	return result + dot_product_scalar(&coefficients[c], &samples[c], length - c);
+}
+
+#endif
+#endif
+
+#ifdef FIR_NEON
+
+int dot_product_neon(const short *coefficients, const short *samples, std::size_t length) {
+	int32x4_t sums = vdupq_n_s32(0);
+	std::size_t c = 0;
+	for(; c + 8 <= length; c += 8) {
+		const int16x8_t coefficient_vector = vld1q_s16(&coefficients[c]);
+		const int16x8_t sample_vector = vld1q_s16(&samples[c]);
+		sums = vmlal_s16(sums, vget_low_s16(coefficient_vector), vget_low_s16(sample_vector));
+		sums = vmlal_s16(sums, vget_high_s16(coefficient_vector), vget_high_s16(sample_vector));
+	}
+
+	const int32x2_t half_sums = vadd_s32(vget_low_s32(sums), vget_high_s32(sums));
+	return vget_lane_s32(vpadd_s32(half_sums, half_sums), 0) + dot_product_scalar(&coefficients[c], &samples[c], length - c);
+}
+
+#endif
+
+}
+
+FIRFilter::DotProduct FIRFilter::select_dot_product() {
+#if defined(FIR_AVX2)
+	if(__builtin_cpu_supports("avx2")) return dot_product_avx2;
+#endif
+#if defined(FIR_X86)
+	return dot_product_sse2;
+#elif defined(FIR_NEON)
+	return dot_product_neon;
+#else
+	return dot_product_scalar;
+#endif
+}
+
+std::vector<std::pair<std::string, FIRFilter::DotProduct>> FIRFilter::get_dot_products() {
+	std::vector<std::pair<std::string, DotProduct>> dot_products;
+	dot_products.emplace_back("scalar", dot_product_scalar);
+#if defined(FIR_X86)
+	dot_products.emplace_back("SSE2", dot_product_sse2);
+#endif
+#if defined(FIR_AVX2)
+	if(__builtin_cpu_supports("avx2")) dot_products.emplace_back("AVX2", dot_product_avx2);
+#endif
+#if defined(FIR_NEON)
+	dot_products.emplace_back("NEON", dot_product_neon);
+#endif
+	return dot_products;
+}
+
 /*
 
 	A Kaiser-Bessel filter is a real time window filter. It looks at the last n samples
@@ -46,18 +164,21 @@ float FIRFilter::ino(float a) {
 	return s;
 }
 
+/*! @returns alpha, the Kaiser-Bessel window shape factor, for the given @c attenuation. */
+float FIRFilter::kaiser_alpha(float attenuation) {
+	if(attenuation < 21.0f) return 0.0f;
+	if(attenuation > 50.0f) return 0.1102f * (attenuation - 8.7f);
+	return 0.5842f * powf(attenuation - 21.0f, 0.4f) + 0.7886f * (attenuation - 21.0f);
+}
+
+float FIRFilter::kaiser_bessel_window(float position, float attenuation) {
+	const float a = kaiser_alpha(attenuation);
+	return ino(a * sqrtf(std::max(0.0f, 1.0f - position * position))) / ino(a);
+}
+
 void FIRFilter::coefficients_for_idealised_filter_response(short *filter_coefficients, float *A, float attenuation, std::size_t number_of_taps) {
 	/* calculate alpha, which is the Kaiser-Bessel window shape factor */
-	float a;	// to take the place of alpha in the normal derivation
-
-	if(attenuation < 21.0f) {
-		a = 0.0f;
-	} else {
-		if(attenuation > 50.0f)
-			a = 0.1102f * (attenuation - 8.7f);
-		else
-			a = 0.5842f * powf(attenuation - 21.0f, 0.4f) + 0.7886f * (attenuation - 21.0f);
-	}
+	const float a = kaiser_alpha(attenuation);	// to take the place of alpha in the normal derivation
 
 	std::vector<float> filter_coefficients_float(number_of_taps);
 
@@ -126,12 +247,18 @@ FIRFilter::FIRFilter(std::size_t number_of_taps, float input_sample_rate, float
 	}
 
 	FIRFilter::coefficients_for_idealised_filter_response(filter_coefficients_.data(), A.data(), attenuation, number_of_taps);
+	update_coefficient_sum();
 }
 
 FIRFilter::FIRFilter(const std::vector<float> &coefficients) {
 	for(const auto coefficient: coefficients) {
 		filter_coefficients_.push_back(static_cast<short>(coefficient * FixedMultiplier));
 	}
+	update_coefficient_sum();
+}
+
+void FIRFilter::update_coefficient_sum() {
+	coefficient_sum_ = std::accumulate(filter_coefficients_.begin(), filter_coefficients_.end(), 0);
 }
 
 FIRFilter FIRFilter::operator+(const FIRFilter &rhs) const {
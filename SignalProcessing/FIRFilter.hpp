@@ -13,6 +13,8 @@
 #include <Accelerate/Accelerate.h>
 #endif
 
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace SignalProcessing {
@@ -56,14 +58,19 @@ class FIRFilter {
 				vDSP_dotpr_s1_15(filter_coefficients_.data(), 1, src, 1, &result, filter_coefficients_.size());
 				return result;
 			#else
-				int outputValue = 0;
-				for(std::size_t c = 0; c < filter_coefficients_.size(); ++c) {
-					outputValue += filter_coefficients_[c] * src[c];
-				}
-				return static_cast<short>(outputValue >> FixedShift);
+				return static_cast<short>(dot_product_(filter_coefficients_.data(), src, filter_coefficients_.size()) >> FixedShift);
 			#endif
 		}
 
+		/*!
+			Applies the filter to a batch of input samples that are all equal to @c value, in constant time.
+			The result is identical to that of the general @c apply other than on Apple platforms, where it may
+			differ in rounding of the least significant bit.
+		*/
+		inline short apply_to_constant(short value) const {
+			return static_cast<short>((value * coefficient_sum_) >> FixedShift);
+		}
+
 		/*! @returns The number of taps used by this filter. */
 		inline std::size_t get_number_of_taps() const {
 			return filter_coefficients_.size();
@@ -84,11 +91,36 @@ class FIRFilter {
 		*/
 		FIRFilter operator*(const FIRFilter &) const;
 
+		/*!
+			@returns The value at @c position, which should be in the range [-1, 1], of the Kaiser-Bessel window
+			that this class uses to achieve @c attenuation.
+		*/
+		static float kaiser_bessel_window(float position, float attenuation);
+
+		/*!
+			Computes the fixed-point dot product of @c length coefficients and samples. An implementation
+			is selected at runtime per the vector instructions available; Apple platforms use the
+			Accelerate framework instead.
+		*/
+		typedef int (*DotProduct)(const short *coefficients, const short *samples, std::size_t length);
+
+		/*!
+			@returns Each dot product implementation that this build and processor support, paired with its name,
+			the scalar implementation first. All should produce identical results.
+		*/
+		static std::vector<std::pair<std::string, DotProduct>> get_dot_products();
+
 	private:
 		std::vector<short> filter_coefficients_;
+		int coefficient_sum_ = 0;
+		void update_coefficient_sum();
+
+		DotProduct dot_product_ = select_dot_product();
+		static DotProduct select_dot_product();
 
 		static void coefficients_for_idealised_filter_response(short *filterCoefficients, float *A, float attenuation, std::size_t numberOfTaps);
 		static float ino(float a);
+		static float kaiser_alpha(float attenuation);
 };
 
 }
@@ -0,0 +1,45 @@
+//
+//  PolyphaseFilter.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#include "PolyphaseFilter.hpp"
+
+#include <cmath>
+
+using namespace SignalProcessing;
+
+PolyphaseFilter::PolyphaseFilter(std::size_t number_of_taps, std::size_t number_of_phases, float input_sample_rate, float high_frequency, float attenuation) {
+	if(number_of_taps < 3) number_of_taps = 3;
+	number_of_taps |= 1;
+	if(!number_of_phases) number_of_phases = 1;
+
+	// The ideal response is a sinc with its first zeroes at the reciprocal of twice the cut-off;
+	// window it to a little beyond the furthest offset of any tap so that no tap has a weight of zero.
+	const float cutoff = high_frequency / input_sample_rate;
+	const float centre = static_cast<float>(number_of_taps - 1) / 2.0f;
+	const float window_radius = centre + 1.0f;
+
+	std::vector<float> coefficients(number_of_taps);
+	phases_.reserve(number_of_phases);
+	for(std::size_t phase = 0; phase < number_of_phases; ++phase) {
+		const float offset = centre + static_cast<float>(phase) / static_cast<float>(number_of_phases);
+
+		float total = 0.0f;
+		for(std::size_t tap = 0; tap < number_of_taps; ++tap) {
+			const float position = static_cast<float>(tap) - offset;
+			const float sinc = (position == 0.0f) ?
+				2.0f * cutoff :
+				sinf(2.0f * static_cast<float>(M_PI) * cutoff * position) / (static_cast<float>(M_PI) * position);
+			coefficients[tap] = sinc * FIRFilter::kaiser_bessel_window(position / window_radius, attenuation);
+			total += coefficients[tap];
+		}
+
+		// Scale so that each phase retains 100% of input volume.
+		for(auto &coefficient: coefficients) coefficient /= total;
+		phases_.emplace_back(coefficients);
+	}
+}
@@ -0,0 +1,74 @@
+//
+//  PolyphaseFilter.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#ifndef PolyphaseFilter_hpp
+#define PolyphaseFilter_hpp
+
+#include "FIRFilter.hpp"
+
+#include <vector>
+
+namespace SignalProcessing {
+
+/*!
+	The polyphase filter provides a bank of low-pass FIR filters, each of which evaluates the same
+	windowed-sinc response at a different fractional offset between input samples. It therefore
+	permits a signal to be resampled to an arbitrary rate, higher or lower, by applying whichever
+	phase is nearest to the position of each output sample.
+
+	Each phase considers the same number of taps; the output of phase p is the filtered signal at
+	p/number_of_phases of a sample after the centre of the window supplied.
+*/
+class PolyphaseFilter {
+	public:
+		/*!
+			Creates an instance of @c PolyphaseFilter.
+
+			@param number_of_taps The size of window for input data; this will be made odd if it isn't already.
+			@param number_of_phases The number of evenly-spaced fractional offsets to provide filters for.
+			@param input_sample_rate The sampling rate of the input signal.
+			@param high_frequency The highest frequency of signal to retain in the output.
+			@param attenuation The attenuation of the discarded frequencies.
+		*/
+		PolyphaseFilter(std::size_t number_of_taps, std::size_t number_of_phases, float input_sample_rate, float high_frequency, float attenuation);
+
+		/*!
+			Applies the filter for @c phase to one batch of input samples, returning the net result.
+
+			@param src The source buffer to apply the filter to.
+			@param phase The phase to apply, in the range [0, number of phases).
+		*/
+		inline short apply(const short *src, std::size_t phase) const {
+			return phases_[phase].apply(src);
+		}
+
+		/*!
+			Applies the filter for @c phase to a batch of input samples that are all equal to @c value,
+			in constant time.
+		*/
+		inline short apply_to_constant(short value, std::size_t phase) const {
+			return phases_[phase].apply_to_constant(value);
+		}
+
+		/*! @returns The number of taps used by each phase of this filter. */
+		inline std::size_t get_number_of_taps() const {
+			return phases_.front().get_number_of_taps();
+		}
+
+		/*! @returns The number of phases provided by this filter. */
+		inline std::size_t get_number_of_phases() const {
+			return phases_.size();
+		}
+
+	private:
+		std::vector<FIRFilter> phases_;
+};
+
+}
+
+#endif /* PolyphaseFilter_hpp */
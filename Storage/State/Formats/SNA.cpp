@@ -0,0 +1,160 @@
+//
+//  SNA.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#include "SNA.hpp"
+
+#include "../../FileHolder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Storage::State;
+
+namespace {
+
+/*!
+	Decompresses a version 3 memory chunk of @c length bytes from @c file into @c target, which is
+	64kb long. Chunks that are exactly 64kb long are uncompressed; otherwise they're run-length encoded
+	with 0xe5 as an escape byte: 0xe5 followed by a non-zero count and a value is a run of that value,
+	0xe5 followed by 0 is a literal 0xe5.
+*/
+void read_memory_chunk(Storage::FileHolder &file, uint32_t length, uint8_t *target) {
+	if(length == 65536) {
+		file.read(target, length);
+		return;
+	}
+
+	std::size_t output = 0;
+	while(length && output < 65536 && !file.eof()) {
+		const uint8_t byte = file.get8();
+		--length;
+
+		if(byte != 0xe5 || !length) {
+			target[output++] = byte;
+			continue;
+		}
+
+		const uint8_t count = file.get8();
+		--length;
+		if(!count) {
+			target[output++] = 0xe5;
+			continue;
+		}
+
+		if(!length) break;
+		const uint8_t value = file.get8();
+		--length;
+
+		const std::size_t run_length = std::min(static_cast<std::size_t>(count), 65536 - output);
+		std::memset(&target[output], value, run_length);
+		output += run_length;
+	}
+}
+
+}
+
+SNA::SNA(const std::string &file_name) {
+	Storage::FileHolder file(file_name, Storage::FileHolder::FileMode::Read);
+
+	// Check the signature and version.
+	if(!file.check_signature("MV - SNA")) throw ErrorNotSNA;
+	file.seek(0x10, SEEK_SET);
+	const uint8_t version = file.get8();
+	if(version < 1 || version > 3) throw ErrorNotSNA;
+
+	// Z80 registers; pairs are stored low byte first.
+	z80.af = file.get16le();
+	z80.bc = file.get16le();
+	z80.de = file.get16le();
+	z80.hl = file.get16le();
+	z80.r = file.get8();
+	z80.i = file.get8();
+	z80.iff1 = !!file.get8();
+	z80.iff2 = !!file.get8();
+	z80.ix = file.get16le();
+	z80.iy = file.get16le();
+	z80.sp = file.get16le();
+	z80.pc = file.get16le();
+	z80.interrupt_mode = file.get8() & 3;
+	z80.af_dash = file.get16le();
+	z80.bc_dash = file.get16le();
+	z80.de_dash = file.get16le();
+	z80.hl_dash = file.get16le();
+
+	// Gate array. Some emulators store palette entries with bit 6 set, as they would be written.
+	gate_array.selected_pen = file.get8() & 0x1f;
+	for(auto &colour: gate_array.palette) {
+		colour = file.get8() & 0x1f;
+	}
+	gate_array.rom_and_mode_configuration = file.get8();
+	gate_array.ram_configuration = file.get8();
+
+	// CRTC.
+	crtc.selected_register = file.get8() & 0x1f;
+	file.read(crtc.registers, sizeof(crtc.registers));
+
+	// Upper ROM selection and 8255.
+	upper_rom_selection = file.get8();
+	ppi.port_a = file.get8();
+	ppi.port_b = file.get8();
+	ppi.port_c = file.get8();
+	ppi.control = file.get8();
+
+	// AY.
+	psg.selected_register = file.get8() & 0xf;
+	file.read(psg.registers, sizeof(psg.registers));
+
+	// Memory dump size, in kilobytes.
+	const uint16_t dump_size = file.get16le();
+	if(dump_size != 0 && dump_size != 64 && dump_size != 128) throw ErrorNotSNA;
+	if(!dump_size && version < 3) throw ErrorNotSNA;
+
+	// Versions 2 and later record the machine.
+	if(version >= 2) {
+		switch(file.get8()) {
+			case 0:	model = Model::CPC464;	break;
+			case 1:	model = Model::CPC664;	break;
+			case 2:	model = Model::CPC6128;	break;
+			default: break;
+		}
+	}
+
+	// Grab the memory dump, if any.
+	file.seek(0x100, SEEK_SET);
+	if(dump_size) {
+		ram.resize(static_cast<std::size_t>(dump_size) * 1024);
+		if(file.read(ram.data(), ram.size()) != ram.size()) throw ErrorNotSNA;
+	}
+
+	// Version 3 files may also contain chunks, including compressed memory.
+	if(version >= 3) {
+		while(true) {
+			uint8_t name[4];
+			if(file.read(name, 4) != 4) break;
+			const uint32_t length = file.get32le();
+			if(file.eof()) break;
+
+			const long next_chunk = file.tell() + static_cast<long>(length);
+			if(!memcmp(name, "MEM0", 4) || !memcmp(name, "MEM1", 4)) {
+				const std::size_t bank = static_cast<std::size_t>(name[3] - '0');
+				if(ram.size() < (bank + 1) * 65536) ram.resize((bank + 1) * 65536);
+				read_memory_chunk(file, length, &ram[bank * 65536]);
+			} else if(!memcmp(name, "MEM", 3) && name[3] >= '2' && name[3] <= '8') {
+				// Expansion RAM beyond 128kb isn't emulated, so such a snapshot can't be restored.
+				throw ErrorNotSNA;
+			}
+			file.seek(next_chunk, SEEK_SET);
+		}
+	}
+
+	if(ram.empty()) throw ErrorNotSNA;
+}
+
+TargetPlatform::Type SNA::target_platform_type() {
+	return TargetPlatform::AmstradCPC;
+}
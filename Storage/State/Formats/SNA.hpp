@@ -0,0 +1,100 @@
+//
+//  SNA.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#ifndef Storage_State_SNA_hpp
+#define Storage_State_SNA_hpp
+
+#include "../Snapshot.hpp"
+#include "../../TargetPlatforms.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Storage {
+namespace State {
+
+/*!
+	Provides a @c Snapshot containing an Amstrad CPC SNA file, as produced by most CPC emulators.
+
+	Versions 1 and 2 of the format, and the uncompressed or compressed memory dumps of version 3,
+	are supported. Files that include expansion RAM beyond 128kb, in MEM2 to MEM8 chunks, are rejected;
+	other version 3 chunks are ignored.
+*/
+class SNA: public Snapshot, public TargetPlatform::TypeDistinguisher {
+	public:
+		/*!
+			Constructs an @c SNA containing content from the file with name @c file_name.
+
+			@throws ErrorNotSNA if this file could not be opened and recognised as a valid SNA file.
+		*/
+		SNA(const std::string &file_name);
+
+		enum {
+			ErrorNotSNA
+		};
+
+		/// The machine that produced this snapshot, if known.
+		enum class Model {
+			Unknown,
+			CPC464,
+			CPC664,
+			CPC6128
+		} model = Model::Unknown;
+
+		/// The Z80's registers, with 16-bit pairs given as a single value.
+		struct {
+			uint16_t af = 0, bc = 0, de = 0, hl = 0;
+			uint16_t af_dash = 0, bc_dash = 0, de_dash = 0, hl_dash = 0;
+			uint16_t ix = 0, iy = 0, sp = 0, pc = 0;
+			uint8_t i = 0, r = 0;
+			bool iff1 = false, iff2 = false;
+			uint8_t interrupt_mode = 0;
+		} z80;
+
+		/// The gate array's state: the selected pen, the hardware colour of each pen with the border as pen 16,
+		/// and the most recent values written to its mode/ROM and RAM configuration registers.
+		struct {
+			uint8_t selected_pen = 0;
+			uint8_t palette[17];
+			uint8_t rom_and_mode_configuration = 0;
+			uint8_t ram_configuration = 0;
+		} gate_array;
+
+		/// The CRTC's state.
+		struct {
+			uint8_t selected_register = 0;
+			uint8_t registers[18];
+		} crtc;
+
+		/// The most recent value written to the upper ROM selection port.
+		uint8_t upper_rom_selection = 0;
+
+		/// The 8255's state.
+		struct {
+			uint8_t port_a = 0, port_b = 0, port_c = 0;
+			uint8_t control = 0;
+		} ppi;
+
+		/// The AY's state.
+		struct {
+			uint8_t selected_register = 0;
+			uint8_t registers[16];
+		} psg;
+
+		/// The contents of RAM; either 64kb or 128kb.
+		std::vector<uint8_t> ram;
+
+		// Implemented to satisfy @c TargetPlatform::TypeDistinguisher.
+		TargetPlatform::Type target_platform_type() override;
+};
+
+}
+}
+
+#endif /* Storage_State_SNA_hpp */
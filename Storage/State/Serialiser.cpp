@@ -0,0 +1,128 @@
+//
+//  Serialiser.cpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 28/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#include "Serialiser.hpp"
+
+#include <cstring>
+
+using namespace Storage::State;
+
+Serialiser::Serialiser(std::vector<uint8_t> &target) : target_(&target) {}
+
+Serialiser::Serialiser(const std::vector<uint8_t> &source) : source_(&source) {}
+
+int Serialiser::begin_section(const char *tag, int version) {
+	if(target_) {
+		target_->insert(target_->end(), tag, tag + 4);
+
+		uint16_t stored_version = static_cast<uint16_t>(version);
+		field(stored_version);
+
+		// Leave space for the length, to be filled in by end_section.
+		section_ends_.push_back(target_->size());
+		uint32_t length = 0;
+		field(length);
+		return version;
+	}
+
+	// Restoration: check that the tag and version are acceptable, and record where
+	// this section ends. If this serialiser is already invalid then nothing is read
+	// but a section end is still pushed, to balance the corresponding end_section.
+	uint16_t stored_version = 0;
+	uint32_t length = 0;
+	if(is_valid_ && can_read(4)) {
+		if(memcmp(&(*source_)[offset_], tag, 4)) {
+			is_valid_ = false;
+		}
+		offset_ += 4;
+	}
+	field(stored_version);
+	field(length);
+	if(!stored_version || stored_version > version) is_valid_ = false;
+	if(is_valid_ && !can_read(length)) is_valid_ = false;
+
+	section_ends_.push_back(offset_ + length);
+	return is_valid_ ? stored_version : 0;
+}
+
+void Serialiser::end_section() {
+	const size_t end = section_ends_.back();
+	section_ends_.pop_back();
+
+	if(target_) {
+		// end currently indicates the location of the length field; calculate and store the length.
+		const uint32_t length = static_cast<uint32_t>(target_->size() - end - 4);
+		for(size_t c = 0; c < 4; ++c) {
+			(*target_)[end + c] = static_cast<uint8_t>(length >> (c * 8));
+		}
+		return;
+	}
+
+	// Skip anything within the section that wasn't read; if reading has proceeded beyond
+	// the end of the section then the section was malformed.
+	if(offset_ > end) is_valid_ = false;
+	if(is_valid_) offset_ = end;
+}
+
+void Serialiser::field(bool &value) {
+	uint8_t flag = value ? 1 : 0;
+	integer(flag);
+	value = !!flag;
+}
+
+void Serialiser::field(float &value) {
+	static_assert(sizeof(float) == sizeof(uint32_t), "Floats are expected to be 32-bit IEEE 754 values");
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	integer(bits);
+	memcpy(&value, &bits, sizeof(bits));
+}
+
+void Serialiser::field(double &value) {
+	static_assert(sizeof(double) == sizeof(uint64_t), "Doubles are expected to be 64-bit IEEE 754 values");
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	integer(bits);
+	memcpy(&value, &bits, sizeof(bits));
+}
+
+void Serialiser::field(std::vector<uint8_t> &vector, bool fixed_size) {
+	uint32_t size = static_cast<uint32_t>(vector.size());
+	field(size);
+
+	if(!target_ && is_valid_) {
+		if(fixed_size) {
+			if(size != vector.size()) is_valid_ = false;
+		} else if(can_read(size)) {
+			vector.resize(size);
+		}
+	}
+	if(!vector.empty()) bytes(vector.data(), vector.size());
+}
+
+void Serialiser::bytes(uint8_t *data, size_t length) {
+	if(target_) {
+		target_->insert(target_->end(), data, data + length);
+		return;
+	}
+
+	if(!can_read(length)) return;
+	memcpy(data, &(*source_)[offset_], length);
+	offset_ += length;
+}
+
+bool Serialiser::can_read(size_t length) {
+	if(!is_valid_) return false;
+
+	const size_t limit = section_ends_.empty() ? source_->size() : section_ends_.back();
+	if(offset_ + length > limit) {
+		is_valid_ = false;
+		return false;
+	}
+	return true;
+}
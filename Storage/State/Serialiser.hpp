@@ -0,0 +1,153 @@
+//
+//  Serialiser.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 28/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#ifndef Storage_State_Serialiser_hpp
+#define Storage_State_Serialiser_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "../../ClockReceiver/ClockReceiver.hpp"
+
+namespace Storage {
+namespace State {
+
+/*!
+	A serialiser captures or restores state symmetrically: components provide a single
+	@c serialise(Serialiser &) that nominates each of their fields in turn, and depending
+	on the mode of the serialiser those fields are either appended to or read from a
+	binary buffer.
+
+	State is grouped into sections, each of which has a four-character tag, a version number
+	and a length. Upon restoration a section with an unexpected tag, or with a version later
+	than that supported, marks the serialiser as invalid; so too does any attempt to read
+	beyond the end of the buffer or of the current section. Once invalid, a serialiser ignores
+	all further fields, leaving them unmodified.
+
+	All integers, and the bit patterns of floating-point values, are stored little endian.
+*/
+class Serialiser {
+	public:
+		/// Constructs a serialiser that captures state, appending it to @c target.
+		Serialiser(std::vector<uint8_t> &target);
+
+		/// Constructs a serialiser that restores state from @c source.
+		Serialiser(const std::vector<uint8_t> &source);
+
+		/// @returns @c true if this serialiser is capturing state; @c false if it is restoring it.
+		bool is_capturing() const {
+			return target_ != nullptr;
+		}
+
+		/// @returns @c true if no error has yet been encountered; @c false otherwise.
+		bool is_valid() const {
+			return is_valid_;
+		}
+
+		/// Marks this serialiser as invalid; components may use this to reject state they can't apply.
+		void set_invalid() {
+			is_valid_ = false;
+		}
+
+		/*!
+			Begins a section.
+
+			@param tag A four-character tag identifying the section.
+			@param version The version of the section that the caller implements.
+			@returns If capturing, @c version. If restoring, the version of the section that was
+				stored, which will be no greater than @c version, or 0 if the section is invalid.
+		*/
+		int begin_section(const char *tag, int version);
+
+		/// Ends the most-recently begun section.
+		void end_section();
+
+		/// Captures or restores an integral value.
+		template <typename T> typename std::enable_if<std::is_integral<T>::value>::type field(T &value) {
+			integer(value);
+		}
+
+		/// Captures or restores an enumerated value, via its underlying type.
+		template <typename T> typename std::enable_if<std::is_enum<T>::value>::type field(T &value) {
+			typename std::underlying_type<T>::type underlying = static_cast<typename std::underlying_type<T>::type>(value);
+			integer(underlying);
+			value = static_cast<T>(underlying);
+		}
+
+		/// Captures or restores a Boolean, as a single byte.
+		void field(bool &value);
+
+		/// Captures or restores a floating-point value, as its IEEE 754 bit pattern stored as a little-endian integer.
+		void field(float &value);
+		void field(double &value);
+
+		/// Captures or restores a Cycles, HalfCycles or other WrappedInt.
+		template <typename T> void field(WrappedInt<T> &value) {
+			int length = value.as_int();
+			field(length);
+			static_cast<T &>(value) = T(length);
+		}
+
+		/// Captures or restores a fixed-size array.
+		template <typename T, size_t n> void field(T (&array)[n]) {
+			for(size_t c = 0; c < n; ++c) field(array[c]);
+		}
+		template <size_t n> void field(uint8_t (&array)[n]) {
+			bytes(array, n);
+		}
+
+		/*!
+			Captures or restores a vector of bytes. When restoring, the vector will be
+			left at the stored size only if @c fixed_size is @c false; otherwise a stored
+			size that differs from the vector's current size marks this serialiser as invalid.
+		*/
+		void field(std::vector<uint8_t> &vector, bool fixed_size = true);
+
+		/// Captures or restores @c length bytes starting at @c data.
+		void bytes(uint8_t *data, size_t length);
+
+	private:
+		std::vector<uint8_t> *target_ = nullptr;
+		const std::vector<uint8_t> *source_ = nullptr;
+		size_t offset_ = 0;
+		bool is_valid_ = true;
+
+		std::vector<size_t> section_ends_;
+
+		template <typename T> void integer(T &value) {
+			typedef typename std::make_unsigned<T>::type Unsigned;
+			uint8_t encoding[sizeof(T)];
+			Unsigned encoded = static_cast<Unsigned>(value);
+
+			if(target_) {
+				for(size_t c = 0; c < sizeof(T); ++c) {
+					encoding[c] = static_cast<uint8_t>(encoded);
+					encoded = static_cast<Unsigned>(encoded >> 8);
+				}
+				target_->insert(target_->end(), encoding, encoding + sizeof(T));
+				return;
+			}
+
+			if(!can_read(sizeof(T))) return;
+			encoded = 0;
+			for(size_t c = 0; c < sizeof(T); ++c) {
+				encoded |= static_cast<Unsigned>(static_cast<Unsigned>((*source_)[offset_ + c]) << (c * 8));
+			}
+			offset_ += sizeof(T);
+			value = static_cast<T>(encoded);
+		}
+
+		bool can_read(size_t length);
+};
+
+}
+}
+
+#endif /* Storage_State_Serialiser_hpp */
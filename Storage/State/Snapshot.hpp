@@ -0,0 +1,30 @@
+//
+//  Snapshot.hpp
+//  Clock Signal
+//
+//  Created by Thomas Harte on 30/09/2018.
+//  Copyright 2018 Thomas Harte. All rights reserved.
+//
+
+#ifndef Storage_State_Snapshot_hpp
+#define Storage_State_Snapshot_hpp
+
+namespace Storage {
+namespace State {
+
+/*!
+	Provides a base class for snapshots: files produced by other emulators that capture the
+	complete state of a particular machine, which can be installed in place of booting it.
+
+	As with cartridges, what constitutes machine state is entirely machine-dependent, so
+	no model is imposed; consumers will dynamic_cast to the specific format they understand.
+*/
+class Snapshot {
+	public:
+		virtual ~Snapshot() {}
+};
+
+}
+}
+
+#endif /* Storage_State_Snapshot_hpp */
@@ -104,6 +104,11 @@ void TapePlayer::run_for(const Cycles cycles) {
 	}
 }
 
+Cycles TapePlayer::get_next_sequence_point() {
+	if(preferred_clocking() == ClockingHint::Preference::None) return Cycles(static_cast<int>(get_input_clock_rate()));
+	return Cycles(static_cast<int>(get_cycles_until_next_event()));
+}
+
 void TapePlayer::run_for_input_pulse() {
 	jump_to_next_event();
 }
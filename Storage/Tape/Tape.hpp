@@ -107,6 +107,13 @@ class TapePlayer: public TimedEventLoop, public ClockingHint::Source {
 
 		void run_for_input_pulse();
 
+		/*!
+			@returns The number of cycles until the next pulse ends, i.e. the time for which this player
+			can go unclocked without missing a call to process_input_pulse. If the player doesn't currently
+			want clocking at all then a second is reported, so that owners needn't accumulate time indefinitely.
+		*/
+		Cycles get_next_sequence_point();
+
 		ClockingHint::Preference preferred_clocking() override;
 
 	protected: